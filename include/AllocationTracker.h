@@ -0,0 +1,50 @@
+#ifndef ALLOCATIONTRACKER_H
+#define ALLOCATIONTRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 按线程统计堆分配 - 用于验证稳态采集每帧不分配内存
+ *
+ * CMake 选项 ENABLE_ALLOCATION_TRACKING 打开后替换全局 operator new/delete，
+ * 每个线程在自己的计数槽上做 relaxed 原子累加；未打开时所有接口为空操作。
+ * 线程名沿用 TraceRecorder::setThreadName()，未命名的线程合并为"其他线程"。
+ * 线程退出时计数按名称并入历史累计，计数槽归还给之后创建的线程；
+ * 同时存活的线程超过槽数时，多出的线程共用一个不记名称的溢出槽。
+ * 只统计 operator new：Qt 容器（QString/QByteArray/QImage 像素）内部直接调用 malloc，不在统计内。
+ */
+class AllocationTracker
+{
+public:
+    struct Counters {
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+        uint64_t frees = 0;
+    };
+
+    struct ThreadCounters {
+        std::string name;
+        Counters counters;
+    };
+
+    static bool isEnabled();
+
+    static void setThreadName(const char *name);
+    static Counters thisThread();
+
+    // 按线程名合并的累计计数（包括已退出的线程）；设置过名称的线程即使没有分配也有一项
+    static std::vector<ThreadCounters> snapshot();
+
+    // after - before，按名称对齐；只保留有新分配的线程
+    static std::vector<ThreadCounters> difference(const std::vector<ThreadCounters> &before,
+                                                  const std::vector<ThreadCounters> &after);
+
+    // operator new/delete 钩子调用
+    static void recordAllocation(size_t bytes);
+    static void recordFree();
+};
+
+#endif // ALLOCATIONTRACKER_H
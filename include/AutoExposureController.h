@@ -0,0 +1,79 @@
+#ifndef AUTOEXPOSURECONTROLLER_H
+#define AUTOEXPOSURECONTROLLER_H
+
+#include <QObject>
+#include <atomic>
+#include <mutex>
+#include "HistogramEngine.h"
+
+class CameraController;
+
+/**
+ * @brief 软件自动曝光/自动增益闭环控制器
+ *
+ * 由分析线程对每帧统计结果调用 process()：
+ * - 测光值取均值或指定百分位，与目标亮度（满量程占比）比较
+ * - 在对数域按阻尼系数逼近目标，误差落入容差带内不再写入
+ * - 优先调节曝光（受相机范围、Settings::maxExposureUs 和帧周期 1e6/帧率约束），曝光到顶后再加增益；
+ *   降低亮度时先减增益
+ * - 通过 CameraController 的异步参数通道写入，写入后跳过在途帧再评估
+ */
+class AutoExposureController : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class MeteringMode {
+        Mean,
+        Percentile
+    };
+
+    struct Settings {
+        MeteringMode mode = MeteringMode::Mean;
+        double target = 0.45;          // 目标亮度，满量程占比
+        double percentile = 0.95;      // Percentile 模式下的测光百分位
+        double damping = 0.7;          // 每步修正对数误差的比例 (0, 1]
+        double tolerance = 0.04;       // 相对误差容差带
+        double maxSaturation = 2.0;    // 饱和像素超过该百分比时强制降低亮度
+        double maxExposureUs = 0.0;    // 曝光上限（<= 0 表示仅受相机范围约束）
+        int latencyFrames = 3;         // 参数写入后需跳过的在途帧数
+    };
+
+    explicit AutoExposureController(CameraController *camera, QObject *parent = nullptr);
+
+    // GUI线程调用：读取当前曝光/增益和范围，并关闭相机内置自动模式
+    bool enable();
+    void disable();
+    bool isEnabled() const;
+
+    void setSettings(const Settings &settings);
+    Settings settings() const;
+
+    // 任意线程调用：当前采集帧率，曝光不超过帧周期；<= 0 表示未知，不按帧周期限制
+    void setFrameRate(double fps);
+
+    // 分析线程调用
+    void process(const FrameStatistics &stats);
+
+Q_SIGNALS:
+    void exposureAdjusted(double exposureUs, double gainDb);
+    void convergedChanged(bool converged);
+
+private:
+    CameraController *m_camera;
+    std::atomic_bool m_enabled{false};
+
+    mutable std::mutex m_mutex;
+    Settings m_settings;
+    std::atomic<double> m_frameRate{0.0};
+
+    // 以下仅在分析线程访问（enable() 时在启用前初始化）
+    double m_exposureMin = 1.0, m_exposureMax = 1.0;
+    double m_gainMin = 0.0, m_gainMax = 0.0;
+    double m_exposure = 0.0;
+    double m_gain = 0.0;
+    int m_framesToSkip = 0;
+    bool m_converged = false;
+};
+
+#endif // AUTOEXPOSURECONTROLLER_H
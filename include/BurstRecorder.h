@@ -0,0 +1,93 @@
+#ifndef BURSTRECORDER_H
+#define BURSTRECORDER_H
+
+#include <QObject>
+#include <QString>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Frame.h"
+
+/**
+ * @brief 连拍录制 - 以相机最高速率把接下来的 N 帧存入内存
+ *
+ * arm() 在 GUI 线程按当前帧尺寸一次性分配 N 帧的连续内存并预先触碰所有页面，
+ * 采集线程的 store() 只做一次 memcpy，不分配内存、不转换、不显示。
+ * 连拍完成后可逐帧回看，或在后台线程保存为 PGM 序列。
+ */
+class BurstRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class State {
+        Idle,
+        Armed,
+        Complete
+    };
+
+    explicit BurstRecorder(QObject *parent = nullptr);
+    ~BurstRecorder();
+
+    // GUI 线程调用：分配内存并布防，后续 frameCount 帧（尺寸和位深需一致）写入内存
+    bool arm(int frameCount, int width, int height, int bitDepth, QString *error = nullptr);
+    void cancel();
+    void release();
+
+    State state() const;
+    bool isArmed() const;
+
+    // 采集线程调用：返回 true 表示帧已被连拍接收，调用方不应再送往处理管线
+    bool store(const Frame &header, const uint8_t *data);
+
+    int capturedFrames() const;
+    int requestedFrames() const;
+    uint64_t missingFrames() const;     // 按帧号间隔统计的缺失帧
+    double captureFps() const;
+
+    // 连拍完成后调用：拷贝出一帧用于显示
+    FramePtr frameAt(int index) const;
+
+    // 在后台线程保存为 PGM 序列和索引 CSV，完成后发出 saveFinished
+    bool saveAsync(const QString &directory);
+    bool isSaving() const;
+
+Q_SIGNALS:
+    void burstProgress(int captured, int total);
+    void burstFinished(int captured, qulonglong missingFrames, double fps);
+    void saveFinished(bool success, const QString &message);
+
+private:
+    struct FrameMeta {
+        uint32_t pixelFormat;
+        int offsetX;
+        int offsetY;
+        uint64_t frameId;
+        uint64_t timestampNs;
+        uint64_t systemTimestampNs;
+        FrameChunkData chunk;
+    };
+
+    void disarmAndWait();
+    void saveLoop(QString directory);
+
+    std::atomic<State> m_state{State::Idle};
+    std::unique_ptr<uint8_t[]> m_arena;
+    std::vector<FrameMeta> m_meta;
+    size_t m_frameBytes = 0;
+    int m_width = 0;
+    int m_height = 0;
+    int m_bitDepth = 0;
+    int m_requested = 0;
+    std::atomic_int m_captured{0};
+    std::atomic_bool m_storing{false};   // 采集线程正在写入，arm/release 需等待其结束
+    std::atomic<uint64_t> m_missing{0};
+    int64_t m_progressReportNs = 0;
+
+    std::thread m_saveThread;
+    std::atomic_bool m_saving{false};
+};
+
+#endif // BURSTRECORDER_H
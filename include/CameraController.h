@@ -5,8 +5,25 @@
 #include <QImage>
 #include <QString>
 #include <QTimer>
+#include <QVector>
+#include <array>
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
 #include <thread>
+#include "Frame.h"
+#include "FramePipeline.h"
+#include "FrameBusWriter.h"
+#include "DerivedFrameCache.h"
+#include "DisplayLut.h"
+#include "FramePool.h"
+#include "AllocationTracker.h"
+#include "ChunkDecoder.h"
+#include "ParameterSequencer.h"
+#include "IntervalHistogram.h"
+#include "RealtimeTuning.h"
+#include "UsbTransferTuning.h"
 
 // 解决 Qt 和 GLib 的宏冲突
 #ifdef signals
@@ -18,6 +35,30 @@
 // 恢复 Qt 的 signals 宏
 #define signals Q_SIGNALS
 
+class FrameAnalyzer;
+class AutoExposureController;
+class FlatFieldCorrector;
+class TemporalFilter;
+class HdrFusion;
+class BurstRecorder;
+class ImageSaveService;
+class PreviewStreamServer;
+class FrameDropMonitor;
+
+/**
+ * @brief 设备枚举结果中的一台相机
+ */
+struct CameraDeviceInfo
+{
+    QString id;             // arv_get_device_id()，可直接传给 connectCamera()
+    QString vendor;
+    QString model;
+    QString serial;
+    QString protocol;       // GigEVision / USB3Vision / Fake
+
+    QString label() const { return QString("%1 %2 (%3, %4)").arg(vendor, model, serial, protocol); }
+};
+
 /**
  * @brief 相机控制器类 - 封装Aravis相机操作
  *
@@ -35,7 +76,13 @@ public:
     explicit CameraController(QObject *parent = nullptr);
     ~CameraController();
 
-    // 相机连接相关
+    // 后台设备探测：工作线程上先打开 preferredId（非空时，并停止其采集），
+    // 再枚举全部设备；打开的相机留给随后的 connectCamera(preferredId) 直接使用。
+    // 依次发出 preferredCameraOpened（打开成功时）和 devicesEnumerated
+    void startDeviceProbe(const QString &preferredId = QString());
+    bool isProbing() const;
+
+    // 相机连接相关；探测进行中且不能复用探测结果时先等待探测结束
     bool connectCamera(const QString &cameraId = QString());
     void disconnectCamera();
     bool isConnected() const;
@@ -44,6 +91,8 @@ public:
     QString getCameraModel() const;
     QString getCameraVendor() const;
     QString getCameraSerialNumber() const;
+    // 连接时使用的设备 ID，未指定时为空
+    QString cameraId() const;
 
     // 参数控制
     bool setExposureTime(double microseconds);
@@ -54,20 +103,128 @@ public:
     double getGain() const;
     bool getGainBounds(double &min, double &max) const;
 
-    // ROI控制
+    // 异步参数写入（采集中闭环调节用）：每个参数只保留最新请求，
+    // 由参数线程写入相机，调用方从不阻塞；不会修改自动曝光/增益模式
+    void setExposureTimeAsync(double microseconds);
+    void setGainAsync(double gain);
+
+    // ROI控制：采集中调用时走 reconfigureAcquisition()，不重建流
     bool setROI(int x, int y, int width, int height);
     bool getROI(int &x, int &y, int &width, int &height) const;
     bool getROIBounds(int &maxWidth, int &maxHeight) const;
 
+    // 采集中修改 ROI/像素格式：暂停采集线程、相机和流接收线程，写入参数，
+    // 仅当负载变大时替换缓冲区，然后恢复；流对象、处理管线和分析线程保持运行。
+    // 写入失败时恢复原 ROI 和像素格式并返回 false。
+    // pixelFormat 为 0 表示不修改。完成后发出 acquisitionReconfigured
+    bool reconfigureAcquisition(int x, int y, int width, int height, ArvPixelFormat pixelFormat = 0);
+
     // 图像采集
     bool startAcquisition();
     void stopAcquisition();
     bool isAcquiring() const;
 
-    // 单帧采集
+    // 块数据（ChunkModeActive）：曝光/增益/帧号/线状态/时间戳随帧发送，
+    // 在采集线程上解析到 Frame::chunk；只能在未采集时切换
+    bool setChunkDataEnabled(bool enabled);
+    bool isChunkDataEnabled() const;
+    // GUI 线程：最近一帧显示图像的块数据
+    FrameChunkData lastFrameChunkData() const;
+    // GUI 线程：newFrameAvailable 发出期间为该帧的帧号（用于延迟追踪）
+    uint64_t lastFrameId() const;
+
+    // 单帧采集：快照模式下对常驻流发软件触发，否则临时建流采集一帧
     QImage grabSingleFrame(int timeoutMs = 5000);
 
+    // 快照模式：未采集时保持一个触发模式的常驻流和缓冲池，
+    // 单帧耗时只剩曝光和传输时间；开始连续采集时自动让出，停止后恢复
+    bool setSnapshotModeEnabled(bool enabled);
+    bool isSnapshotModeEnabled() const;
+
+    // 图像分析（直方图/统计），由采集线程投递帧
+    FrameAnalyzer *frameAnalyzer() const;
+
+    // 软件自动曝光/自动增益，由分析线程按帧驱动
+    AutoExposureController *autoExposureController() const;
+
+    // 暗场/平场校正（处理管线阶段）
+    FlatFieldCorrector *flatFieldCorrector() const;
+
+    // 时域平均/运行背景（处理管线阶段，位于校正之后）
+    TemporalFilter *temporalFilter() const;
+
+    // 曝光/增益参数序列（包围曝光）：逐帧循环切换各组参数并标记到 Frame::sequence；
+    // 相机支持 SequencerMode 时由相机切换，否则由参数线程流水线写入。
+    // 只能在未采集时设置，steps 少于 2 组表示关闭；与自动曝光/自动增益互斥
+    bool setParameterSequence(const ParameterSequencer::Settings &settings);
+    const ParameterSequencer &parameterSequencer() const;
+
+    // 包围曝光融合（处理管线阶段，位于校正之后、时域滤波之前）
+    HdrFusion *hdrFusion() const;
+
+    // 处理管线输入队列的溢出策略（采集线程 -> 首个阶段）
+    void setPipelineOverflowPolicy(FramePipeline::OverflowPolicy policy);
+
+    // 把处理后的帧发布到共享内存帧总线，供外部进程读取（见 FrameBusClient）
+    void setFrameBusEnabled(bool enabled);
+    bool isFrameBusEnabled() const;
+
+    // 派生输出（裁剪/合并/抽样）：各消费者按需订阅，同一帧的相同规格只计算一次。
+    // 预览和帧总线默认使用原始帧；预览规格不支持裁剪（框选坐标按 scale() 换算回原始帧）
+    DerivedFrameCache *derivedFrames();
+    void setPreviewOutput(const DerivedFrameSpec &spec);
+    DerivedFrameSpec previewOutput() const;
+    void setFrameBusOutput(const DerivedFrameSpec &spec);
+    DerivedFrameSpec frameBusOutput() const;
+
+    // 显示窗口（窗宽窗位、伽马、伪彩色），只作用于预览图像；查找表在设置改变后按需重建
+    void setDisplayWindow(const DisplayWindow &window);
+    DisplayWindow displayWindow() const;
+    // 按当前显示窗口把帧转换为显示图像（实时预览和连拍回看共用）
+    QImage toDisplayImage(const FramePtr &frame);
+
+    // 远程预览（MJPEG over HTTP），只在有客户端时才计算派生帧和编码
+    PreviewStreamServer *previewStreamServer() const;
+    void setStreamOutput(const DerivedFrameSpec &spec);
+    DerivedFrameSpec streamOutput() const;
+
+    // 连拍：采集中把接下来的 frameCount 帧直接拷入预分配内存（不经处理管线和显示），
+    // useMaxFrameRate 为 true 时临时切换到相机最高帧率，结束后恢复
+    bool startBurst(int frameCount, bool useMaxFrameRate);
+    void cancelBurst();
+    BurstRecorder *burstRecorder() const;
+
+    // 后台图像保存（序列录制/单帧），处理后的帧和单帧采集的帧都会送达
+    ImageSaveService *imageSaveService() const;
+
+    // 丢帧监测：按缓冲区帧号间隔和状态分类统计，超过阈值时报警
+    FrameDropMonitor *frameDropMonitor() const;
+
+    // 采集线程实时性选项，在下次开始采集时生效（采集中调用返回 false）
+    bool setCaptureThreadOptions(const CaptureThreadOptions &options);
+    CaptureThreadOptions captureThreadOptions() const;
+
+    // 采集线程相邻两次出队的间隔分布（抖动），每次开始采集时清空
+    const IntervalHistogram &popIntervalHistogram() const;
+
+    // USB3 Vision 传输：USB 模式和最大传输大小在下次开始采集（创建流）时生效，采集中调用返回 false
+    bool isUsb3Device() const;
+    bool setUsbTransferOptions(const UsbTransferOptions &options);
+    UsbTransferOptions usbTransferOptions() const;
+    // 相机 DeviceLinkThroughputLimit（字节/秒），0 表示不限制；采集中也可修改
+    bool setLinkThroughputLimit(uint64_t bytesPerSecond);
+    uint64_t linkThroughputLimit() const;
+    bool linkThroughputLimitBounds(uint64_t &minimum, uint64_t &maximum) const;
+
+    // 每个缓冲区从开始接收到接收完成的耗时分布，每次开始采集时清空
+    const IntervalHistogram &transferDurationHistogram() const;
+    // 当前连续采集流的统计项（名称 = 值），未采集时为空
+    QStringList streamInfo() const;
+
 Q_SIGNALS:
+    // 后台探测：preferredId 已在工作线程上打开，可立即连接
+    void preferredCameraOpened(const QString &cameraId);
+    void devicesEnumerated(const QVector<CameraDeviceInfo> &devices, double elapsedMs);
     void cameraConnected(const QString &model);
     void cameraDisconnected();
     void newFrameAvailable(const QImage &image);
@@ -76,20 +233,176 @@ Q_SIGNALS:
     void acquisitionStopped();
     void parameterChanged(const QString &paramName, double value);
     void fpsUpdated(double fps);
+    // 每秒一次，各阶段队列深度/占用率的摘要
+    void pipelineStatisticsUpdated(const QString &summary);
+    // 单帧采集耗时（调用到拿到图像），warmStream 表示来自快照模式的常驻流
+    void grabLatencyMeasured(double milliseconds, bool warmStream);
+    // 每秒一次：接收吞吐、单帧传输耗时和流的错误计数
+    void transferStatisticsUpdated(const QString &summary);
+    // 实时性选项和 USB3 传输设置的实际生效情况（采集线程/接收线程/USB3 传输各报告一次）
+    void captureThreadConfigured(const QString &report, bool success);
+    // 重配置完成：applyMs 为暂停到恢复的耗时，gapMs 为重配置前最后一帧到之后第一帧的无帧间隔
+    void acquisitionReconfigured(double applyMs, double gapMs);
+    // 停止采集时（ENABLE_ALLOCATION_TRACKING）：预热后采集线程的分配次数和字节数，
+    // measured 为 false 表示采集线程没有独立计数，结果未知
+    void steadyStateAllocationsMeasured(bool measured, quint64 allocations, quint64 bytes, quint64 frames);
 
 private Q_SLOTS:
     void updateFPS();
+    void onBurstFinished(int captured, qulonglong missingFrames, double fps);
 
 private:
+    static constexpr uint32_t FRAME_BUS_SLOTS = 8;
+    static constexpr int SNAPSHOT_BUFFERS = 3;
+    static constexpr guint64 BLOCKING_POP_TIMEOUT_US = 20000;
+    static constexpr int STREAM_BUFFERS = 50;
+    static constexpr int ALLOCATION_WARMUP_SECONDS = 2;    // 稳态分配统计跳过的启动时间
+
+    // 采集线程的累计计数（见 m_captureLoops 等）在 GUI 线程的快照
+    struct CaptureCounters {
+        uint64_t loops = 0;         // 采集循环次数
+        uint64_t received = 0;      // 出队的缓冲区数
+        uint64_t succeeded = 0;     // 状态为 SUCCESS 的帧数
+        uint64_t submitted = 0;     // 送入处理管线的帧数
+        uint64_t burstStored = 0;   // 写入连拍内存的帧数
+    };
+
     void captureLoop();
+    void pushStreamBuffers(int count, size_t payloadSize);
+    static void streamCallback(void *userData, ArvStreamCallbackType type, ArvBuffer *buffer);
+    void reportCaptureThreadConfig(const QString &thread, const QStringList &applied, const QStringList &failed);
+    void releaseMemoryLock();
     void cleanupResources();
+    static int bitDepthForPixelFormat(ArvPixelFormat format);
+    bool readFrameHeader(ArvBuffer *buffer, Frame &header, const uint8_t **data) const;
+    FramePtr createFrame(ArvBuffer *buffer) const;
+    void applySequence(Frame &frame);
+    void publishFrame(const FramePtr &frame);
+    bool startSnapshotStream();
+    void stopSnapshotStream();
+    QImage grabFromSnapshotStream(int timeoutMs);
+    void publishToFrameBus(const Frame &frame);
+    void publishToStream(const FramePtr &frame);
+    CaptureCounters captureCounters() const;
+    void logCaptureStatistics();
+    void sampleAllocations(QString &summary);
+    void reportSteadyStateAllocations();
+    void resubscribe(std::atomic<int> &subscription, DerivedFrameSpec &current, const DerivedFrameSpec &spec);
+    FramePtr derivedOrSource(const std::atomic<int> &subscription, const FramePtr &frame);
+    void probeDevices(const QString &preferredId);
+    ArvCamera *takeProbedCamera(const QString &cameraId, int64_t &stoppedNs);
+    void releaseProbedCamera();
+    void startParameterThread();
+    void stopParameterThread();
+    void parameterLoop();
     QString getLastGError() const;
 
     ArvCamera *m_camera;
     ArvStream *m_stream;
+    ArvStream *m_snapshotStream = nullptr;  // 快照模式的常驻流（软件触发）
+    bool m_snapshotModeRequested = false;
     std::atomic_bool m_running{false};
     std::thread m_captureThread;
     QTimer *m_fpsTimer;
+    FrameAnalyzer *m_frameAnalyzer;
+    AutoExposureController *m_autoExposure;
+    FlatFieldCorrector *m_flatField;
+    TemporalFilter *m_temporalFilter;
+    HdrFusion *m_hdrFusion;
+    BurstRecorder *m_burstRecorder;
+    ImageSaveService *m_imageSaver;
+    PreviewStreamServer *m_streamServer;
+    FrameDropMonitor *m_dropMonitor;
+
+    // 采集线程之后的处理管线：各阶段在独立线程上执行，经无锁队列串联，结果再送往显示和分析
+    FramePipeline m_pipeline;
+
+    // 采集帧对象池：开始采集时按借出上限预先建帧，稳态下 createFrame() 不分配内存，停止采集后释放空闲帧
+    mutable FramePool m_framePool;
+
+    // 稳态内存分配统计（ENABLE_ALLOCATION_TRACKING），在 GUI 线程每秒采样
+    std::vector<AllocationTracker::ThreadCounters> m_allocationBaseline;
+    std::vector<AllocationTracker::ThreadCounters> m_allocationPrevious;
+    uint64_t m_allocationBaselineFrames = 0;
+    uint64_t m_allocationPreviousFrames = 0;
+    int m_allocationSamples = 0;
+
+    // 块数据解码，配置在 GUI 线程，decode 在采集线程
+    ChunkDecoder m_chunkDecoder;
+    FrameChunkData m_lastChunk;     // GUI 线程
+
+    // 参数序列，配置在 GUI 线程（未采集时），tag 在采集线程
+    ParameterSequencer m_sequencer;
+    uint64_t m_lastFrameId = 0;     // GUI 线程
+
+    // 实时性选项只在 GUI 线程修改（未采集时），采集线程和接收线程启动时读取
+    CaptureThreadOptions m_captureOptions;
+    bool m_memoryLocked = false;
+    IntervalHistogram m_popIntervals;
+
+    // USB3 传输设置只在 GUI 线程修改（未采集时）；带宽限制缓存最近一次写入的值
+    UsbTransferOptions m_usbOptions;
+    bool m_isUsb3 = false;
+    uint64_t m_linkThroughputLimit = 0;
+
+    // 传输统计：START_BUFFER/BUFFER_DONE 回调在 Aravis 接收线程记录，GUI 线程每秒汇总
+    IntervalHistogram m_transferDurations;
+    // 每个接收中的缓冲区各记一个开始时间：GigE 或多传输的 USB3 上同时有多个缓冲区在接收
+    struct TransferStart {
+        ArvBuffer *buffer = nullptr;
+        int64_t startNs = 0;
+    };
+    std::array<TransferStart, STREAM_BUFFERS> m_transferStarts{};    // 接收线程（线程停止时 GUI 线程清空）
+    std::atomic<uint64_t> m_transferredBytes{0};
+    uint64_t m_transferredBytesSampled = 0;         // GUI 线程
+    int64_t m_transferSampleNs = 0;                 // GUI 线程
+
+    // 以下在采集线程停止期间由 GUI 线程写入，线程启动后只读（线程创建保证可见性）
+    size_t m_streamPayload = 0;         // 当前缓冲池的缓冲区大小
+    int64_t m_lastPopNs = 0;            // 采集线程退出前最后一次出队的时间
+    int64_t m_reconfigureFromNs = 0;    // 非 0 表示刚完成重配置，首帧到达时计算无帧间隔
+    double m_reconfigureApplyMs = 0.0;
+
+    // 共享内存帧总线，在管线线程上写入
+    FrameBusWriter m_frameBus;
+    std::mutex m_frameBusMutex;
+    std::atomic_bool m_frameBusEnabled{false};
+
+    // 派生输出；订阅号为 0 表示使用原始帧，规格只在 GUI 线程访问
+    DerivedFrameCache m_derivedFrames;
+    std::atomic<int> m_previewSubscription{0};
+    std::atomic<int> m_frameBusSubscription{0};
+    std::atomic<int> m_streamSubscription{0};
+    DerivedFrameSpec m_previewSpec;
+    DerivedFrameSpec m_frameBusSpec;
+    DerivedFrameSpec m_streamSpec;
+
+    // 显示转换：查找表，管线线程按显示帧率限频（超过的帧不转换）
+    static constexpr int64_t DISPLAY_INTERVAL_NS = 1000000000 / 120;
+    DisplayLut m_displayLut;
+    int64_t m_lastDisplayNs = 0;    // 管线线程
+
+    // 异步参数写入
+    std::thread m_parameterThread;
+    std::mutex m_parameterMutex;
+    std::condition_variable m_parameterCond;
+    bool m_parameterThreadRunning = false;
+    std::optional<double> m_pendingExposure;
+    std::optional<double> m_pendingGain;
+    std::optional<ParameterSequencer::WriteRequest> m_pendingSequenceWrite;
+
+    // 后台设备探测：线程由 GUI 线程启动和回收，预先打开的相机受 m_probeMutex 保护
+    static constexpr int CAMERA_SETTLE_MS = 100;    // 停止采集后到首次设置 ROI 的等待
+    std::thread m_probeThread;
+    std::mutex m_probeMutex;
+    ArvCamera *m_probedCamera = nullptr;
+    QString m_probedCameraId;
+    int64_t m_probedStoppedNs = 0;
+
+    // 连拍期间的帧率与流统计，结束时用于恢复和报告
+    std::optional<double> m_burstRestoreFrameRate;
+    guint64 m_burstStartFailures = 0;
+    guint64 m_burstStartUnderruns = 0;
 
     bool m_isConnected;
     bool m_isAcquiring;
@@ -97,14 +410,20 @@ private:
     QString m_cameraModel;
     QString m_cameraVendor;
     QString m_cameraSerial;
+    QString m_cameraId;
 
     int m_frameCount;          // Qt层发送的帧数
     double m_currentFPS;
     double m_maxFPS = 120.0;
 
-    // Aravis底层统计
-    int m_arvReceivedCount;    // arv_stream_try_pop_buffer 获取到的总帧数
-    int m_arvSuccessCount;     // 状态为SUCCESS的帧数
+    // Aravis底层统计：采集线程只做原子累加，由 updateFPS() 每秒输出
+    // （采集线程不能直接输出日志，QDebug 每次都会分配内存）
+    std::atomic<uint64_t> m_captureLoops{0};
+    std::atomic<uint64_t> m_arvReceivedCount{0};
+    std::atomic<uint64_t> m_arvSuccessCount{0};
+    std::atomic<uint64_t> m_submittedCount{0};
+    std::atomic<uint64_t> m_burstStoredCount{0};
+    CaptureCounters m_captureSampled;   // GUI 线程：上一秒的累计值
 };
 
 #endif // CAMERACONTROLLER_H
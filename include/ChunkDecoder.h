@@ -0,0 +1,73 @@
+#ifndef CHUNKDECODER_H
+#define CHUNKDECODER_H
+
+#include <QString>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "Frame.h"
+
+typedef struct _ArvCamera ArvCamera;
+typedef struct _ArvBuffer ArvBuffer;
+typedef struct _ArvChunkParser ArvChunkParser;
+
+/**
+ * @brief GenICam 块数据解码 - 在采集线程上把每帧的曝光/增益/帧号/线状态/时间戳填入 FrameChunkData
+ *
+ * configure() 在采集开始前调用：打开 ChunkModeActive，逐个启用所需的块，
+ * 再从相机的 GenICam XML 中解析每个块寄存器的 ChunkID、偏移、长度和字节序。
+ * 能直接定位的字段在 decode() 中只做一次 arv_buffer_get_chunk_data 查找和按字节读取，
+ * 不分配内存、不访问节点树；地址需要公式计算等复杂情况才回退到 ArvChunkParser。
+ */
+class ChunkDecoder
+{
+public:
+    ChunkDecoder() = default;
+    ~ChunkDecoder();
+
+    ChunkDecoder(const ChunkDecoder &) = delete;
+    ChunkDecoder &operator=(const ChunkDecoder &) = delete;
+
+    // 相机未采集时调用；失败时块模式保持关闭
+    bool configure(ArvCamera *camera, QString *error = nullptr);
+    void disable(ArvCamera *camera);
+    void reset();
+
+    bool isActive() const;
+
+    // 采集线程调用，chunk 先被清空
+    void decode(ArvBuffer *buffer, FrameChunkData &chunk) const;
+
+    // 各字段的解码方式，用于日志
+    QString describe() const;
+
+    // 录制索引 CSV 的块数据列（无效字段留空），以换行结尾
+    static const char *csvHeader();
+    static void writeCsvColumns(FILE *file, const FrameChunkData &chunk);
+
+private:
+    struct FieldLayout {
+        FrameChunkData::Field field;
+        const char *chunkName;      // ChunkSelector 的取值，如 "ExposureTime"
+        const char *featureName;    // 块特征名，如 "ChunkExposureTime"
+        bool isFloat = false;
+        bool direct = false;        // 已解析出寄存器位置，可直接读取
+        uint64_t chunkId = 0;
+        uint64_t address = 0;
+        uint32_t length = 0;
+        bool bigEndian = false;
+        bool isSigned = false;
+        int lsb = -1;               // MaskedIntReg 的位域，-1 表示整个寄存器
+        int msb = -1;
+    };
+
+    void resolveLayouts(const char *xml, size_t size);
+    static bool readField(const FieldLayout &layout, const uint8_t *chunkData, size_t chunkSize, double &value,
+                          uint64_t &integer);
+
+    std::vector<FieldLayout> m_fields;
+    ArvChunkParser *m_parser = nullptr;
+    bool m_active = false;
+};
+
+#endif // CHUNKDECODER_H
@@ -0,0 +1,58 @@
+#ifndef DERIVEDFRAMECACHE_H
+#define DERIVEDFRAMECACHE_H
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Frame.h"
+#include "FrameResampler.h"
+
+/**
+ * @brief 派生输出缓存 - 一帧全分辨率图像按订阅生成多个低成本输出
+ *
+ * 消费者（预览、共享内存帧总线等）先 subscribe() 自己需要的规格，之后对每帧调用 get()。
+ * 只有被订阅且被请求的规格才会计算；相同规格的订阅共用一个输出，
+ * 同一帧只计算一次，后到的订阅者直接拿到缓存结果（计算期间到达的会等待）。
+ * 每个输出只缓存最近一帧的结果。所有方法线程安全。
+ */
+class DerivedFrameCache
+{
+public:
+    struct Statistics {
+        uint64_t computed = 0;      // 实际计算次数
+        uint64_t shared = 0;        // 命中缓存次数
+        int outputs = 0;            // 当前不同规格的输出数
+        int subscriptions = 0;
+    };
+
+    // 返回订阅号（> 0）
+    int subscribe(const DerivedFrameSpec &spec);
+    void unsubscribe(int subscription);
+
+    // 返回 source 按该订阅规格的派生帧；直通规格返回 source 本身，
+    // 订阅号无效或规格与帧不相交时返回 nullptr
+    FramePtr get(int subscription, const FramePtr &source);
+
+    Statistics statistics() const;
+
+private:
+    struct Output {
+        DerivedFrameSpec spec;
+        int references = 0;             // 受 m_mutex 保护
+        std::mutex mutex;               // 保护以下字段，计算期间持有
+        std::weak_ptr<const Frame> source;
+        FramePtr result;
+    };
+
+    mutable std::mutex m_mutex;
+    std::map<int, std::shared_ptr<Output>> m_subscriptions;
+    std::vector<std::shared_ptr<Output>> m_outputs;
+    int m_nextSubscription = 1;
+
+    std::atomic<uint64_t> m_computed{0};
+    std::atomic<uint64_t> m_shared{0};
+};
+
+#endif // DERIVEDFRAMECACHE_H
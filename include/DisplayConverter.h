@@ -0,0 +1,21 @@
+#ifndef DISPLAYCONVERTER_H
+#define DISPLAYCONVERTER_H
+
+#include "Frame.h"
+
+/**
+ * @brief 显示转换内核 - 把任意位深的帧转换为 8 位灰度
+ *
+ * 高位深数据右移 (bitDepth - 8) 位，AVX2/SSE2 每次处理 16/8 个像素；
+ * 大帧按行带交给 TileExecutor 并行。
+ */
+class DisplayConverter
+{
+public:
+    // out 至少 height 行、每行 outStride 字节
+    static void toGray8(const Frame &frame, uint8_t *out, int outStride);
+
+    static void shiftRow16(const uint16_t *in, uint8_t *out, size_t count, int shift);
+};
+
+#endif // DISPLAYCONVERTER_H
@@ -0,0 +1,77 @@
+#ifndef DISPLAYLUT_H
+#define DISPLAYLUT_H
+
+#include <QColor>
+#include <QVector>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Frame.h"
+
+/**
+ * @brief 显示窗口设置 - 窗宽窗位、伽马和伪彩色
+ *
+ * 窗口上下限用满量程的比例表示，与位深无关：同一设置对 10/12/16 位数据显示效果一致。
+ */
+struct DisplayWindow
+{
+    enum class Palette {
+        Gray,
+        Hot,        // 黑-红-黄-白
+        Rainbow     // 蓝-青-绿-黄-红
+    };
+
+    double low = 0.0;
+    double high = 1.0;
+    double gamma = 1.0;             // 输出 = t^(1/gamma)，大于 1 提亮暗部
+    Palette palette = Palette::Gray;
+
+    // 满量程线性映射：可以直接移位转换，不需要查表
+    bool isLinearFullRange() const { return low <= 0.0 && high >= 1.0 && gamma == 1.0; }
+
+    bool operator==(const DisplayWindow &other) const
+    {
+        return low == other.low && high == other.high && gamma == other.gamma && palette == other.palette;
+    }
+    bool operator!=(const DisplayWindow &other) const { return !(*this == other); }
+};
+
+/**
+ * @brief 显示查找表 - 把 8~16 位数据按显示窗口映射为 8 位
+ *
+ * 每个位深一张表（8 位 256 项，其余 65536 项覆盖整个 16 位取值，超出位深的值饱和），
+ * 设置改变后清空，下次转换该位深的帧时才重建；转换逐像素查表，按行带并行。
+ * 伪彩色不改变查表结果，只是输出 Indexed8 图像并附带调色板，由绘制时展开。
+ * 只用于预览尺寸的显示图像，保存和分析仍使用原始数据。
+ */
+class DisplayLut
+{
+public:
+    // 任意线程调用；上下限会被限制在 [0, 1] 且 high > low
+    void setWindow(const DisplayWindow &window);
+    DisplayWindow window() const;
+
+    // out 至少 height 行、每行 outStride 字节，写入查表后的 8 位索引
+    void convert(const Frame &frame, uint8_t *out, int outStride);
+
+    // 当前伪彩色的调色板，灰度时为空
+    QVector<QRgb> colorTable() const;
+
+    static void applyRow8(const uint8_t *in, uint8_t *out, size_t count, const uint8_t *table);
+    static void applyRow16(const uint16_t *in, uint8_t *out, size_t count, const uint8_t *table);
+    static QVector<QRgb> paletteColors(DisplayWindow::Palette palette);
+
+private:
+    using Table = std::vector<uint8_t>;
+
+    std::shared_ptr<const Table> tableFor(int bitDepth);
+    static std::shared_ptr<const Table> buildTable(const DisplayWindow &window, int bitDepth);
+
+    mutable std::mutex m_mutex;
+    DisplayWindow m_window;                                 // 受 m_mutex 保护
+    std::array<std::shared_ptr<const Table>, 17> m_tables;  // 按位深缓存，受 m_mutex 保护
+    QVector<QRgb> m_colorTable;                             // 受 m_mutex 保护
+};
+
+#endif // DISPLAYLUT_H
@@ -0,0 +1,102 @@
+#ifndef FLATFIELDCORRECTOR_H
+#define FLATFIELDCORRECTOR_H
+
+#include <QObject>
+#include <QString>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "FrameStage.h"
+
+/**
+ * @brief 暗场/平场校正阶段
+ *
+ * 输出 = (输入 - 暗场) × 增益，增益为 Q4.12 定点数（4096 表示 1.0）：
+ * - 暗场：N 帧遮光图像的逐像素均值
+ * - 平场：N 帧均匀照明图像减去暗场后，以全局均值除以逐像素值得到增益
+ * 校正映射按 ROI（偏移、尺寸、位深）缓存；当前 ROI 没有标定但被某个已标定区域
+ * 覆盖时（如全幅标定后缩小 ROI），从该区域裁剪出映射并缓存。
+ * 8 位和 10/12 位数据使用 SSE2/AVX2 定点运算，更高位深走标量路径。
+ */
+class FlatFieldCorrector : public QObject, public FrameStage
+{
+    Q_OBJECT
+
+public:
+    enum class CalibrationKind {
+        Dark,
+        Flat
+    };
+
+    static constexpr int GAIN_SHIFT = 12;
+    static constexpr uint16_t GAIN_ONE = 1 << GAIN_SHIFT;
+
+    explicit FlatFieldCorrector(QObject *parent = nullptr);
+
+    // 以下接口可在任意线程调用
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+    void startCalibration(CalibrationKind kind, int frameCount);
+    void clearCalibration();
+
+    // FrameStage 接口，在管线线程上调用
+    const char *stageName() const override;
+    FramePtr process(FramePtr frame) override;
+
+    // 校正内核
+    static void correct8(uint8_t *pixels, const uint16_t *dark, const uint16_t *gain, size_t count);
+    static void correct16(uint16_t *pixels, const uint16_t *dark, const uint16_t *gain, size_t count, int bitDepth);
+
+Q_SIGNALS:
+    void calibrationProgress(int captured, int total);
+    void calibrationFinished(const QString &summary);
+
+private:
+    struct CalibrationKey {
+        int x = 0;
+        int y = 0;
+        int width = 0;
+        int height = 0;
+        int bitDepth = 0;
+
+        auto operator<=>(const CalibrationKey &) const = default;
+    };
+
+    struct CalibrationMaps {
+        CalibrationKey key;
+        std::vector<uint16_t> dark;
+        std::vector<uint16_t> gain;
+        bool derived = false;    // 从更大的标定区域裁剪而来
+    };
+
+    using MapsPtr = std::shared_ptr<const CalibrationMaps>;
+
+    static CalibrationKey keyOf(const Frame &frame);
+    MapsPtr findMaps(const CalibrationKey &key);
+    void accumulate(const Frame &frame);
+    void finishCalibration();
+
+    std::atomic_bool m_enabled{false};
+
+    // 跨线程请求与缓存，受 m_mutex 保护
+    std::mutex m_mutex;
+    bool m_calibrationRequested = false;
+    CalibrationKind m_requestedKind = CalibrationKind::Dark;
+    int m_requestedFrames = 0;
+    std::map<CalibrationKey, MapsPtr> m_cache;
+    uint64_t m_cacheGeneration = 0;
+
+    // 以下仅在管线线程访问
+    bool m_calibrating = false;
+    CalibrationKind m_activeKind = CalibrationKind::Dark;
+    CalibrationKey m_activeKey;
+    int m_targetFrames = 0;
+    int m_capturedFrames = 0;
+    std::vector<uint32_t> m_accumulator;
+    MapsPtr m_currentMaps;
+    uint64_t m_currentGeneration = 0;
+};
+
+#endif // FLATFIELDCORRECTOR_H
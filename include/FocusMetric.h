@@ -0,0 +1,41 @@
+#ifndef FOCUSMETRIC_H
+#define FOCUSMETRIC_H
+
+#include "Frame.h"
+
+/**
+ * @brief 对焦评价内核
+ *
+ * - Laplacian: 4 邻域拉普拉斯响应的方差
+ * - Tenengrad: Sobel 梯度模平方的均值
+ * 数值越大表示越清晰，只用于同一场景下的相对比较。
+ * 8 位数据使用 AVX2（16 像素一组，int16 运算、int32 累加），其余位深走标量路径。
+ * 各行带由 TileExecutor 并行计算，整数部分和相加，结果与串行计算完全一致。
+ */
+class FocusMetric
+{
+public:
+    enum class Method {
+        Laplacian,
+        Tenengrad
+    };
+
+    static double compute(const Frame &frame, Method method, const ImageRegion &region = ImageRegion());
+
+private:
+    // 一个行带内的部分和；Tenengrad 只用 squares
+    struct Sums {
+        int64_t sum = 0;
+        uint64_t squares = 0;
+    };
+
+    static Sums laplacian8(const Frame &frame, int x0, int y0, int x1, int y1);
+    static Sums tenengrad8(const Frame &frame, int x0, int y0, int x1, int y1);
+
+    template <typename T>
+    static Sums laplacianScalar(const T *bits, int stride, int x0, int y0, int x1, int y1);
+    template <typename T>
+    static Sums tenengradScalar(const T *bits, int stride, int x0, int y0, int x1, int y1);
+};
+
+#endif // FOCUSMETRIC_H
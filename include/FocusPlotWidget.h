@@ -0,0 +1,35 @@
+#ifndef FOCUSPLOTWIDGET_H
+#define FOCUSPLOTWIDGET_H
+
+#include <QWidget>
+#include <vector>
+
+/**
+ * @brief 对焦分数滚动曲线
+ *
+ * 固定容量的环形缓冲保存最近的对焦分数，纵轴按窗口内最大/最小值自动缩放，
+ * 同时显示当前值和历史峰值，便于调焦时找到峰值位置。
+ */
+class FocusPlotWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit FocusPlotWidget(QWidget *parent = nullptr);
+
+    void addValue(double score, double computeTimeUs);
+    void clear();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    static constexpr int HISTORY_SIZE = 600;   // 120fps 下约 5 秒
+
+    std::vector<double> m_values;
+    int m_head = 0;       // 下一个写入位置
+    int m_count = 0;
+    double m_peak = 0.0;
+    double m_lastComputeTimeUs = 0.0;
+};
+
+#endif // FOCUSPLOTWIDGET_H
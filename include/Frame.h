@@ -0,0 +1,117 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief 相机随帧发送的块数据（GenICam ChunkModeActive），在采集线程上解析
+ *
+ * valid 按 Field 位标记哪些字段来自本帧的块数据；未启用块数据或相机不支持的字段为 0。
+ */
+struct FrameChunkData
+{
+    enum Field : uint32_t {
+        ExposureTime = 1u << 0,
+        Gain = 1u << 1,
+        FrameId = 1u << 2,
+        LineStatus = 1u << 3,
+        Timestamp = 1u << 4
+    };
+
+    uint32_t valid = 0;
+    double exposureUs = 0.0;
+    double gainDb = 0.0;
+    uint64_t frameId = 0;
+    uint32_t lineStatus = 0;        // LineStatusAll，每位对应一条 I/O 线
+    uint64_t deviceTimestamp = 0;   // 相机时钟计数（GigE 按 GevTimestampTickFrequency，U3V 为 ns）
+
+    bool has(Field field) const { return (valid & field) != 0; }
+};
+
+/**
+ * @brief 参数序列（包围曝光）标记，由 ParameterSequencer 在采集线程上填写
+ *
+ * 同一 cycle 中 step 为 0..stepCount-1 的帧组成一组包围曝光。
+ * 序列运行期间 stepCount > 0；step 为 -1 表示这一帧的参数组无法确定。
+ * exposureUs/gainDb 为该帧实际使用的参数（有块数据时取块数据）。
+ */
+struct FrameSequenceTag
+{
+    int step = -1;
+    int stepCount = 0;             // 0 表示未运行序列
+    uint64_t cycle = 0;
+    double exposureUs = 0.0;
+    double gainDb = 0.0;
+
+    bool isValid() const { return step >= 0; }
+};
+
+/**
+ * @brief 采集帧 - 采集线程与处理/显示模块之间传递的原始图像
+ *
+ * 像素按行紧密排列：
+ * - 8 位数据每像素 1 字节
+ * - 10/12/16 位数据统一为每像素 2 字节（小端，低位对齐）
+ */
+struct Frame
+{
+    int width = 0;
+    int height = 0;
+    int offsetX = 0;               // ROI 在传感器上的偏移
+    int offsetY = 0;
+    int bitDepth = 8;              // 有效位数: 8/10/12/16
+    uint32_t pixelFormat = 0;      // ArvPixelFormat 原值
+    uint64_t frameId = 0;
+    uint64_t timestampNs = 0;      // 设备时间戳
+    uint64_t systemTimestampNs = 0; // 主机接收时间戳
+    FrameChunkData chunk;
+    FrameSequenceTag sequence;
+    std::vector<uint8_t> data;
+
+    int bytesPerPixel() const { return bitDepth > 8 ? 2 : 1; }
+    int stride() const { return width * bytesPerPixel(); }
+    int maxValue() const { return (1 << bitDepth) - 1; }
+
+    const uint8_t *bits() const { return data.data(); }
+    uint8_t *bits() { return data.data(); }
+    const uint16_t *bits16() const { return reinterpret_cast<const uint16_t*>(data.data()); }
+    uint16_t *bits16() { return reinterpret_cast<uint16_t*>(data.data()); }
+};
+
+using FramePtr = std::shared_ptr<Frame>;
+
+// 创建几何与元数据相同的新帧，数据区已按尺寸分配
+inline FramePtr makeFrameLike(const Frame &source)
+{
+    auto frame = std::make_shared<Frame>();
+    frame->width = source.width;
+    frame->height = source.height;
+    frame->offsetX = source.offsetX;
+    frame->offsetY = source.offsetY;
+    frame->bitDepth = source.bitDepth;
+    frame->pixelFormat = source.pixelFormat;
+    frame->frameId = source.frameId;
+    frame->timestampNs = source.timestampNs;
+    frame->systemTimestampNs = source.systemTimestampNs;
+    frame->chunk = source.chunk;
+    frame->sequence = source.sequence;
+    frame->data.resize(source.data.size());
+    return frame;
+}
+
+/**
+ * @brief 图像内的矩形区域（像素坐标），宽或高 <= 0 表示整帧
+ */
+struct ImageRegion
+{
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+
+    bool isEmpty() const { return width <= 0 || height <= 0; }
+};
+
+#endif // FRAME_H
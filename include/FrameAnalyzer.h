@@ -0,0 +1,87 @@
+#ifndef FRAMEANALYZER_H
+#define FRAMEANALYZER_H
+
+#include <QObject>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "Frame.h"
+#include "HistogramEngine.h"
+#include "FocusMetric.h"
+
+class AutoExposureController;
+
+/**
+ * @brief 帧分析器 - 在独立工作线程上计算图像统计
+ *
+ * 采集线程通过 submitFrame() 投递帧：
+ * - 按配置的统计频率节流，未到时间的帧直接忽略
+ * - 只保留最新一帧，工作线程忙时旧帧被替换，从不阻塞采集线程
+ * 计算结果通过 statisticsReady 信号在对象所在线程（GUI线程）发出。
+ *
+ * 启用自动曝光时每帧都做统计并直接在工作线程上驱动控制器，
+ * statisticsReady 仍按统计频率发出。
+ * 启用对焦评价时每帧计算一次对焦分数（focusMeasured）。
+ */
+class FrameAnalyzer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FrameAnalyzer(QObject *parent = nullptr);
+    ~FrameAnalyzer();
+
+    void start();
+    void stop();
+    bool isRunning() const;
+
+    // 采集线程调用
+    void submitFrame(const FramePtr &frame);
+
+    // 直方图统计配置（可在任意线程调用）
+    void setHistogramEnabled(bool enabled);
+    bool isHistogramEnabled() const;
+    void setHistogramRate(double hz);     // <= 0 表示每帧统计
+    double histogramRate() const;
+    void setSampleStep(int step);         // <= 0 表示自动
+    int sampleStep() const;
+
+    // 对焦评价配置（可在任意线程调用），区域为空表示整帧
+    void setFocusEnabled(bool enabled);
+    bool isFocusEnabled() const;
+    void setFocusMethod(FocusMetric::Method method);
+    void setFocusRegion(const ImageRegion &region);
+
+    // 自动曝光控制器（在工作线程上调用），须在 start() 之前设置
+    void setAutoExposureController(AutoExposureController *controller);
+
+Q_SIGNALS:
+    void statisticsReady(const FrameStatistics &stats);
+    void focusMeasured(double score, double computeTimeUs);
+
+private:
+    void workerLoop();
+
+    std::thread m_workerThread;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    FramePtr m_pendingFrame;
+    bool m_running;
+
+    std::atomic_bool m_histogramEnabled{true};
+    std::atomic<int64_t> m_histogramIntervalNs;
+    std::atomic<int64_t> m_lastSubmitNs{0};
+    int64_t m_lastEmitNs = 0;
+    std::atomic_int m_sampleStep{0};
+
+    std::atomic_bool m_focusEnabled{false};
+    std::atomic<FocusMetric::Method> m_focusMethod{FocusMetric::Method::Laplacian};
+    ImageRegion m_focusRegion;   // 受 m_mutex 保护
+
+    AutoExposureController *m_autoExposure = nullptr;
+    HistogramEngine m_histogramEngine;
+    FrameStatistics m_statistics;
+};
+
+#endif // FRAMEANALYZER_H
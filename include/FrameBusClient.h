@@ -0,0 +1,84 @@
+#ifndef FRAMEBUSCLIENT_H
+#define FRAMEBUSCLIENT_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "FrameBusProtocol.h"
+
+/**
+ * @brief 共享内存帧总线客户端 - 供外部检测进程读取帧（不依赖 Qt）
+ *
+ * 用法：
+ *   FrameBusClient client;
+ *   client.open();
+ *   while (client.waitForFrame(1000)) {
+ *       client.readNext([](const FrameBusClient::FrameView &view) { ... });
+ *   }
+ *
+ * 读取是零拷贝的：回调中的 data 直接指向共享内存。回调返回后再次校验序列锁，
+ * 若写端在此期间覆盖了该槽位则返回 Overrun，回调中得到的结果应丢弃。
+ * 需要长期持有数据时使用 copyLatest()。读者之间互不影响，也不会阻塞写端。
+ */
+class FrameBusClient
+{
+public:
+    struct FrameView {
+        const uint8_t *data = nullptr;
+        size_t size = 0;
+        int width = 0;
+        int height = 0;
+        int bitDepth = 0;
+        uint32_t pixelFormat = 0;
+        uint64_t frameId = 0;
+        uint64_t timestampNs = 0;
+        uint64_t sequence = 0;          // 总线上的发布序号
+    };
+
+    enum class ReadResult {
+        Ok,
+        NoFrame,        // 没有新帧
+        Overrun,        // 读取期间槽位被覆盖
+        Closed          // 写端已关闭或重建，需要重新 open()
+    };
+
+    using ViewFunction = std::function<void(const FrameView &view)>;
+
+    FrameBusClient() = default;
+    ~FrameBusClient();
+
+    FrameBusClient(const FrameBusClient &) = delete;
+    FrameBusClient &operator=(const FrameBusClient &) = delete;
+
+    bool open(const std::string &name = FrameBus::DEFAULT_NAME);
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+    const std::string &errorString() const { return m_error; }
+
+    // 等待比上次读取更新的帧；timeoutMs < 0 表示无限等待。超时或总线关闭时返回 false
+    bool waitForFrame(int timeoutMs);
+
+    // 顺序读取下一帧；落后超过环形缓冲长度时跳到最旧的可用帧，跳过的帧计入 missedFrames()
+    ReadResult readNext(const ViewFunction &fn);
+
+    // 读取最新一帧（跳过中间所有帧）
+    ReadResult readLatest(const ViewFunction &fn);
+
+    // 把最新一帧拷贝到 data，meta.data 指向 data 的内容
+    ReadResult copyLatest(std::vector<uint8_t> &data, FrameView &meta);
+
+    uint64_t missedFrames() const { return m_missed; }
+    uint64_t publishedFrames() const;
+
+private:
+    ReadResult readSequence(uint64_t sequence, const ViewFunction &fn);
+
+    std::string m_error;
+    FrameBus::BusHeader *m_header = nullptr;
+    size_t m_mappedSize = 0;
+    uint64_t m_next = 0;
+    uint64_t m_missed = 0;
+};
+
+#endif // FRAMEBUSCLIENT_H
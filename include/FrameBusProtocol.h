@@ -0,0 +1,93 @@
+#ifndef FRAMEBUSPROTOCOL_H
+#define FRAMEBUSPROTOCOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 共享内存帧总线的内存布局（写端与客户端共用，不依赖 Qt）
+ *
+ * 共享内存段 = BusHeader + slotCount 个槽位，每个槽位 = SlotHeader + 像素数据。
+ * 帧序号 seq 写入槽位 seq % slotCount。槽位用序列锁保护：
+ *   写入前 lock = 2*seq + 1（奇数表示写入中），写完 lock = 2*seq + 2；
+ *   读者读取前后各检查一次 lock，两次相同且等于 2*seq + 2 时数据有效。
+ * 写完一帧后 published 加一，notifyWord 加一，有等待者时用 futex 唤醒。
+ * 写端重建共享内存段（例如帧尺寸变大）时先把旧段的 closed 置 1，客户端应重新 open()。
+ */
+namespace FrameBus {
+
+constexpr uint32_t MAGIC = 0x42465241;     // "ARFB"
+constexpr uint32_t VERSION = 1;
+constexpr const char *DEFAULT_NAME = "/aravis-demo-frames";
+constexpr size_t ALIGNMENT = 64;
+
+struct alignas(ALIGNMENT) BusHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t reserved;
+    uint64_t slotStride;                // 相邻槽位的字节距离
+    uint64_t payloadCapacity;           // 每个槽位可容纳的最大像素数据字节数
+    uint64_t writerPid;
+
+    std::atomic<uint64_t> published;    // 已发布帧数，即下一帧的序号
+    std::atomic<uint32_t> notifyWord;   // futex 等待字
+    std::atomic<uint32_t> waiters;      // 正在等待的读者数
+    std::atomic<uint32_t> closed;       // 写端已关闭或重建
+};
+
+struct alignas(ALIGNMENT) SlotHeader {
+    std::atomic<uint64_t> lock;         // 序列锁
+    uint64_t sequence;
+    int32_t width;
+    int32_t height;
+    int32_t bitDepth;
+    uint32_t pixelFormat;
+    uint64_t frameId;
+    uint64_t timestampNs;
+    uint64_t dataSize;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "跨进程原子操作要求 64 位原子无锁");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "跨进程原子操作要求 32 位原子无锁");
+
+inline constexpr size_t alignUp(size_t value)
+{
+    return (value + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+inline constexpr size_t slotStrideFor(size_t payloadCapacity)
+{
+    return alignUp(sizeof(SlotHeader) + payloadCapacity);
+}
+
+inline constexpr size_t segmentSize(uint32_t slotCount, size_t payloadCapacity)
+{
+    return alignUp(sizeof(BusHeader)) + slotCount * slotStrideFor(payloadCapacity);
+}
+
+inline SlotHeader *slotAt(BusHeader *header, uint64_t sequence)
+{
+    auto *base = reinterpret_cast<uint8_t*>(header) + alignUp(sizeof(BusHeader));
+    return reinterpret_cast<SlotHeader*>(base + (sequence % header->slotCount) * header->slotStride);
+}
+
+inline uint8_t *slotData(SlotHeader *slot)
+{
+    return reinterpret_cast<uint8_t*>(slot) + sizeof(SlotHeader);
+}
+
+inline constexpr uint64_t lockWriting(uint64_t sequence)
+{
+    return 2 * sequence + 1;
+}
+
+inline constexpr uint64_t lockComplete(uint64_t sequence)
+{
+    return 2 * sequence + 2;
+}
+
+} // namespace FrameBus
+
+#endif // FRAMEBUSPROTOCOL_H
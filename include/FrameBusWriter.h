@@ -0,0 +1,44 @@
+#ifndef FRAMEBUSWRITER_H
+#define FRAMEBUSWRITER_H
+
+#include <string>
+#include "Frame.h"
+#include "FrameBusProtocol.h"
+
+/**
+ * @brief 共享内存帧总线写端 - 把帧发布到 POSIX 共享内存环形缓冲
+ *
+ * 单写者：publish() 只能由一个线程调用。写端从不等待读者，读得慢的读者会丢帧。
+ * 目前仅支持 Linux（shm_open + futex），其他平台 create() 返回 false。
+ */
+class FrameBusWriter
+{
+public:
+    FrameBusWriter() = default;
+    ~FrameBusWriter();
+
+    FrameBusWriter(const FrameBusWriter &) = delete;
+    FrameBusWriter &operator=(const FrameBusWriter &) = delete;
+
+    // 创建（或重建）共享内存段；写端进程已退出的同名旧段会被标记为关闭并解除链接，
+    // 仍被存活进程占用时失败
+    bool create(const std::string &name, uint32_t slotCount, size_t payloadCapacity);
+    void close();
+
+    bool isOpen() const { return m_header != nullptr; }
+    size_t payloadCapacity() const;
+    const std::string &errorString() const { return m_error; }
+
+    // 帧数据超过槽位容量时返回 false
+    bool publish(const Frame &frame);
+
+private:
+    bool reclaimStale(const std::string &name);
+
+    std::string m_name;
+    std::string m_error;
+    FrameBus::BusHeader *m_header = nullptr;
+    size_t m_mappedSize = 0;
+};
+
+#endif // FRAMEBUSWRITER_H
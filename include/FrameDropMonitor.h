@@ -0,0 +1,108 @@
+#ifndef FRAMEDROPMONITOR_H
+#define FRAMEDROPMONITOR_H
+
+#include <QObject>
+#include <QString>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+typedef struct _ArvBuffer ArvBuffer;
+
+/**
+ * @brief 丢帧监测 - 按缓冲区帧号间隔和状态精确统计丢失的帧
+ *
+ * 采集线程对每个取出的缓冲区调用 record()：
+ * - 帧号不连续：相机发出但主机从未收到的帧（无空闲缓冲区、整帧丢包等）
+ * - 状态非 SUCCESS：收到但不完整的帧，按超时/缺包/包号错误/大小不符/中止分类
+ * GigE 的 16 位帧号回绕（65535 之后为 1）按连续处理，帧号倒退视为相机重新计数。
+ *
+ * 正常帧只做几次原子计数；异常写入带时间戳的事件环形日志，
+ * 窗口内丢失帧数达到阈值时发出 dropAlarm（每个窗口最多一次）。
+ */
+class FrameDropMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class EventType {
+        FrameGap,           // 帧号间隔，count 为缺失的帧数
+        Timeout,
+        MissingPackets,
+        WrongPacketId,
+        SizeMismatch,
+        Aborted,
+        OtherFailure,
+        IdReset             // 帧号倒退，不计入丢帧
+    };
+    static constexpr int EVENT_TYPE_COUNT = 8;
+    static constexpr size_t EVENT_LOG_CAPACITY = 4096;
+
+    struct Event {
+        qint64 wallTimeMs = 0;          // 系统时间（ms since epoch）
+        EventType type = EventType::FrameGap;
+        uint64_t frameId = 0;           // 间隔事件为间隔后的第一帧
+        uint64_t count = 1;
+    };
+
+    struct Counters {
+        uint64_t received = 0;
+        uint64_t succeeded = 0;
+        std::array<uint64_t, EVENT_TYPE_COUNT> events{};
+
+        uint64_t count(EventType type) const { return events[static_cast<int>(type)]; }
+        // 帧号间隔 + 所有不完整的缓冲区
+        uint64_t lostFrames() const;
+    };
+
+    struct AlarmSettings {
+        uint64_t threshold = 1;         // 窗口内丢失帧数达到该值即报警，0 表示关闭
+        int windowMs = 1000;
+    };
+
+    explicit FrameDropMonitor(QObject *parent = nullptr);
+
+    // 采集开始前调用：清空计数、事件日志和帧号基准
+    void reset();
+
+    // 采集线程调用，返回缓冲区是否为 SUCCESS
+    bool record(ArvBuffer *buffer);
+
+    Counters counters() const;
+    std::vector<Event> events() const;          // 按时间顺序，最多 EVENT_LOG_CAPACITY 条
+    bool exportEvents(const QString &path, QString *error = nullptr) const;
+
+    void setAlarmSettings(const AlarmSettings &settings);
+    AlarmSettings alarmSettings() const;
+
+    static const char *eventName(EventType type);
+
+Q_SIGNALS:
+    void dropAlarm(qulonglong lostFrames, int windowMs);
+
+private:
+    void trackFrameId(uint64_t frameId);
+    void addEvent(EventType type, uint64_t frameId, uint64_t count);
+
+    std::atomic<uint64_t> m_received{0};
+    std::atomic<uint64_t> m_succeeded{0};
+    std::array<std::atomic<uint64_t>, EVENT_TYPE_COUNT> m_eventCounts{};
+
+    // 以下仅在采集线程访问（reset() 在采集线程启动前调用）
+    bool m_hasLastId = false;
+    uint64_t m_lastId = 0;
+    int64_t m_windowStartMs = 0;
+    uint64_t m_windowLost = 0;
+    bool m_windowAlarmed = false;
+
+    std::atomic<uint64_t> m_alarmThreshold{1};
+    std::atomic<int> m_alarmWindowMs{1000};
+
+    mutable std::mutex m_logMutex;
+    std::vector<Event> m_log;           // 环形缓冲，m_logNext 为下一个写入位置
+    size_t m_logNext = 0;
+};
+
+#endif // FRAMEDROPMONITOR_H
@@ -0,0 +1,114 @@
+#ifndef FRAMEPIPELINE_H
+#define FRAMEPIPELINE_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Frame.h"
+#include "SpscQueue.h"
+
+class FrameStage;
+
+/**
+ * @brief 多级帧处理管线 - 把图像处理从采集线程移到专用线程
+ *
+ * 采集线程调用 submit() 投递帧后立即返回（Block 策略除外）。
+ * 各处理阶段通过有界无锁队列串联：默认每个阶段独占一个线程，
+ * 也可以让阶段与前一阶段共用线程，减少轻量阶段的线程切换。
+ * 最后一个阶段的结果交给输出回调（显示、分析等），回调在最后一个线程上执行。
+ */
+class FramePipeline
+{
+public:
+    using Sink = std::function<void(const FramePtr &frame)>;
+
+    // 队列满时的处理方式
+    enum class OverflowPolicy {
+        DropOldest,     // 丢弃队列中最旧的帧（默认，保证显示最新）
+        DropNewest,     // 丢弃新到的帧
+        Block           // 阻塞上游直到有空位
+    };
+
+    struct StageOptions {
+        size_t queueCapacity = 4;
+        OverflowPolicy overflow = OverflowPolicy::DropOldest;
+        bool ownThread = true;      // false: 与前一阶段在同一线程上顺序执行
+    };
+
+    // 单个阶段的运行统计；队列相关字段属于该阶段所在线程的输入队列
+    struct StageStatistics {
+        std::string name;
+        size_t queueDepth = 0;
+        size_t peakQueueDepth = 0;      // 本采样周期内的最大深度
+        size_t queueCapacity = 0;
+        double occupancy = 0.0;         // 本采样周期内处理耗时占比 (0~1)
+        double averageProcessUs = 0.0;
+        uint64_t processed = 0;
+        uint64_t droppedByQueue = 0;    // 因队列溢出丢弃的帧（累计）
+        uint64_t droppedByStage = 0;    // 阶段主动丢弃的帧（累计）
+    };
+
+    FramePipeline();
+    ~FramePipeline();
+
+    // 须在 start() 之前调用，阶段对象的生命周期由调用方管理
+    void addStage(FrameStage *stage);
+    void addStage(FrameStage *stage, const StageOptions &options);
+    void setSink(Sink sink);
+
+    // 采集线程所面对的输入队列的溢出策略，运行中可修改
+    void setInputOverflowPolicy(OverflowPolicy policy);
+    OverflowPolicy inputOverflowPolicy() const;
+
+    void start();
+    void stop();
+    bool isRunning() const;
+
+    // 采集线程调用
+    void submit(FramePtr frame);
+
+    // 输入队列累计丢弃的帧数
+    uint64_t droppedFrames() const;
+
+    // 计算自上次调用以来的占用率和峰值深度，应由同一线程定期调用（如每秒一次）
+    std::vector<StageStatistics> sampleStatistics();
+
+private:
+    struct StageEntry {
+        FrameStage *stage = nullptr;
+        std::atomic<uint64_t> processed{0};
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<uint64_t> busyNs{0};
+        uint64_t sampledBusyNs = 0;     // 以下仅在 sampleStatistics() 中访问
+        uint64_t sampledProcessed = 0;
+    };
+
+    struct Worker {
+        std::vector<StageEntry*> stages;
+        std::unique_ptr<SpscQueue<FramePtr>> queue;
+        std::atomic<OverflowPolicy> overflow{OverflowPolicy::DropOldest};
+        std::atomic<uint32_t> itemsEvent{0};    // 入队计数，消费者在此等待
+        std::atomic<uint32_t> spaceEvent{0};    // 出队计数，Block 策略的生产者在此等待
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<size_t> peakDepth{0};
+        Worker *next = nullptr;
+        std::thread thread;
+    };
+
+    void enqueue(Worker &worker, FramePtr frame);
+    void workerLoop(Worker *worker);
+
+    std::vector<std::unique_ptr<StageEntry>> m_stages;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    Sink m_sink;
+
+    std::mutex m_controlMutex;          // 保护 start/stop/sampleStatistics
+    std::atomic_bool m_running{false};
+    int64_t m_lastSampleNs = 0;
+};
+
+#endif // FRAMEPIPELINE_H
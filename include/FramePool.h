@@ -0,0 +1,47 @@
+#ifndef FRAMEPOOL_H
+#define FRAMEPOOL_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Frame.h"
+
+/**
+ * @brief 帧对象池 - 采集线程稳态下创建帧不再分配堆内存
+ *
+ * acquire() 返回的 FramePtr 与普通帧完全相同（use_count 只反映使用者），
+ * 最后一个引用释放时帧连同像素缓冲区（保留容量）回到池中，
+ * shared_ptr 的控制块也从池内的空闲块分配。池中空闲帧超过 maxFree 时直接释放。
+ * 任意线程可以 acquire()，帧可以在任意线程释放。
+ */
+class FramePool
+{
+public:
+    explicit FramePool(size_t maxFree = 32);
+    ~FramePool();
+
+    FramePool(const FramePool &) = delete;
+    FramePool &operator=(const FramePool &) = delete;
+
+    // 返回元数据已清零的帧；data 为空但保留上次使用的容量
+    FramePtr acquire();
+
+    // 预先创建空闲帧（不超过 maxFree）并为像素保留 bytesPerFrame 容量，
+    // 池的规模从一开始就达到借出帧数的上限，之后不会因借出峰值而新建
+    void reserve(size_t frames, size_t bytesPerFrame);
+
+    // 释放所有空闲帧（停止采集后归还内存），正在使用的帧释放时仍会回到池中
+    void trim();
+
+    size_t freeFrames() const;
+    size_t createdFrames() const;   // 累计新建的帧对象数，稳态下不再增长
+
+    // 池状态，由池和借出帧的删除器/控制块分配器共同持有
+    struct State;
+
+private:
+    std::shared_ptr<State> m_state;
+};
+
+#endif // FRAMEPOOL_H
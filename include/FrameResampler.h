@@ -0,0 +1,63 @@
+#ifndef FRAMERESAMPLER_H
+#define FRAMERESAMPLER_H
+
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+#include "Frame.h"
+
+/**
+ * @brief 派生输出规格：先裁剪，再按 factor 合并或抽样
+ *
+ * 裁剪区域为空表示整帧，超出图像的部分被截掉；合并/抽样后不足一个块的尾部行列丢弃。
+ */
+struct DerivedFrameSpec
+{
+    enum class Reduce {
+        None,       // 只裁剪
+        Bin,        // factor × factor 块取平均（降噪，适合预览）
+        Decimate    // 每 factor 行/列取一个像素（最便宜，会有混叠）
+    };
+
+    ImageRegion crop;
+    Reduce reduce = Reduce::None;
+    int factor = 1;             // 2 或 4，Reduce::None 时忽略
+
+    // 既不裁剪也不缩减，直接使用原始帧
+    bool isPassthrough() const { return crop.isEmpty() && (reduce == Reduce::None || factor <= 1); }
+    int scale() const { return reduce == Reduce::None ? 1 : factor; }
+
+    bool operator==(const DerivedFrameSpec &other) const
+    {
+        return crop.x == other.crop.x && crop.y == other.crop.y && crop.width == other.crop.width
+            && crop.height == other.crop.height && reduce == other.reduce && scale() == other.scale();
+    }
+    bool operator!=(const DerivedFrameSpec &other) const { return !(*this == other); }
+
+    QString description() const;
+};
+
+/**
+ * @brief 裁剪/合并/抽样内核
+ *
+ * 行内核每次处理一个 2× 步骤，AVX2/SSE2 每次输出 32/16 个 8 位像素或 16/8 个 16 位像素；
+ * 4× 由两级 2× 级联完成（合并每级四舍五入，与精确平均相差不超过 1 LSB）。
+ * 整帧按输出行带交给 TileExecutor 并行。
+ */
+class FrameResampler
+{
+public:
+    // 返回派生帧；规格与帧不相交（或缩减后为空）时返回 nullptr。
+    // 派生帧的 offsetX/offsetY 为裁剪区域在传感器上的位置，位深和元数据与源帧相同
+    static FramePtr derive(const Frame &source, const DerivedFrameSpec &spec);
+
+    // 输出 count 个像素：out[i] = round((r0[2i] + r0[2i+1] + r1[2i] + r1[2i+1]) / 4)
+    static void binRow8(const uint8_t *row0, const uint8_t *row1, uint8_t *out, size_t count);
+    static void binRow16(const uint16_t *row0, const uint16_t *row1, uint16_t *out, size_t count);
+
+    // 输出 count 个像素：out[i] = in[2i]
+    static void decimateRow8(const uint8_t *in, uint8_t *out, size_t count);
+    static void decimateRow16(const uint16_t *in, uint16_t *out, size_t count);
+};
+
+#endif // FRAMERESAMPLER_H
@@ -0,0 +1,21 @@
+#ifndef FRAMESTAGE_H
+#define FRAMESTAGE_H
+
+#include "Frame.h"
+
+/**
+ * @brief 帧处理管线中的一个处理阶段
+ *
+ * process() 在管线线程上调用，可以原地修改帧（管线保证此时没有其他消费者持有该帧），
+ * 也可以返回新的帧；返回 nullptr 表示丢弃该帧，后续阶段和输出都不会收到它。
+ */
+class FrameStage
+{
+public:
+    virtual ~FrameStage() = default;
+
+    virtual const char *stageName() const = 0;
+    virtual FramePtr process(FramePtr frame) = 0;
+};
+
+#endif // FRAMESTAGE_H
@@ -0,0 +1,61 @@
+#ifndef HDRFUSION_H
+#define HDRFUSION_H
+
+#include <QObject>
+#include <atomic>
+#include <vector>
+#include "FrameStage.h"
+
+/**
+ * @brief 包围曝光融合阶段 - 把参数序列中同一轮的各帧合成一帧线性 HDR 图像
+ *
+ * 每帧按 曝光 × 增益 换算到最短曝光的亮度尺度，再按三角权重（中间灰度权重最大、
+ * 接近饱和为 0）加权平均；最短曝光帧保留一个下限权重，保证全部饱和的像素仍有输出。
+ * 输出为 16 位，满量程对应最短曝光帧的饱和值，较长曝光带来的精度保留在低位。
+ * 一轮凑齐时输出一帧，其余帧被丢弃（输出帧率 = 采集帧率 / 组数）；没有序列标记的帧
+ * 在尚未见到序列时原样通过。行内核使用 AVX2/SSE2 单精度浮点。
+ */
+class HdrFusion : public QObject, public FrameStage
+{
+    Q_OBJECT
+
+public:
+    static constexpr float SATURATION_LEVEL = 0.97f;   // 超过满量程该比例视为饱和
+    static constexpr float MIN_WEIGHT = 1e-6f;          // 最短曝光帧的权重下限（只在其余帧都饱和时起作用）
+
+    explicit HdrFusion(QObject *parent = nullptr);
+
+    // 以下接口可在任意线程调用
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+    uint64_t fusedFrames() const;
+    uint64_t incompleteBrackets() const;    // 因丢帧或无法确定参数组而放弃的轮次
+
+    // FrameStage 接口，在管线线程上调用
+    const char *stageName() const override;
+    FramePtr process(FramePtr frame) override;
+
+    // 融合内核：sum += w(v) × v × scale，weight += w(v)；
+    // w(v) = min(v, max - v) / (max / 2)，v >= max × SATURATION_LEVEL 时为 0，再与 minWeight 取大
+    static void accumulate8(float *sum, float *weight, const uint8_t *pixels, size_t count, float scale,
+                            float maxValue, float minWeight);
+    static void accumulate16(float *sum, float *weight, const uint16_t *pixels, size_t count, float scale,
+                             float maxValue, float minWeight);
+    // out = round(sum / weight × outScale)，限制在 16 位内
+    static void resolve(uint16_t *out, const float *sum, const float *weight, size_t count, float outScale);
+
+private:
+    FramePtr fuse();
+    void clearBracket();
+
+    std::atomic_bool m_enabled{false};
+    std::atomic<uint64_t> m_fused{0};
+    std::atomic<uint64_t> m_incomplete{0};
+
+    // 以下仅在管线线程访问
+    std::vector<FramePtr> m_bracket;    // 按 step 存放当前一轮的帧
+    int m_collected = 0;
+    uint64_t m_cycle = 0;
+};
+
+#endif // HDRFUSION_H
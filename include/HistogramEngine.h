@@ -0,0 +1,67 @@
+#ifndef HISTOGRAMENGINE_H
+#define HISTOGRAMENGINE_H
+
+#include "Frame.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 单帧强度统计结果
+ *
+ * 直方图按原始位深分箱（8位 256 个，12位 4096 个，16位 65536 个），
+ * 其余统计量均由直方图推导。
+ */
+struct FrameStatistics
+{
+    int bitDepth = 8;
+    std::vector<uint32_t> histogram;
+    uint64_t sampleCount = 0;
+    int sampleStep = 1;
+    int minValue = 0;
+    int maxValue = 0;
+    double mean = 0.0;
+    double saturationPercent = 0.0;   // 达到满量程的像素占比
+    uint64_t frameId = 0;
+    FrameChunkData chunk;             // 帧自带的曝光/增益等块数据（若启用）
+    double computeTimeUs = 0.0;
+
+    bool isValid() const { return sampleCount > 0; }
+    int fullScale() const { return (1 << bitDepth) - 1; }
+
+    // 返回累计占比达到 p (0~1) 的灰度值
+    int percentile(double p) const;
+};
+
+/**
+ * @brief 直方图计算内核
+ *
+ * - 8/10/12 位数据使用 4 路交错子直方图计数，避免相邻像素同值时的写后读停顿
+ * - 子直方图合并使用 SSE2/AVX2 向量加法
+ * - 支持按步长隔行采样（整行连续读取，带宽随步长下降），5MP 帧默认采样约 50 万像素
+ * - 采样行数较多时按行带交给 TileExecutor 并行，每个行带有独立的子直方图
+ *
+ * 对象内部持有计数缓冲区，尺寸不变时计算过程中不分配内存；单个对象不可跨线程并发使用。
+ */
+class HistogramEngine
+{
+public:
+    // 采样预算: 自动行步长下每帧最多统计的像素数
+    static constexpr uint64_t AUTO_SAMPLE_BUDGET = 1u << 19;
+
+    // 按采样预算选择行步长 (>= 1)
+    static int autoSampleStep(int width, int height);
+
+    // sampleStep 为行步长，<= 0 表示自动选择
+    void compute(const Frame &frame, int sampleStep, FrameStatistics &stats);
+
+private:
+    // 统计 [rowBegin, rowEnd) 内按 step 采样的行，lanes 个子直方图从 base 开始连续存放
+    static void countRows8(const Frame &frame, int rowBegin, int rowEnd, int step, int lanes, uint32_t *base);
+    static void countRows16(const Frame &frame, int rowBegin, int rowEnd, int step, int lanes, uint32_t mask,
+                            uint32_t *base);
+    void mergeLanes(int lanes, int bins, uint32_t *out) const;
+
+    std::vector<uint32_t> m_lanes;
+};
+
+#endif // HISTOGRAMENGINE_H
@@ -0,0 +1,143 @@
+#ifndef IMAGESAVESERVICE_H
+#define IMAGESAVESERVICE_H
+
+#include <QObject>
+#include <QString>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Frame.h"
+
+class QTimer;
+
+/**
+ * @brief 后台图像保存服务 - 有界队列 + 编码线程池
+ *
+ * 采集/管线线程和 GUI 线程通过 offer() 投递帧：
+ * - 录制序列时每帧入队，单帧保存时只取下一帧
+ * - 队列满时丢弃新帧并计数，调用方从不阻塞
+ * 编码线程数默认等于 CPU 核数，每个线程独立编码并写盘。
+ *
+ * 格式：
+ * - PNG / TIFF：8 位或 16 位灰度，高位深保留原始数值（不拉伸）
+ * - BMP：8 位灰度，高位深先右移到 8 位
+ * - RAW：原始像素（小端），尺寸和位深写在文件名中
+ * - ALC：LosslessCodec 无损压缩，含完整帧元数据，12 位数据通常可压缩到 1/2 以下
+ */
+class ImageSaveService : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Format {
+        Png,
+        Tiff,
+        Bmp,
+        Raw,
+        Compressed
+    };
+
+    struct SaveStatistics {
+        double framesPerSecond = 0.0;
+        double megabytesPerSecond = 0.0;       // 原始像素数据速率
+        double compressionRatio = 0.0;         // 原始/压缩后，没有压缩帧时为 0
+        double codecMegabytesPerSecond = 0.0;  // 单帧编码速率（原始数据 / 编码耗时，单帧在 TileExecutor 上分行带并行）
+        int queuedFrames = 0;
+        qulonglong droppedFrames = 0;
+    };
+
+    explicit ImageSaveService(QObject *parent = nullptr);
+    ~ImageSaveService();
+
+    // 以下配置在 GUI 线程调用
+    void setDirectory(const QString &directory);
+    QString directory() const;
+    void setFormat(Format format);
+    Format format() const;
+    void setQueueCapacity(int frames);
+    int queueCapacity() const;
+
+    // 序列录制：frameLimit <= 0 表示不限帧数，直到 stopSequence()
+    bool startSequence(int frameLimit = 0);
+    void stopSequence();
+    bool isRecording() const;
+
+    // 保存下一帧
+    bool saveNextFrame();
+
+    // 任意线程调用：按当前录制/单帧请求决定是否入队
+    void offer(const FramePtr &frame);
+
+    int queuedFrames() const;
+    uint64_t savedFrames() const;
+    uint64_t droppedFrames() const;
+
+    static QString formatSuffix(Format format);
+
+Q_SIGNALS:
+    // 每秒一次：保存帧率、数据速率、压缩率、队列深度、累计丢弃
+    void throughputUpdated(const ImageSaveService::SaveStatistics &stats);
+    void sequenceFinished(qulonglong savedFrames);
+    void frameSaved(const QString &filePath);
+    void saveFailed(const QString &message);
+
+private:
+    struct Job {
+        FramePtr frame;
+        QString path;
+        Format format;
+        bool single;      // 单帧保存：写完后发出 frameSaved
+        bool sequence;    // 序列录制：计入序列统计
+    };
+
+    void startWorkers();
+    void stopWorkers();
+    void workerLoop();
+    void finishSequenceIfDrained();
+    bool enqueue(const FramePtr &frame, bool single, bool sequence);
+    QString makeFilePath(const Frame &frame, Format format, const QString &directory) const;
+    bool writeFrame(const Job &job, QString *error);
+    bool writeCompressed(const Frame &frame, const QString &path);
+    void reportThroughput();
+
+    static bool writeTiff(const Frame &frame, const QString &path);
+    static bool writeRaw(const Frame &frame, const QString &path);
+    static bool writeWithQImage(const Frame &frame, const QString &path, const char *format);
+
+    std::vector<std::thread> m_workers;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::deque<Job> m_queue;          // 受 m_mutex 保护
+    int m_queueCapacity = 32;         // 受 m_mutex 保护
+    QString m_directory;              // 受 m_mutex 保护
+    Format m_format = Format::Png;    // 受 m_mutex 保护
+    bool m_workersRunning = false;
+
+    std::atomic_bool m_recording{false};
+    std::atomic_bool m_singlePending{false};
+    std::atomic_int m_sequenceRemaining{0};   // <= 0 表示不限
+    std::atomic<uint64_t> m_sequenceSaved{0};
+    std::atomic_int m_sequenceInFlight{0};    // 已入队未写完的序列帧
+    std::atomic_bool m_sequenceActive{false}; // 保证 sequenceFinished 只发一次
+
+    std::atomic<uint64_t> m_savedFrames{0};
+    std::atomic<uint64_t> m_savedBytes{0};
+    std::atomic<uint64_t> m_droppedFrames{0};
+    std::atomic<uint64_t> m_codecInputBytes{0};
+    std::atomic<uint64_t> m_codecOutputBytes{0};
+    std::atomic<uint64_t> m_codecNs{0};
+    std::atomic_bool m_failureReported{false};
+
+    QTimer *m_statsTimer;
+    uint64_t m_lastSavedFrames = 0;
+    uint64_t m_lastSavedBytes = 0;
+    uint64_t m_lastCodecInputBytes = 0;
+    uint64_t m_lastCodecOutputBytes = 0;
+    uint64_t m_lastCodecNs = 0;
+    int64_t m_lastReportNs = 0;
+};
+
+#endif // IMAGESAVESERVICE_H
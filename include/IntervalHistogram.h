@@ -0,0 +1,57 @@
+#ifndef INTERVALHISTOGRAM_H
+#define INTERVALHISTOGRAM_H
+
+#include <QStringList>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief 时间间隔直方图 - 用于统计采集线程相邻两次出队之间的间隔（抖动）
+ *
+ * 对数分桶：从 1 μs 起每个二倍区间分 4 个子桶（相对误差 ≤ 25%），上限约 16 s。
+ * add() 由单个线程调用，只做几次 relaxed 原子加；summary() 可在任意线程读取。
+ * 百分位取所在桶的上界，最小/最大值精确。
+ */
+class IntervalHistogram
+{
+public:
+    static constexpr int SUB_BUCKETS = 4;
+    static constexpr int MIN_SHIFT = 10;                // 第一个桶从 2^10 ns ≈ 1 μs 开始
+    static constexpr int OCTAVES = 24;
+    static constexpr int BUCKET_COUNT = OCTAVES * SUB_BUCKETS;
+
+    struct Summary {
+        uint64_t count = 0;
+        double meanUs = 0.0;
+        double minUs = 0.0;
+        double p50Us = 0.0;
+        double p99Us = 0.0;
+        double p999Us = 0.0;
+        double maxUs = 0.0;
+        uint64_t lateCount = 0;     // 超过 lateFactor × 中位数的间隔数（按桶下界判断）
+    };
+
+    IntervalHistogram();
+
+    void reset();
+    void add(int64_t intervalNs);
+
+    Summary summary(double lateFactor = 1.5) const;
+
+    // 摘要加非空桶的文本直方图
+    QStringList report(double lateFactor = 1.5) const;
+
+    static int bucketIndex(int64_t intervalNs);
+    static int64_t bucketLowerNs(int index);
+    static int64_t bucketUpperNs(int index);
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_buckets;
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<int64_t> m_sumNs{0};
+    std::atomic<int64_t> m_minNs{0};
+    std::atomic<int64_t> m_maxNs{0};
+};
+
+#endif // INTERVALHISTOGRAM_H
@@ -0,0 +1,24 @@
+#ifndef KERNELBENCHMARK_H
+#define KERNELBENCHMARK_H
+
+#include <QString>
+#include <QStringList>
+#include <functional>
+
+/**
+ * @brief 图像内核并行扩展性测试
+ *
+ * 用合成帧依次以 1..N 个线程运行各逐帧内核（显示转换、合并、平场校正、时域累加、直方图、对焦评价、压缩），
+ * 报告每个内核的耗时、加速比和并行效率 (T1 / (N × TN))。
+ * 测试期间会临时修改 TileExecutor 的线程上限，应在停止采集后运行。
+ */
+class KernelBenchmark
+{
+public:
+    using ProgressCallback = std::function<void(const QString &line)>;
+
+    // 返回报告文本（每行一条），progress 可为空
+    static QStringList run(int width, int height, int repeats = 5, const ProgressCallback &progress = nullptr);
+};
+
+#endif // KERNELBENCHMARK_H
@@ -0,0 +1,61 @@
+#ifndef LOGMODEL_H
+#define LOGMODEL_H
+
+#include <QAbstractListModel>
+#include <QString>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 状态日志模型 - 固定容量的环形日志，供 QListView 虚拟化显示
+ *
+ * 达到容量后一次淘汰最旧的 1/8 条目（一次 beginRemoveRows），追加的开销与运行时长无关；
+ * 时间戳在 data() 中按需格式化，只有可见行才会产生字符串。
+ * 与上一条内容和级别都相同的消息不新增行，只累加重复次数并刷新时间戳。
+ * 多行消息按行拆分为多个条目。
+ */
+class LogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DEFAULT_CAPACITY = 5000;
+
+    enum Roles {
+        IsErrorRole = Qt::UserRole + 1
+    };
+
+    explicit LogModel(int capacity = DEFAULT_CAPACITY, QObject *parent = nullptr);
+
+    void append(const QString &message, bool isError);
+    void clear();
+
+    int capacity() const { return static_cast<int>(m_entries.size()); }
+    uint64_t evictedEntries() const { return m_evicted; }
+
+    // 按时间顺序写出当前保留的条目（纯文本）
+    bool exportText(const QString &path, QString *error = nullptr) const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    struct Entry {
+        qint64 wallTimeMs = 0;      // 最后一次出现的系统时间
+        QString text;
+        bool isError = false;
+        int repeats = 1;
+    };
+
+    void appendLine(qint64 wallTimeMs, const QString &line, bool isError);
+    Entry &entryAt(int row) { return m_entries[(m_head + row) % m_entries.size()]; }
+    const Entry &entryAt(int row) const { return m_entries[(m_head + row) % m_entries.size()]; }
+    static QString formatEntry(const Entry &entry);
+
+    std::vector<Entry> m_entries;   // 环形缓冲区
+    size_t m_head = 0;              // 最旧条目的位置
+    int m_count = 0;
+    uint64_t m_evicted = 0;         // 累计淘汰的条目数
+};
+
+#endif // LOGMODEL_H
@@ -0,0 +1,75 @@
+#ifndef LOSSLESSCODEC_H
+#define LOSSLESSCODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Frame.h"
+
+/**
+ * @brief 传感器数据无损编解码 - 梯度预测 + 分块位打包
+ *
+ * 编码分两步：
+ * 1. 预测：每个像素用 left + up - upLeft 预测（带首行只用 left，首列只用 up），
+ *    残差按存储字长（8 位数据模 2^8，9~16 位数据模 2^16）回绕后做 zigzag 映射为无符号数，
+ *    与有效位深无关；AVX2/SSE2 每次处理 16/8 个像素
+ * 2. 位打包：每 16 个残差一块，记录块内最大位宽 b（1 字节），随后写 16*b 位
+ *
+ * 帧按 ROWS_PER_BAND 行切成互相独立的行带，由 TileExecutor 并行编码/解码。
+ *
+ * 码流（小端）：StreamHeader | uint32 bandBytes[bandCount] | 各行带数据
+ */
+class LosslessCodec
+{
+public:
+    static constexpr uint32_t MAGIC = 0x31434C41;   // "ALC1"
+    static constexpr uint16_t VERSION = 2;          // 2: 码流头追加块数据
+    static constexpr uint16_t MIN_HEADER_SIZE = 64; // 版本 1 的码流头长度
+    static constexpr int ROWS_PER_BAND = 64;
+    static constexpr int BLOCK_SIZE = 16;
+
+    struct StreamHeader {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t headerSize;
+        uint32_t width;
+        uint32_t height;
+        uint32_t pixelFormat;
+        int32_t offsetX;
+        int32_t offsetY;
+        uint8_t bitDepth;
+        uint8_t bytesPerPixel;
+        uint16_t rowsPerBand;
+        uint32_t bandCount;
+        uint32_t chunkValid;          // FrameChunkData::valid，版本 1 中为保留字段 0
+        uint64_t frameId;
+        uint64_t timestampNs;
+        uint64_t systemTimestampNs;
+        double chunkExposureUs;
+        double chunkGainDb;
+        uint64_t chunkFrameId;
+        uint64_t chunkTimestamp;
+        uint32_t chunkLineStatus;
+        uint32_t reserved;
+    };
+
+    // 编码整帧，out 被覆盖（容量可复用）
+    static void encode(const Frame &frame, std::vector<uint8_t> &out);
+
+    // 解码码流，失败（格式错误/数据截断）返回 false
+    static bool decode(const uint8_t *data, size_t size, Frame &frame);
+
+    // 预测 + zigzag 内核，up 为 nullptr 表示行带首行
+    static void residualRow8(const uint8_t *row, const uint8_t *up, uint8_t *out, size_t width);
+    static void residualRow16(const uint16_t *row, const uint16_t *up, uint16_t *out, size_t width);
+
+private:
+    template<typename T>
+    static size_t packBlocks(const T *values, size_t count, uint8_t *out);
+    template<typename T>
+    static bool unpackBlocks(const uint8_t *data, size_t size, T *values, size_t count);
+    template<typename T>
+    static void reconstructBand(const T *residuals, T *pixels, size_t width, size_t rows);
+};
+
+#endif // LOSSLESSCODEC_H
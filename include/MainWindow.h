@@ -8,12 +8,21 @@
 #include <QSpinBox>
 #include <QDoubleSpinBox>
 #include <QGroupBox>
-#include <QTextEdit>
+#include <QListView>
+#include <QCheckBox>
+#include <QComboBox>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGridLayout>
+#include <thread>
+#include <utility>
+#include <vector>
 #include "CameraController.h"
 #include "VideoWidget.h"
+#include "FocusPlotWidget.h"
+#include "LogModel.h"
+
+class QMessageBox;
 
 /**
  * @brief 主窗口类 - 相机控制界面
@@ -53,21 +62,45 @@ private Q_SLOTS:
     void onAcquisitionStarted();
     void onAcquisitionStopped();
     void onFPSUpdated(double fps);
+    void onStatisticsReady(const FrameStatistics &stats);
+    void onAutoExposureToggled(bool checked);
+    void onAutoExposureAdjusted(double exposureUs, double gainDb);
 
 private:
     // UI初始化
     void setupUI();
     void createCameraControlPanel();
     void createParameterPanel();
+    void createAnalysisPanel();
+    void createDisplayPanel();
+    void createCorrectionPanel();
+    void createTemporalPanel();
+    void createSequencePanel();
+    void createBurstPanel();
+    void createSavePanel();
+    void createAdvancedPanels();
+    void createStreamPanel();
+    void createRealtimePanel();
+    void applyCaptureThreadOptions();
+    void createTransferPanel();
+    void applyUsbTransferOptions();
+    void updateTransferPanel();
+    void applyDerivedOutputs();
     void createImageDisplayPanel();
     void createStatusPanel();
     void createMenuBar();
 
     // 辅助函数
+    bool connectToCamera(const QString &cameraId);
+    void onDevicesEnumerated(const QVector<CameraDeviceInfo> &devices, double elapsedMs);
+    void reportStartup();
     void updateCameraInfo();
     void updateParameterBounds();
     void updateUIState();
+    void showBurstFrame(int index);
+    void applyDisplayWindow();
     void logMessage(const QString &msg, bool isError = false);
+    void notifyError(const QString &errorMsg);
 
     // 相机控制器
     CameraController *m_cameraController;
@@ -89,6 +122,9 @@ private:
 
     // 相机连接组
     QGroupBox *m_connectionGroup;
+    QComboBox *m_cameraComboBox;
+    QPushButton *m_refreshDevicesButton;
+    QCheckBox *m_autoConnectCheckBox;
     QPushButton *m_connectButton;
     QPushButton *m_disconnectButton;
     QLabel *m_cameraInfoLabel;
@@ -98,6 +134,16 @@ private:
     QPushButton *m_startAcquisitionButton;
     QPushButton *m_stopAcquisitionButton;
     QPushButton *m_grabFrameButton;
+    QCheckBox *m_snapshotModeCheckBox;
+    QCheckBox *m_chunkDataCheckBox;
+    QComboBox *m_overflowPolicyComboBox;
+    QCheckBox *m_frameBusCheckBox;
+    QComboBox *m_previewOutputComboBox;
+    QComboBox *m_frameBusOutputComboBox;
+    QCheckBox *m_frameBusCropCheckBox;
+    QLabel *m_dropStatusLabel;
+    QSpinBox *m_dropAlarmSpinBox;
+    QPushButton *m_dropExportButton;
 
     // 参数控制组
     QGroupBox *m_parameterGroup;
@@ -121,22 +167,149 @@ private:
     QPushButton *m_setROIButton;
     QPushButton *m_resetROIButton;
 
+    // 图像分析组
+    QGroupBox *m_analysisGroup;
+    QCheckBox *m_histogramCheckBox;
+    QDoubleSpinBox *m_histogramRateSpinBox;
+    QSpinBox *m_sampleStepSpinBox;
+    QCheckBox *m_autoExposureCheckBox;
+    QDoubleSpinBox *m_aeTargetSpinBox;
+    QComboBox *m_aeMeteringComboBox;
+    QCheckBox *m_focusCheckBox;
+    QComboBox *m_focusMethodComboBox;
+
+    // 显示窗口组
+    QGroupBox *m_displayGroup;
+    QDoubleSpinBox *m_windowLowSpinBox;
+    QDoubleSpinBox *m_windowHighSpinBox;
+    QDoubleSpinBox *m_gammaSpinBox;
+    QComboBox *m_paletteComboBox;
+    QPushButton *m_autoWindowButton;
+    QPushButton *m_resetWindowButton;
+    FrameStatistics m_lastStatistics;   // 自动窗口取最近一次直方图
+
+    // 平场校正组
+    QGroupBox *m_correctionGroup;
+    QCheckBox *m_flatFieldCheckBox;
+    QSpinBox *m_calibrationFramesSpinBox;
+    QPushButton *m_darkCaptureButton;
+    QPushButton *m_flatCaptureButton;
+    QPushButton *m_clearCalibrationButton;
+    QLabel *m_calibrationStatusLabel;
+
+    // 时域滤波组
+    QGroupBox *m_temporalGroup;
+    QComboBox *m_temporalModeComboBox;
+    QSpinBox *m_averageFramesSpinBox;
+    QSpinBox *m_backgroundShiftSpinBox;
+    QSpinBox *m_changeThresholdSpinBox;
+    QLabel *m_changeLabel;
+
+    // 包围曝光序列组
+    QGroupBox *m_sequenceGroup;
+    QSpinBox *m_sequenceStepsSpinBox;
+    QDoubleSpinBox *m_sequenceRatioSpinBox;
+    QCheckBox *m_sequenceHardwareCheckBox;
+    QCheckBox *m_hdrFusionCheckBox;
+    QPushButton *m_sequenceApplyButton;
+    QLabel *m_sequenceStatusLabel;
+
+    // 连拍组
+    QGroupBox *m_burstGroup;
+    QSpinBox *m_burstFramesSpinBox;
+    QCheckBox *m_burstMaxRateCheckBox;
+    QPushButton *m_burstStartButton;
+    QLabel *m_burstStatusLabel;
+    QCheckBox *m_burstReviewCheckBox;
+    QSlider *m_burstReviewSlider;
+    QPushButton *m_burstSaveButton;
+    QPushButton *m_burstReleaseButton;
+
+    // 图像保存组
+    QGroupBox *m_saveGroup;
+    QComboBox *m_saveFormatComboBox;
+    QPushButton *m_saveDirectoryButton;
+    QLabel *m_saveDirectoryLabel;
+    QSpinBox *m_sequenceFramesSpinBox;
+    QPushButton *m_recordButton;
+    QPushButton *m_saveNextButton;
+    QLabel *m_saveStatsLabel;
+
+    // 高级设置：远程预览/采集实时性/USB3 传输三组在首次展开时创建，之前相应指针为空
+    QPushButton *m_advancedButton;
+    QWidget *m_advancedPanel;
+    QVBoxLayout *m_advancedLayout;
+
+    // 远程预览组
+    QGroupBox *m_streamGroup = nullptr;
+    QCheckBox *m_streamCheckBox;
+    QSpinBox *m_streamPortSpinBox;
+    QCheckBox *m_streamLoopbackCheckBox;
+    QSpinBox *m_streamFpsSpinBox;
+    QComboBox *m_streamOutputComboBox;
+    QLabel *m_streamStatusLabel;
+
+    // 采集实时性组
+    QGroupBox *m_realtimeGroup = nullptr;
+    QCheckBox *m_realtimeCheckBox;
+    QSpinBox *m_realtimePrioritySpinBox;
+    QSpinBox *m_captureCpuSpinBox;
+    QSpinBox *m_streamCpuSpinBox;
+    QCheckBox *m_lockMemoryCheckBox;
+    QCheckBox *m_prefaultCheckBox;
+    QPushButton *m_jitterReportButton;
+
+    // USB3 传输组
+    QGroupBox *m_transferGroup = nullptr;
+    QComboBox *m_usbModeComboBox;
+    QSpinBox *m_maxTransferSpinBox;
+    QCheckBox *m_throughputLimitCheckBox;
+    QDoubleSpinBox *m_throughputLimitSpinBox;   // MB/s
+    QPushButton *m_throughputApplyButton;
+    QPushButton *m_streamInfoButton;
+    QLabel *m_transferStatusLabel;
+
     // 图像显示区域
     QGroupBox *m_imageGroup;
     VideoWidget *m_videoWidget;
+    FocusPlotWidget *m_focusPlotWidget;
     QLabel *m_imageInfoLabel;
+    QLabel *m_pipelineStatsLabel;
 
     // 状态信息区域
     QGroupBox *m_statusGroup;
-    QTextEdit *m_statusTextEdit;
+    LogModel *m_logModel;
+    QListView *m_logView;
+    QPushButton *m_logClearButton;
+    QPushButton *m_logExportButton;
+    bool m_logScrollPending = false;    // 同一轮事件循环内只滚动一次
+
+    // 错误提示：复用一个非模态对话框，按间隔限频，同一错误一段时间内只弹一次
+    static constexpr qint64 ERROR_DIALOG_INTERVAL_MS = 5000;    // 关闭对话框后再次弹出的最小间隔
+    static constexpr qint64 ERROR_REPEAT_WINDOW_MS = 60000;
+    QMessageBox *m_errorDialog = nullptr;
+    qint64 m_errorDialogClosedMs = 0;
+    int m_unshownErrors = 0;        // 上次弹出后未单独提示的错误数
+    std::vector<std::pair<QString, qint64>> m_recentErrors;    // 最近提示过的错误及时间
 
     // 状态栏标签
     QLabel *m_statusBarLabel;
 
+    // 启动：自动连接等待探测线程打开上次的相机；启动耗时只报告一次
+    bool m_autoConnectPending = false;
+    bool m_startupReported = false;
+
     // 参数范围缓存
     double m_exposureMin, m_exposureMax;
     double m_gainMin, m_gainMax;
     int m_roiMaxWidth, m_roiMaxHeight;
+
+    // 最近一次框选区域（原始帧坐标），用于帧总线裁剪输出
+    ImageRegion m_selectedImageRegion;
+
+    // 并行扩展性测试在后台线程运行，期间会改写 TileExecutor 线程数上限，不允许开始采集
+    std::thread m_benchmarkThread;
+    bool m_benchmarkRunning = false;
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,99 @@
+#ifndef PARAMETERSEQUENCER_H
+#define PARAMETERSEQUENCER_H
+
+#include <QString>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include "Frame.h"
+
+typedef struct _ArvCamera ArvCamera;
+
+/**
+ * @brief 曝光/增益参数序列（包围曝光）- 逐帧循环切换若干组参数，并给每帧打上参数组标记
+ *
+ * - Hardware: 相机支持 GenICam SequencerMode 时，把各组参数写入 SequencerSet，
+ *   由相机在每个 FrameStart 切换到下一组，帧间没有任何主机写入
+ * - Software: 否则在采集线程收到第 k 帧时请求写入第 k + latency 帧的参数，
+ *   由参数线程在帧间完成（流水线写入）
+ *
+ * 帧标记优先用块数据中的曝光/增益匹配参数组（精确）；没有块数据时按帧号推算，
+ * 软件模式下写入被覆盖、帧号跳变后无法确定的帧标记为无效。
+ * configure()/disable() 在相机未采集时调用，tag() 只在采集线程调用。
+ */
+class ParameterSequencer
+{
+public:
+    enum class Mode {
+        Off,
+        Hardware,
+        Software
+    };
+
+    struct Step {
+        double exposureUs = 0.0;
+        double gainDb = 0.0;
+    };
+
+    struct Settings {
+        std::vector<Step> steps;
+        bool allowHardware = true;      // false: 即使相机支持 SequencerMode 也使用软件写入
+        int latencyFrames = 2;          // 软件模式：写入到生效的帧数
+    };
+
+    struct Counters {
+        uint64_t tagged = 0;
+        uint64_t untagged = 0;          // 无法确定参数组（序列起始、写入被覆盖或帧号跳变）
+        uint64_t corrected = 0;         // 块数据与推算的参数组不一致，已按块数据更正
+        uint64_t overruns = 0;          // 软件模式下写入未在一帧内完成而被下一次覆盖
+    };
+
+    static constexpr int MAX_STEPS = 8;
+
+    ~ParameterSequencer();
+
+    // 相机未采集时调用；steps 少于 2 组时等同 disable()
+    bool configure(ArvCamera *camera, const Settings &settings, QString *error = nullptr);
+    // 关闭序列并恢复第一组参数
+    void disable(ArvCamera *camera);
+
+    Mode mode() const;
+    bool isActive() const;
+    Settings settings() const;
+    QString describe() const;
+
+    // 开始采集时调用，清空计数和帧号推算状态
+    void reset();
+
+    // 采集线程调用：填写 frame.sequence；软件模式下返回需要提前写入的参数
+    // （targetIndex 为该参数预计生效的帧序号），调用方写入后若被覆盖应调用 writeSuperseded()
+    struct WriteRequest {
+        Step step;
+        uint64_t targetIndex = 0;
+    };
+    std::optional<WriteRequest> tag(Frame &frame);
+    void writeSuperseded(uint64_t targetIndex);
+
+    Counters counters() const;
+
+private:
+    int matchStep(const FrameChunkData &chunk) const;
+
+    Mode m_mode = Mode::Off;
+    Settings m_settings;
+
+    // 以下仅在采集线程访问
+    bool m_started = false;
+    uint64_t m_lastFrameId = 0;
+    uint64_t m_frameIndex = 0;          // 自采集开始的帧序号（按帧号差推进，包含丢失的帧）
+    std::array<uint64_t, 64> m_scheduled{};     // 软件模式：按帧序号记录已写入参数的目标帧（+1，0 表示无）
+
+    std::atomic<uint64_t> m_tagged{0};
+    std::atomic<uint64_t> m_untagged{0};
+    std::atomic<uint64_t> m_corrected{0};
+    std::atomic<uint64_t> m_overruns{0};
+};
+
+#endif // PARAMETERSEQUENCER_H
@@ -0,0 +1,142 @@
+#ifndef PREVIEWSTREAMSERVER_H
+#define PREVIEWSTREAMSERVER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Frame.h"
+
+class QTcpServer;
+class QTcpSocket;
+class QTimer;
+
+/**
+ * @brief 远程预览服务 - 内置 HTTP 服务器，以 MJPEG 推送缩小后的预览
+ *
+ * - GET /            简单的查看页面
+ * - GET /stream.mjpg multipart/x-mixed-replace 连续 JPEG，浏览器/VLC/ffplay 可直接打开
+ * - GET /snapshot.jpg 下一帧的单张 JPEG（便于脚本和回环测试）
+ *
+ * 管线线程通过 offer() 投递帧，只保留最新一帧，从不阻塞采集；编码线程按 maxFps 限速，
+ * 每帧只为客户端当前使用的质量档各编码一次。每个客户端根据套接字未发出的字节数自适应：
+ * 积压超过 clientBufferFrames 帧时该客户端跳过此帧，连续积压则降一档质量，
+ * 长时间无积压再升一档。套接字在 GUI 线程读写。
+ */
+class PreviewStreamServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int QUALITY_LEVELS = 5;
+    static constexpr int QUALITY[QUALITY_LEVELS] = {30, 45, 60, 75, 90};
+    static constexpr int MAX_CLIENTS = 8;
+
+    struct Settings {
+        quint16 port = 8080;
+        bool loopbackOnly = true;       // 只监听 127.0.0.1
+        double maxFps = 15.0;
+        int maxQualityLevel = 3;        // QUALITY 的索引，新客户端从该档开始
+        int clientBufferFrames = 2;     // 每个客户端允许积压的帧数
+    };
+
+    struct Statistics {
+        int clients = 0;
+        double encodedFps = 0.0;
+        double encodeMsPerFrame = 0.0;  // 转换 + 编码（所有质量档）
+        double encoderCpuPercent = 0.0; // 编码线程占用单核的比例
+        double sendMegabitsPerSecond = 0.0;
+        qulonglong clientDrops = 0;     // 累计：因客户端积压跳过的帧
+        QString clientLevels;           // 各客户端当前质量，如 "75,45"
+    };
+
+    explicit PreviewStreamServer(QObject *parent = nullptr);
+    ~PreviewStreamServer();
+
+    // 以下在 GUI 线程调用
+    bool start(const Settings &settings, QString *error = nullptr);
+    void stop();
+    bool isRunning() const;
+    Settings settings() const;
+    quint16 serverPort() const;
+
+    // 任意线程调用：有客户端等待时为 true，调用方据此决定是否准备帧
+    bool wantsFrames() const;
+    // 任意线程调用：替换待编码的帧，编码线程忙时旧帧直接丢弃
+    void offer(const FramePtr &frame);
+
+Q_SIGNALS:
+    // 每秒一次
+    void statisticsUpdated(const PreviewStreamServer::Statistics &stats);
+    void clientConnected(const QString &peer);
+    void clientDisconnected(const QString &peer);
+
+private:
+    struct Client {
+        QTcpSocket *socket = nullptr;
+        QString peer;
+        QByteArray request;
+        bool streaming = false;         // 已发送 MJPEG 响应头
+        bool snapshot = false;          // 等待下一帧后关闭
+        int level = 0;
+        int congested = 0;              // 连续因积压跳过的帧数
+        int clean = 0;                  // 连续无积压发送的帧数
+        qint64 lastFrameBytes = 0;
+    };
+
+    struct EncodedFrame {
+        uint64_t frameId = 0;
+        std::array<QByteArray, QUALITY_LEVELS> jpeg;   // 未请求的质量档为空
+    };
+
+    void onNewConnection();
+    void onReadyRead(QTcpSocket *socket);
+    void onDisconnected(QTcpSocket *socket);
+    Client *findClient(QTcpSocket *socket);
+    void handleRequest(Client &client);
+    void deliver(const EncodedFrame &frame);
+    void updateRequestedLevels();
+    void reportStatistics();
+
+    void startEncoder();
+    void stopEncoder();
+    void encoderLoop();
+    static QByteArray encode(const Frame &frame, int quality, std::vector<uint8_t> &scratch);
+    static int64_t threadCpuNs();
+
+    QTcpServer *m_server;
+    QTimer *m_statsTimer;
+    Settings m_settings;
+    std::vector<Client> m_clients;      // GUI 线程
+
+    // 编码线程
+    std::thread m_encoderThread;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    FramePtr m_pending;                 // 受 m_mutex 保护
+    bool m_encoderRunning = false;      // 受 m_mutex 保护
+    unsigned m_requestedLevels = 0;     // 受 m_mutex 保护：按位表示需要编码的质量档
+    std::shared_ptr<EncodedFrame> m_encoded;    // 受 m_mutex 保护：等待 GUI 线程发送的最新一帧
+    std::atomic_bool m_wantsFrames{false};
+    std::atomic<double> m_maxFps{15.0};
+
+    std::atomic<uint64_t> m_encodedFrames{0};
+    std::atomic<uint64_t> m_encodeNs{0};
+    std::atomic<uint64_t> m_encoderCpuNs{0};
+    uint64_t m_sentBytes = 0;           // GUI 线程
+    uint64_t m_clientDrops = 0;         // GUI 线程
+
+    uint64_t m_lastEncodedFrames = 0;
+    uint64_t m_lastEncodeNs = 0;
+    uint64_t m_lastEncoderCpuNs = 0;
+    uint64_t m_lastSentBytes = 0;
+    int64_t m_lastReportNs = 0;
+};
+
+#endif // PREVIEWSTREAMSERVER_H
@@ -0,0 +1,40 @@
+#ifndef REALTIMETUNING_H
+#define REALTIMETUNING_H
+
+#include <QString>
+#include <cstddef>
+
+/**
+ * @brief 采集线程实时性选项
+ *
+ * 在 Linux 上通过 pthread/mlockall 实现；其他平台各操作返回 false 并给出原因。
+ * SCHED_FIFO 和 mlockall 通常需要 CAP_SYS_NICE / CAP_IPC_LOCK 或相应的 rlimit
+ * （/etc/security/limits.conf 中的 rtprio 和 memlock）。
+ */
+struct CaptureThreadOptions {
+    bool realtime = false;          // 采集线程和 Aravis 接收线程使用 SCHED_FIFO
+    int priority = 50;              // SCHED_FIFO 优先级 1..99
+    int captureCpu = -1;            // 采集线程绑定的 CPU，-1 表示不绑定
+    int streamCpu = -1;             // Aravis 接收线程绑定的 CPU，-1 表示不绑定
+    bool lockMemory = false;        // 采集期间 mlockall(MCL_CURRENT | MCL_FUTURE)
+    bool prefaultBuffers = false;   // 缓冲区入队前逐页写入，避免首次接收时缺页
+};
+
+class RealtimeTuning
+{
+public:
+    // 作用于调用线程
+    static bool setCurrentThreadRealtime(int priority, QString *error = nullptr);
+    static bool setCurrentThreadAffinity(int cpu, QString *error = nullptr);
+
+    // 作用于整个进程
+    static bool lockMemory(QString *error = nullptr);
+    static void unlockMemory();
+
+    // 逐页写入，使页面在进入实时路径前已映射
+    static void prefault(void *data, size_t size);
+
+    static int cpuCount();
+};
+
+#endif // REALTIMETUNING_H
@@ -0,0 +1,28 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+/**
+ * @brief SIMD 指令集检测
+ *
+ * 图像内核按编译期可用的指令集选择实现：
+ * - ARAVIS_HAS_AVX2: 由 CMake 选项 ENABLE_AVX2 打开（-mavx2 / /arch:AVX2，默认关闭）。
+ *   没有运行时分派，打开后整个程序只能在支持 AVX2 的 CPU 上运行
+ * - ARAVIS_HAS_SSE2: x86-64 平台恒定可用
+ * 两者都不可用时（如 ARM）回退到标量实现。
+ */
+
+#if defined(__AVX2__)
+#define ARAVIS_HAS_AVX2 1
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ARAVIS_HAS_SSE2 1
+#endif
+
+#if defined(ARAVIS_HAS_AVX2)
+#include <immintrin.h>
+#elif defined(ARAVIS_HAS_SSE2)
+#include <emmintrin.h>
+#endif
+
+#endif // SIMD_H
@@ -0,0 +1,102 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/**
+ * @brief 有界无锁队列 - 单生产者，消费端基于 CAS
+ *
+ * 每个槽位带序号（Vyukov 有界队列），入队只由一个线程执行，不需要 CAS；
+ * 出队使用 CAS 推进头指针，因此除消费线程外，生产者也可以在队列满时
+ * 取出最旧元素丢弃（DropOldest 策略），而不破坏无锁性质。
+ * 容量向上取整到 2 的幂。
+ */
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(size_t capacity)
+    {
+        size_t rounded = 1;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        m_mask = rounded - 1;
+        m_slots = std::make_unique<Slot[]>(rounded);
+        for (size_t i = 0; i < rounded; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    // 仅生产者线程调用；队列满时返回 false，value 保持不变
+    bool tryPush(T &value)
+    {
+        const size_t pos = m_tail.load(std::memory_order_relaxed);
+        Slot &slot = m_slots[pos & m_mask];
+        if (slot.sequence.load(std::memory_order_acquire) != pos) {
+            return false;
+        }
+        slot.value = std::move(value);
+        slot.sequence.store(pos + 1, std::memory_order_release);
+        m_tail.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者线程调用；生产者在丢弃最旧元素时也可调用
+    bool tryPop(T &value)
+    {
+        size_t pos = m_head.load(std::memory_order_relaxed);
+        while (true) {
+            Slot &slot = m_slots[pos & m_mask];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+            if (diff == 0) {
+                if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = std::move(slot.value);
+                    slot.value = T();
+                    slot.sequence.store(pos + m_mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // 近似值，仅用于统计
+    size_t size() const
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    size_t capacity() const
+    {
+        return m_mask + 1;
+    }
+
+private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_mask = 0;
+
+    // 头尾指针分属不同缓存行，避免生产者与消费者互相失效
+    alignas(CACHE_LINE) std::atomic<size_t> m_head{0};
+    alignas(CACHE_LINE) std::atomic<size_t> m_tail{0};
+};
+
+#endif // SPSCQUEUE_H
@@ -0,0 +1,27 @@
+#ifndef STARTUPTIMER_H
+#define STARTUPTIMER_H
+
+#include <QStringList>
+#include <cstdint>
+
+/**
+ * @brief 启动耗时记录 - 从程序启动到首帧显示的各阶段时间点
+ *
+ * 起点是本文件的静态初始化时刻（早于 main，不含动态库加载）。
+ * 各阶段可在任意线程标记，报告按时间排序并给出相邻阶段的间隔；
+ * 同名阶段只记录第一次，例如"首帧显示"只在启动后第一帧时生效。
+ */
+class StartupTimer
+{
+public:
+    // phase 必须是字符串字面量（只保存指针）；返回 false 表示该阶段已记录过
+    static bool mark(const char *phase);
+
+    // 距起点的毫秒数
+    static double elapsedMs();
+
+    // "+123.4 ms  阶段 (+间隔)" 形式的报告
+    static QStringList report();
+};
+
+#endif // STARTUPTIMER_H
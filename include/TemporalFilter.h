@@ -0,0 +1,84 @@
+#ifndef TEMPORALFILTER_H
+#define TEMPORALFILTER_H
+
+#include <QObject>
+#include <atomic>
+#include <vector>
+#include "FrameStage.h"
+
+/**
+ * @brief 时域滤波阶段 - 多帧滚动平均与运行背景
+ *
+ * - Average: 最近 N 帧的滚动平均。累加器增量更新（加新帧、减最旧帧），
+ *   每帧开销与 N 无关；8 位数据用 16 位累加器，更高位深用 32 位累加器
+ * - Background: 输出指数滑动平均背景，bg += (v - bg) / 2^k，Q8 定点
+ * - Subtract: 输出 |v - bg|，并统计超过阈值的像素比例，用于简单的运动/缺陷检测
+ * 累加与背景更新使用 SSE2/AVX2 整数运算。
+ */
+class TemporalFilter : public QObject, public FrameStage
+{
+    Q_OBJECT
+
+public:
+    enum class Mode {
+        Off,
+        Average,
+        Background,
+        Subtract
+    };
+
+    static constexpr int MAX_AVERAGE_FRAMES = 64;
+
+    explicit TemporalFilter(QObject *parent = nullptr);
+
+    // 以下配置可在任意线程调用，修改模式或帧数会重置累加状态
+    void setMode(Mode mode);
+    Mode mode() const;
+    void setAverageFrames(int frames);
+    int averageFrames() const;
+    void setBackgroundShift(int shift);      // 背景时间常数 2^shift 帧 (1~10)
+    void setChangeThreshold(int threshold);  // Subtract 模式下的变化阈值（原始灰度）
+
+    // FrameStage 接口
+    const char *stageName() const override;
+    FramePtr process(FramePtr frame) override;
+
+    // 累加与背景内核
+    static void accumulate8(uint16_t *acc, const uint8_t *add, const uint8_t *sub, size_t count);
+    static void accumulate16(uint32_t *acc, const uint16_t *add, const uint16_t *sub, size_t count);
+    static void updateBackground8(int32_t *background, const uint8_t *pixels, size_t count, int shift);
+    static void updateBackground16(int32_t *background, const uint16_t *pixels, size_t count, int shift);
+
+Q_SIGNALS:
+    // Subtract 模式下约每 100ms 发出一次
+    void changeMeasured(double changedPercent);
+
+private:
+    void reset(const Frame &frame, Mode mode);
+    FramePtr averageFrame(FramePtr frame);
+    FramePtr backgroundFrame(FramePtr frame, bool subtract);
+
+    std::atomic<Mode> m_mode{Mode::Off};
+    std::atomic_int m_averageFrames{8};
+    std::atomic_int m_backgroundShift{4};
+    std::atomic_int m_changeThreshold{16};
+    std::atomic<uint64_t> m_settingsGeneration{0};
+
+    // 以下仅在管线线程访问
+    uint64_t m_appliedGeneration = ~0ull;
+    int m_width = 0;
+    int m_height = 0;
+    int m_bitDepth = 0;
+
+    std::vector<FramePtr> m_history;     // 环形缓冲，保存参与平均的帧
+    size_t m_historyHead = 0;
+    size_t m_historyCount = 0;
+    std::vector<uint16_t> m_accumulator16;
+    std::vector<uint32_t> m_accumulator32;
+
+    std::vector<int32_t> m_background;   // Q8 定点
+    bool m_backgroundValid = false;
+    int64_t m_lastReportNs = 0;
+};
+
+#endif // TEMPORALFILTER_H
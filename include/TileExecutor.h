@@ -0,0 +1,87 @@
+#ifndef TILEEXECUTOR_H
+#define TILEEXECUTOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 逐帧图像内核的分块并行执行器（工作窃取线程池）
+ *
+ * parallelFor() 把 [0, count) 按块切分（通常是行带），任务轮流放入各工作线程的本地队列；
+ * 线程先处理本地队列，空闲时从其他线程的队列头部窃取。调用线程也参与执行，
+ * 因此多个管线线程可以同时提交任务，嵌套调用也不会死锁。
+ * 帧较小时（只有一块）直接在调用线程上执行，没有调度开销。
+ */
+class TileExecutor
+{
+public:
+    using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+    static TileExecutor &instance();
+
+    ~TileExecutor();
+
+    // 参与执行的线程数（含调用线程）
+    int threadCount() const;
+
+    // 限制参与线程数，用于扩展性测试；0 表示不限制
+    void setThreadLimit(int threads);
+    int threadLimit() const;
+
+    // 按块执行 fn(begin, end)，全部完成后返回；块序号为 begin / grain
+    void parallelFor(size_t count, size_t grain, const RangeFunction &fn);
+
+    // 根据每项（通常是一行）的字节数选择块大小：每块约占 L2 的一半，
+    // 同时保证块数足够多以均衡负载
+    size_t autoGrain(size_t count, size_t bytesPerItem) const;
+
+    static size_t chunkCount(size_t count, size_t grain)
+    {
+        return grain ? (count + grain - 1) / grain : 0;
+    }
+
+private:
+    static constexpr size_t CHUNK_TARGET_BYTES = 256 * 1024;
+    static constexpr size_t CHUNKS_PER_THREAD = 4;
+
+    struct Job {
+        const RangeFunction *fn = nullptr;
+        std::atomic<size_t> remaining{0};
+    };
+
+    struct Task {
+        std::shared_ptr<Job> job;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    TileExecutor();
+    TileExecutor(const TileExecutor &) = delete;
+    TileExecutor &operator=(const TileExecutor &) = delete;
+
+    void workerLoop(int index);
+    bool popLocal(int index, Task &task);
+    bool steal(int thief, Task &task);
+    static void runTask(Task &task);
+    int activeWorkers() const;
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::atomic<int> m_threadLimit{0};
+    std::atomic<uint32_t> m_workEvent{0};
+    std::atomic<size_t> m_nextQueue{0};
+    std::atomic_bool m_running{true};
+};
+
+#endif // TILEEXECUTOR_H
@@ -0,0 +1,113 @@
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include <QString>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 逐帧延迟追踪 - 记录各阶段的时间区间，按需导出为 Chrome trace JSON（Perfetto 可直接打开）
+ *
+ * 每个线程第一次记录时分配自己的环形缓冲区（单写者，无锁），只有注册新线程时加锁；
+ * 线程退出后缓冲区保留到被新线程复用，短生命周期的工作线程不会让内存持续增长。
+ * 关闭时 record() 只有一次原子读。区间名必须是字符串字面量（只保存指针）。
+ * 时间统一为 steady_clock 纳秒；Aravis 的系统时间戳（实时时钟）用 fromRealtimeNs() 换算。
+ *
+ * 相机侧的区间（曝光结束→到达主机、到达→出队）不属于任何主机线程，
+ * 以 Track::Device 记录，导出时放在单独的"相机"轨道上。
+ */
+class TraceRecorder
+{
+public:
+    enum class Track : uint32_t {
+        CurrentThread,
+        Device
+    };
+
+    static constexpr size_t THREAD_CAPACITY = 16384;   // 每线程保留的最近区间数，2 的幂
+
+    static TraceRecorder &instance();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // 当前线程在导出文件中的名称，可在记录前后任意时刻调用
+    static void setThreadName(const char *name);
+
+    static int64_t nowNs();
+    static int64_t fromRealtimeNs(int64_t realtimeNs);
+
+    void record(const char *name, uint64_t frameId, int64_t beginNs, int64_t endNs,
+                Track track = Track::CurrentThread);
+
+    // 丢弃所有已记录的区间
+    void clear();
+
+    // 导出各线程环形缓冲区中现存的区间
+    bool exportChromeTrace(const QString &path, QString *error = nullptr) const;
+
+private:
+    struct Span {
+        const char *name;
+        uint64_t frameId;
+        int64_t beginNs;
+        int64_t endNs;
+        Track track;
+    };
+
+    struct ThreadBuffer {
+        std::unique_ptr<Span[]> spans{new Span[THREAD_CAPACITY]};
+        std::atomic<uint64_t> head{0};      // 已写入的区间总数，写者 release 发布
+        std::atomic<uint64_t> clearedAt{0}; // clear() 时的 head，导出时跳过其之前的区间
+        std::string name;
+        uint32_t tid = 0;
+        bool inUse = true;                  // 线程退出后置 false，由新线程复用
+    };
+    struct ThreadLease;
+
+    TraceRecorder() = default;
+    ThreadBuffer *threadBuffer();
+
+    static thread_local ThreadBuffer *t_buffer;
+    static thread_local const char *t_threadName;
+
+    std::atomic_bool m_enabled{false};
+
+    mutable std::mutex m_registryMutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> m_threads;
+};
+
+/**
+ * @brief 作用域区间：构造时计时，析构时记录；追踪关闭时不读时钟
+ */
+class TraceScope
+{
+public:
+    TraceScope(const char *name, uint64_t frameId)
+        : m_name(name)
+        , m_frameId(frameId)
+        , m_beginNs(TraceRecorder::instance().isEnabled() ? TraceRecorder::nowNs() : 0)
+    {
+    }
+
+    ~TraceScope()
+    {
+        if (m_beginNs != 0) {
+            TraceRecorder::instance().record(m_name, m_frameId, m_beginNs, TraceRecorder::nowNs());
+        }
+    }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    const char *m_name;
+    uint64_t m_frameId;
+    int64_t m_beginNs;
+};
+
+#endif // TRACERECORDER_H
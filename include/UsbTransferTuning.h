@@ -0,0 +1,53 @@
+#ifndef USBTRANSFERTUNING_H
+#define USBTRANSFERTUNING_H
+
+#include <QString>
+#include <QStringList>
+#include <cstdint>
+
+typedef struct _ArvCamera ArvCamera;
+typedef struct _ArvStream ArvStream;
+
+/**
+ * @brief USB3 Vision 流的传输设置，在创建流之前写入设备
+ *
+ * 同步模式每次只有一个 USB 传输在途，异步模式（Aravis 默认）多个传输排队，
+ * 主机负载高时异步模式更不容易因传输间隙丢帧。最大传输大小决定一帧拆成多少个 bulk 传输：
+ * 越大则每帧的传输次数和回调越少，但单次传输失败时损失的数据也越多。
+ */
+struct UsbTransferOptions {
+    enum class Mode {
+        Default,
+        Sync,
+        Async
+    };
+
+    Mode mode = Mode::Default;
+    int maximumTransferKB = 0;      // 0 表示 Aravis 默认（1 MB）
+};
+
+/**
+ * @brief USB3 Vision 传输调优 - USB 模式、最大传输大小和链路带宽限制
+ *
+ * 链路带宽限制使用相机的 DeviceLinkThroughputLimit（单位字节/秒），多台相机共用一个主控制器时
+ * 按各自份额限速可避免突发叠加。最大传输大小通过 ArvUvDevice 的 "maximum-transfer-size"
+ * 属性设置，所用 Aravis 版本没有该属性时报告为未生效。
+ */
+class UsbTransferTuning
+{
+public:
+    // 在 arv_camera_create_stream() 之前调用，applied/failed 追加实际生效情况
+    static void apply(ArvCamera *camera, const UsbTransferOptions &options, QStringList &applied, QStringList &failed);
+
+    // bytesPerSecond 为 0 表示关闭限制
+    static bool setLinkThroughputLimit(ArvCamera *camera, uint64_t bytesPerSecond, QString *error = nullptr);
+    static uint64_t linkThroughputLimit(ArvCamera *camera);
+    static bool linkThroughputLimitBounds(ArvCamera *camera, uint64_t &minimum, uint64_t &maximum);
+
+    // 流的全部统计项（"名称 = 值"），USB3 流包括完成/失败/欠载/中止的缓冲区数和传输字节数
+    static QStringList streamInfo(ArvStream *stream);
+
+    static const char *modeName(UsbTransferOptions::Mode mode);
+};
+
+#endif // USBTRANSFERTUNING_H
@@ -4,6 +4,8 @@
 #include <QWidget>
 #include <QImage>
 #include <QPainter>
+#include <QPolygonF>
+#include "HistogramEngine.h"
 
 class VideoWidget : public QWidget
 {
@@ -11,14 +13,47 @@ class VideoWidget : public QWidget
 public:
     explicit VideoWidget(QWidget *parent = nullptr);
 
-    void setFrame(const QImage &frame);
+    // frameId 仅用于延迟追踪（新帧首次绘制的等待和耗时）
+    void setFrame(const QImage &frame, uint64_t frameId = 0);
     void clear();
 
+    // 直方图/统计叠加层
+    void setStatistics(const FrameStatistics &stats);
+    void setOverlayVisible(bool visible);
+    bool isOverlayVisible() const;
+
+    // 用户框选区域（图像坐标），左键拖动框选，右键清除
+    QRect selectedRegion() const;
+    void clearSelectedRegion();
+
+Q_SIGNALS:
+    void regionSelected(const QRect &imageRegion);
+
 protected:
     void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
 
 private:
+    void drawStatisticsOverlay(QPainter &painter);
+    QPoint widgetToImage(const QPoint &pos) const;
+    QRect imageToWidget(const QRect &rect) const;
+
     QImage m_frame;
+    uint64_t m_frameId = 0;
+    int64_t m_frameSetNs = 0;       // 追踪开启时新帧到达的时间，首次绘制后清零
+
+    bool m_overlayVisible = true;
+    QPolygonF m_histogramCurve;   // 归一化到 [0,1] 的直方图折线，绘制时再缩放
+    QString m_statisticsText;
+
+    // 最近一次绘制时图像在控件中的位置，用于坐标映射
+    QRect m_imageRect;
+    QSize m_imageSize;
+    QRect m_selectedRegion;
+    QPoint m_dragStart;
+    bool m_dragging = false;
 };
 
 #endif
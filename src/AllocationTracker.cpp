@@ -0,0 +1,324 @@
+#include "AllocationTracker.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+namespace {
+
+constexpr int MAX_THREADS = 256;
+constexpr int MAX_RETIRED_NAMES = 64;
+constexpr const char *UNNAMED = "其他线程";
+
+// 每个存活线程独占一个槽，只有本线程写入；槽用完后的线程共用最后一个（溢出槽，不记名称、不回收）
+struct Slot {
+    std::atomic<bool> inUse{false};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> frees{0};
+};
+
+// 已退出线程的计数按名称合并保留，槽归还后可被新线程复用
+struct Retired {
+    const char *name = nullptr;     // nullptr 表示未命名线程
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    uint64_t frees = 0;
+};
+
+Slot g_slots[MAX_THREADS];
+Slot &g_overflowSlot = g_slots[MAX_THREADS - 1];
+
+std::mutex g_retireMutex;               // 保护 g_retired，并让归还与 snapshot() 互斥
+Retired g_retired[MAX_RETIRED_NAMES];   // [0] 固定为未命名线程
+int g_retiredCount = 1;
+
+thread_local Slot *t_slot = nullptr;
+thread_local bool t_exited = false;
+
+bool sameName(const char *a, const char *b)
+{
+    return a == b || (a && b && std::strcmp(a, b) == 0);
+}
+
+// 线程退出时把计数并入同名的 Retired 并归还槽；调用方持有 g_retireMutex
+void retireLocked(Slot &slot)
+{
+    const char *name = slot.name.load(std::memory_order_relaxed);
+    Retired *target = nullptr;
+    for (int i = 0; i < g_retiredCount && !target; ++i) {
+        if (sameName(g_retired[i].name, name)) {
+            target = &g_retired[i];
+        }
+    }
+    if (!target && g_retiredCount < MAX_RETIRED_NAMES) {
+        target = &g_retired[g_retiredCount++];
+        target->name = name;
+    }
+    if (!target) {
+        // 名称表满时并入未命名线程
+        target = &g_retired[0];
+    }
+    target->allocations += slot.allocations.exchange(0, std::memory_order_relaxed);
+    target->bytes += slot.bytes.exchange(0, std::memory_order_relaxed);
+    target->frees += slot.frees.exchange(0, std::memory_order_relaxed);
+    slot.name.store(nullptr, std::memory_order_relaxed);
+    slot.inUse.store(false, std::memory_order_release);
+}
+
+// thread_local 析构在线程退出时归还槽
+struct SlotGuard {
+    bool armed = false;
+    ~SlotGuard()
+    {
+        if (t_slot && t_slot != &g_overflowSlot) {
+            std::lock_guard<std::mutex> lock(g_retireMutex);
+            retireLocked(*t_slot);
+        }
+        t_slot = nullptr;
+        t_exited = true;
+    }
+};
+
+thread_local SlotGuard t_guard;
+
+// 钩子内不能经 operator new 分配内存：槽是静态数组，thread_local 只有指针和标志
+Slot *threadSlot()
+{
+    if (t_slot) {
+        return t_slot;
+    }
+    // 其他 thread_local 析构时仍可能分配：记到溢出槽
+    if (t_exited) {
+        return &g_overflowSlot;
+    }
+
+    for (int i = 0; i < MAX_THREADS - 1; ++i) {
+        bool expected = false;
+        if (g_slots[i].inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            t_slot = &g_slots[i];
+            break;
+        }
+    }
+    if (!t_slot) {
+        t_slot = &g_overflowSlot;
+    }
+    t_guard.armed = true;   // 首次访问时注册析构
+    return t_slot;
+}
+
+} // namespace
+
+bool AllocationTracker::isEnabled()
+{
+#ifdef ARAVIS_TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void AllocationTracker::setThreadName(const char *name)
+{
+#ifdef ARAVIS_TRACK_ALLOCATIONS
+    Slot *slot = threadSlot();
+    // 共用的溢出槽不记名称
+    if (slot != &g_overflowSlot) {
+        slot->name.store(name, std::memory_order_release);
+    }
+#else
+    (void)name;
+#endif
+}
+
+AllocationTracker::Counters AllocationTracker::thisThread()
+{
+    Counters counters;
+#ifdef ARAVIS_TRACK_ALLOCATIONS
+    const Slot *slot = threadSlot();
+    counters.allocations = slot->allocations.load(std::memory_order_relaxed);
+    counters.bytes = slot->bytes.load(std::memory_order_relaxed);
+    counters.frees = slot->frees.load(std::memory_order_relaxed);
+#endif
+    return counters;
+}
+
+std::vector<AllocationTracker::ThreadCounters> AllocationTracker::snapshot()
+{
+    std::vector<ThreadCounters> result;
+#ifdef ARAVIS_TRACK_ALLOCATIONS
+    auto accumulate = [&result](const char *name, uint64_t allocations, uint64_t bytes, uint64_t frees) {
+        const std::string key = name ? name : UNNAMED;
+        auto it = std::find_if(result.begin(), result.end(),
+                               [&key](const ThreadCounters &entry) { return entry.name == key; });
+        if (it == result.end()) {
+            result.push_back(ThreadCounters{key, Counters{}});
+            it = result.end() - 1;
+        }
+        it->counters.allocations += allocations;
+        it->counters.bytes += bytes;
+        it->counters.frees += frees;
+    };
+
+    // 持锁期间没有线程归还槽，已退出和存活的线程不会重复或遗漏
+    std::lock_guard<std::mutex> lock(g_retireMutex);
+    for (int i = 0; i < g_retiredCount; ++i) {
+        const Retired &retired = g_retired[i];
+        accumulate(retired.name, retired.allocations, retired.bytes, retired.frees);
+    }
+    for (int i = 0; i < MAX_THREADS; ++i) {
+        const Slot &slot = g_slots[i];
+        if (!slot.inUse.load(std::memory_order_acquire) && &slot != &g_overflowSlot) {
+            continue;
+        }
+        accumulate(slot.name.load(std::memory_order_acquire), slot.allocations.load(std::memory_order_relaxed),
+                   slot.bytes.load(std::memory_order_relaxed), slot.frees.load(std::memory_order_relaxed));
+    }
+#endif
+    return result;
+}
+
+std::vector<AllocationTracker::ThreadCounters> AllocationTracker::difference(
+    const std::vector<ThreadCounters> &before, const std::vector<ThreadCounters> &after)
+{
+    std::vector<ThreadCounters> result;
+    for (const ThreadCounters &entry : after) {
+        Counters delta = entry.counters;
+        auto it = std::find_if(before.begin(), before.end(),
+                               [&entry](const ThreadCounters &previous) { return previous.name == entry.name; });
+        if (it != before.end()) {
+            delta.allocations -= it->counters.allocations;
+            delta.bytes -= it->counters.bytes;
+            delta.frees -= it->counters.frees;
+        }
+        if (delta.allocations > 0) {
+            result.push_back(ThreadCounters{entry.name, delta});
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const ThreadCounters &a, const ThreadCounters &b) {
+        return a.counters.allocations > b.counters.allocations;
+    });
+    return result;
+}
+
+void AllocationTracker::recordAllocation(size_t bytes)
+{
+    Slot *slot = threadSlot();
+    slot->allocations.fetch_add(1, std::memory_order_relaxed);
+    slot->bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void AllocationTracker::recordFree()
+{
+    threadSlot()->frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+#ifdef ARAVIS_TRACK_ALLOCATIONS
+
+// ========== 全局 operator new/delete 替换 ==========
+
+namespace {
+
+void *allocate(size_t bytes)
+{
+    AllocationTracker::recordAllocation(bytes);
+    return std::malloc(bytes ? bytes : 1);
+}
+
+void *allocateAligned(size_t bytes, std::align_val_t alignment)
+{
+    AllocationTracker::recordAllocation(bytes);
+    const size_t align = static_cast<size_t>(alignment);
+#ifdef _WIN32
+    return _aligned_malloc(bytes ? bytes : 1, align);
+#else
+    // aligned_alloc 要求大小是对齐的整数倍
+    return std::aligned_alloc(align, ((bytes ? bytes : 1) + align - 1) / align * align);
+#endif
+}
+
+void release(void *pointer)
+{
+    if (pointer) {
+        AllocationTracker::recordFree();
+        std::free(pointer);
+    }
+}
+
+void releaseAligned(void *pointer)
+{
+    if (pointer) {
+        AllocationTracker::recordFree();
+#ifdef _WIN32
+        _aligned_free(pointer);
+#else
+        std::free(pointer);
+#endif
+    }
+}
+
+} // namespace
+
+void *operator new(size_t bytes)
+{
+    if (void *pointer = allocate(bytes)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t bytes)
+{
+    return operator new(bytes);
+}
+
+void *operator new(size_t bytes, const std::nothrow_t &) noexcept
+{
+    return allocate(bytes);
+}
+
+void *operator new[](size_t bytes, const std::nothrow_t &) noexcept
+{
+    return allocate(bytes);
+}
+
+void *operator new(size_t bytes, std::align_val_t alignment)
+{
+    if (void *pointer = allocateAligned(bytes, alignment)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t bytes, std::align_val_t alignment)
+{
+    return operator new(bytes, alignment);
+}
+
+void *operator new(size_t bytes, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return allocateAligned(bytes, alignment);
+}
+
+void *operator new[](size_t bytes, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return allocateAligned(bytes, alignment);
+}
+
+void operator delete(void *pointer) noexcept { release(pointer); }
+void operator delete[](void *pointer) noexcept { release(pointer); }
+void operator delete(void *pointer, size_t) noexcept { release(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { release(pointer); }
+void operator delete(void *pointer, const std::nothrow_t &) noexcept { release(pointer); }
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept { release(pointer); }
+void operator delete(void *pointer, std::align_val_t) noexcept { releaseAligned(pointer); }
+void operator delete[](void *pointer, std::align_val_t) noexcept { releaseAligned(pointer); }
+void operator delete(void *pointer, size_t, std::align_val_t) noexcept { releaseAligned(pointer); }
+void operator delete[](void *pointer, size_t, std::align_val_t) noexcept { releaseAligned(pointer); }
+void operator delete(void *pointer, std::align_val_t, const std::nothrow_t &) noexcept { releaseAligned(pointer); }
+void operator delete[](void *pointer, std::align_val_t, const std::nothrow_t &) noexcept { releaseAligned(pointer); }
+
+#endif // ARAVIS_TRACK_ALLOCATIONS
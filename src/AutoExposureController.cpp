@@ -0,0 +1,160 @@
+#include "AutoExposureController.h"
+#include "CameraController.h"
+#include <QDebug>
+#include <QMetaObject>
+#include <algorithm>
+#include <cmath>
+
+AutoExposureController::AutoExposureController(CameraController *camera, QObject *parent)
+    : QObject(parent)
+    , m_camera(camera)
+{
+}
+
+bool AutoExposureController::enable()
+{
+    if (!m_camera->isConnected()) {
+        return false;
+    }
+
+    if (!m_camera->getExposureTimeBounds(m_exposureMin, m_exposureMax) ||
+        !m_camera->getGainBounds(m_gainMin, m_gainMax)) {
+        qWarning() << "自动曝光: 无法读取曝光/增益范围";
+        return false;
+    }
+
+    m_exposure = std::clamp(m_camera->getExposureTime(), m_exposureMin, m_exposureMax);
+    m_gain = std::clamp(m_camera->getGain(), m_gainMin, m_gainMax);
+
+    // 同步接口会关闭相机内置的自动曝光/自动增益
+    if (!m_camera->setExposureTime(m_exposure)) {
+        return false;
+    }
+    m_camera->setGain(m_gain);
+
+    m_framesToSkip = 0;
+    m_converged = false;
+    m_enabled = true;
+
+    qDebug() << "自动曝光启用: 曝光" << m_exposure << "μs 增益" << m_gain << "dB";
+    return true;
+}
+
+void AutoExposureController::disable()
+{
+    m_enabled = false;
+}
+
+bool AutoExposureController::isEnabled() const
+{
+    return m_enabled;
+}
+
+void AutoExposureController::setSettings(const Settings &settings)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_settings = settings;
+    m_settings.damping = std::clamp(m_settings.damping, 0.05, 1.0);
+    m_settings.target = std::clamp(m_settings.target, 0.01, 0.99);
+    m_settings.percentile = std::clamp(m_settings.percentile, 0.0, 1.0);
+}
+
+AutoExposureController::Settings AutoExposureController::settings() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_settings;
+}
+
+void AutoExposureController::setFrameRate(double fps)
+{
+    m_frameRate = fps;
+}
+
+void AutoExposureController::process(const FrameStatistics &stats)
+{
+    if (!m_enabled || !stats.isValid()) {
+        return;
+    }
+
+    // 帧带有实际曝光时直接以其为基准，无需等待固定的生效延迟
+    const bool hasChunkExposure = stats.chunk.has(FrameChunkData::ExposureTime);
+
+    // 上次写入的参数尚未作用到这一帧
+    if (!hasChunkExposure && m_framesToSkip > 0) {
+        --m_framesToSkip;
+        return;
+    }
+
+    const Settings s = settings();
+    const double fullScale = stats.fullScale();
+
+    double measured = s.mode == MeteringMode::Mean
+                          ? stats.mean
+                          : static_cast<double>(stats.percentile(s.percentile));
+    measured = std::max(measured, 1.0);
+
+    // 亮度比例限制在 [1/8, 8]，避免单步跨度过大导致振荡
+    double ratio = std::clamp(s.target * fullScale / measured, 0.125, 8.0);
+    if (stats.saturationPercent > s.maxSaturation) {
+        ratio = std::min(ratio, 0.5);
+    }
+
+    const bool converged = std::abs(ratio - 1.0) <= s.tolerance;
+    if (converged != m_converged) {
+        m_converged = converged;
+        QMetaObject::invokeMethod(this, [this, converged]() {
+            emit convergedChanged(converged);
+        }, Qt::QueuedConnection);
+    }
+    if (converged) {
+        return;
+    }
+
+    // 对数域阻尼: 总亮度 = 曝光 × 线性增益
+    const double frameExposure = hasChunkExposure ? stats.chunk.exposureUs : m_exposure;
+    const double frameGain = stats.chunk.has(FrameChunkData::Gain) ? stats.chunk.gainDb : m_gain;
+    const double currentBrightness = frameExposure * std::pow(10.0, frameGain / 20.0);
+    const double desiredBrightness = currentBrightness * std::exp(s.damping * std::log(ratio));
+
+    double exposureLimit = m_exposureMax;
+    if (s.maxExposureUs > 0.0) {
+        exposureLimit = std::clamp(s.maxExposureUs, m_exposureMin, m_exposureMax);
+    }
+    // 曝光超过帧周期会拉低帧率，此时改为加增益
+    const double frameRate = m_frameRate.load();
+    if (frameRate > 0.0) {
+        exposureLimit = std::max(std::min(exposureLimit, 1e6 / frameRate), m_exposureMin);
+    }
+
+    const double gainMinLinear = std::pow(10.0, m_gainMin / 20.0);
+    double exposure = desiredBrightness / gainMinLinear;
+    double gain = m_gainMin;
+    if (exposure > exposureLimit) {
+        exposure = exposureLimit;
+        gain = std::clamp(20.0 * std::log10(desiredBrightness / exposureLimit), m_gainMin, m_gainMax);
+    }
+    exposure = std::max(exposure, m_exposureMin);
+
+    bool written = false;
+    if (std::abs(exposure - m_exposure) > 0.5) {
+        m_exposure = exposure;
+        m_camera->setExposureTimeAsync(exposure);
+        written = true;
+    }
+    if (std::abs(gain - m_gain) > 0.01) {
+        m_gain = gain;
+        m_camera->setGainAsync(gain);
+        written = true;
+    }
+
+    if (!written) {
+        // 已到达范围边界，无法继续逼近
+        return;
+    }
+
+    m_framesToSkip = std::max(s.latencyFrames, 0);
+
+    QMetaObject::invokeMethod(this, [this, exposure = m_exposure, gain = m_gain]() {
+        emit exposureAdjusted(exposure, gain);
+    }, Qt::QueuedConnection);
+}
@@ -0,0 +1,333 @@
+#include "BurstRecorder.h"
+#include "ChunkDecoder.h"
+#include <QDebug>
+#include <QDir>
+#include <QMetaObject>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+namespace {
+
+int64_t steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+BurstRecorder::BurstRecorder(QObject *parent)
+    : QObject(parent)
+{
+}
+
+BurstRecorder::~BurstRecorder()
+{
+    if (m_saveThread.joinable()) {
+        m_saveThread.join();
+    }
+}
+
+bool BurstRecorder::arm(int frameCount, int width, int height, int bitDepth, QString *error)
+{
+    if (m_saving) {
+        if (error) {
+            *error = "正在保存上一次连拍";
+        }
+        return false;
+    }
+    if (frameCount <= 0 || width <= 0 || height <= 0) {
+        if (error) {
+            *error = "连拍参数无效";
+        }
+        return false;
+    }
+
+    if (isArmed()) {
+        if (error) {
+            *error = "连拍正在进行";
+        }
+        return false;
+    }
+
+    // 保证采集线程不再访问旧内存
+    disarmAndWait();
+
+    const size_t frameBytes = static_cast<size_t>(width) * height * (bitDepth > 8 ? 2 : 1);
+    const size_t totalBytes = frameBytes * static_cast<size_t>(frameCount);
+
+    if (totalBytes != m_frameBytes * m_meta.size() || !m_arena) {
+        m_arena.reset();
+        m_arena.reset(new (std::nothrow) uint8_t[totalBytes]);
+        if (!m_arena) {
+            m_meta.clear();
+            m_frameBytes = 0;
+            if (error) {
+                *error = QString("无法分配 %1 MB 连拍内存").arg(totalBytes / (1024.0 * 1024.0), 0, 'f', 0);
+            }
+            return false;
+        }
+        // 预先触碰所有页面，避免采集时发生缺页
+        std::memset(m_arena.get(), 0, totalBytes);
+    }
+
+    m_meta.assign(frameCount, FrameMeta{});
+    m_frameBytes = frameBytes;
+    m_width = width;
+    m_height = height;
+    m_bitDepth = bitDepth;
+    m_requested = frameCount;
+    m_captured = 0;
+    m_missing = 0;
+    m_progressReportNs = 0;
+
+    m_state.store(State::Armed, std::memory_order_release);
+    qDebug() << "连拍已布防:" << frameCount << "帧," << totalBytes / (1024 * 1024) << "MB";
+    return true;
+}
+
+void BurstRecorder::cancel()
+{
+    State expected = State::Armed;
+    if (m_state.compare_exchange_strong(expected, State::Complete)) {
+        const int captured = m_captured;
+        emit burstFinished(captured, m_missing, captureFps());
+    }
+}
+
+void BurstRecorder::release()
+{
+    if (m_saving) {
+        return;
+    }
+    disarmAndWait();
+    m_arena.reset();
+    m_meta.clear();
+    m_frameBytes = 0;
+    m_requested = 0;
+    m_captured = 0;
+}
+
+BurstRecorder::State BurstRecorder::state() const
+{
+    return m_state.load(std::memory_order_acquire);
+}
+
+bool BurstRecorder::isArmed() const
+{
+    return m_state.load(std::memory_order_acquire) == State::Armed;
+}
+
+void BurstRecorder::disarmAndWait()
+{
+    m_state = State::Idle;
+    while (m_storing) {
+        std::this_thread::yield();
+    }
+}
+
+bool BurstRecorder::store(const Frame &header, const uint8_t *data)
+{
+    if (!isArmed()) {
+        return false;
+    }
+
+    // 与 disarmAndWait 配对：先声明正在写入，再确认仍处于布防状态
+    m_storing = true;
+    struct StoringGuard {
+        std::atomic_bool &flag;
+        ~StoringGuard() { flag.store(false, std::memory_order_release); }
+    } guard{m_storing};
+
+    if (m_state != State::Armed
+        || header.width != m_width || header.height != m_height || header.bitDepth != m_bitDepth) {
+        return false;
+    }
+
+    const int index = m_captured.load(std::memory_order_relaxed);
+    std::memcpy(m_arena.get() + static_cast<size_t>(index) * m_frameBytes, data, m_frameBytes);
+
+    FrameMeta &meta = m_meta[index];
+    meta.pixelFormat = header.pixelFormat;
+    meta.offsetX = header.offsetX;
+    meta.offsetY = header.offsetY;
+    meta.frameId = header.frameId;
+    meta.timestampNs = header.timestampNs;
+    meta.systemTimestampNs = header.systemTimestampNs;
+    meta.chunk = header.chunk;
+
+    if (index > 0) {
+        const uint64_t previous = m_meta[index - 1].frameId;
+        if (header.frameId > previous + 1) {
+            m_missing.fetch_add(header.frameId - previous - 1, std::memory_order_relaxed);
+        }
+    }
+
+    const int captured = index + 1;
+    m_captured.store(captured, std::memory_order_release);
+
+    if (captured == m_requested) {
+        State expected = State::Armed;
+        if (m_state.compare_exchange_strong(expected, State::Complete, std::memory_order_acq_rel)) {
+            const uint64_t missing = m_missing;
+            const double fps = captureFps();
+            QMetaObject::invokeMethod(this, [this, captured, missing, fps]() {
+                emit burstFinished(captured, missing, fps);
+            }, Qt::QueuedConnection);
+        }
+        return true;
+    }
+
+    const int64_t now = steadyNowNs();
+    if (now - m_progressReportNs >= 100'000'000) {
+        m_progressReportNs = now;
+        const int total = m_requested;
+        QMetaObject::invokeMethod(this, [this, captured, total]() {
+            emit burstProgress(captured, total);
+        }, Qt::QueuedConnection);
+    }
+    return true;
+}
+
+int BurstRecorder::capturedFrames() const
+{
+    return m_captured.load(std::memory_order_acquire);
+}
+
+int BurstRecorder::requestedFrames() const
+{
+    return m_requested;
+}
+
+uint64_t BurstRecorder::missingFrames() const
+{
+    return m_missing;
+}
+
+double BurstRecorder::captureFps() const
+{
+    const int captured = m_captured.load(std::memory_order_acquire);
+    if (captured < 2) {
+        return 0.0;
+    }
+    // 优先使用设备时间戳，不可用时退回主机时间戳
+    uint64_t first = m_meta.front().timestampNs;
+    uint64_t last = m_meta[captured - 1].timestampNs;
+    if (last <= first) {
+        first = m_meta.front().systemTimestampNs;
+        last = m_meta[captured - 1].systemTimestampNs;
+    }
+    return last > first ? (captured - 1) * 1e9 / static_cast<double>(last - first) : 0.0;
+}
+
+FramePtr BurstRecorder::frameAt(int index) const
+{
+    if (state() != State::Complete || index < 0 || index >= m_captured) {
+        return nullptr;
+    }
+
+    const FrameMeta &meta = m_meta[index];
+    auto frame = std::make_shared<Frame>();
+    frame->width = m_width;
+    frame->height = m_height;
+    frame->offsetX = meta.offsetX;
+    frame->offsetY = meta.offsetY;
+    frame->bitDepth = m_bitDepth;
+    frame->pixelFormat = meta.pixelFormat;
+    frame->frameId = meta.frameId;
+    frame->timestampNs = meta.timestampNs;
+    frame->systemTimestampNs = meta.systemTimestampNs;
+    frame->chunk = meta.chunk;
+    const uint8_t *source = m_arena.get() + static_cast<size_t>(index) * m_frameBytes;
+    frame->data.assign(source, source + m_frameBytes);
+    return frame;
+}
+
+bool BurstRecorder::saveAsync(const QString &directory)
+{
+    if (state() != State::Complete || m_captured == 0 || m_saving) {
+        return false;
+    }
+    if (m_saveThread.joinable()) {
+        m_saveThread.join();
+    }
+
+    m_saving = true;
+    m_saveThread = std::thread(&BurstRecorder::saveLoop, this, directory);
+    return true;
+}
+
+bool BurstRecorder::isSaving() const
+{
+    return m_saving;
+}
+
+void BurstRecorder::saveLoop(QString directory)
+{
+    auto finish = [this](bool success, const QString &message) {
+        m_saving = false;
+        QMetaObject::invokeMethod(this, [this, success, message]() {
+            emit saveFinished(success, message);
+        }, Qt::QueuedConnection);
+    };
+
+    QDir dir(directory);
+    if (!dir.exists() && !dir.mkpath(".")) {
+        finish(false, QString("无法创建目录: %1").arg(directory));
+        return;
+    }
+
+    const QByteArray indexPath = dir.filePath("burst_index.csv").toLocal8Bit();
+    FILE *index = std::fopen(indexPath.constData(), "w");
+    if (!index) {
+        finish(false, QString("无法写入: %1").arg(QString::fromLocal8Bit(indexPath)));
+        return;
+    }
+    std::fprintf(index, "index,frame_id,timestamp_ns,system_timestamp_ns,offset_x,offset_y,%s",
+                 ChunkDecoder::csvHeader());
+
+    // PGM: 8 位直接写入，高位深按规范写成大端 16 位
+    const int maxValue = (1 << m_bitDepth) - 1;
+    const int captured = m_captured;
+    std::vector<uint8_t> bigEndian(m_bitDepth > 8 ? m_frameBytes : 0);
+
+    for (int i = 0; i < captured; ++i) {
+        const FrameMeta &meta = m_meta[i];
+        std::fprintf(index, "%d,%llu,%llu,%llu,%d,%d,", i,
+                     static_cast<unsigned long long>(meta.frameId),
+                     static_cast<unsigned long long>(meta.timestampNs),
+                     static_cast<unsigned long long>(meta.systemTimestampNs),
+                     meta.offsetX, meta.offsetY);
+        ChunkDecoder::writeCsvColumns(index, meta.chunk);
+
+        const QByteArray path = dir.filePath(QString("burst_%1.pgm").arg(i, 5, 10, QChar('0'))).toLocal8Bit();
+        FILE *file = std::fopen(path.constData(), "wb");
+        if (!file) {
+            std::fclose(index);
+            finish(false, QString("无法写入: %1").arg(QString::fromLocal8Bit(path)));
+            return;
+        }
+
+        std::fprintf(file, "P5\n%d %d\n%d\n", m_width, m_height, maxValue);
+        const uint8_t *pixels = m_arena.get() + static_cast<size_t>(i) * m_frameBytes;
+        if (m_bitDepth > 8) {
+            for (size_t p = 0; p < m_frameBytes; p += 2) {
+                bigEndian[p] = pixels[p + 1];
+                bigEndian[p + 1] = pixels[p];
+            }
+            pixels = bigEndian.data();
+        }
+        const bool written = std::fwrite(pixels, 1, m_frameBytes, file) == m_frameBytes;
+        std::fclose(file);
+        if (!written) {
+            std::fclose(index);
+            finish(false, QString("写入失败: %1").arg(QString::fromLocal8Bit(path)));
+            return;
+        }
+    }
+
+    std::fclose(index);
+    finish(true, QString("已保存 %1 帧到 %2").arg(captured).arg(directory));
+}
@@ -1,29 +1,184 @@
 #include "CameraController.h"
+#include "FrameAnalyzer.h"
+#include "AutoExposureController.h"
+#include "FlatFieldCorrector.h"
+#include "TemporalFilter.h"
+#include "HdrFusion.h"
+#include "DisplayConverter.h"
+#include "BurstRecorder.h"
+#include "ImageSaveService.h"
+#include "PreviewStreamServer.h"
+#include "FrameDropMonitor.h"
+#include "TraceRecorder.h"
+#include "StartupTimer.h"
 #include <QDebug>
 #include <QMetaObject>
+#include <QStringList>
+#include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+namespace {
+
+// 处理管线每个阶段的输入队列容量
+constexpr size_t PIPELINE_QUEUE_CAPACITY = 4;
+constexpr size_t PIPELINE_STAGES = 3;
+
+// 采集线程、各阶段处理中、分析/预览/显示各自持有的帧
+constexpr size_t FRAME_POOL_HELD_FRAMES = 8;
+
+// 帧池保留的空闲帧上限：管线队列 + 时域平均历史的最大值 + 各处持有的帧，
+// 借出峰值内的帧归还后都留在池中，不会释放后再新建
+constexpr size_t FRAME_POOL_MAX_FREE = PIPELINE_STAGES * PIPELINE_QUEUE_CAPACITY
+                                       + TemporalFilter::MAX_AVERAGE_FRAMES + FRAME_POOL_HELD_FRAMES;
+
+// "采集线程 0, 管线输出 3.0, ..."：每帧平均分配次数，按次数从多到少
+QString formatAllocationsPerFrame(const std::vector<AllocationTracker::ThreadCounters> &threads, uint64_t frames)
+{
+    QStringList parts;
+    for (const AllocationTracker::ThreadCounters &thread : threads) {
+        parts << QString("%1 %2").arg(QString::fromStdString(thread.name))
+                     .arg(static_cast<double>(thread.counters.allocations) / frames, 0, 'f', 2);
+    }
+    return parts.isEmpty() ? QString("全部为 0") : parts.join(", ");
+}
+
+} // namespace
 
 CameraController::CameraController(QObject *parent)
     : QObject(parent)
     , m_camera(nullptr)
     , m_stream(nullptr)
     , m_fpsTimer(new QTimer(this))
+    , m_frameAnalyzer(new FrameAnalyzer(this))
+    , m_autoExposure(new AutoExposureController(this, this))
+    , m_flatField(new FlatFieldCorrector(this))
+    , m_temporalFilter(new TemporalFilter(this))
+    , m_hdrFusion(new HdrFusion(this))
+    , m_burstRecorder(new BurstRecorder(this))
+    , m_imageSaver(new ImageSaveService(this))
+    , m_streamServer(new PreviewStreamServer(this))
+    , m_dropMonitor(new FrameDropMonitor(this))
+    , m_framePool(FRAME_POOL_MAX_FREE)
     , m_isConnected(false)
     , m_isAcquiring(false)
     , m_frameCount(0)
     , m_currentFPS(0.0)
-    , m_arvReceivedCount(0)
-    , m_arvSuccessCount(0)
 {
     connect(m_fpsTimer, &QTimer::timeout,
             this, &CameraController::updateFPS);
+
+    connect(m_burstRecorder, &BurstRecorder::burstFinished,
+            this, &CameraController::onBurstFinished);
+
+    m_frameAnalyzer->setAutoExposureController(m_autoExposure);
+
+    FramePipeline::StageOptions stageOptions;
+    stageOptions.queueCapacity = PIPELINE_QUEUE_CAPACITY;
+    m_pipeline.addStage(m_flatField, stageOptions);
+    m_pipeline.addStage(m_hdrFusion, stageOptions);
+    m_pipeline.addStage(m_temporalFilter, stageOptions);
+    m_pipeline.setSink([this](const FramePtr &frame) {
+        publishFrame(frame);
+    });
 }
 
 CameraController::~CameraController()
 {
+    if (m_probeThread.joinable()) {
+        m_probeThread.join();
+    }
+    releaseProbedCamera();
     cleanupResources();
 }
 
+void CameraController::startDeviceProbe(const QString &preferredId)
+{
+    if (m_probeThread.joinable()) {
+        return;
+    }
+    m_probeThread = std::thread(&CameraController::probeDevices, this, preferredId);
+}
+
+bool CameraController::isProbing() const
+{
+    return m_probeThread.joinable();
+}
+
+void CameraController::probeDevices(const QString &preferredId)
+{
+    TraceRecorder::setThreadName("设备探测线程");
+    const int64_t beginNs = TraceRecorder::nowNs();
+
+    // 先打开上次的相机：GigE 发现要等待超时，不让它推迟首帧
+    if (!preferredId.isEmpty()) {
+        GError *error = nullptr;
+        ArvCamera *camera = arv_camera_new(preferredId.toUtf8().constData(), &error);
+        if (camera && !error) {
+            arv_camera_stop_acquisition(camera, &error);
+            g_clear_error(&error);
+            {
+                std::lock_guard<std::mutex> lock(m_probeMutex);
+                m_probedCamera = camera;
+                m_probedCameraId = preferredId;
+                m_probedStoppedNs = TraceRecorder::nowNs();
+            }
+            StartupTimer::mark("预先打开相机");
+            QMetaObject::invokeMethod(this, [this, preferredId]() {
+                emit preferredCameraOpened(preferredId);
+            }, Qt::QueuedConnection);
+        } else {
+            qDebug() << "预先打开相机失败:" << preferredId << (error ? error->message : "");
+            g_clear_error(&error);
+            g_clear_object(&camera);
+        }
+    }
+
+    arv_update_device_list();
+    QVector<CameraDeviceInfo> devices;
+    const unsigned int count = arv_get_n_devices();
+    for (unsigned int i = 0; i < count; ++i) {
+        CameraDeviceInfo info;
+        info.id = QString::fromUtf8(arv_get_device_id(i));
+        info.vendor = QString::fromUtf8(arv_get_device_vendor(i));
+        info.model = QString::fromUtf8(arv_get_device_model(i));
+        info.serial = QString::fromUtf8(arv_get_device_serial_nbr(i));
+        info.protocol = QString::fromUtf8(arv_get_device_protocol(i));
+        devices.push_back(info);
+    }
+    StartupTimer::mark("设备枚举完成");
+
+    const double elapsedMs = (TraceRecorder::nowNs() - beginNs) / 1e6;
+    QMetaObject::invokeMethod(this, [this, devices, elapsedMs]() {
+        if (m_probeThread.joinable()) {
+            m_probeThread.join();
+        }
+        emit devicesEnumerated(devices, elapsedMs);
+    }, Qt::QueuedConnection);
+}
+
+ArvCamera *CameraController::takeProbedCamera(const QString &cameraId, int64_t &stoppedNs)
+{
+    std::lock_guard<std::mutex> lock(m_probeMutex);
+    if (!m_probedCamera || cameraId != m_probedCameraId) {
+        return nullptr;
+    }
+    ArvCamera *camera = m_probedCamera;
+    m_probedCamera = nullptr;
+    m_probedCameraId.clear();
+    stoppedNs = m_probedStoppedNs;
+    return camera;
+}
+
+void CameraController::releaseProbedCamera()
+{
+    std::lock_guard<std::mutex> lock(m_probeMutex);
+    g_clear_object(&m_probedCamera);
+    m_probedCameraId.clear();
+}
+
 bool CameraController::connectCamera(const QString &cameraId)
 {
     if (m_isConnected) {
@@ -31,38 +186,61 @@ bool CameraController::connectCamera(const QString &cameraId)
         return false;
     }
 
-    GError *error = nullptr;
-
-    if (cameraId.isEmpty()) {
-        m_camera = arv_camera_new(nullptr, &error);
+    // 探测线程已打开并停止了同一台相机：直接接管，只补足剩余的稳定等待
+    int64_t stoppedNs = 0;
+    m_camera = cameraId.isEmpty() ? nullptr : takeProbedCamera(cameraId, stoppedNs);
+    if (m_camera) {
+        const int64_t settleNs = static_cast<int64_t>(CAMERA_SETTLE_MS) * 1000000 - (TraceRecorder::nowNs() - stoppedNs);
+        if (settleNs > 0) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(settleNs));
+        }
     } else {
-        m_camera = arv_camera_new(cameraId.toUtf8().constData(), &error);
-    }
+        // 打开设备会更新 Aravis 的设备列表，不能与探测线程同时进行
+        if (m_probeThread.joinable()) {
+            qDebug() << "等待后台设备探测结束";
+            m_probeThread.join();
+        }
+        releaseProbedCamera();
 
-    if (!m_camera || error) {
-        QString errorMsg = error ? QString::fromUtf8(error->message) : "未找到相机";
-        if (error) g_error_free(error);
-        emit errorOccurred(QString("相机连接失败: %1").arg(errorMsg));
-        return false;
+        GError *error = nullptr;
+
+        if (cameraId.isEmpty()) {
+            m_camera = arv_camera_new(nullptr, &error);
+        } else {
+            m_camera = arv_camera_new(cameraId.toUtf8().constData(), &error);
+        }
+
+        if (!m_camera || error) {
+            QString errorMsg = error ? QString::fromUtf8(error->message) : "未找到相机";
+            if (error) g_error_free(error);
+            g_clear_object(&m_camera);
+            emit errorOccurred(QString("相机连接失败: %1").arg(errorMsg));
+            return false;
+        }
+
+        // 确保相机处于停止状态
+        GError *stopError = nullptr;
+        arv_camera_stop_acquisition(m_camera, &stopError);
+        if (stopError) {
+            // 如果相机本来就是停止状态，这个错误可以忽略
+            qDebug() << "停止采集(如果有):" << stopError->message;
+            g_error_free(stopError);
+        }
+
+        // 等待一下让相机稳定 确保第一次设置 ROI 成功
+        std::this_thread::sleep_for(std::chrono::milliseconds(CAMERA_SETTLE_MS));
     }
 
+    m_cameraId = cameraId;
     m_cameraModel = QString::fromUtf8(arv_camera_get_model_name(m_camera, nullptr));
     m_cameraVendor = QString::fromUtf8(arv_camera_get_vendor_name(m_camera, nullptr));
     m_cameraSerial = QString::fromUtf8(arv_camera_get_device_serial_number(m_camera, nullptr));
 
-    // 确保相机处于停止状态
-    GError *stopError = nullptr;
-    arv_camera_stop_acquisition(m_camera, &stopError);
-    if (stopError) {
-        // 如果相机本来就是停止状态，这个错误可以忽略
-        qDebug() << "停止采集(如果有):" << stopError->message;
-        g_error_free(stopError);
-    }
-
-    // 等待一下让相机稳定 确保第一次设置 ROI 成功
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    m_isUsb3 = arv_camera_is_uv_device(m_camera);
+    m_linkThroughputLimit = m_isUsb3 ? UsbTransferTuning::linkThroughputLimit(m_camera) : 0;
 
     m_isConnected = true;
+    startParameterThread();
     emit cameraConnected(m_cameraModel);
     qDebug() << "相机连接成功:" << m_cameraModel << "SN:" << m_cameraSerial;
 
@@ -75,10 +253,13 @@ void CameraController::disconnectCamera()
         return;
     }
 
+    m_autoExposure->disable();
     stopAcquisition();
     cleanupResources();
 
     m_isConnected = false;
+    m_isUsb3 = false;
+    m_linkThroughputLimit = 0;
     emit cameraDisconnected();
     qDebug() << "相机已断开";
 }
@@ -93,6 +274,11 @@ QString CameraController::getCameraModel() const
     return m_cameraModel;
 }
 
+QString CameraController::cameraId() const
+{
+    return m_cameraId;
+}
+
 QString CameraController::getCameraVendor() const
 {
     return m_cameraVendor;
@@ -278,6 +464,140 @@ bool CameraController::getGainBounds(double &min, double &max) const
     return true;
 }
 
+// ========== 异步参数写入 ==========
+
+void CameraController::setExposureTimeAsync(double microseconds)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_parameterMutex);
+        if (!m_parameterThreadRunning) {
+            return;
+        }
+        m_pendingExposure = microseconds;
+    }
+    m_parameterCond.notify_one();
+}
+
+void CameraController::setGainAsync(double gain)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_parameterMutex);
+        if (!m_parameterThreadRunning) {
+            return;
+        }
+        m_pendingGain = gain;
+    }
+    m_parameterCond.notify_one();
+}
+
+void CameraController::startParameterThread()
+{
+    std::lock_guard<std::mutex> lock(m_parameterMutex);
+    if (m_parameterThreadRunning) {
+        return;
+    }
+
+    m_parameterThreadRunning = true;
+    m_pendingExposure.reset();
+    m_pendingGain.reset();
+    m_pendingSequenceWrite.reset();
+    m_parameterThread = std::thread(&CameraController::parameterLoop, this);
+}
+
+void CameraController::stopParameterThread()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_parameterMutex);
+        m_parameterThreadRunning = false;
+    }
+    m_parameterCond.notify_one();
+
+    if (m_parameterThread.joinable()) {
+        m_parameterThread.join();
+    }
+}
+
+void CameraController::parameterLoop()
+{
+    // 连续失败只上报第一次，避免闭环控制时错误刷屏
+    bool lastWriteFailed = false;
+
+    auto reportResult = [this, &lastWriteFailed](const char *name, double value, GError *error) {
+        if (!error) {
+            lastWriteFailed = false;
+            QMetaObject::invokeMethod(this, [this, name, value]() {
+                emit parameterChanged(name, value);
+            }, Qt::QueuedConnection);
+            return;
+        }
+
+        QString errorMsg = QString("异步设置%1失败: %2").arg(name, QString::fromUtf8(error->message));
+        g_error_free(error);
+        qWarning() << errorMsg;
+
+        if (!lastWriteFailed) {
+            lastWriteFailed = true;
+            QMetaObject::invokeMethod(this, [this, errorMsg]() {
+                emit errorOccurred(errorMsg);
+            }, Qt::QueuedConnection);
+        }
+    };
+
+    // 参数序列的上一次写入值，相同的参数不重复写入
+    std::optional<ParameterSequencer::Step> lastSequenceStep;
+
+    while (true) {
+        std::optional<double> exposure;
+        std::optional<double> gain;
+        std::optional<ParameterSequencer::WriteRequest> sequenceWrite;
+        {
+            std::unique_lock<std::mutex> lock(m_parameterMutex);
+            m_parameterCond.wait(lock, [this]() {
+                return !m_parameterThreadRunning || m_pendingExposure || m_pendingGain || m_pendingSequenceWrite;
+            });
+            if (!m_parameterThreadRunning) {
+                break;
+            }
+            exposure = std::exchange(m_pendingExposure, std::nullopt);
+            gain = std::exchange(m_pendingGain, std::nullopt);
+            sequenceWrite = std::exchange(m_pendingSequenceWrite, std::nullopt);
+        }
+
+        // 序列写入每帧一次：只在失败时上报，不逐帧发出 parameterChanged
+        if (sequenceWrite) {
+            const ParameterSequencer::Step &step = sequenceWrite->step;
+            GError *error = nullptr;
+            if (!lastSequenceStep || lastSequenceStep->exposureUs != step.exposureUs) {
+                arv_camera_set_exposure_time(m_camera, step.exposureUs, &error);
+            }
+            if (!error && (!lastSequenceStep || lastSequenceStep->gainDb != step.gainDb)) {
+                arv_camera_set_gain(m_camera, step.gainDb, &error);
+            }
+            if (error) {
+                lastSequenceStep.reset();
+                reportResult("参数序列", step.exposureUs, error);
+            } else {
+                lastSequenceStep = step;
+                lastWriteFailed = false;
+            }
+        } else if (exposure || gain) {
+            lastSequenceStep.reset();
+        }
+
+        if (exposure) {
+            GError *error = nullptr;
+            arv_camera_set_exposure_time(m_camera, *exposure, &error);
+            reportResult("ExposureTime", *exposure, error);
+        }
+
+        if (gain) {
+            GError *error = nullptr;
+            arv_camera_set_gain(m_camera, *gain, &error);
+            reportResult("Gain", *gain, error);
+        }
+    }
+}
+
 // ========== ROI控制 ==========
 
 bool CameraController::setROI(int x, int y, int width, int height)
@@ -288,8 +608,7 @@ bool CameraController::setROI(int x, int y, int width, int height)
     }
 
     if (m_isAcquiring) {
-        emit errorOccurred("ROI设置失败: 采集正在运行，请先停止采集");
-        return false;
+        return reconfigureAcquisition(x, y, width, height);
     }
 
     GError *error = nullptr;
@@ -298,8 +617,16 @@ bool CameraController::setROI(int x, int y, int width, int height)
     qDebug() << "当前isAcquiring状态:" << m_isAcquiring;
     qDebug() << "当前stream指针:" << (void*)m_stream;
 
+    // 快照流运行时相机处于采集状态，ROI 不可写，修改后按新负载大小重建
+    const bool restartSnapshot = m_snapshotStream != nullptr;
+    stopSnapshotStream();
+
     arv_camera_set_region(m_camera, x, y, width, height, &error);
 
+    if (restartSnapshot && !startSnapshotStream()) {
+        m_snapshotModeRequested = false;
+    }
+
     if (error) {
         QString errorMsg = QString::fromUtf8(error->message);
         g_error_free(error);
@@ -355,6 +682,137 @@ bool CameraController::getROIBounds(int &maxWidth, int &maxHeight) const
     return true;
 }
 
+bool CameraController::reconfigureAcquisition(int x, int y, int width, int height, ArvPixelFormat pixelFormat)
+{
+    if (!m_isAcquiring || !m_stream) {
+        emit errorOccurred("重配置失败: 采集未运行");
+        return false;
+    }
+
+    if (m_burstRecorder->isArmed()) {
+        emit errorOccurred("重配置失败: 连拍进行中");
+        return false;
+    }
+
+    const int64_t beginNs = TraceRecorder::nowNs();
+    qDebug() << "采集中重配置ROI:" << x << y << width << height;
+
+    // 写入前记下原 ROI 和像素格式，后续步骤失败时恢复，相机不会停在一半生效的状态
+    GError *error = nullptr;
+    gint oldX = 0, oldY = 0, oldWidth = 0, oldHeight = 0;
+    arv_camera_get_region(m_camera, &oldX, &oldY, &oldWidth, &oldHeight, &error);
+    if (error) {
+        QString errorMsg = QString::fromUtf8(error->message);
+        g_error_free(error);
+        emit errorOccurred(QString("重配置失败: 读取当前ROI失败: %1").arg(errorMsg));
+        return false;
+    }
+    const ArvPixelFormat oldPixelFormat = arv_camera_get_pixel_format(m_camera, &error);
+    if (error) {
+        QString errorMsg = QString::fromUtf8(error->message);
+        g_error_free(error);
+        emit errorOccurred(QString("重配置失败: 读取当前像素格式失败: %1").arg(errorMsg));
+        return false;
+    }
+
+    // 暂停采集线程、相机和流接收线程；流对象、处理管线和分析线程保持运行
+    m_running = false;
+    if (m_captureThread.joinable()) {
+        m_captureThread.join();
+    }
+
+    arv_camera_stop_acquisition(m_camera, &error);
+    if (error) {
+        qWarning() << "重配置时停止采集出错:" << error->message;
+        g_error_free(error);
+        error = nullptr;
+    }
+
+    // 接收线程启动时按负载大小设置传输（USB3 的 leader/payload/trailer 传输），
+    // 负载变化后必须重启；停止时保留缓冲区，接收中的缓冲区回到输入队列
+    arv_stream_stop_thread(m_stream, FALSE);
+    m_transferStarts.fill(TransferStart{});   // 中止接收的缓冲区不会再有 BUFFER_DONE
+
+    QString applyError;
+    arv_camera_set_region(m_camera, x, y, width, height, &error);
+    if (error) {
+        applyError = QString("设置ROI失败: %1").arg(QString::fromUtf8(error->message));
+        g_error_free(error);
+        error = nullptr;
+    }
+    if (applyError.isEmpty() && pixelFormat != 0 && pixelFormat != oldPixelFormat) {
+        arv_camera_set_pixel_format(m_camera, pixelFormat, &error);
+        if (error) {
+            applyError = QString("设置像素格式失败: %1").arg(QString::fromUtf8(error->message));
+            g_error_free(error);
+            error = nullptr;
+        }
+    }
+
+    // 任一步失败都恢复原 ROI 和像素格式，恢复不了的如实报告
+    if (!applyError.isEmpty()) {
+        arv_camera_set_pixel_format(m_camera, oldPixelFormat, &error);
+        if (error) {
+            applyError += QString("; 恢复像素格式失败: %1").arg(QString::fromUtf8(error->message));
+            g_error_free(error);
+            error = nullptr;
+        }
+        arv_camera_set_region(m_camera, oldX, oldY, oldWidth, oldHeight, &error);
+        if (error) {
+            applyError += QString("; 恢复原ROI (%1,%2,%3x%4) 失败: %5").arg(oldX).arg(oldY).arg(oldWidth)
+                              .arg(oldHeight).arg(QString::fromUtf8(error->message));
+            g_error_free(error);
+            error = nullptr;
+        } else {
+            applyError += QString("; 已恢复原ROI (%1,%2,%3x%4)").arg(oldX).arg(oldY).arg(oldWidth).arg(oldHeight);
+        }
+    }
+
+    // 接收线程已停止，所有缓冲区都在队列中；负载变大时全部替换为新大小
+    const guint payload = arv_camera_get_payload(m_camera, &error);
+    if (error) {
+        qWarning() << "重配置时读取负载大小失败:" << error->message;
+        g_error_free(error);
+        error = nullptr;
+    } else if (payload > m_streamPayload) {
+        int replaced = 0;
+        while (ArvBuffer *buffer = arv_stream_pop_input_buffer(m_stream)) {
+            g_object_unref(buffer);
+            replaced++;
+        }
+        while (ArvBuffer *buffer = arv_stream_try_pop_buffer(m_stream)) {
+            g_object_unref(buffer);
+            replaced++;
+        }
+        pushStreamBuffers(replaced, payload);
+        qDebug() << "负载增大到" << payload << "字节, 替换缓冲区" << replaced << "个";
+    }
+
+    arv_stream_start_thread(m_stream);
+    arv_camera_start_acquisition(m_camera, &error);
+    if (error) {
+        QString errorMsg = QString::fromUtf8(error->message);
+        g_error_free(error);
+        emit errorOccurred(QString("重配置后恢复采集失败: %1").arg(errorMsg));
+        stopAcquisition();
+        return false;
+    }
+
+    m_reconfigureApplyMs = (TraceRecorder::nowNs() - beginNs) / 1e6;
+    m_reconfigureFromNs = m_lastPopNs != 0 ? m_lastPopNs : beginNs;
+    m_running = true;
+    m_captureThread = std::thread(&CameraController::captureLoop, this);
+
+    if (!applyError.isEmpty()) {
+        emit errorOccurred(QString("重配置失败: %1").arg(applyError));
+        return false;
+    }
+
+    qDebug() << "重配置完成, 耗时" << m_reconfigureApplyMs << "ms";
+    emit parameterChanged("ROI", 0);
+    return true;
+}
+
 // ========== 图像采集 ==========
 
 bool CameraController::startAcquisition()
@@ -369,13 +827,44 @@ bool CameraController::startAcquisition()
         return false;
     }
 
+    // 快照模式的常驻流占用着相机，连续采集期间先让出
+    stopSnapshotStream();
+
     GError *error = nullptr;
 
+    // 缓冲区分配前锁定内存，MCL_FUTURE 使随后分配的缓冲区也常驻
+    if (m_captureOptions.lockMemory) {
+        QString lockError;
+        m_memoryLocked = RealtimeTuning::lockMemory(&lockError);
+        if (!m_memoryLocked) {
+            qWarning() << lockError;
+            emit captureThreadConfigured(QString("内存锁定未生效: %1").arg(lockError), false);
+        }
+    }
+
+    // USB 模式和最大传输大小在创建流时读取，必须先写入设备
+    if (m_isUsb3) {
+        QStringList applied, failed;
+        UsbTransferTuning::apply(m_camera, m_usbOptions, applied, failed);
+        if (!applied.isEmpty() || !failed.isEmpty()) {
+            reportCaptureThreadConfig("USB3 传输", applied, failed);
+        }
+    }
+
+    // 接收线程在创建流时启动，传输统计先清零
+    m_transferDurations.reset();
+    m_transferStarts.fill(TransferStart{});
+    m_transferredBytes = 0;
+    m_transferredBytesSampled = 0;
+    m_transferSampleNs = TraceRecorder::nowNs();
+
     // 创建流 (需要5个参数: camera, callback, user_data, destroy, error)
-    m_stream = arv_camera_create_stream(m_camera, nullptr, nullptr, nullptr, &error);
+    // 回调在 Aravis 接收线程中调用：启动时设置该线程的优先级和亲和性，每个缓冲区记录传输耗时
+    m_stream = arv_camera_create_stream(m_camera, &CameraController::streamCallback, this, nullptr, &error);
     if (!m_stream || error) {
         QString errorMsg = error ? QString::fromUtf8(error->message) : "创建流失败";
         if (error) g_error_free(error);
+        releaseMemoryLock();
         emit errorOccurred(QString("启动采集失败: %1").arg(errorMsg));
         return false;
     }
@@ -387,13 +876,20 @@ bool CameraController::startAcquisition()
         g_error_free(error);
         g_object_unref(m_stream);
         m_stream = nullptr;
+        releaseMemoryLock();
         emit errorOccurred(QString("获取缓冲区大小失败: %1").arg(errorMsg));
         return false;
     }
 
-    for (int i = 0; i < 50; i++) {
-        arv_stream_push_buffer(m_stream, arv_buffer_new(payload_size, nullptr));
+    pushStreamBuffers(STREAM_BUFFERS, static_cast<size_t>(payload_size));
+
+    // 帧池预先建到借出上限：管线队列、当前时域平均历史和各处持有的帧，
+    // 像素缓冲区按负载大小保留，采集线程稳态下取帧不会因借出峰值而新建
+    size_t poolFrames = PIPELINE_STAGES * PIPELINE_QUEUE_CAPACITY + FRAME_POOL_HELD_FRAMES;
+    if (m_temporalFilter->mode() == TemporalFilter::Mode::Average) {
+        poolFrames += static_cast<size_t>(m_temporalFilter->averageFrames());
     }
+    m_framePool.reserve(poolFrames, static_cast<size_t>(payload_size));
 
     arv_camera_set_frame_rate(m_camera, 120.0, &error);
     if (error) {
@@ -404,6 +900,8 @@ bool CameraController::startAcquisition()
         double actual_fps = arv_camera_get_frame_rate(m_camera, nullptr);
         qDebug() << "相机帧率已设置为:" << actual_fps << "fps";
     }
+    // 自动曝光的曝光上限不超过帧周期，避免为提亮而拉低帧率
+    m_autoExposure->setFrameRate(arv_camera_get_frame_rate(m_camera, nullptr));
 
     double exposure = arv_camera_get_exposure_time(m_camera, nullptr);
     qDebug() << "当前曝光时间:" << exposure << "μs";
@@ -415,17 +913,30 @@ bool CameraController::startAcquisition()
         g_error_free(error);
         g_object_unref(m_stream);
         m_stream = nullptr;
+        releaseMemoryLock();
         emit errorOccurred(QString("启动采集失败: %1").arg(errorMsg));
         return false;
     }
 
     m_isAcquiring = true;
     m_frameCount = 0;
+    m_captureLoops = 0;
     m_arvReceivedCount = 0;
     m_arvSuccessCount = 0;
+    m_submittedCount = 0;
+    m_burstStoredCount = 0;
+    m_captureSampled = CaptureCounters{};
+    m_dropMonitor->reset();
+    m_popIntervals.reset();
+    m_sequencer.reset();
+    m_allocationSamples = 0;
+    m_reconfigureFromNs = 0;
+    m_lastPopNs = 0;
     m_currentFPS = 0.0;
     m_running = true;
 
+    m_frameAnalyzer->start();
+    m_pipeline.start();
     m_captureThread = std::thread(&CameraController::captureLoop, this);
     m_fpsTimer->start(1000);
     emit acquisitionStarted();
@@ -434,6 +945,15 @@ bool CameraController::startAcquisition()
     return true;
 }
 
+void CameraController::releaseMemoryLock()
+{
+    // 采集停止或启动失败时解除 startAcquisition() 中的内存锁定
+    if (m_memoryLocked) {
+        RealtimeTuning::unlockMemory();
+        m_memoryLocked = false;
+    }
+}
+
 void CameraController::stopAcquisition()
 {
     if (!m_isAcquiring) {
@@ -445,8 +965,35 @@ void CameraController::stopAcquisition()
     if (m_captureThread.joinable()) {
         m_captureThread.join();
     }
+    qDebug() << "采集线程停止";
+
+    // 未完成的连拍按已采集帧数结束，同时恢复帧率
+    m_burstRecorder->cancel();
 
+    m_pipeline.stop();
+    m_frameAnalyzer->stop();
     m_fpsTimer->stop();
+    reportSteadyStateAllocations();
+
+    const FrameDropMonitor::Counters drops = m_dropMonitor->counters();
+    qDebug() << "本次采集: 接收" << drops.received << "帧, 丢失" << drops.lostFrames() << "帧";
+    if (m_sequencer.isActive()) {
+        const ParameterSequencer::Counters sequence = m_sequencer.counters();
+        qDebug() << "参数序列: 标记" << sequence.tagged << "帧, 无法确定" << sequence.untagged
+                 << "帧, 块数据更正" << sequence.corrected << "帧, 写入被覆盖" << sequence.overruns << "次";
+    }
+    for (const QString &line : m_popIntervals.report()) {
+        qDebug().noquote() << line;
+    }
+    const IntervalHistogram::Summary transfer = m_transferDurations.summary();
+    if (transfer.count > 0) {
+        qDebug().noquote() << QString("单帧传输耗时: %1 帧 | P50 %2 μs | P99 %3 | P99.9 %4 | 最大 %5 μs")
+                                  .arg(transfer.count).arg(transfer.p50Us, 0, 'f', 0).arg(transfer.p99Us, 0, 'f', 0)
+                                  .arg(transfer.p999Us, 0, 'f', 0).arg(transfer.maxUs, 0, 'f', 0);
+    }
+    for (const QString &line : UsbTransferTuning::streamInfo(m_stream)) {
+        qDebug().noquote() << "流统计:" << line;
+    }
 
     GError *error = nullptr;
     const int maxRetries = 3;
@@ -475,80 +1022,150 @@ void CameraController::stopAcquisition()
         m_stream = nullptr;
     }
 
+    releaseMemoryLock();
+
     m_isAcquiring = false;
+    m_framePool.trim();
     emit acquisitionStopped();
     qDebug() << "图像采集已停止";
+
+    if (m_snapshotModeRequested && !startSnapshotStream()) {
+        m_snapshotModeRequested = false;
+    }
+}
+
+void CameraController::pushStreamBuffers(int count, size_t payloadSize)
+{
+    for (int i = 0; i < count; i++) {
+        ArvBuffer *buffer = arv_buffer_new(payloadSize, nullptr);
+        if (m_captureOptions.prefaultBuffers) {
+            RealtimeTuning::prefault(const_cast<void*>(arv_buffer_get_data(buffer, nullptr)), payloadSize);
+        }
+        arv_stream_push_buffer(m_stream, buffer);
+    }
+    m_streamPayload = payloadSize;
 }
 
 void CameraController::captureLoop()
 {
     qDebug() << "采集线程启动";
+    TraceRecorder::setThreadName("采集线程");
+    TraceRecorder &trace = TraceRecorder::instance();
+
+    // m_captureOptions 在线程创建前写入，采集期间不会修改
+    const CaptureThreadOptions options = m_captureOptions;
+    if (options.realtime || options.captureCpu >= 0) {
+        QStringList applied, failed;
+        QString error;
+        if (options.realtime) {
+            if (RealtimeTuning::setCurrentThreadRealtime(options.priority, &error)) {
+                applied << QString("SCHED_FIFO %1").arg(options.priority);
+            } else {
+                failed << error;
+            }
+        }
+        if (options.captureCpu >= 0) {
+            if (RealtimeTuning::setCurrentThreadAffinity(options.captureCpu, &error)) {
+                applied << QString("CPU %1").arg(options.captureCpu);
+            } else {
+                failed << error;
+            }
+        }
+        reportCaptureThreadConfig("采集线程", applied, failed);
+    }
+
+    // 实时优先级下忙等会独占 CPU（并触发内核的 RT 限流），改为阻塞出队
+    const bool blockingPop = options.realtime;
+    int64_t lastPopNs = 0;
+    int64_t reconfigureFromNs = m_reconfigureFromNs;
+    const size_t streamPayload = m_streamPayload;
 
-    // 用于统计每秒的帧数
-    auto lastLogTime = std::chrono::steady_clock::now();
-    int loopCount = 0;              // 循环次数
-    int localArvReceived = 0;       // 本秒内arv接收的帧数
-    int localArvSuccess = 0;        // 本秒内成功的帧数
-    int localQtSent = 0;            // 本秒内发送给Qt的帧数
+    // 设备时钟到主机 steady 时钟的偏移取观测到的最小值（即最短传输延迟），
+    // 曝光结束时刻据此换算，追踪中显示的是相对最短延迟的额外传输时间
+    int64_t deviceToHostNs = std::numeric_limits<int64_t>::max();
 
     while (m_running) {
-        ArvBuffer *buffer = arv_stream_try_pop_buffer(m_stream);
-        loopCount++;
+        ArvBuffer *buffer = blockingPop ? arv_stream_timeout_pop_buffer(m_stream, BLOCKING_POP_TIMEOUT_US)
+                                        : arv_stream_try_pop_buffer(m_stream);
+        m_captureLoops.fetch_add(1, std::memory_order_relaxed);
 
         if (buffer) {
-            m_arvReceivedCount++;
-            localArvReceived++;
+            m_arvReceivedCount.fetch_add(1, std::memory_order_relaxed);
 
-            if (arv_buffer_get_status(buffer) == ARV_BUFFER_STATUS_SUCCESS) {
-                m_arvSuccessCount++;
-                localArvSuccess++;
-
-                size_t buffer_size;
-                const void *buffer_data = arv_buffer_get_data(buffer, &buffer_size);
+            const int64_t popNs = TraceRecorder::nowNs();
+            if (lastPopNs != 0) {
+                m_popIntervals.add(popNs - lastPopNs);
+            }
+            lastPopNs = popNs;
+
+            if (m_dropMonitor->record(buffer)) {
+                m_arvSuccessCount.fetch_add(1, std::memory_order_relaxed);
+
+                if (reconfigureFromNs != 0) {
+                    const double gapMs = (popNs - reconfigureFromNs) / 1e6;
+                    const double applyMs = m_reconfigureApplyMs;
+                    reconfigureFromNs = 0;
+                    QMetaObject::invokeMethod(this, [this, applyMs, gapMs]() {
+                        emit acquisitionReconfigured(applyMs, gapMs);
+                    }, Qt::QueuedConnection);
+                }
 
-                if (buffer_data) {
-                    gint width, height;
-                    arv_buffer_get_image_region(buffer, nullptr, nullptr, &width, &height);
-                    ArvPixelFormat pixel_format = arv_buffer_get_image_pixel_format(buffer);
+                const bool tracing = trace.isEnabled();
+                const uint64_t frameId = tracing ? arv_buffer_get_frame_id(buffer) : 0;
+                if (tracing) {
+                    const int64_t arrivalNs = TraceRecorder::fromRealtimeNs(
+                        static_cast<int64_t>(arv_buffer_get_system_timestamp(buffer)));
+                    const int64_t deviceNs = static_cast<int64_t>(arv_buffer_get_timestamp(buffer));
+                    if (deviceNs != 0) {
+                        deviceToHostNs = std::min(deviceToHostNs, arrivalNs - deviceNs);
+                        trace.record("exposure_to_arrival", frameId, deviceNs + deviceToHostNs, arrivalNs,
+                                     TraceRecorder::Track::Device);
+                    }
+                    trace.record("arrival_to_pop", frameId, arrivalNs, popNs, TraceRecorder::Track::Device);
+                }
 
-                    if (pixel_format == ARV_PIXEL_FORMAT_MONO_8 || pixel_format == 0x01080001) {
-                        QImage image(static_cast<const uchar*>(buffer_data), width, height, width, QImage::Format_Grayscale8);
-                        QImage imageCopy = image.copy();
+                // 连拍期间帧直接拷入预分配内存，不再经过管线和显示；
+                // 参数序列按到达顺序给每帧打标记，连拍的帧也不例外
+                Frame header;
+                const uint8_t *data = nullptr;
+                FramePtr frame;
+                if (m_burstRecorder->isArmed() && readFrameHeader(buffer, header, &data)) {
+                    applySequence(header);
+                    if (m_burstRecorder->store(header, data)) {
+                        m_burstStoredCount.fetch_add(1, std::memory_order_relaxed);
+                    } else if ((frame = createFrame(buffer))) {
+                        frame->sequence = header.sequence;
+                    }
+                } else if ((frame = createFrame(buffer))) {
+                    applySequence(*frame);
+                }
+                if (frame) {
+                    m_pipeline.submit(std::move(frame));
+                    m_submittedCount.fetch_add(1, std::memory_order_relaxed);
+                }
 
-                        QMetaObject::invokeMethod(this, [this, imageCopy = std::move(imageCopy)]() {
-                            m_frameCount++;
-                            emit newFrameAvailable(imageCopy);
-                        }, Qt::QueuedConnection);
+                if (tracing) {
+                    trace.record("capture", frameId, popNs, TraceRecorder::nowNs());
+                }
+            }
 
-                        localQtSent++;
-                    }
+            // 重配置前发出的缓冲区可能小于新负载，归还时替换
+            size_t bufferSize = 0;
+            arv_buffer_get_data(buffer, &bufferSize);
+            if (bufferSize < streamPayload) {
+                g_object_unref(buffer);
+                buffer = arv_buffer_new(streamPayload, nullptr);
+                if (options.prefaultBuffers) {
+                    RealtimeTuning::prefault(const_cast<void*>(arv_buffer_get_data(buffer, nullptr)), streamPayload);
                 }
             }
             arv_stream_push_buffer(m_stream, buffer);
         }
 
-        // 每秒输出一次统计信息
-        auto now = std::chrono::steady_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastLogTime).count();
-        if (elapsed >= 1000) {
-            qDebug() << "=== Aravis采集统计 ===";
-            qDebug() << "循环次数/秒:" << loopCount;
-            qDebug() << "Arv接收帧数/秒:" << localArvReceived << "(总计:" << m_arvReceivedCount << ")";
-            qDebug() << "Arv成功帧数/秒:" << localArvSuccess << "(总计:" << m_arvSuccessCount << ")";
-            qDebug() << "Qt发送帧数/秒:" << localQtSent;
-
-            // 重置本秒计数器
-            loopCount = 0;
-            localArvReceived = 0;
-            localArvSuccess = 0;
-            localQtSent = 0;
-            lastLogTime = now;
-        }
-
         // std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
 
-    qDebug() << "采集线程停止";
+    m_lastPopNs = lastPopNs;
 }
 
 bool CameraController::isAcquiring() const
@@ -556,41 +1173,619 @@ bool CameraController::isAcquiring() const
     return m_isAcquiring;
 }
 
-QImage CameraController::grabSingleFrame(int timeoutMs)
+FrameAnalyzer *CameraController::frameAnalyzer() const
 {
-    if (!m_isConnected) {
-        emit errorOccurred("相机未连接");
-        return QImage();
-    }
+    return m_frameAnalyzer;
+}
 
-    GError *error = nullptr;
-    ArvBuffer *buffer = arv_camera_acquisition(m_camera, timeoutMs * 1000, &error);
+AutoExposureController *CameraController::autoExposureController() const
+{
+    return m_autoExposure;
+}
 
-    if (!buffer || error) {
-        QString errorMsg = error ? QString::fromUtf8(error->message) : "采集超时";
-        if (error) g_error_free(error);
-        emit errorOccurred(QString("单帧采集失败: %1").arg(errorMsg));
-        return QImage();
-    }
+FlatFieldCorrector *CameraController::flatFieldCorrector() const
+{
+    return m_flatField;
+}
 
-    size_t buffer_size;
-    const void *buffer_data = arv_buffer_get_data(buffer, &buffer_size);
-    QImage image;
+TemporalFilter *CameraController::temporalFilter() const
+{
+    return m_temporalFilter;
+}
 
-    if (buffer_data) {
-        gint width, height;
-        arv_buffer_get_image_region(buffer, nullptr, nullptr, &width, &height);
-        ArvPixelFormat pixel_format = arv_buffer_get_image_pixel_format(buffer);
+HdrFusion *CameraController::hdrFusion() const
+{
+    return m_hdrFusion;
+}
 
-        if (pixel_format == ARV_PIXEL_FORMAT_MONO_8 || pixel_format == 0x01080001) {
-            image = QImage(static_cast<const uchar*>(buffer_data), width, height, width, QImage::Format_Grayscale8).copy();
-        }
-    }
+BurstRecorder *CameraController::burstRecorder() const
+{
+    return m_burstRecorder;
+}
+
+ImageSaveService *CameraController::imageSaveService() const
+{
+    return m_imageSaver;
+}
+
+FrameDropMonitor *CameraController::frameDropMonitor() const
+{
+    return m_dropMonitor;
+}
+
+bool CameraController::setCaptureThreadOptions(const CaptureThreadOptions &options)
+{
+    if (m_isAcquiring) {
+        emit errorOccurred("实时性选项需在停止采集后修改");
+        return false;
+    }
+    m_captureOptions = options;
+    return true;
+}
+
+CaptureThreadOptions CameraController::captureThreadOptions() const
+{
+    return m_captureOptions;
+}
+
+const IntervalHistogram &CameraController::popIntervalHistogram() const
+{
+    return m_popIntervals;
+}
+
+void CameraController::streamCallback(void *userData, ArvStreamCallbackType type, ArvBuffer *buffer)
+{
+    // Aravis 接收线程中调用
+    CameraController *self = static_cast<CameraController*>(userData);
+    switch (type) {
+    case ARV_STREAM_CALLBACK_TYPE_START_BUFFER: {
+        // 缓冲区数不超过 STREAM_BUFFERS，线性查找即可，不分配内存
+        const int64_t now = TraceRecorder::nowNs();
+        TransferStart *freeEntry = nullptr;
+        for (TransferStart &entry : self->m_transferStarts) {
+            if (entry.buffer == buffer) {
+                freeEntry = &entry;
+                break;
+            }
+            if (!entry.buffer && !freeEntry) {
+                freeEntry = &entry;
+            }
+        }
+        if (freeEntry) {
+            freeEntry->buffer = buffer;
+            freeEntry->startNs = now;
+        }
+        return;
+    }
+    case ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE:
+        // 只统计开始和完成配对的缓冲区；arv_buffer_get_data 返回实际接收的字节数
+        for (TransferStart &entry : self->m_transferStarts) {
+            if (buffer && entry.buffer == buffer) {
+                self->m_transferDurations.add(TraceRecorder::nowNs() - entry.startNs);
+                size_t received = 0;
+                arv_buffer_get_data(buffer, &received);
+                self->m_transferredBytes.fetch_add(received, std::memory_order_relaxed);
+                entry = TransferStart{};
+                break;
+            }
+        }
+        return;
+    case ARV_STREAM_CALLBACK_TYPE_INIT:
+        break;
+    default:
+        return;
+    }
+
+    const CaptureThreadOptions options = self->m_captureOptions;
+    if (!options.realtime && options.streamCpu < 0) {
+        return;
+    }
+    QStringList applied, failed;
+    QString error;
+    if (options.realtime) {
+        // 接收线程比采集线程高一级，先保证缓冲区被及时填充
+        const int priority = std::min(options.priority + 1, 99);
+        if (RealtimeTuning::setCurrentThreadRealtime(priority, &error)) {
+            applied << QString("SCHED_FIFO %1").arg(priority);
+        } else {
+            failed << error;
+        }
+    }
+    if (options.streamCpu >= 0) {
+        if (RealtimeTuning::setCurrentThreadAffinity(options.streamCpu, &error)) {
+            applied << QString("CPU %1").arg(options.streamCpu);
+        } else {
+            failed << error;
+        }
+    }
+    self->reportCaptureThreadConfig("Aravis 接收线程", applied, failed);
+}
+
+bool CameraController::isUsb3Device() const
+{
+    return m_isUsb3;
+}
+
+bool CameraController::setUsbTransferOptions(const UsbTransferOptions &options)
+{
+    if (m_isAcquiring) {
+        emit errorOccurred("USB3 传输设置需在停止采集后修改");
+        return false;
+    }
+    m_usbOptions = options;
+    return true;
+}
+
+UsbTransferOptions CameraController::usbTransferOptions() const
+{
+    return m_usbOptions;
+}
+
+bool CameraController::setLinkThroughputLimit(uint64_t bytesPerSecond)
+{
+    if (!m_isConnected || !m_isUsb3) {
+        emit errorOccurred("链路带宽限制仅适用于已连接的 USB3 相机");
+        return false;
+    }
+
+    QString error;
+    if (!UsbTransferTuning::setLinkThroughputLimit(m_camera, bytesPerSecond, &error)) {
+        emit errorOccurred(error);
+        return false;
+    }
+    // 相机会按步进取整，读回实际值
+    m_linkThroughputLimit = bytesPerSecond > 0 ? UsbTransferTuning::linkThroughputLimit(m_camera) : 0;
+    return true;
+}
+
+uint64_t CameraController::linkThroughputLimit() const
+{
+    return m_linkThroughputLimit;
+}
+
+bool CameraController::linkThroughputLimitBounds(uint64_t &minimum, uint64_t &maximum) const
+{
+    if (!m_isConnected || !m_isUsb3) {
+        return false;
+    }
+    return UsbTransferTuning::linkThroughputLimitBounds(m_camera, minimum, maximum);
+}
+
+const IntervalHistogram &CameraController::transferDurationHistogram() const
+{
+    return m_transferDurations;
+}
+
+QStringList CameraController::streamInfo() const
+{
+    return UsbTransferTuning::streamInfo(m_isAcquiring ? m_stream : nullptr);
+}
+
+void CameraController::reportCaptureThreadConfig(const QString &thread, const QStringList &applied,
+                                                 const QStringList &failed)
+{
+    QString report = QString("%1: %2").arg(thread, applied.isEmpty() ? "未应用" : applied.join(", "));
+    if (!failed.isEmpty()) {
+        report += QString(" | 失败: %1").arg(failed.join("; "));
+        qWarning() << report;
+    } else {
+        qDebug() << report;
+    }
+
+    const bool success = failed.isEmpty();
+    QMetaObject::invokeMethod(this, [this, report, success]() {
+        emit captureThreadConfigured(report, success);
+    }, Qt::QueuedConnection);
+}
+
+bool CameraController::startBurst(int frameCount, bool useMaxFrameRate)
+{
+    if (!m_isAcquiring) {
+        emit errorOccurred("连拍需要先开始采集");
+        return false;
+    }
+
+    if (m_burstRecorder->isArmed()) {
+        emit errorOccurred("连拍正在进行");
+        return false;
+    }
+
+    GError *error = nullptr;
+    gint x, y, width, height;
+    arv_camera_get_region(m_camera, &x, &y, &width, &height, &error);
+    if (error) {
+        QString errorMsg = QString::fromUtf8(error->message);
+        g_error_free(error);
+        emit errorOccurred(QString("连拍失败: %1").arg(errorMsg));
+        return false;
+    }
+
+    const int bitDepth = bitDepthForPixelFormat(arv_camera_get_pixel_format(m_camera, nullptr));
+    if (bitDepth == 0) {
+        emit errorOccurred("连拍失败: 不支持当前像素格式");
+        return false;
+    }
+
+    QString armError;
+    if (!m_burstRecorder->arm(frameCount, width, height, bitDepth, &armError)) {
+        emit errorOccurred(QString("连拍失败: %1").arg(armError));
+        return false;
+    }
+
+    if (m_stream) {
+        guint64 completed = 0;
+        arv_stream_get_statistics(m_stream, &completed, &m_burstStartFailures, &m_burstStartUnderruns);
+    }
+
+    if (useMaxFrameRate) {
+        double minRate = 0.0;
+        double maxRate = 0.0;
+        arv_camera_get_frame_rate_bounds(m_camera, &minRate, &maxRate, &error);
+        if (!error) {
+            const double current = arv_camera_get_frame_rate(m_camera, nullptr);
+            arv_camera_set_frame_rate(m_camera, maxRate, &error);
+            if (!error) {
+                m_burstRestoreFrameRate = current;
+                qDebug() << "连拍帧率:" << arv_camera_get_frame_rate(m_camera, nullptr) << "fps (原" << current << "fps)";
+            }
+        }
+        if (error) {
+            // 部分相机采集中不允许修改帧率，此时按当前帧率连拍
+            qDebug() << "连拍切换最高帧率失败:" << error->message;
+            g_error_free(error);
+        }
+    }
+
+    return true;
+}
+
+void CameraController::cancelBurst()
+{
+    m_burstRecorder->cancel();
+}
+
+void CameraController::onBurstFinished(int captured, qulonglong missingFrames, double fps)
+{
+    if (m_burstRestoreFrameRate && m_camera) {
+        GError *error = nullptr;
+        arv_camera_set_frame_rate(m_camera, *m_burstRestoreFrameRate, &error);
+        if (error) {
+            qDebug() << "恢复帧率失败:" << error->message;
+            g_error_free(error);
+        }
+    }
+    m_burstRestoreFrameRate.reset();
 
+    guint64 failures = 0;
+    guint64 underruns = 0;
+    if (m_stream) {
+        guint64 completed = 0;
+        arv_stream_get_statistics(m_stream, &completed, &failures, &underruns);
+        failures -= m_burstStartFailures;
+        underruns -= m_burstStartUnderruns;
+    }
+
+    qDebug() << "连拍结束:" << captured << "帧," << fps << "fps, 缺失帧:" << missingFrames
+             << "传输失败:" << failures << "缓冲区不足:" << underruns;
+}
+
+void CameraController::setPipelineOverflowPolicy(FramePipeline::OverflowPolicy policy)
+{
+    m_pipeline.setInputOverflowPolicy(policy);
+}
+
+QImage CameraController::grabSingleFrame(int timeoutMs)
+{
+    if (!m_isConnected) {
+        emit errorOccurred("相机未连接");
+        return QImage();
+    }
+
+    if (m_snapshotStream) {
+        return grabFromSnapshotStream(timeoutMs);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    GError *error = nullptr;
+    ArvBuffer *buffer = arv_camera_acquisition(m_camera, timeoutMs * 1000, &error);
+
+    if (!buffer || error) {
+        QString errorMsg = error ? QString::fromUtf8(error->message) : "采集超时";
+        if (error) g_error_free(error);
+        emit errorOccurred(QString("单帧采集失败: %1").arg(errorMsg));
+        return QImage();
+    }
+
+    FramePtr frame = createFrame(buffer);
     g_object_unref(buffer);
+    m_imageSaver->offer(frame);
+    publishToStream(frame);
+    QImage image = toDisplayImage(derivedOrSource(m_previewSubscription, frame));
+
+    const double latencyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    emit grabLatencyMeasured(latencyMs, false);
     return image;
 }
 
+QImage CameraController::grabFromSnapshotStream(int timeoutMs)
+{
+    // 丢弃触发前残留的帧（例如上次超时后才到达的帧），保证拿到的是本次触发的图像
+    while (ArvBuffer *stale = arv_stream_try_pop_buffer(m_snapshotStream)) {
+        arv_stream_push_buffer(m_snapshotStream, stale);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    GError *error = nullptr;
+    arv_camera_software_trigger(m_camera, &error);
+    if (error) {
+        QString errorMsg = QString::fromUtf8(error->message);
+        g_error_free(error);
+        emit errorOccurred(QString("软件触发失败: %1").arg(errorMsg));
+        return QImage();
+    }
+
+    ArvBuffer *buffer = arv_stream_timeout_pop_buffer(m_snapshotStream, static_cast<guint64>(timeoutMs) * 1000);
+    if (!buffer) {
+        emit errorOccurred("单帧采集失败: 等待触发帧超时");
+        return QImage();
+    }
+
+    QImage image;
+    if (arv_buffer_get_status(buffer) == ARV_BUFFER_STATUS_SUCCESS) {
+        FramePtr frame = createFrame(buffer);
+        m_imageSaver->offer(frame);
+        publishToStream(frame);
+        image = toDisplayImage(derivedOrSource(m_previewSubscription, frame));
+    }
+    const ArvBufferStatus status = arv_buffer_get_status(buffer);
+    arv_stream_push_buffer(m_snapshotStream, buffer);
+
+    if (image.isNull()) {
+        emit errorOccurred(QString("单帧采集失败: 缓冲区状态 %1").arg(static_cast<int>(status)));
+        return QImage();
+    }
+
+    const double latencyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    emit grabLatencyMeasured(latencyMs, true);
+    return image;
+}
+
+bool CameraController::setChunkDataEnabled(bool enabled)
+{
+    if (!m_isConnected) {
+        emit errorOccurred("相机未连接");
+        return false;
+    }
+
+    if (m_isAcquiring) {
+        emit errorOccurred("块数据设置失败: 采集正在运行，请先停止采集");
+        return false;
+    }
+
+    if (enabled == m_chunkDecoder.isActive()) {
+        return true;
+    }
+
+    // 块数据会改变负载大小，快照流需按新大小重建
+    const bool restartSnapshot = m_snapshotStream != nullptr;
+    stopSnapshotStream();
+
+    bool ok = true;
+    if (enabled) {
+        QString error;
+        ok = m_chunkDecoder.configure(m_camera, &error);
+        if (ok) {
+            qDebug() << "块数据已启用:" << m_chunkDecoder.describe();
+        } else {
+            emit errorOccurred(error);
+        }
+    } else {
+        m_chunkDecoder.disable(m_camera);
+        m_lastChunk = FrameChunkData{};
+        qDebug() << "块数据已关闭";
+    }
+
+    if (restartSnapshot && !startSnapshotStream()) {
+        m_snapshotModeRequested = false;
+    }
+    return ok;
+}
+
+bool CameraController::setParameterSequence(const ParameterSequencer::Settings &settings)
+{
+    if (!m_isConnected) {
+        emit errorOccurred("相机未连接");
+        return false;
+    }
+
+    if (m_isAcquiring) {
+        emit errorOccurred("参数序列设置失败: 采集正在运行，请先停止采集");
+        return false;
+    }
+
+    const bool enable = settings.steps.size() >= 2;
+    if (enable && m_autoExposure->isEnabled()) {
+        emit errorOccurred("参数序列设置失败: 请先关闭自动曝光/自动增益");
+        return false;
+    }
+
+    if (!enable && !m_sequencer.isActive()) {
+        return true;
+    }
+
+    // 快照流在触发模式下同样会推进硬件序列，重建以从第一组开始
+    const bool restartSnapshot = m_snapshotStream != nullptr;
+    stopSnapshotStream();
+
+    bool ok = true;
+    if (enable) {
+        QString error;
+        ok = m_sequencer.configure(m_camera, settings, &error);
+        if (ok) {
+            qDebug().noquote() << m_sequencer.describe();
+            const ParameterSequencer::Step &first = settings.steps.front();
+            emit parameterChanged("ExposureTime", first.exposureUs);
+            emit parameterChanged("Gain", first.gainDb);
+        } else {
+            emit errorOccurred(error);
+        }
+    } else {
+        m_sequencer.disable(m_camera);
+        qDebug() << "参数序列已关闭";
+    }
+
+    if (restartSnapshot && !startSnapshotStream()) {
+        m_snapshotModeRequested = false;
+    }
+    return ok;
+}
+
+const ParameterSequencer &CameraController::parameterSequencer() const
+{
+    return m_sequencer;
+}
+
+void CameraController::applySequence(Frame &frame)
+{
+    std::optional<ParameterSequencer::WriteRequest> request = m_sequencer.tag(frame);
+    if (!request) {
+        return;
+    }
+
+    // 参数线程还没取走上一次写入说明它落后了一帧以上，上一次的目标帧不再可信
+    std::optional<ParameterSequencer::WriteRequest> superseded;
+    {
+        std::lock_guard<std::mutex> lock(m_parameterMutex);
+        if (!m_parameterThreadRunning) {
+            return;
+        }
+        superseded = std::exchange(m_pendingSequenceWrite, request);
+    }
+    m_parameterCond.notify_one();
+
+    if (superseded) {
+        m_sequencer.writeSuperseded(superseded->targetIndex);
+    }
+}
+
+bool CameraController::isChunkDataEnabled() const
+{
+    return m_chunkDecoder.isActive();
+}
+
+FrameChunkData CameraController::lastFrameChunkData() const
+{
+    return m_lastChunk;
+}
+
+uint64_t CameraController::lastFrameId() const
+{
+    return m_lastFrameId;
+}
+
+bool CameraController::setSnapshotModeEnabled(bool enabled)
+{
+    if (!m_isConnected) {
+        emit errorOccurred("相机未连接");
+        return false;
+    }
+
+    m_snapshotModeRequested = enabled;
+
+    // 采集中只记录请求，停止采集后生效
+    if (m_isAcquiring) {
+        return true;
+    }
+
+    if (!enabled) {
+        stopSnapshotStream();
+        return true;
+    }
+
+    if (!m_snapshotStream && !startSnapshotStream()) {
+        m_snapshotModeRequested = false;
+        return false;
+    }
+    return true;
+}
+
+bool CameraController::isSnapshotModeEnabled() const
+{
+    return m_snapshotModeRequested;
+}
+
+bool CameraController::startSnapshotStream()
+{
+    GError *error = nullptr;
+
+    arv_camera_set_acquisition_mode(m_camera, ARV_ACQUISITION_MODE_CONTINUOUS, &error);
+    if (!error) {
+        arv_camera_set_trigger(m_camera, "Software", &error);
+    }
+    if (error) {
+        QString errorMsg = QString::fromUtf8(error->message);
+        g_error_free(error);
+        emit errorOccurred(QString("快照模式启动失败(软件触发不可用): %1").arg(errorMsg));
+        return false;
+    }
+
+    m_snapshotStream = arv_camera_create_stream(m_camera, nullptr, nullptr, nullptr, &error);
+    if (!m_snapshotStream || error) {
+        QString errorMsg = error ? QString::fromUtf8(error->message) : "创建流失败";
+        if (error) g_error_free(error);
+        m_snapshotStream = nullptr;
+        arv_camera_clear_triggers(m_camera, nullptr);
+        emit errorOccurred(QString("快照模式启动失败: %1").arg(errorMsg));
+        return false;
+    }
+
+    gint payload_size = arv_camera_get_payload(m_camera, &error);
+    if (!error) {
+        for (int i = 0; i < SNAPSHOT_BUFFERS; i++) {
+            arv_stream_push_buffer(m_snapshotStream, arv_buffer_new(payload_size, nullptr));
+        }
+        arv_camera_start_acquisition(m_camera, &error);
+    }
+    if (error) {
+        QString errorMsg = QString::fromUtf8(error->message);
+        g_error_free(error);
+        g_object_unref(m_snapshotStream);
+        m_snapshotStream = nullptr;
+        arv_camera_clear_triggers(m_camera, nullptr);
+        emit errorOccurred(QString("快照模式启动失败: %1").arg(errorMsg));
+        return false;
+    }
+
+    qDebug() << "快照模式已就绪: 软件触发," << SNAPSHOT_BUFFERS << "个缓冲区";
+    return true;
+}
+
+void CameraController::stopSnapshotStream()
+{
+    if (!m_snapshotStream) {
+        return;
+    }
+
+    GError *error = nullptr;
+    arv_camera_stop_acquisition(m_camera, &error);
+    if (error) {
+        qWarning() << "停止快照流时出错:" << error->message;
+        g_error_free(error);
+        error = nullptr;
+    }
+
+    g_object_unref(m_snapshotStream);
+    m_snapshotStream = nullptr;
+
+    // 恢复自由运行，连续采集不受触发设置影响
+    arv_camera_clear_triggers(m_camera, &error);
+    if (error) {
+        qWarning() << "清除触发设置时出错:" << error->message;
+        g_error_free(error);
+    }
+    qDebug() << "快照模式已停止";
+}
+
 // ========== 私有方法 ==========
 
 void CameraController::updateFPS()
@@ -599,14 +1794,180 @@ void CameraController::updateFPS()
     qDebug() << ">>> Qt层FPS:" << m_currentFPS << "(Qt接收并显示的帧数)";
     m_frameCount = 0;
     emit fpsUpdated(m_currentFPS);
+
+    if (m_isAcquiring) {
+        logCaptureStatistics();
+    }
+
+    if (m_pipeline.isRunning()) {
+        QStringList parts;
+        for (const auto &stats : m_pipeline.sampleStatistics()) {
+            QString part = QString("%1 %2%").arg(QString::fromStdString(stats.name))
+                               .arg(stats.occupancy * 100.0, 0, 'f', 0);
+            if (stats.queueCapacity > 0) {
+                part += QString(" [%1/%2 峰值%3 丢%4]").arg(stats.queueDepth).arg(stats.queueCapacity)
+                            .arg(stats.peakQueueDepth).arg(stats.droppedByQueue);
+            }
+            parts << part;
+        }
+        QString summary = parts.join(" → ");
+        const DerivedFrameCache::Statistics derived = m_derivedFrames.statistics();
+        if (derived.outputs > 0) {
+            summary += QString(" | 派生输出 %1 个: 计算 %2 次, 共享 %3 次")
+                           .arg(derived.outputs).arg(derived.computed).arg(derived.shared);
+        }
+        sampleAllocations(summary);
+        if (m_hdrFusion->isEnabled() && m_sequencer.isActive()) {
+            summary += QString(" | HDR 融合 %1 帧, 放弃 %2 轮")
+                           .arg(m_hdrFusion->fusedFrames()).arg(m_hdrFusion->incompleteBrackets());
+        }
+        emit pipelineStatisticsUpdated(summary);
+    }
+
+    if (m_isAcquiring && m_stream) {
+        const int64_t nowNs = TraceRecorder::nowNs();
+        const uint64_t bytes = m_transferredBytes.load(std::memory_order_relaxed);
+        const double seconds = (nowNs - m_transferSampleNs) / 1e9;
+        const double megabytesPerSecond = seconds > 0.0 ? (bytes - m_transferredBytesSampled) / seconds / 1e6 : 0.0;
+        m_transferredBytesSampled = bytes;
+        m_transferSampleNs = nowNs;
+
+        QString summary = QString("吞吐 %1 MB/s").arg(megabytesPerSecond, 0, 'f', 1);
+        if (m_linkThroughputLimit > 0) {
+            summary += QString(" (限制 %1 MB/s)").arg(m_linkThroughputLimit / 1e6, 0, 'f', 1);
+        }
+        const IntervalHistogram::Summary transfer = m_transferDurations.summary();
+        if (transfer.count > 0) {
+            summary += QString(" | 单帧传输 P50 %1 ms, P99 %2 ms, 最大 %3 ms")
+                           .arg(transfer.p50Us / 1000.0, 0, 'f', 2).arg(transfer.p99Us / 1000.0, 0, 'f', 2)
+                           .arg(transfer.maxUs / 1000.0, 0, 'f', 2);
+        }
+        guint64 completed = 0, failures = 0, underruns = 0;
+        arv_stream_get_statistics(m_stream, &completed, &failures, &underruns);
+        summary += QString(" | 失败 %1, 欠载 %2").arg(failures).arg(underruns);
+        emit transferStatisticsUpdated(summary);
+    }
+}
+
+CameraController::CaptureCounters CameraController::captureCounters() const
+{
+    CaptureCounters counters;
+    counters.loops = m_captureLoops.load(std::memory_order_relaxed);
+    counters.received = m_arvReceivedCount.load(std::memory_order_relaxed);
+    counters.succeeded = m_arvSuccessCount.load(std::memory_order_relaxed);
+    counters.submitted = m_submittedCount.load(std::memory_order_relaxed);
+    counters.burstStored = m_burstStoredCount.load(std::memory_order_relaxed);
+    return counters;
+}
+
+void CameraController::logCaptureStatistics()
+{
+    const CaptureCounters total = captureCounters();
+    const CaptureCounters &last = m_captureSampled;
+
+    qDebug() << "=== Aravis采集统计 ===";
+    qDebug() << "循环次数/秒:" << total.loops - last.loops;
+    qDebug() << "Arv接收帧数/秒:" << total.received - last.received << "(总计:" << total.received << ")";
+    qDebug() << "Arv成功帧数/秒:" << total.succeeded - last.succeeded << "(总计:" << total.succeeded << ")";
+    qDebug() << "送入处理管线帧数/秒:" << total.submitted - last.submitted
+             << "(管线丢弃总计:" << m_pipeline.droppedFrames() << ")";
+    if (total.burstStored > last.burstStored) {
+        qDebug() << "写入连拍内存帧数/秒:" << total.burstStored - last.burstStored;
+    }
+    const IntervalHistogram::Summary jitter = m_popIntervals.summary();
+    if (jitter.count > 0) {
+        qDebug() << "出队间隔 P50/P99/最大 (μs):" << jitter.p50Us << "/" << jitter.p99Us << "/" << jitter.maxUs;
+    }
+    const FrameDropMonitor::Counters drops = m_dropMonitor->counters();
+    if (drops.lostFrames() > 0) {
+        qDebug() << "丢帧总计:" << drops.lostFrames()
+                 << "(帧号间隔:" << drops.count(FrameDropMonitor::EventType::FrameGap)
+                 << "超时:" << drops.count(FrameDropMonitor::EventType::Timeout)
+                 << "缺包:" << drops.count(FrameDropMonitor::EventType::MissingPackets)
+                 << "大小不符:" << drops.count(FrameDropMonitor::EventType::SizeMismatch)
+                 << "中止:" << drops.count(FrameDropMonitor::EventType::Aborted) << ")";
+    }
+    if (m_sequencer.isActive()) {
+        const ParameterSequencer::Counters sequence = m_sequencer.counters();
+        qDebug() << "参数序列: 无法确定" << sequence.untagged << "帧, 写入被覆盖" << sequence.overruns << "次";
+    }
+
+    m_captureSampled = total;
+}
+
+void CameraController::sampleAllocations(QString &summary)
+{
+    if (!AllocationTracker::isEnabled()) {
+        return;
+    }
+
+    const uint64_t frames = m_dropMonitor->counters().received;
+    std::vector<AllocationTracker::ThreadCounters> current = AllocationTracker::snapshot();
+    if (m_allocationSamples > 0 && frames > m_allocationPreviousFrames) {
+        summary += QString(" | 分配/帧: %1").arg(formatAllocationsPerFrame(
+            AllocationTracker::difference(m_allocationPrevious, current), frames - m_allocationPreviousFrames));
+    }
+    if (m_allocationSamples == ALLOCATION_WARMUP_SECONDS) {
+        m_allocationBaseline = current;
+        m_allocationBaselineFrames = frames;
+    }
+
+    m_allocationPrevious = std::move(current);
+    m_allocationPreviousFrames = frames;
+    m_allocationSamples++;
+}
+
+void CameraController::reportSteadyStateAllocations()
+{
+    if (!AllocationTracker::isEnabled() || m_allocationSamples <= ALLOCATION_WARMUP_SECONDS) {
+        return;
+    }
+
+    const uint64_t frames = m_dropMonitor->counters().received - m_allocationBaselineFrames;
+    if (frames == 0) {
+        return;
+    }
+
+    const std::vector<AllocationTracker::ThreadCounters> current = AllocationTracker::snapshot();
+    const std::vector<AllocationTracker::ThreadCounters> steady =
+        AllocationTracker::difference(m_allocationBaseline, current);
+    qDebug().noquote() << QString("稳态内存分配 (%1 帧, 次/帧): %2").arg(frames)
+                              .arg(formatAllocationsPerFrame(steady, frames));
+
+    // 采集线程每帧只从帧池取帧，稳态下应当没有任何分配
+    auto isCaptureThread = [](const AllocationTracker::ThreadCounters &thread) {
+        return thread.name == "采集线程";
+    };
+    const auto capture = std::find_if(steady.begin(), steady.end(), isCaptureThread);
+    if (std::none_of(current.begin(), current.end(), isCaptureThread)
+        || std::none_of(m_allocationBaseline.begin(), m_allocationBaseline.end(), isCaptureThread)) {
+        // 采集线程没有独立的计数槽（记在溢出槽中），无法判断
+        qWarning() << "采集线程稳态零分配: 未知 (采集线程没有独立计数)";
+        emit steadyStateAllocationsMeasured(false, 0, 0, frames);
+    } else if (capture == steady.end()) {
+        qDebug() << "采集线程稳态零分配: 通过";
+        emit steadyStateAllocationsMeasured(true, 0, 0, frames);
+    } else {
+        qWarning() << "采集线程稳态零分配: 未通过," << capture->counters.allocations << "次分配,"
+                   << capture->counters.bytes << "字节";
+        emit steadyStateAllocationsMeasured(true, capture->counters.allocations, capture->counters.bytes, frames);
+    }
 }
 
 void CameraController::cleanupResources()
 {
+    stopParameterThread();
+
     if (m_isAcquiring) {
         stopAcquisition();
     }
 
+    m_snapshotModeRequested = false;
+    stopSnapshotStream();
+    m_chunkDecoder.reset();
+    m_lastChunk = FrameChunkData{};
+    m_sequencer.disable(m_camera);
+
     if (m_camera) {
         g_object_unref(m_camera);
         m_camera = nullptr;
@@ -615,6 +1976,255 @@ void CameraController::cleanupResources()
     m_cameraModel.clear();
     m_cameraVendor.clear();
     m_cameraSerial.clear();
+    m_cameraId.clear();
+}
+
+void CameraController::setFrameBusEnabled(bool enabled)
+{
+    m_frameBusEnabled = enabled;
+    if (!enabled) {
+        std::lock_guard<std::mutex> lock(m_frameBusMutex);
+        m_frameBus.close();
+    }
+}
+
+bool CameraController::isFrameBusEnabled() const
+{
+    return m_frameBusEnabled;
+}
+
+DerivedFrameCache *CameraController::derivedFrames()
+{
+    return &m_derivedFrames;
+}
+
+void CameraController::setPreviewOutput(const DerivedFrameSpec &spec)
+{
+    DerivedFrameSpec previewSpec = spec;
+    previewSpec.crop = ImageRegion();
+    resubscribe(m_previewSubscription, m_previewSpec, previewSpec);
+}
+
+void CameraController::setDisplayWindow(const DisplayWindow &window)
+{
+    m_displayLut.setWindow(window);
+}
+
+DisplayWindow CameraController::displayWindow() const
+{
+    return m_displayLut.window();
+}
+
+DerivedFrameSpec CameraController::previewOutput() const
+{
+    return m_previewSpec;
+}
+
+void CameraController::setFrameBusOutput(const DerivedFrameSpec &spec)
+{
+    resubscribe(m_frameBusSubscription, m_frameBusSpec, spec);
+}
+
+DerivedFrameSpec CameraController::frameBusOutput() const
+{
+    return m_frameBusSpec;
+}
+
+PreviewStreamServer *CameraController::previewStreamServer() const
+{
+    return m_streamServer;
+}
+
+void CameraController::setStreamOutput(const DerivedFrameSpec &spec)
+{
+    resubscribe(m_streamSubscription, m_streamSpec, spec);
+}
+
+DerivedFrameSpec CameraController::streamOutput() const
+{
+    return m_streamSpec;
+}
+
+void CameraController::publishToStream(const FramePtr &frame)
+{
+    // 没有远程客户端时不计算派生帧
+    if (frame && m_streamServer->wantsFrames()) {
+        m_streamServer->offer(derivedOrSource(m_streamSubscription, frame));
+    }
+}
+
+void CameraController::resubscribe(std::atomic<int> &subscription, DerivedFrameSpec &current, const DerivedFrameSpec &spec)
+{
+    // 先切换订阅号再退订旧的，管线线程最多再用旧订阅取一帧（取不到时回退到原始帧）
+    const int next = spec.isPassthrough() ? 0 : m_derivedFrames.subscribe(spec);
+    const int previous = subscription.exchange(next);
+    if (previous != 0) {
+        m_derivedFrames.unsubscribe(previous);
+    }
+    current = spec;
+}
+
+FramePtr CameraController::derivedOrSource(const std::atomic<int> &subscription, const FramePtr &frame)
+{
+    const int id = subscription.load(std::memory_order_relaxed);
+    if (id == 0) {
+        return frame;
+    }
+    FramePtr derived = m_derivedFrames.get(id, frame);
+    return derived ? derived : frame;
+}
+
+void CameraController::publishToFrameBus(const Frame &frame)
+{
+    std::lock_guard<std::mutex> lock(m_frameBusMutex);
+
+    // 首帧或帧变大（ROI 扩大、位深增加）时按当前帧尺寸重建，读者会收到关闭通知后重新打开
+    if (!m_frameBus.isOpen() || m_frameBus.payloadCapacity() < frame.data.size()) {
+        if (!m_frameBus.create(FrameBus::DEFAULT_NAME, FRAME_BUS_SLOTS, frame.data.size())) {
+            m_frameBusEnabled = false;
+            const QString message = QString("共享内存帧总线创建失败: %1")
+                                        .arg(QString::fromStdString(m_frameBus.errorString()));
+            QMetaObject::invokeMethod(this, [this, message]() {
+                emit errorOccurred(message);
+            }, Qt::QueuedConnection);
+            return;
+        }
+        qDebug() << "共享内存帧总线已创建:" << FrameBus::DEFAULT_NAME << "槽位容量:" << frame.data.size();
+    }
+
+    m_frameBus.publish(frame);
+}
+
+void CameraController::publishFrame(const FramePtr &frame)
+{
+    // 在管线线程上调用：送往共享内存、分析线程和 GUI 线程
+    if (m_frameBusEnabled) {
+        publishToFrameBus(*derivedOrSource(m_frameBusSubscription, frame));
+    }
+
+    m_frameAnalyzer->submitFrame(frame);
+    m_imageSaver->offer(frame);
+    publishToStream(frame);
+
+    // 显示最多按显示帧率刷新，多余的帧不做派生和转换（image 为空，GUI 线程只计数）
+    QImage image;
+    const int64_t nowNs = TraceRecorder::nowNs();
+    if (nowNs - m_lastDisplayNs >= DISPLAY_INTERVAL_NS) {
+        m_lastDisplayNs = nowNs;
+        FramePtr preview = derivedOrSource(m_previewSubscription, frame);
+        TraceScope scope("convert", frame->frameId);
+        image = toDisplayImage(preview);
+    }
+
+    const int64_t dispatchNs = TraceRecorder::instance().isEnabled() ? TraceRecorder::nowNs() : 0;
+    QMetaObject::invokeMethod(this, [this, image = std::move(image), chunk = frame->chunk,
+                                     frameId = frame->frameId, dispatchNs]() {
+        if (dispatchNs != 0) {
+            TraceRecorder::instance().record("gui_dispatch", frameId, dispatchNs, TraceRecorder::nowNs());
+        }
+        TraceScope scope("publish", frameId);
+        m_frameCount++;
+        m_lastChunk = chunk;
+        m_lastFrameId = frameId;
+        emit newFrameAvailable(image);
+    }, Qt::QueuedConnection);
+}
+
+int CameraController::bitDepthForPixelFormat(ArvPixelFormat format)
+{
+    switch (format) {
+    case ARV_PIXEL_FORMAT_MONO_8:
+        return 8;
+    case ARV_PIXEL_FORMAT_MONO_10:
+        return 10;
+    case ARV_PIXEL_FORMAT_MONO_12:
+        return 12;
+    case ARV_PIXEL_FORMAT_MONO_14:
+        return 14;
+    case ARV_PIXEL_FORMAT_MONO_16:
+        return 16;
+    default:
+        // 打包格式和彩色格式暂不支持
+        return 0;
+    }
+}
+
+bool CameraController::readFrameHeader(ArvBuffer *buffer, Frame &header, const uint8_t **data) const
+{
+    size_t buffer_size;
+    const void *buffer_data = arv_buffer_get_data(buffer, &buffer_size);
+    if (!buffer_data) {
+        return false;
+    }
+
+    const ArvPixelFormat pixelFormat = arv_buffer_get_image_pixel_format(buffer);
+    const int bitDepth = bitDepthForPixelFormat(pixelFormat);
+    if (bitDepth == 0) {
+        return false;
+    }
+
+    gint x, y, width, height;
+    arv_buffer_get_image_region(buffer, &x, &y, &width, &height);
+
+    header.width = width;
+    header.height = height;
+    header.offsetX = x;
+    header.offsetY = y;
+    header.bitDepth = bitDepth;
+    header.pixelFormat = pixelFormat;
+    header.frameId = arv_buffer_get_frame_id(buffer);
+    header.timestampNs = arv_buffer_get_timestamp(buffer);
+    header.systemTimestampNs = arv_buffer_get_system_timestamp(buffer);
+    m_chunkDecoder.decode(buffer, header.chunk);
+
+    if (buffer_size < static_cast<size_t>(header.stride()) * height) {
+        return false;
+    }
+
+    *data = static_cast<const uint8_t*>(buffer_data);
+    return true;
+}
+
+QImage CameraController::toDisplayImage(const FramePtr &frame)
+{
+    if (!frame) {
+        return QImage();
+    }
+
+    const DisplayWindow window = m_displayLut.window();
+    const bool pseudoColor = window.palette != DisplayWindow::Palette::Gray;
+    if (frame->bitDepth == 8 && window.isLinearFullRange() && !pseudoColor) {
+        // QImage 直接引用帧数据，由帧的引用计数管理生命周期，避免二次拷贝
+        return QImage(static_cast<const uchar*>(frame->bits()), frame->width, frame->height, frame->stride(),
+                      QImage::Format_Grayscale8,
+                      [](void *info) { delete static_cast<FramePtr*>(info); },
+                      new FramePtr(frame));
+    }
+
+    // 高位深帧转换为 8 位显示，原始数据仍完整送往分析；默认窗口直接移位，否则查表
+    QImage image(frame->width, frame->height, pseudoColor ? QImage::Format_Indexed8 : QImage::Format_Grayscale8);
+    if (window.isLinearFullRange()) {
+        DisplayConverter::toGray8(*frame, image.bits(), image.bytesPerLine());
+    } else {
+        m_displayLut.convert(*frame, image.bits(), image.bytesPerLine());
+    }
+    if (pseudoColor) {
+        image.setColorTable(m_displayLut.colorTable());
+    }
+    return image;
+}
+
+FramePtr CameraController::createFrame(ArvBuffer *buffer) const
+{
+    FramePtr frame = m_framePool.acquire();
+    const uint8_t *data = nullptr;
+    if (!readFrameHeader(buffer, *frame, &data)) {
+        return nullptr;
+    }
+
+    const size_t imageSize = static_cast<size_t>(frame->stride()) * frame->height;
+    frame->data.assign(data, data + imageSize);
+    return frame;
 }
 
 QString CameraController::getLastGError() const
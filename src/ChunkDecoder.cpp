@@ -0,0 +1,415 @@
+#include "ChunkDecoder.h"
+#include <QByteArray>
+#include <QDebug>
+#include <QStringList>
+#include <QXmlStreamReader>
+#include <cstring>
+#include <map>
+#include <string>
+
+// 解决 Qt 和 GLib 的宏冲突
+#ifdef signals
+#undef signals
+#endif
+
+#include <arv.h>
+
+// 恢复 Qt 的 signals 宏
+#define signals Q_SIGNALS
+
+namespace {
+
+struct ChunkCandidate {
+    FrameChunkData::Field field;
+    const char *chunkName;
+    const char *featureName;
+    bool isFloat;
+};
+
+// 同一字段按顺序尝试，第一个能启用的生效
+const ChunkCandidate CHUNK_CANDIDATES[] = {
+    {FrameChunkData::ExposureTime, "ExposureTime", "ChunkExposureTime", true},
+    {FrameChunkData::Gain, "Gain", "ChunkGain", true},
+    {FrameChunkData::FrameId, "FrameID", "ChunkFrameID", false},
+    {FrameChunkData::FrameId, "FrameCounter", "ChunkFrameCounter", false},
+    {FrameChunkData::LineStatus, "LineStatusAll", "ChunkLineStatusAll", false},
+    {FrameChunkData::Timestamp, "Timestamp", "ChunkTimestamp", false},
+};
+
+// XML 中与块寄存器定位有关的节点信息
+struct XmlNode {
+    std::string type;
+    uint64_t address = 0;
+    bool hasAddress = false;
+    bool computedAddress = false;   // pAddress / IntSwissKnife 等需要求值
+    uint32_t length = 0;
+    std::string port;
+    std::string value;              // Integer / Float 节点的 pValue
+    bool bigEndian = false;
+    bool isSigned = false;
+    int lsb = -1;
+    int msb = -1;
+    uint64_t chunkId = 0;
+    bool hasChunkId = false;
+};
+
+uint64_t parseNumber(const QString &text, bool *ok)
+{
+    // GenICam 数值可以是十进制或 0x 前缀的十六进制
+    return text.trimmed().toULongLong(ok, 0);
+}
+
+} // namespace
+
+ChunkDecoder::~ChunkDecoder()
+{
+    reset();
+}
+
+bool ChunkDecoder::configure(ArvCamera *camera, QString *error)
+{
+    reset();
+
+    GError *gerror = nullptr;
+    if (!arv_camera_are_chunks_available(camera, &gerror)) {
+        if (gerror) g_error_free(gerror);
+        if (error) {
+            *error = "相机不支持块数据 (ChunkModeActive)";
+        }
+        return false;
+    }
+
+    arv_camera_set_chunk_mode(camera, TRUE, &gerror);
+    if (gerror) {
+        if (error) {
+            *error = QString("开启块模式失败: %1").arg(QString::fromUtf8(gerror->message));
+        }
+        g_error_free(gerror);
+        return false;
+    }
+
+    uint32_t enabledFields = 0;
+    for (const ChunkCandidate &candidate : CHUNK_CANDIDATES) {
+        if (enabledFields & candidate.field) {
+            continue;
+        }
+        arv_camera_set_chunk_state(camera, candidate.chunkName, TRUE, &gerror);
+        if (gerror) {
+            // 相机没有这个块，跳过
+            g_error_free(gerror);
+            gerror = nullptr;
+            continue;
+        }
+        FieldLayout layout;
+        layout.field = candidate.field;
+        layout.chunkName = candidate.chunkName;
+        layout.featureName = candidate.featureName;
+        layout.isFloat = candidate.isFloat;
+        m_fields.push_back(layout);
+        enabledFields |= candidate.field;
+    }
+
+    if (m_fields.empty()) {
+        arv_camera_set_chunk_mode(camera, FALSE, nullptr);
+        if (error) {
+            *error = "相机不支持曝光/增益/帧号/线状态/时间戳中的任何块";
+        }
+        return false;
+    }
+
+    size_t xmlSize = 0;
+    const char *xml = arv_device_get_genicam_xml(arv_camera_get_device(camera), &xmlSize);
+    if (xml && xmlSize > 0) {
+        resolveLayouts(xml, xmlSize);
+    }
+
+    for (const FieldLayout &layout : m_fields) {
+        if (!layout.direct) {
+            m_parser = arv_camera_create_chunk_parser(camera);
+            break;
+        }
+    }
+
+    m_active = true;
+    return true;
+}
+
+void ChunkDecoder::disable(ArvCamera *camera)
+{
+    if (m_active && camera) {
+        GError *error = nullptr;
+        arv_camera_set_chunk_mode(camera, FALSE, &error);
+        if (error) {
+            qDebug() << "关闭块模式失败:" << error->message;
+            g_error_free(error);
+        }
+    }
+    reset();
+}
+
+void ChunkDecoder::reset()
+{
+    if (m_parser) {
+        g_object_unref(m_parser);
+        m_parser = nullptr;
+    }
+    m_fields.clear();
+    m_active = false;
+}
+
+bool ChunkDecoder::isActive() const
+{
+    return m_active;
+}
+
+void ChunkDecoder::resolveLayouts(const char *xml, size_t size)
+{
+    std::map<std::string, XmlNode> nodes;
+
+    QXmlStreamReader reader(QByteArray(xml, static_cast<int>(size)));
+    while (!reader.atEnd()) {
+        reader.readNext();
+        if (!reader.isStartElement()) {
+            continue;
+        }
+
+        const QString type = reader.name().toString();
+        if (type != "IntReg" && type != "MaskedIntReg" && type != "FloatReg" && type != "Port"
+            && type != "Integer" && type != "Float") {
+            continue;
+        }
+
+        XmlNode node;
+        node.type = type.toStdString();
+        const std::string name = reader.attributes().value("Name").toString().toStdString();
+
+        while (reader.readNextStartElement()) {
+            const QString child = reader.name().toString();
+            if (child == "Address") {
+                bool ok = false;
+                node.address += parseNumber(reader.readElementText(), &ok);
+                node.hasAddress = true;
+                node.computedAddress |= !ok;
+            } else if (child == "pAddress" || child == "IntSwissKnife" || child == "pIndex") {
+                node.computedAddress = true;
+                reader.skipCurrentElement();
+            } else if (child == "Length") {
+                bool ok = false;
+                node.length = static_cast<uint32_t>(parseNumber(reader.readElementText(), &ok));
+            } else if (child == "pPort") {
+                node.port = reader.readElementText().trimmed().toStdString();
+            } else if (child == "pValue") {
+                node.value = reader.readElementText().trimmed().toStdString();
+            } else if (child == "Endianess") {
+                node.bigEndian = reader.readElementText().trimmed() == "BigEndian";
+            } else if (child == "Sign") {
+                node.isSigned = reader.readElementText().trimmed() == "Signed";
+            } else if (child == "LSB" || child == "Bit") {
+                bool ok = false;
+                node.lsb = static_cast<int>(parseNumber(reader.readElementText(), &ok));
+                if (child == "Bit") {
+                    node.msb = node.lsb;
+                }
+            } else if (child == "MSB") {
+                bool ok = false;
+                node.msb = static_cast<int>(parseNumber(reader.readElementText(), &ok));
+            } else if (child == "ChunkID") {
+                bool ok = false;
+                node.chunkId = parseNumber(reader.readElementText(), &ok);
+                node.hasChunkId = ok;
+            } else {
+                reader.skipCurrentElement();
+            }
+        }
+
+        if (!name.empty()) {
+            nodes[name] = node;
+        }
+    }
+
+    if (reader.hasError()) {
+        qDebug() << "GenICam XML 解析出错，块数据回退到 ArvChunkParser:" << reader.errorString();
+        return;
+    }
+
+    for (FieldLayout &layout : m_fields) {
+        auto it = nodes.find(layout.featureName);
+        // Integer/Float 节点只是别名时跟随一次 pValue
+        if (it != nodes.end() && (it->second.type == "Integer" || it->second.type == "Float")
+            && !it->second.value.empty()) {
+            it = nodes.find(it->second.value);
+        }
+        if (it == nodes.end()) {
+            continue;
+        }
+
+        const XmlNode &reg = it->second;
+        const bool isRegister = reg.type == "IntReg" || reg.type == "MaskedIntReg" || reg.type == "FloatReg";
+        const bool validLength = reg.type == "FloatReg" ? (reg.length == 4 || reg.length == 8)
+                                                        : (reg.length >= 1 && reg.length <= 8);
+        const auto port = nodes.find(reg.port);
+        if (!isRegister || !validLength || !reg.hasAddress || reg.computedAddress
+            || port == nodes.end() || port->second.type != "Port" || !port->second.hasChunkId
+            || (reg.type == "MaskedIntReg" && reg.lsb < 0)) {
+            continue;
+        }
+
+        layout.direct = true;
+        layout.isFloat = reg.type == "FloatReg";
+        layout.chunkId = port->second.chunkId;
+        layout.address = reg.address;
+        layout.length = reg.length;
+        layout.bigEndian = reg.bigEndian;
+        layout.isSigned = reg.isSigned;
+        if (reg.type == "MaskedIntReg") {
+            layout.lsb = reg.lsb;
+            layout.msb = reg.msb < 0 ? reg.lsb : reg.msb;
+        }
+    }
+}
+
+bool ChunkDecoder::readField(const FieldLayout &layout, const uint8_t *chunkData, size_t chunkSize,
+                             double &value, uint64_t &integer)
+{
+    if (!chunkData || layout.address + layout.length > chunkSize) {
+        return false;
+    }
+
+    const uint8_t *p = chunkData + layout.address;
+    uint64_t raw = 0;
+    for (uint32_t i = 0; i < layout.length; ++i) {
+        const uint32_t shift = layout.bigEndian ? (layout.length - 1 - i) * 8 : i * 8;
+        raw |= static_cast<uint64_t>(p[i]) << shift;
+    }
+
+    if (layout.isFloat) {
+        if (layout.length == 4) {
+            float f;
+            const uint32_t bits = static_cast<uint32_t>(raw);
+            std::memcpy(&f, &bits, 4);
+            value = f;
+        } else {
+            std::memcpy(&value, &raw, 8);
+        }
+        return true;
+    }
+
+    uint32_t width = layout.length * 8;
+    if (layout.lsb >= 0) {
+        // GenICam 位号随字节序：小端 LSB <= MSB，大端位 0 为最高位
+        const int registerBits = static_cast<int>(layout.length * 8);
+        const int low = layout.bigEndian ? registerBits - 1 - layout.lsb : layout.lsb;
+        const int high = layout.bigEndian ? registerBits - 1 - layout.msb : layout.msb;
+        if (low < 0 || high < low || high >= registerBits) {
+            return false;
+        }
+        width = static_cast<uint32_t>(high - low + 1);
+        raw >>= low;
+    }
+    if (width < 64) {
+        raw &= (1ull << width) - 1;
+        if (layout.isSigned && (raw >> (width - 1)) & 1) {
+            raw |= ~((1ull << width) - 1);
+        }
+    }
+
+    integer = raw;
+    value = layout.isSigned ? static_cast<double>(static_cast<int64_t>(raw)) : static_cast<double>(raw);
+    return true;
+}
+
+void ChunkDecoder::decode(ArvBuffer *buffer, FrameChunkData &chunk) const
+{
+    chunk = FrameChunkData{};
+    if (!m_active || !arv_buffer_has_chunks(buffer)) {
+        return;
+    }
+
+    for (const FieldLayout &layout : m_fields) {
+        double value = 0.0;
+        uint64_t integer = 0;
+
+        if (layout.direct) {
+            size_t chunkSize = 0;
+            const auto *chunkData = static_cast<const uint8_t*>(
+                arv_buffer_get_chunk_data(buffer, layout.chunkId, &chunkSize));
+            if (!readField(layout, chunkData, chunkSize, value, integer)) {
+                continue;
+            }
+        } else if (m_parser) {
+            GError *error = nullptr;
+            if (layout.isFloat) {
+                value = arv_chunk_parser_get_float_value(m_parser, buffer, layout.featureName, &error);
+            } else {
+                integer = static_cast<uint64_t>(arv_chunk_parser_get_integer_value(m_parser, buffer,
+                                                                                   layout.featureName, &error));
+                value = static_cast<double>(integer);
+            }
+            if (error) {
+                g_error_free(error);
+                continue;
+            }
+        } else {
+            continue;
+        }
+
+        switch (layout.field) {
+        case FrameChunkData::ExposureTime:
+            chunk.exposureUs = value;
+            break;
+        case FrameChunkData::Gain:
+            chunk.gainDb = value;
+            break;
+        case FrameChunkData::FrameId:
+            chunk.frameId = layout.isFloat ? static_cast<uint64_t>(value) : integer;
+            break;
+        case FrameChunkData::LineStatus:
+            chunk.lineStatus = static_cast<uint32_t>(layout.isFloat ? static_cast<uint64_t>(value) : integer);
+            break;
+        case FrameChunkData::Timestamp:
+            chunk.deviceTimestamp = layout.isFloat ? static_cast<uint64_t>(value) : integer;
+            break;
+        }
+        chunk.valid |= layout.field;
+    }
+}
+
+const char *ChunkDecoder::csvHeader()
+{
+    return "chunk_exposure_us,chunk_gain_db,chunk_frame_id,chunk_line_status,chunk_timestamp\n";
+}
+
+void ChunkDecoder::writeCsvColumns(FILE *file, const FrameChunkData &chunk)
+{
+    if (chunk.has(FrameChunkData::ExposureTime)) {
+        std::fprintf(file, "%.3f", chunk.exposureUs);
+    }
+    std::fputc(',', file);
+    if (chunk.has(FrameChunkData::Gain)) {
+        std::fprintf(file, "%.3f", chunk.gainDb);
+    }
+    std::fputc(',', file);
+    if (chunk.has(FrameChunkData::FrameId)) {
+        std::fprintf(file, "%llu", static_cast<unsigned long long>(chunk.frameId));
+    }
+    std::fputc(',', file);
+    if (chunk.has(FrameChunkData::LineStatus)) {
+        std::fprintf(file, "0x%X", chunk.lineStatus);
+    }
+    std::fputc(',', file);
+    if (chunk.has(FrameChunkData::Timestamp)) {
+        std::fprintf(file, "%llu", static_cast<unsigned long long>(chunk.deviceTimestamp));
+    }
+    std::fputc('\n', file);
+}
+
+QString ChunkDecoder::describe() const
+{
+    QStringList parts;
+    for (const FieldLayout &layout : m_fields) {
+        parts << QString("%1(%2)").arg(layout.chunkName)
+                     .arg(layout.direct ? QString("直接读取 ID=0x%1").arg(layout.chunkId, 0, 16)
+                                        : QString("ChunkParser"));
+    }
+    return parts.join(", ");
+}
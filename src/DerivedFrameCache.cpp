@@ -0,0 +1,87 @@
+#include "DerivedFrameCache.h"
+#include "TraceRecorder.h"
+#include <algorithm>
+
+int DerivedFrameCache::subscribe(const DerivedFrameSpec &spec)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = std::find_if(m_outputs.begin(), m_outputs.end(), [&](const std::shared_ptr<Output> &output) {
+        return output->spec == spec;
+    });
+    std::shared_ptr<Output> output;
+    if (it != m_outputs.end()) {
+        output = *it;
+    } else {
+        output = std::make_shared<Output>();
+        output->spec = spec;
+        m_outputs.push_back(output);
+    }
+    output->references++;
+
+    const int subscription = m_nextSubscription++;
+    m_subscriptions[subscription] = output;
+    return subscription;
+}
+
+void DerivedFrameCache::unsubscribe(int subscription)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_subscriptions.find(subscription);
+    if (it == m_subscriptions.end()) {
+        return;
+    }
+
+    // 最后一个订阅者离开时释放输出及其缓存帧（正在 get() 的线程仍持有引用）
+    std::shared_ptr<Output> output = it->second;
+    m_subscriptions.erase(it);
+    if (--output->references == 0) {
+        m_outputs.erase(std::remove(m_outputs.begin(), m_outputs.end(), output), m_outputs.end());
+    }
+}
+
+FramePtr DerivedFrameCache::get(int subscription, const FramePtr &source)
+{
+    if (!source) {
+        return nullptr;
+    }
+
+    std::shared_ptr<Output> output;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_subscriptions.find(subscription);
+        if (it == m_subscriptions.end()) {
+            return nullptr;
+        }
+        output = it->second;
+    }
+
+    if (output->spec.isPassthrough()) {
+        return source;
+    }
+
+    std::lock_guard<std::mutex> lock(output->mutex);
+    if (output->result && output->source.lock() == source) {
+        m_shared.fetch_add(1, std::memory_order_relaxed);
+        return output->result;
+    }
+
+    TraceScope scope("derive", source->frameId);
+    output->result = FrameResampler::derive(*source, output->spec);
+    output->source = source;
+    m_computed.fetch_add(1, std::memory_order_relaxed);
+    return output->result;
+}
+
+DerivedFrameCache::Statistics DerivedFrameCache::statistics() const
+{
+    Statistics stats;
+    stats.computed = m_computed.load(std::memory_order_relaxed);
+    stats.shared = m_shared.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    stats.outputs = static_cast<int>(m_outputs.size());
+    stats.subscriptions = static_cast<int>(m_subscriptions.size());
+    return stats;
+}
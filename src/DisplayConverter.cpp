@@ -0,0 +1,51 @@
+#include "DisplayConverter.h"
+#include "Simd.h"
+#include "TileExecutor.h"
+#include <algorithm>
+#include <cstring>
+
+void DisplayConverter::toGray8(const Frame &frame, uint8_t *out, int outStride)
+{
+    const size_t width = static_cast<size_t>(frame.width);
+    const int shift = std::clamp(frame.bitDepth - 8, 0, 8);
+
+    TileExecutor &executor = TileExecutor::instance();
+    executor.parallelFor(frame.height, executor.autoGrain(frame.height, width * 3),
+                         [&](size_t rowBegin, size_t rowEnd) {
+        for (size_t y = rowBegin; y < rowEnd; ++y) {
+            uint8_t *dst = out + y * outStride;
+            if (frame.bytesPerPixel() == 1) {
+                std::memcpy(dst, frame.bits() + y * width, width);
+            } else {
+                shiftRow16(frame.bits16() + y * width, dst, width, shift);
+            }
+        }
+    });
+}
+
+void DisplayConverter::shiftRow16(const uint16_t *in, uint8_t *out, size_t count, int shift)
+{
+    size_t i = 0;
+
+#if defined(ARAVIS_HAS_AVX2)
+    const __m128i shiftCount = _mm_cvtsi32_si128(shift);
+    for (; i + 32 <= count; i += 32) {
+        __m256i a = _mm256_srl_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)), shiftCount);
+        __m256i b = _mm256_srl_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 16)), shiftCount);
+        // packus 按 128 位通道交错，permute 恢复像素顺序
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+    }
+#elif defined(ARAVIS_HAS_SSE2)
+    const __m128i shiftCount = _mm_cvtsi32_si128(shift);
+    for (; i + 16 <= count; i += 16) {
+        __m128i a = _mm_srl_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)), shiftCount);
+        __m128i b = _mm_srl_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 8)), shiftCount);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(a, b));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        out[i] = static_cast<uint8_t>(std::min<uint32_t>(in[i] >> shift, 255));
+    }
+}
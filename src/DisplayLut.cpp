@@ -0,0 +1,145 @@
+#include "DisplayLut.h"
+#include "TileExecutor.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 调色板控制点之间线性插值
+QVector<QRgb> interpolatePalette(const std::vector<std::array<int, 3>> &stops)
+{
+    QVector<QRgb> colors(256);
+    const int segments = static_cast<int>(stops.size()) - 1;
+    for (int i = 0; i < 256; ++i) {
+        const double position = i / 255.0 * segments;
+        const int segment = std::min(static_cast<int>(position), segments - 1);
+        const double t = position - segment;
+        int rgb[3];
+        for (int c = 0; c < 3; ++c) {
+            rgb[c] = static_cast<int>(std::lround(stops[segment][c] + (stops[segment + 1][c] - stops[segment][c]) * t));
+        }
+        colors[i] = qRgb(rgb[0], rgb[1], rgb[2]);
+    }
+    return colors;
+}
+
+// 4 路展开，让相邻像素的查表读取互相独立
+template <typename T>
+void lookupRow(const T *in, uint8_t *out, size_t count, const uint8_t *table)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        out[i] = table[in[i]];
+        out[i + 1] = table[in[i + 1]];
+        out[i + 2] = table[in[i + 2]];
+        out[i + 3] = table[in[i + 3]];
+    }
+    for (; i < count; ++i) {
+        out[i] = table[in[i]];
+    }
+}
+
+} // namespace
+
+void DisplayLut::setWindow(const DisplayWindow &window)
+{
+    DisplayWindow normalized = window;
+    normalized.low = std::clamp(window.low, 0.0, 0.999);
+    normalized.high = std::clamp(window.high, normalized.low + 0.001, 1.0);
+    normalized.gamma = std::clamp(window.gamma, 0.1, 10.0);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (normalized == m_window) {
+        return;
+    }
+    if (normalized.palette != m_window.palette) {
+        m_colorTable = paletteColors(normalized.palette);
+    }
+    m_window = normalized;
+    // 只清空缓存，表在下次用到该位深时重建
+    m_tables.fill(nullptr);
+}
+
+DisplayWindow DisplayLut::window() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_window;
+}
+
+QVector<QRgb> DisplayLut::colorTable() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_colorTable;
+}
+
+std::shared_ptr<const DisplayLut::Table> DisplayLut::tableFor(int bitDepth)
+{
+    bitDepth = std::clamp(bitDepth, 8, 16);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::shared_ptr<const Table> &table = m_tables[bitDepth];
+    if (!table) {
+        table = buildTable(m_window, bitDepth);
+    }
+    return table;
+}
+
+std::shared_ptr<const DisplayLut::Table> DisplayLut::buildTable(const DisplayWindow &window, int bitDepth)
+{
+    const size_t entries = bitDepth > 8 ? 65536 : 256;
+    const double maxValue = static_cast<double>((1 << bitDepth) - 1);
+    const double low = window.low * maxValue;
+    const double range = (window.high - window.low) * maxValue;
+    const double exponent = 1.0 / window.gamma;
+
+    auto table = std::make_shared<Table>(entries);
+    for (size_t value = 0; value < entries; ++value) {
+        const double t = std::clamp((static_cast<double>(value) - low) / range, 0.0, 1.0);
+        (*table)[value] = static_cast<uint8_t>(std::lround(std::pow(t, exponent) * 255.0));
+    }
+    return table;
+}
+
+void DisplayLut::convert(const Frame &frame, uint8_t *out, int outStride)
+{
+    const std::shared_ptr<const Table> table = tableFor(frame.bitDepth);
+    const uint8_t *lut = table->data();
+    const size_t width = static_cast<size_t>(frame.width);
+
+    TileExecutor &executor = TileExecutor::instance();
+    executor.parallelFor(frame.height, executor.autoGrain(frame.height, width * 3),
+                         [&](size_t rowBegin, size_t rowEnd) {
+        for (size_t y = rowBegin; y < rowEnd; ++y) {
+            uint8_t *dst = out + y * outStride;
+            if (frame.bytesPerPixel() == 1) {
+                applyRow8(frame.bits() + y * width, dst, width, lut);
+            } else {
+                applyRow16(frame.bits16() + y * width, dst, width, lut);
+            }
+        }
+    });
+}
+
+void DisplayLut::applyRow8(const uint8_t *in, uint8_t *out, size_t count, const uint8_t *table)
+{
+    lookupRow(in, out, count, table);
+}
+
+void DisplayLut::applyRow16(const uint16_t *in, uint8_t *out, size_t count, const uint8_t *table)
+{
+    // 表覆盖全部 65536 个取值，无需掩码或比较
+    lookupRow(in, out, count, table);
+}
+
+QVector<QRgb> DisplayLut::paletteColors(DisplayWindow::Palette palette)
+{
+    switch (palette) {
+    case DisplayWindow::Palette::Hot:
+        return interpolatePalette({{0, 0, 0}, {230, 0, 0}, {255, 210, 0}, {255, 255, 255}});
+    case DisplayWindow::Palette::Rainbow:
+        return interpolatePalette({{0, 0, 143}, {0, 0, 255}, {0, 255, 255}, {0, 255, 0},
+                                   {255, 255, 0}, {255, 0, 0}, {128, 0, 0}});
+    case DisplayWindow::Palette::Gray:
+    default:
+        return QVector<QRgb>();
+    }
+}
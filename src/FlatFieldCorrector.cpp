@@ -0,0 +1,320 @@
+#include "FlatFieldCorrector.h"
+#include "Simd.h"
+#include "TileExecutor.h"
+#include <QDebug>
+#include <QMetaObject>
+#include <algorithm>
+
+FlatFieldCorrector::FlatFieldCorrector(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void FlatFieldCorrector::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+}
+
+bool FlatFieldCorrector::isEnabled() const
+{
+    return m_enabled;
+}
+
+void FlatFieldCorrector::startCalibration(CalibrationKind kind, int frameCount)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_calibrationRequested = true;
+    m_requestedKind = kind;
+    m_requestedFrames = std::max(frameCount, 1);
+}
+
+void FlatFieldCorrector::clearCalibration()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cache.clear();
+    ++m_cacheGeneration;
+}
+
+const char *FlatFieldCorrector::stageName() const
+{
+    return "FlatField";
+}
+
+FramePtr FlatFieldCorrector::process(FramePtr frame)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_calibrationRequested) {
+            m_calibrationRequested = false;
+            m_calibrating = true;
+            m_activeKind = m_requestedKind;
+            m_activeKey = keyOf(*frame);
+            m_targetFrames = m_requestedFrames;
+            m_capturedFrames = 0;
+            m_accumulator.assign(static_cast<size_t>(frame->width) * frame->height, 0);
+        }
+    }
+
+    // 标定期间使用未校正的原始帧
+    if (m_calibrating) {
+        if (keyOf(*frame) != m_activeKey) {
+            m_calibrating = false;
+            QMetaObject::invokeMethod(this, [this]() {
+                emit calibrationFinished("标定中止: 图像尺寸或位深发生变化");
+            }, Qt::QueuedConnection);
+        } else {
+            accumulate(*frame);
+            return frame;
+        }
+    }
+
+    if (!m_enabled) {
+        return frame;
+    }
+
+    const CalibrationKey key = keyOf(*frame);
+    MapsPtr maps = findMaps(key);
+    if (!maps) {
+        return frame;
+    }
+
+    // 帧可能已被其他消费者引用，原地修改前确保独占
+    if (frame.use_count() > 1) {
+        frame = std::make_shared<Frame>(*frame);
+    }
+
+    // 按行带并行，校正图与帧行对齐
+    Frame *target = frame.get();
+    const size_t width = static_cast<size_t>(target->width);
+    TileExecutor &executor = TileExecutor::instance();
+    executor.parallelFor(target->height, executor.autoGrain(target->height, width * 6),
+                         [target, &maps, width](size_t rowBegin, size_t rowEnd) {
+        const size_t offset = rowBegin * width;
+        const size_t count = (rowEnd - rowBegin) * width;
+        if (target->bytesPerPixel() == 1) {
+            correct8(target->bits() + offset, maps->dark.data() + offset, maps->gain.data() + offset, count);
+        } else {
+            correct16(target->bits16() + offset, maps->dark.data() + offset, maps->gain.data() + offset,
+                      count, target->bitDepth);
+        }
+    });
+    return frame;
+}
+
+FlatFieldCorrector::CalibrationKey FlatFieldCorrector::keyOf(const Frame &frame)
+{
+    return CalibrationKey{frame.offsetX, frame.offsetY, frame.width, frame.height, frame.bitDepth};
+}
+
+FlatFieldCorrector::MapsPtr FlatFieldCorrector::findMaps(const CalibrationKey &key)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // 几何不变且缓存未清空时直接复用
+    if (m_currentMaps && m_currentGeneration == m_cacheGeneration && m_currentMaps->key == key) {
+        return m_currentMaps;
+    }
+    m_currentGeneration = m_cacheGeneration;
+    m_currentMaps.reset();
+
+    auto it = m_cache.find(key);
+    if (it != m_cache.end()) {
+        m_currentMaps = it->second;
+        return m_currentMaps;
+    }
+
+    // 查找覆盖当前 ROI 的标定区域并裁剪
+    for (const auto &entry : m_cache) {
+        const CalibrationKey &source = entry.first;
+        if (entry.second->derived || source.bitDepth != key.bitDepth ||
+            key.x < source.x || key.y < source.y ||
+            key.x + key.width > source.x + source.width ||
+            key.y + key.height > source.y + source.height) {
+            continue;
+        }
+
+        auto maps = std::make_shared<CalibrationMaps>();
+        maps->key = key;
+        maps->derived = true;
+        maps->dark.resize(static_cast<size_t>(key.width) * key.height);
+        maps->gain.resize(maps->dark.size());
+        for (int y = 0; y < key.height; ++y) {
+            const size_t src = static_cast<size_t>(key.y - source.y + y) * source.width + (key.x - source.x);
+            const size_t dst = static_cast<size_t>(y) * key.width;
+            std::copy_n(entry.second->dark.begin() + src, key.width, maps->dark.begin() + dst);
+            std::copy_n(entry.second->gain.begin() + src, key.width, maps->gain.begin() + dst);
+        }
+
+        qDebug() << "平场校正: 从" << source.width << "x" << source.height << "标定裁剪 ROI"
+                 << key.x << key.y << key.width << key.height;
+        m_cache[key] = maps;
+        m_currentMaps = maps;
+        return m_currentMaps;
+    }
+
+    return nullptr;
+}
+
+void FlatFieldCorrector::accumulate(const Frame &frame)
+{
+    const size_t count = m_accumulator.size();
+    if (frame.bytesPerPixel() == 1) {
+        const uint8_t *src = frame.bits();
+        for (size_t i = 0; i < count; ++i) {
+            m_accumulator[i] += src[i];
+        }
+    } else {
+        const uint16_t *src = frame.bits16();
+        for (size_t i = 0; i < count; ++i) {
+            m_accumulator[i] += src[i];
+        }
+    }
+
+    ++m_capturedFrames;
+    QMetaObject::invokeMethod(this, [this, captured = m_capturedFrames, total = m_targetFrames]() {
+        emit calibrationProgress(captured, total);
+    }, Qt::QueuedConnection);
+
+    if (m_capturedFrames >= m_targetFrames) {
+        finishCalibration();
+    }
+}
+
+void FlatFieldCorrector::finishCalibration()
+{
+    m_calibrating = false;
+
+    const CalibrationKey key = m_activeKey;
+    const size_t count = m_accumulator.size();
+    const uint32_t frames = static_cast<uint32_t>(m_capturedFrames);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto maps = std::make_shared<CalibrationMaps>();
+    maps->key = key;
+
+    auto existing = m_cache.find(key);
+    if (existing != m_cache.end() && !existing->second->derived) {
+        maps->dark = existing->second->dark;
+        maps->gain = existing->second->gain;
+    } else {
+        maps->dark.assign(count, 0);
+        maps->gain.assign(count, GAIN_ONE);
+    }
+
+    QString summary;
+    if (m_activeKind == CalibrationKind::Dark) {
+        uint64_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            maps->dark[i] = static_cast<uint16_t>((m_accumulator[i] + frames / 2) / frames);
+            total += maps->dark[i];
+        }
+        summary = QString("暗场标定完成: %1 帧, 平均暗电平 %2")
+                      .arg(frames).arg(static_cast<double>(total) / count, 0, 'f', 2);
+    } else {
+        // 扣除暗场后的逐像素均值，增益 = 全局均值 / 像素均值
+        std::vector<uint32_t> &net = m_accumulator;
+        uint64_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const uint32_t mean = (net[i] + frames / 2) / frames;
+            net[i] = mean > maps->dark[i] ? mean - maps->dark[i] : 1;
+            total += net[i];
+        }
+
+        const double globalMean = static_cast<double>(total) / count;
+        for (size_t i = 0; i < count; ++i) {
+            const double gain = globalMean / net[i] * GAIN_ONE + 0.5;
+            maps->gain[i] = static_cast<uint16_t>(std::min(gain, 65535.0));
+        }
+        summary = QString("平场标定完成: %1 帧, 平均响应 %2").arg(frames).arg(globalMean, 0, 'f', 2);
+    }
+
+    // 新标定使所有裁剪出来的映射失效
+    for (auto it = m_cache.begin(); it != m_cache.end();) {
+        it = it->second->derived ? m_cache.erase(it) : std::next(it);
+    }
+    m_cache[key] = maps;
+    ++m_cacheGeneration;
+
+    m_accumulator.clear();
+    m_accumulator.shrink_to_fit();
+
+    summary += QString(" (ROI %1,%2 %3x%4)").arg(key.x).arg(key.y).arg(key.width).arg(key.height);
+    qDebug() << summary;
+    QMetaObject::invokeMethod(this, [this, summary]() {
+        emit calibrationFinished(summary);
+    }, Qt::QueuedConnection);
+}
+
+void FlatFieldCorrector::correct8(uint8_t *pixels, const uint16_t *dark, const uint16_t *gain, size_t count)
+{
+    size_t i = 0;
+
+    // (v - d) << 4 不超过 16 位，mulhi 取高 16 位即得 (v - d) * g >> 12
+#if defined(ARAVIS_HAS_AVX2)
+    for (; i + 16 <= count; i += 16) {
+        __m256i v = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i)));
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dark + i));
+        __m256i g = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(gain + i));
+        v = _mm256_slli_epi16(_mm256_subs_epu16(v, d), 16 - GAIN_SHIFT);
+        __m256i r = _mm256_mulhi_epu16(v, g);
+        __m128i packed = _mm_packus_epi16(_mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), packed);
+    }
+#elif defined(ARAVIS_HAS_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16) {
+        __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i));
+        __m128i lo = _mm_unpacklo_epi8(raw, zero);
+        __m128i hi = _mm_unpackhi_epi8(raw, zero);
+        lo = _mm_slli_epi16(_mm_subs_epu16(lo, _mm_loadu_si128(reinterpret_cast<const __m128i*>(dark + i))), 16 - GAIN_SHIFT);
+        hi = _mm_slli_epi16(_mm_subs_epu16(hi, _mm_loadu_si128(reinterpret_cast<const __m128i*>(dark + i + 8))), 16 - GAIN_SHIFT);
+        lo = _mm_mulhi_epu16(lo, _mm_loadu_si128(reinterpret_cast<const __m128i*>(gain + i)));
+        hi = _mm_mulhi_epu16(hi, _mm_loadu_si128(reinterpret_cast<const __m128i*>(gain + i + 8)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        const uint32_t v = pixels[i] > dark[i] ? pixels[i] - dark[i] : 0;
+        pixels[i] = static_cast<uint8_t>(std::min<uint32_t>((v * gain[i]) >> GAIN_SHIFT, 255));
+    }
+}
+
+void FlatFieldCorrector::correct16(uint16_t *pixels, const uint16_t *dark, const uint16_t *gain, size_t count, int bitDepth)
+{
+    const uint32_t maxValue = (1u << bitDepth) - 1;
+    size_t i = 0;
+
+    // 12 位及以下数据左移 4 位仍在 16 位内，可走与 8 位相同的 mulhi 定点路径
+    if (bitDepth <= 12) {
+#if defined(ARAVIS_HAS_AVX2)
+        const __m256i limit = _mm256_set1_epi16(static_cast<short>(maxValue));
+        for (; i + 16 <= count; i += 16) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + i));
+            __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dark + i));
+            __m256i g = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(gain + i));
+            v = _mm256_slli_epi16(_mm256_subs_epu16(v, d), 16 - GAIN_SHIFT);
+            __m256i r = _mm256_min_epu16(_mm256_mulhi_epu16(v, g), limit);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels + i), r);
+        }
+#elif defined(ARAVIS_HAS_SSE2)
+        const __m128i limit = _mm_set1_epi16(static_cast<short>(maxValue));
+        for (; i + 8 <= count; i += 8) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i));
+            __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dark + i));
+            __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(gain + i));
+            v = _mm_slli_epi16(_mm_subs_epu16(v, d), 16 - GAIN_SHIFT);
+            __m128i r = _mm_mulhi_epu16(v, g);
+            // SSE2 没有无符号 16 位 min: min(r, limit) = r - subs(r, limit)
+            r = _mm_sub_epi16(r, _mm_subs_epu16(r, limit));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), r);
+        }
+#endif
+    }
+
+    for (; i < count; ++i) {
+        const uint32_t v = pixels[i] > dark[i] ? pixels[i] - dark[i] : 0;
+        pixels[i] = static_cast<uint16_t>(std::min<uint32_t>((v * gain[i]) >> GAIN_SHIFT, maxValue));
+    }
+}
@@ -0,0 +1,237 @@
+#include "FocusMetric.h"
+#include "Simd.h"
+#include "TileExecutor.h"
+#include <algorithm>
+
+namespace {
+
+#if defined(ARAVIS_HAS_AVX2)
+// 每累加这么多组就把 int32 累加器并入 64 位总和，保证不溢出
+constexpr int FLUSH_INTERVAL = 128;
+
+inline __m256i load16u8(const uint8_t *p)
+{
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+inline int64_t horizontalSum32(__m256i v)
+{
+    alignas(32) int32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), v);
+    int64_t sum = 0;
+    for (int32_t lane : lanes) {
+        sum += lane;
+    }
+    return sum;
+}
+
+inline uint64_t horizontalSumU32(__m256i v)
+{
+    alignas(32) uint32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), v);
+    uint64_t sum = 0;
+    for (uint32_t lane : lanes) {
+        sum += lane;
+    }
+    return sum;
+}
+#endif
+
+} // namespace
+
+double FocusMetric::compute(const Frame &frame, Method method, const ImageRegion &region)
+{
+    // 3x3 邻域需要一圈边界像素
+    int x0 = 1, y0 = 1, x1 = frame.width - 1, y1 = frame.height - 1;
+    if (!region.isEmpty()) {
+        x0 = std::max(x0, region.x);
+        y0 = std::max(y0, region.y);
+        x1 = std::min(x1, region.x + region.width);
+        y1 = std::min(y1, region.y + region.height);
+    }
+    if (x1 - x0 < 1 || y1 - y0 < 1) {
+        return 0.0;
+    }
+
+    // 按行带并行，每块写自己的部分和，最后按块序号相加
+    TileExecutor &executor = TileExecutor::instance();
+    const size_t rows = static_cast<size_t>(y1 - y0);
+    const size_t grain = executor.autoGrain(rows, static_cast<size_t>(x1 - x0) * frame.bytesPerPixel());
+    std::vector<Sums> partial(TileExecutor::chunkCount(rows, grain));
+
+    executor.parallelFor(rows, grain, [&](size_t begin, size_t end) {
+        const int yBegin = y0 + static_cast<int>(begin);
+        const int yEnd = y0 + static_cast<int>(end);
+        Sums &sums = partial[begin / grain];
+        if (frame.bytesPerPixel() == 1) {
+            sums = method == Method::Laplacian ? laplacian8(frame, x0, yBegin, x1, yEnd)
+                                               : tenengrad8(frame, x0, yBegin, x1, yEnd);
+        } else {
+            sums = method == Method::Laplacian
+                       ? laplacianScalar(frame.bits16(), frame.width, x0, yBegin, x1, yEnd)
+                       : tenengradScalar(frame.bits16(), frame.width, x0, yBegin, x1, yEnd);
+        }
+    });
+
+    Sums total;
+    for (const Sums &sums : partial) {
+        total.sum += sums.sum;
+        total.squares += sums.squares;
+    }
+
+    const double count = static_cast<double>(x1 - x0) * static_cast<double>(y1 - y0);
+    if (method == Method::Tenengrad) {
+        return static_cast<double>(total.squares) / count;
+    }
+    const double mean = static_cast<double>(total.sum) / count;
+    return static_cast<double>(total.squares) / count - mean * mean;
+}
+
+FocusMetric::Sums FocusMetric::laplacian8(const Frame &frame, int x0, int y0, int x1, int y1)
+{
+#if defined(ARAVIS_HAS_AVX2)
+    const int stride = frame.stride();
+    const __m256i ones = _mm256_set1_epi16(1);
+    int64_t sum = 0;
+    uint64_t sumSquares = 0;
+
+    for (int y = y0; y < y1; ++y) {
+        const uint8_t *up = frame.bits() + static_cast<size_t>(y - 1) * stride;
+        const uint8_t *mid = up + stride;
+        const uint8_t *down = mid + stride;
+
+        __m256i accSum = _mm256_setzero_si256();
+        __m256i accSquares = _mm256_setzero_si256();
+        int groups = 0;
+        int x = x0;
+
+        for (; x + 16 <= x1; x += 16) {
+            __m256i center = load16u8(mid + x);
+            __m256i neighbours = _mm256_add_epi16(
+                _mm256_add_epi16(load16u8(mid + x - 1), load16u8(mid + x + 1)),
+                _mm256_add_epi16(load16u8(up + x), load16u8(down + x)));
+            __m256i lap = _mm256_sub_epi16(_mm256_slli_epi16(center, 2), neighbours);
+
+            accSum = _mm256_add_epi32(accSum, _mm256_madd_epi16(lap, ones));
+            accSquares = _mm256_add_epi32(accSquares, _mm256_madd_epi16(lap, lap));
+
+            if (++groups == FLUSH_INTERVAL) {
+                sum += horizontalSum32(accSum);
+                sumSquares += horizontalSumU32(accSquares);
+                accSum = _mm256_setzero_si256();
+                accSquares = _mm256_setzero_si256();
+                groups = 0;
+            }
+        }
+
+        sum += horizontalSum32(accSum);
+        sumSquares += horizontalSumU32(accSquares);
+
+        for (; x < x1; ++x) {
+            const int lap = 4 * mid[x] - mid[x - 1] - mid[x + 1] - up[x] - down[x];
+            sum += lap;
+            sumSquares += static_cast<uint64_t>(lap * lap);
+        }
+    }
+
+    return Sums{sum, sumSquares};
+#else
+    return laplacianScalar(frame.bits(), frame.width, x0, y0, x1, y1);
+#endif
+}
+
+FocusMetric::Sums FocusMetric::tenengrad8(const Frame &frame, int x0, int y0, int x1, int y1)
+{
+#if defined(ARAVIS_HAS_AVX2)
+    const int stride = frame.stride();
+    uint64_t sumSquares = 0;
+
+    for (int y = y0; y < y1; ++y) {
+        const uint8_t *up = frame.bits() + static_cast<size_t>(y - 1) * stride;
+        const uint8_t *mid = up + stride;
+        const uint8_t *down = mid + stride;
+
+        __m256i accSquares = _mm256_setzero_si256();
+        int groups = 0;
+        int x = x0;
+
+        for (; x + 16 <= x1; x += 16) {
+            __m256i ul = load16u8(up + x - 1), uc = load16u8(up + x), ur = load16u8(up + x + 1);
+            __m256i ml = load16u8(mid + x - 1), mr = load16u8(mid + x + 1);
+            __m256i dl = load16u8(down + x - 1), dc = load16u8(down + x), dr = load16u8(down + x + 1);
+
+            // Gx = (ur + 2mr + dr) - (ul + 2ml + dl), Gy = (dl + 2dc + dr) - (ul + 2uc + ur)
+            __m256i gx = _mm256_sub_epi16(
+                _mm256_add_epi16(_mm256_add_epi16(ur, dr), _mm256_slli_epi16(mr, 1)),
+                _mm256_add_epi16(_mm256_add_epi16(ul, dl), _mm256_slli_epi16(ml, 1)));
+            __m256i gy = _mm256_sub_epi16(
+                _mm256_add_epi16(_mm256_add_epi16(dl, dr), _mm256_slli_epi16(dc, 1)),
+                _mm256_add_epi16(_mm256_add_epi16(ul, ur), _mm256_slli_epi16(uc, 1)));
+
+            // 每个 32 位通道一次最多累加 4 × 1020²，128 组内不会溢出 uint32
+            accSquares = _mm256_add_epi32(accSquares,
+                _mm256_add_epi32(_mm256_madd_epi16(gx, gx), _mm256_madd_epi16(gy, gy)));
+
+            if (++groups == FLUSH_INTERVAL) {
+                sumSquares += horizontalSumU32(accSquares);
+                accSquares = _mm256_setzero_si256();
+                groups = 0;
+            }
+        }
+
+        sumSquares += horizontalSumU32(accSquares);
+
+        for (; x < x1; ++x) {
+            const int gx = (up[x + 1] + 2 * mid[x + 1] + down[x + 1]) - (up[x - 1] + 2 * mid[x - 1] + down[x - 1]);
+            const int gy = (down[x - 1] + 2 * down[x] + down[x + 1]) - (up[x - 1] + 2 * up[x] + up[x + 1]);
+            sumSquares += static_cast<uint64_t>(gx * gx + gy * gy);
+        }
+    }
+
+    return Sums{0, sumSquares};
+#else
+    return tenengradScalar(frame.bits(), frame.width, x0, y0, x1, y1);
+#endif
+}
+
+template <typename T>
+FocusMetric::Sums FocusMetric::laplacianScalar(const T *bits, int stride, int x0, int y0, int x1, int y1)
+{
+    Sums sums;
+
+    for (int y = y0; y < y1; ++y) {
+        const T *up = bits + static_cast<size_t>(y - 1) * stride;
+        const T *mid = up + stride;
+        const T *down = mid + stride;
+
+        for (int x = x0; x < x1; ++x) {
+            const int64_t lap = 4 * static_cast<int64_t>(mid[x]) - mid[x - 1] - mid[x + 1] - up[x] - down[x];
+            sums.sum += lap;
+            sums.squares += static_cast<uint64_t>(lap * lap);
+        }
+    }
+
+    return sums;
+}
+
+template <typename T>
+FocusMetric::Sums FocusMetric::tenengradScalar(const T *bits, int stride, int x0, int y0, int x1, int y1)
+{
+    Sums sums;
+
+    for (int y = y0; y < y1; ++y) {
+        const T *up = bits + static_cast<size_t>(y - 1) * stride;
+        const T *mid = up + stride;
+        const T *down = mid + stride;
+
+        for (int x = x0; x < x1; ++x) {
+            const int64_t gx = (static_cast<int64_t>(up[x + 1]) + 2 * mid[x + 1] + down[x + 1])
+                             - (static_cast<int64_t>(up[x - 1]) + 2 * mid[x - 1] + down[x - 1]);
+            const int64_t gy = (static_cast<int64_t>(down[x - 1]) + 2 * down[x] + down[x + 1])
+                             - (static_cast<int64_t>(up[x - 1]) + 2 * up[x] + up[x + 1]);
+            sums.squares += static_cast<uint64_t>(gx * gx + gy * gy);
+        }
+    }
+
+    return sums;
+}
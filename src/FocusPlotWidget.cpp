@@ -0,0 +1,76 @@
+#include "FocusPlotWidget.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QPolygonF>
+#include <algorithm>
+
+FocusPlotWidget::FocusPlotWidget(QWidget *parent)
+    : QWidget(parent)
+    , m_values(HISTORY_SIZE, 0.0)
+{
+    setMinimumHeight(100);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+void FocusPlotWidget::addValue(double score, double computeTimeUs)
+{
+    m_values[m_head] = score;
+    m_head = (m_head + 1) % HISTORY_SIZE;
+    m_count = std::min(m_count + 1, HISTORY_SIZE);
+    m_peak = std::max(m_peak, score);
+    m_lastComputeTimeUs = computeTimeUs;
+    update();
+}
+
+void FocusPlotWidget::clear()
+{
+    m_head = 0;
+    m_count = 0;
+    m_peak = 0.0;
+    update();
+}
+
+void FocusPlotWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.fillRect(rect(), QColor(24, 24, 24));
+
+    if (m_count == 0) {
+        painter.setPen(Qt::gray);
+        painter.drawText(rect(), Qt::AlignCenter, "对焦评价未启用");
+        return;
+    }
+
+    const int first = (m_head - m_count + HISTORY_SIZE) % HISTORY_SIZE;
+    double minValue = m_values[first];
+    double maxValue = m_values[first];
+    for (int i = 0; i < m_count; ++i) {
+        const double v = m_values[(first + i) % HISTORY_SIZE];
+        minValue = std::min(minValue, v);
+        maxValue = std::max(maxValue, v);
+    }
+    const double span = maxValue > minValue ? maxValue - minValue : 1.0;
+
+    const QRectF plot = QRectF(rect()).adjusted(4, 20, -4, -4);
+    QPolygonF curve(m_count);
+    for (int i = 0; i < m_count; ++i) {
+        const double v = m_values[(first + i) % HISTORY_SIZE];
+        curve[i] = QPointF(plot.left() + plot.width() * i / (HISTORY_SIZE - 1),
+                           plot.bottom() - plot.height() * (v - minValue) / span);
+    }
+
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setPen(QPen(QColor(80, 200, 120), 1.5));
+    painter.drawPolyline(curve);
+
+    const double current = m_values[(m_head - 1 + HISTORY_SIZE) % HISTORY_SIZE];
+    painter.setPen(Qt::white);
+    painter.drawText(QRectF(4, 2, width() - 8, 18), Qt::AlignLeft | Qt::AlignVCenter,
+                     QString("对焦: %1  峰值: %2 (%3%)  耗时: %4 μs")
+                         .arg(current, 0, 'f', 1)
+                         .arg(m_peak, 0, 'f', 1)
+                         .arg(m_peak > 0.0 ? 100.0 * current / m_peak : 0.0, 0, 'f', 0)
+                         .arg(m_lastComputeTimeUs, 0, 'f', 0));
+}
@@ -0,0 +1,202 @@
+#include "FrameAnalyzer.h"
+#include "AutoExposureController.h"
+#include "TraceRecorder.h"
+#include <QDebug>
+#include <QMetaObject>
+#include <chrono>
+
+namespace {
+
+int64_t steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+FrameAnalyzer::FrameAnalyzer(QObject *parent)
+    : QObject(parent)
+    , m_running(false)
+    , m_histogramIntervalNs(100'000'000)   // 默认 10 Hz
+{
+}
+
+FrameAnalyzer::~FrameAnalyzer()
+{
+    stop();
+}
+
+void FrameAnalyzer::start()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_running) {
+        return;
+    }
+
+    m_running = true;
+    m_pendingFrame.reset();
+    m_lastSubmitNs = 0;
+    m_lastEmitNs = 0;
+    m_workerThread = std::thread(&FrameAnalyzer::workerLoop, this);
+}
+
+void FrameAnalyzer::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running) {
+            return;
+        }
+        m_running = false;
+        m_pendingFrame.reset();
+    }
+    m_cond.notify_one();
+
+    if (m_workerThread.joinable()) {
+        m_workerThread.join();
+    }
+}
+
+bool FrameAnalyzer::isRunning() const
+{
+    return m_workerThread.joinable();
+}
+
+void FrameAnalyzer::submitFrame(const FramePtr &frame)
+{
+    // 自动曝光和对焦评价需要每帧处理
+    const bool everyFrame = m_focusEnabled || (m_autoExposure && m_autoExposure->isEnabled());
+    if (!m_histogramEnabled && !everyFrame) {
+        return;
+    }
+
+    // 按统计频率节流，只在采集线程上做一次时钟读取
+    if (!everyFrame) {
+        const int64_t now = steadyNowNs();
+        if (now - m_lastSubmitNs.load(std::memory_order_relaxed) < m_histogramIntervalNs.load(std::memory_order_relaxed)) {
+            return;
+        }
+        m_lastSubmitNs.store(now, std::memory_order_relaxed);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running) {
+            return;
+        }
+        m_pendingFrame = frame;
+    }
+    m_cond.notify_one();
+}
+
+void FrameAnalyzer::setHistogramEnabled(bool enabled)
+{
+    m_histogramEnabled = enabled;
+}
+
+bool FrameAnalyzer::isHistogramEnabled() const
+{
+    return m_histogramEnabled;
+}
+
+void FrameAnalyzer::setHistogramRate(double hz)
+{
+    m_histogramIntervalNs = hz > 0.0 ? static_cast<int64_t>(1e9 / hz) : 0;
+}
+
+double FrameAnalyzer::histogramRate() const
+{
+    const int64_t interval = m_histogramIntervalNs;
+    return interval > 0 ? 1e9 / static_cast<double>(interval) : 0.0;
+}
+
+void FrameAnalyzer::setSampleStep(int step)
+{
+    m_sampleStep = step;
+}
+
+int FrameAnalyzer::sampleStep() const
+{
+    return m_sampleStep;
+}
+
+void FrameAnalyzer::setFocusEnabled(bool enabled)
+{
+    m_focusEnabled = enabled;
+}
+
+bool FrameAnalyzer::isFocusEnabled() const
+{
+    return m_focusEnabled;
+}
+
+void FrameAnalyzer::setFocusMethod(FocusMetric::Method method)
+{
+    m_focusMethod = method;
+}
+
+void FrameAnalyzer::setFocusRegion(const ImageRegion &region)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_focusRegion = region;
+}
+
+void FrameAnalyzer::setAutoExposureController(AutoExposureController *controller)
+{
+    m_autoExposure = controller;
+}
+
+void FrameAnalyzer::workerLoop()
+{
+    qDebug() << "分析线程启动";
+    TraceRecorder::setThreadName("分析线程");
+
+    while (true) {
+        FramePtr frame;
+        ImageRegion focusRegion;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cond.wait(lock, [this]() { return !m_running || m_pendingFrame; });
+            if (!m_running) {
+                break;
+            }
+            frame = std::move(m_pendingFrame);
+            focusRegion = m_focusRegion;
+        }
+
+        TraceScope scope("analyze", frame->frameId);
+        const int64_t now = steadyNowNs();
+        const bool autoExposure = m_autoExposure && m_autoExposure->isEnabled();
+        const bool histogramDue = m_histogramEnabled &&
+            now - m_lastEmitNs >= m_histogramIntervalNs.load(std::memory_order_relaxed);
+
+        if (autoExposure || histogramDue) {
+            m_histogramEngine.compute(*frame, m_sampleStep, m_statistics);
+
+            if (autoExposure) {
+                m_autoExposure->process(m_statistics);
+            }
+
+            if (histogramDue) {
+                m_lastEmitNs = now;
+                QMetaObject::invokeMethod(this, [this, stats = m_statistics]() {
+                    emit statisticsReady(stats);
+                }, Qt::QueuedConnection);
+            }
+        }
+
+        if (m_focusEnabled) {
+            auto start = std::chrono::steady_clock::now();
+            const double score = FocusMetric::compute(*frame, m_focusMethod, focusRegion);
+            const double elapsedUs = std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - start).count();
+
+            QMetaObject::invokeMethod(this, [this, score, elapsedUs]() {
+                emit focusMeasured(score, elapsedUs);
+            }, Qt::QueuedConnection);
+        }
+    }
+
+    qDebug() << "分析线程停止";
+}
@@ -0,0 +1,248 @@
+#include "FrameBusClient.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+FrameBusClient::~FrameBusClient()
+{
+    close();
+}
+
+uint64_t FrameBusClient::publishedFrames() const
+{
+    return m_header ? m_header->published.load(std::memory_order_acquire) : 0;
+}
+
+FrameBusClient::ReadResult FrameBusClient::readNext(const ViewFunction &fn)
+{
+    if (!m_header) {
+        return ReadResult::Closed;
+    }
+
+    while (true) {
+        if (m_header->closed.load(std::memory_order_acquire)) {
+            return ReadResult::Closed;
+        }
+
+        const uint64_t published = m_header->published.load(std::memory_order_acquire);
+        if (m_next >= published) {
+            return ReadResult::NoFrame;
+        }
+
+        // 序号 published 的槽位可能正在写入，最旧的安全帧是 published - slotCount + 1
+        const uint64_t oldest = published > m_header->slotCount ? published - m_header->slotCount + 1 : 0;
+        if (m_next < oldest) {
+            m_missed += oldest - m_next;
+            m_next = oldest;
+        }
+
+        const ReadResult result = readSequence(m_next, fn);
+        if (result == ReadResult::Overrun) {
+            ++m_missed;
+            ++m_next;
+            continue;
+        }
+        if (result == ReadResult::Ok) {
+            ++m_next;
+        }
+        return result;
+    }
+}
+
+FrameBusClient::ReadResult FrameBusClient::readLatest(const ViewFunction &fn)
+{
+    if (!m_header) {
+        return ReadResult::Closed;
+    }
+
+    const uint64_t published = m_header->published.load(std::memory_order_acquire);
+    if (published == 0 || published <= m_next) {
+        return m_header->closed.load(std::memory_order_acquire) ? ReadResult::Closed : ReadResult::NoFrame;
+    }
+
+    m_missed += published - 1 - m_next;
+    m_next = published - 1;
+    return readNext(fn);
+}
+
+FrameBusClient::ReadResult FrameBusClient::copyLatest(std::vector<uint8_t> &data, FrameView &meta)
+{
+    const ReadResult result = readLatest([&](const FrameView &view) {
+        data.assign(view.data, view.data + view.size);
+        meta = view;
+    });
+    if (result == ReadResult::Ok) {
+        meta.data = data.data();
+    }
+    return result;
+}
+
+FrameBusClient::ReadResult FrameBusClient::readSequence(uint64_t sequence, const ViewFunction &fn)
+{
+    FrameBus::SlotHeader *slot = FrameBus::slotAt(m_header, sequence);
+    const uint64_t expected = FrameBus::lockComplete(sequence);
+
+    if (slot->lock.load(std::memory_order_acquire) != expected) {
+        return ReadResult::Overrun;
+    }
+
+    FrameView view;
+    view.size = std::min<uint64_t>(slot->dataSize, m_header->payloadCapacity);
+    view.width = slot->width;
+    view.height = slot->height;
+    view.bitDepth = slot->bitDepth;
+    view.pixelFormat = slot->pixelFormat;
+    view.frameId = slot->frameId;
+    view.timestampNs = slot->timestampNs;
+    view.sequence = sequence;
+    view.data = FrameBus::slotData(slot);
+
+    // 元数据在回调前校验，像素数据在回调后校验
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot->lock.load(std::memory_order_relaxed) != expected) {
+        return ReadResult::Overrun;
+    }
+
+    fn(view);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot->lock.load(std::memory_order_relaxed) != expected) {
+        return ReadResult::Overrun;
+    }
+    return ReadResult::Ok;
+}
+
+#if defined(__linux__)
+
+bool FrameBusClient::open(const std::string &name)
+{
+    close();
+
+    const int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        m_error = std::string("shm_open 失败: ") + std::strerror(errno);
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(FrameBus::BusHeader)) {
+        m_error = "共享内存段尚未初始化";
+        ::close(fd);
+        return false;
+    }
+
+    const size_t size = static_cast<size_t>(info.st_size);
+    void *mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        m_error = std::string("mmap 失败: ") + std::strerror(errno);
+        return false;
+    }
+
+    auto *header = static_cast<FrameBus::BusHeader*>(mapped);
+    const bool valid = header->magic == FrameBus::MAGIC;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (!valid || header->version != FrameBus::VERSION
+        || FrameBus::segmentSize(header->slotCount, header->payloadCapacity) > size) {
+        m_error = "共享内存段格式不匹配";
+        munmap(mapped, size);
+        return false;
+    }
+
+    m_header = header;
+    m_mappedSize = size;
+    m_missed = 0;
+    // 从当前最新帧开始读取
+    const uint64_t published = header->published.load(std::memory_order_acquire);
+    m_next = published > 0 ? published - 1 : 0;
+    m_error.clear();
+    return true;
+}
+
+void FrameBusClient::close()
+{
+    if (m_header) {
+        munmap(m_header, m_mappedSize);
+        m_header = nullptr;
+        m_mappedSize = 0;
+    }
+}
+
+bool FrameBusClient::waitForFrame(int timeoutMs)
+{
+    if (!m_header) {
+        return false;
+    }
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    if (timeoutMs >= 0) {
+        deadline.tv_sec += timeoutMs / 1000;
+        deadline.tv_nsec += static_cast<long>(timeoutMs % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec += 1;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+
+    while (true) {
+        // 先取等待字再检查条件，写端在两者之间发布时 futex 会立即返回
+        const uint32_t key = m_header->notifyWord.load(std::memory_order_seq_cst);
+        if (m_header->closed.load(std::memory_order_acquire)) {
+            return false;
+        }
+        if (m_header->published.load(std::memory_order_acquire) > m_next) {
+            return true;
+        }
+
+        struct timespec remaining;
+        struct timespec *timeout = nullptr;
+        if (timeoutMs >= 0) {
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            int64_t ns = (deadline.tv_sec - now.tv_sec) * 1000000000LL + (deadline.tv_nsec - now.tv_nsec);
+            if (ns <= 0) {
+                return false;
+            }
+            remaining.tv_sec = static_cast<time_t>(ns / 1000000000LL);
+            remaining.tv_nsec = static_cast<long>(ns % 1000000000LL);
+            timeout = &remaining;
+        }
+
+        m_header->waiters.fetch_add(1, std::memory_order_seq_cst);
+        if (m_header->published.load(std::memory_order_seq_cst) <= m_next) {
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_header->notifyWord), FUTEX_WAIT, key,
+                    timeout, nullptr, 0);
+        }
+        m_header->waiters.fetch_sub(1, std::memory_order_seq_cst);
+    }
+}
+
+#else
+
+bool FrameBusClient::open(const std::string &)
+{
+    m_error = "共享内存帧总线目前仅支持 Linux";
+    return false;
+}
+
+void FrameBusClient::close()
+{
+}
+
+bool FrameBusClient::waitForFrame(int)
+{
+    return false;
+}
+
+#endif
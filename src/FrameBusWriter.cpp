@@ -0,0 +1,206 @@
+#include "FrameBusWriter.h"
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <string>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+FrameBusWriter::~FrameBusWriter()
+{
+    close();
+}
+
+size_t FrameBusWriter::payloadCapacity() const
+{
+    return m_header ? m_header->payloadCapacity : 0;
+}
+
+#if defined(__linux__)
+
+namespace {
+
+void wakeAll(std::atomic<uint32_t> *word)
+{
+    // 共享内存跨进程等待，不能使用 FUTEX_PRIVATE_FLAG
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+} // namespace
+
+bool FrameBusWriter::create(const std::string &name, uint32_t slotCount, size_t payloadCapacity)
+{
+    close();
+    if (!reclaimStale(name)) {
+        return false;
+    }
+
+    if (slotCount < 2) {
+        m_error = "槽位数至少为 2";
+        return false;
+    }
+
+    const size_t size = FrameBus::segmentSize(slotCount, payloadCapacity);
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+    if (fd < 0) {
+        m_error = std::string("shm_open 失败: ") + std::strerror(errno);
+        return false;
+    }
+
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        m_error = std::string("ftruncate 失败: ") + std::strerror(errno);
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    void *mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        m_error = std::string("mmap 失败: ") + std::strerror(errno);
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    auto *header = new (mapped) FrameBus::BusHeader();
+    header->slotCount = slotCount;
+    header->slotStride = FrameBus::slotStrideFor(payloadCapacity);
+    header->payloadCapacity = payloadCapacity;
+    header->writerPid = static_cast<uint64_t>(getpid());
+    header->published.store(0, std::memory_order_relaxed);
+    header->notifyWord.store(0, std::memory_order_relaxed);
+    header->waiters.store(0, std::memory_order_relaxed);
+    header->closed.store(0, std::memory_order_relaxed);
+
+    for (uint32_t i = 0; i < slotCount; ++i) {
+        auto *slot = new (FrameBus::slotAt(header, i)) FrameBus::SlotHeader();
+        slot->lock.store(0, std::memory_order_relaxed);
+    }
+
+    // magic 最后写入，客户端据此判断段已初始化完成
+    header->version = FrameBus::VERSION;
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = FrameBus::MAGIC;
+
+    m_name = name;
+    m_header = header;
+    m_mappedSize = size;
+    m_error.clear();
+    return true;
+}
+
+void FrameBusWriter::close()
+{
+    if (!m_header) {
+        return;
+    }
+
+    m_header->closed.store(1, std::memory_order_release);
+    m_header->notifyWord.fetch_add(1, std::memory_order_release);
+    wakeAll(&m_header->notifyWord);
+
+    munmap(m_header, m_mappedSize);
+    shm_unlink(m_name.c_str());
+    m_header = nullptr;
+    m_mappedSize = 0;
+}
+
+bool FrameBusWriter::reclaimStale(const std::string &name)
+{
+    // 上次异常退出时遗留的同名段：确认写端进程已不存在，通知仍挂在上面的读者后解除链接
+    const int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        return true;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(FrameBus::BusHeader)) {
+        void *mapped = mmap(nullptr, sizeof(FrameBus::BusHeader), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapped != MAP_FAILED) {
+            auto *header = static_cast<FrameBus::BusHeader*>(mapped);
+            // 只有 kill(pid, 0) 报告 ESRCH 才算写端已退出；EPERM 说明进程存在但属于其他用户
+            const pid_t writerPid = static_cast<pid_t>(header->writerPid);
+            if (writerPid > 0 && (kill(writerPid, 0) == 0 || errno != ESRCH)) {
+                munmap(mapped, sizeof(FrameBus::BusHeader));
+                ::close(fd);
+                m_error = "帧总线名称已被进程 " + std::to_string(writerPid) + " 占用";
+                return false;
+            }
+            if (header->magic == FrameBus::MAGIC) {
+                header->closed.store(1, std::memory_order_release);
+                header->notifyWord.fetch_add(1, std::memory_order_release);
+                wakeAll(&header->notifyWord);
+            }
+            munmap(mapped, sizeof(FrameBus::BusHeader));
+        }
+    }
+    ::close(fd);
+    shm_unlink(name.c_str());
+    return true;
+}
+
+bool FrameBusWriter::publish(const Frame &frame)
+{
+    if (!m_header || frame.data.size() > m_header->payloadCapacity) {
+        return false;
+    }
+
+    const uint64_t sequence = m_header->published.load(std::memory_order_relaxed);
+    FrameBus::SlotHeader *slot = FrameBus::slotAt(m_header, sequence);
+
+    // 先标记写入中，之后的数据写入不能被重排到标记之前
+    slot->lock.store(FrameBus::lockWriting(sequence), std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->sequence = sequence;
+    slot->width = frame.width;
+    slot->height = frame.height;
+    slot->bitDepth = frame.bitDepth;
+    slot->pixelFormat = frame.pixelFormat;
+    slot->frameId = frame.frameId;
+    slot->timestampNs = frame.timestampNs;
+    slot->dataSize = frame.data.size();
+    std::memcpy(FrameBus::slotData(slot), frame.data.data(), frame.data.size());
+
+    slot->lock.store(FrameBus::lockComplete(sequence), std::memory_order_release);
+    m_header->published.store(sequence + 1, std::memory_order_seq_cst);
+
+    m_header->notifyWord.fetch_add(1, std::memory_order_seq_cst);
+    if (m_header->waiters.load(std::memory_order_seq_cst) > 0) {
+        wakeAll(&m_header->notifyWord);
+    }
+    return true;
+}
+
+#else
+
+bool FrameBusWriter::create(const std::string &, uint32_t, size_t)
+{
+    m_error = "共享内存帧总线目前仅支持 Linux";
+    return false;
+}
+
+void FrameBusWriter::close()
+{
+}
+
+bool FrameBusWriter::reclaimStale(const std::string &)
+{
+    return true;
+}
+
+bool FrameBusWriter::publish(const Frame &)
+{
+    return false;
+}
+
+#endif
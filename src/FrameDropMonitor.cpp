@@ -0,0 +1,258 @@
+#include "FrameDropMonitor.h"
+#include <QDateTime>
+#include <QMetaObject>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+// 解决 Qt 和 GLib 的宏冲突
+#ifdef signals
+#undef signals
+#endif
+
+#include <arv.h>
+
+// 恢复 Qt 的 signals 宏
+#define signals Q_SIGNALS
+
+namespace {
+
+constexpr uint64_t GIGE_FRAME_ID_MAX = 0xFFFF;
+
+int64_t steadyNowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+uint64_t FrameDropMonitor::Counters::lostFrames() const
+{
+    uint64_t lost = 0;
+    for (int i = 0; i < EVENT_TYPE_COUNT; ++i) {
+        if (static_cast<EventType>(i) != EventType::IdReset) {
+            lost += events[i];
+        }
+    }
+    return lost;
+}
+
+FrameDropMonitor::FrameDropMonitor(QObject *parent)
+    : QObject(parent)
+{
+    m_log.reserve(EVENT_LOG_CAPACITY);
+}
+
+void FrameDropMonitor::reset()
+{
+    m_received = 0;
+    m_succeeded = 0;
+    for (auto &count : m_eventCounts) {
+        count = 0;
+    }
+
+    m_hasLastId = false;
+    m_lastId = 0;
+    m_windowStartMs = 0;
+    m_windowLost = 0;
+    m_windowAlarmed = false;
+
+    std::lock_guard<std::mutex> lock(m_logMutex);
+    m_log.clear();
+    m_logNext = 0;
+}
+
+bool FrameDropMonitor::record(ArvBuffer *buffer)
+{
+    m_received.fetch_add(1, std::memory_order_relaxed);
+
+    const ArvBufferStatus status = arv_buffer_get_status(buffer);
+    const uint64_t frameId = arv_buffer_get_frame_id(buffer);
+
+    EventType failure;
+    switch (status) {
+    case ARV_BUFFER_STATUS_SUCCESS:
+        m_succeeded.fetch_add(1, std::memory_order_relaxed);
+        trackFrameId(frameId);
+        return true;
+    case ARV_BUFFER_STATUS_TIMEOUT:
+        failure = EventType::Timeout;
+        break;
+    case ARV_BUFFER_STATUS_MISSING_PACKETS:
+        failure = EventType::MissingPackets;
+        break;
+    case ARV_BUFFER_STATUS_WRONG_PACKET_ID:
+        failure = EventType::WrongPacketId;
+        break;
+    case ARV_BUFFER_STATUS_SIZE_MISMATCH:
+        failure = EventType::SizeMismatch;
+        break;
+    case ARV_BUFFER_STATUS_ABORTED:
+        failure = EventType::Aborted;
+        break;
+    default:
+        failure = EventType::OtherFailure;
+        break;
+    }
+
+    // 中止/清空的缓冲区帧号不可信，不参与间隔判断
+    if (failure != EventType::Aborted && failure != EventType::OtherFailure) {
+        trackFrameId(frameId);
+    }
+    addEvent(failure, frameId, 1);
+    return false;
+}
+
+void FrameDropMonitor::trackFrameId(uint64_t frameId)
+{
+    if (!m_hasLastId) {
+        m_hasLastId = true;
+        m_lastId = frameId;
+        return;
+    }
+
+    const uint64_t last = m_lastId;
+    m_lastId = frameId;
+
+    if (frameId > last) {
+        if (frameId - last > 1) {
+            addEvent(EventType::FrameGap, frameId, frameId - last - 1);
+        }
+        return;
+    }
+
+    // GigE 16 位帧号回绕：65535 之后是 1（0 保留）
+    if (last <= GIGE_FRAME_ID_MAX && last - frameId > GIGE_FRAME_ID_MAX / 2 && frameId > 0) {
+        const uint64_t missing = (GIGE_FRAME_ID_MAX - last) + (frameId - 1);
+        if (missing > 0) {
+            addEvent(EventType::FrameGap, frameId, missing);
+        }
+        return;
+    }
+
+    addEvent(EventType::IdReset, frameId, 1);
+}
+
+void FrameDropMonitor::addEvent(EventType type, uint64_t frameId, uint64_t count)
+{
+    m_eventCounts[static_cast<int>(type)].fetch_add(count, std::memory_order_relaxed);
+
+    Event event;
+    event.wallTimeMs = QDateTime::currentMSecsSinceEpoch();
+    event.type = type;
+    event.frameId = frameId;
+    event.count = count;
+    {
+        std::lock_guard<std::mutex> lock(m_logMutex);
+        if (m_log.size() < EVENT_LOG_CAPACITY) {
+            m_log.push_back(event);
+        } else {
+            m_log[m_logNext] = event;
+        }
+        m_logNext = (m_logNext + 1) % EVENT_LOG_CAPACITY;
+    }
+
+    if (type == EventType::IdReset) {
+        return;
+    }
+
+    const uint64_t threshold = m_alarmThreshold.load(std::memory_order_relaxed);
+    const int windowMs = m_alarmWindowMs.load(std::memory_order_relaxed);
+    const int64_t now = steadyNowMs();
+    if (now - m_windowStartMs >= windowMs) {
+        m_windowStartMs = now;
+        m_windowLost = 0;
+        m_windowAlarmed = false;
+    }
+    m_windowLost += count;
+
+    if (threshold > 0 && !m_windowAlarmed && m_windowLost >= threshold) {
+        m_windowAlarmed = true;
+        const qulonglong lost = m_windowLost;
+        QMetaObject::invokeMethod(this, [this, lost, windowMs]() {
+            emit dropAlarm(lost, windowMs);
+        }, Qt::QueuedConnection);
+    }
+}
+
+FrameDropMonitor::Counters FrameDropMonitor::counters() const
+{
+    Counters counters;
+    counters.received = m_received.load(std::memory_order_relaxed);
+    counters.succeeded = m_succeeded.load(std::memory_order_relaxed);
+    for (int i = 0; i < EVENT_TYPE_COUNT; ++i) {
+        counters.events[i] = m_eventCounts[i].load(std::memory_order_relaxed);
+    }
+    return counters;
+}
+
+std::vector<FrameDropMonitor::Event> FrameDropMonitor::events() const
+{
+    std::lock_guard<std::mutex> lock(m_logMutex);
+    if (m_log.size() < EVENT_LOG_CAPACITY) {
+        return m_log;
+    }
+
+    std::vector<Event> ordered;
+    ordered.reserve(m_log.size());
+    ordered.insert(ordered.end(), m_log.begin() + m_logNext, m_log.end());
+    ordered.insert(ordered.end(), m_log.begin(), m_log.begin() + m_logNext);
+    return ordered;
+}
+
+bool FrameDropMonitor::exportEvents(const QString &path, QString *error) const
+{
+    const QByteArray localPath = path.toLocal8Bit();
+    FILE *file = std::fopen(localPath.constData(), "w");
+    if (!file) {
+        if (error) {
+            *error = QString("无法写入: %1").arg(path);
+        }
+        return false;
+    }
+
+    std::fprintf(file, "wall_time,event,frame_id,count\n");
+    for (const Event &event : events()) {
+        const QByteArray time = QDateTime::fromMSecsSinceEpoch(event.wallTimeMs)
+                                    .toString("yyyy-MM-dd hh:mm:ss.zzz").toLocal8Bit();
+        std::fprintf(file, "%s,%s,%llu,%llu\n", time.constData(), eventName(event.type),
+                     static_cast<unsigned long long>(event.frameId),
+                     static_cast<unsigned long long>(event.count));
+    }
+
+    const bool ok = std::fclose(file) == 0;
+    if (!ok && error) {
+        *error = QString("写入失败: %1").arg(path);
+    }
+    return ok;
+}
+
+void FrameDropMonitor::setAlarmSettings(const AlarmSettings &settings)
+{
+    m_alarmThreshold = settings.threshold;
+    m_alarmWindowMs = std::max(settings.windowMs, 1);
+}
+
+FrameDropMonitor::AlarmSettings FrameDropMonitor::alarmSettings() const
+{
+    AlarmSettings settings;
+    settings.threshold = m_alarmThreshold.load();
+    settings.windowMs = m_alarmWindowMs.load();
+    return settings;
+}
+
+const char *FrameDropMonitor::eventName(EventType type)
+{
+    switch (type) {
+    case EventType::FrameGap: return "frame_gap";
+    case EventType::Timeout: return "timeout";
+    case EventType::MissingPackets: return "missing_packets";
+    case EventType::WrongPacketId: return "wrong_packet_id";
+    case EventType::SizeMismatch: return "size_mismatch";
+    case EventType::Aborted: return "aborted";
+    case EventType::OtherFailure: return "other_failure";
+    case EventType::IdReset: return "id_reset";
+    }
+    return "unknown";
+}
@@ -0,0 +1,282 @@
+#include "FramePipeline.h"
+#include "FrameStage.h"
+#include "TraceRecorder.h"
+#include <QDebug>
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+int64_t steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+FramePipeline::FramePipeline()
+{
+}
+
+FramePipeline::~FramePipeline()
+{
+    stop();
+}
+
+void FramePipeline::addStage(FrameStage *stage)
+{
+    addStage(stage, StageOptions());
+}
+
+void FramePipeline::addStage(FrameStage *stage, const StageOptions &options)
+{
+    auto entry = std::make_unique<StageEntry>();
+    entry->stage = stage;
+
+    if (options.ownThread || m_workers.empty()) {
+        auto worker = std::make_unique<Worker>();
+        worker->queue = std::make_unique<SpscQueue<FramePtr>>(std::max<size_t>(options.queueCapacity, 1));
+        worker->overflow = options.overflow;
+        if (!m_workers.empty()) {
+            m_workers.back()->next = worker.get();
+        }
+        m_workers.push_back(std::move(worker));
+    }
+
+    m_workers.back()->stages.push_back(entry.get());
+    m_stages.push_back(std::move(entry));
+}
+
+void FramePipeline::setSink(Sink sink)
+{
+    m_sink = std::move(sink);
+}
+
+void FramePipeline::setInputOverflowPolicy(OverflowPolicy policy)
+{
+    if (m_workers.empty()) {
+        // 没有阶段时创建一个只执行输出回调的线程
+        addStage(nullptr);
+    }
+    m_workers.front()->overflow = policy;
+}
+
+FramePipeline::OverflowPolicy FramePipeline::inputOverflowPolicy() const
+{
+    return m_workers.empty() ? OverflowPolicy::DropOldest : m_workers.front()->overflow.load();
+}
+
+void FramePipeline::start()
+{
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    if (m_running) {
+        return;
+    }
+
+    if (m_workers.empty()) {
+        addStage(nullptr);
+    }
+
+    for (auto &entry : m_stages) {
+        entry->processed = 0;
+        entry->dropped = 0;
+        entry->busyNs = 0;
+        entry->sampledBusyNs = 0;
+        entry->sampledProcessed = 0;
+    }
+    for (auto &worker : m_workers) {
+        worker->dropped = 0;
+        worker->peakDepth = 0;
+    }
+    m_lastSampleNs = steadyNowNs();
+
+    m_running = true;
+    for (auto &worker : m_workers) {
+        worker->thread = std::thread(&FramePipeline::workerLoop, this, worker.get());
+    }
+}
+
+void FramePipeline::stop()
+{
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    if (!m_running) {
+        return;
+    }
+    m_running = false;
+
+    // 唤醒所有等待中的生产者和消费者
+    for (auto &worker : m_workers) {
+        worker->itemsEvent.fetch_add(1, std::memory_order_release);
+        worker->itemsEvent.notify_all();
+        worker->spaceEvent.fetch_add(1, std::memory_order_release);
+        worker->spaceEvent.notify_all();
+    }
+
+    for (auto &worker : m_workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+        FramePtr pending;
+        while (worker->queue->tryPop(pending)) {
+        }
+    }
+}
+
+bool FramePipeline::isRunning() const
+{
+    return m_running.load(std::memory_order_acquire);
+}
+
+void FramePipeline::submit(FramePtr frame)
+{
+    if (!m_running.load(std::memory_order_acquire)) {
+        return;
+    }
+    enqueue(*m_workers.front(), std::move(frame));
+}
+
+uint64_t FramePipeline::droppedFrames() const
+{
+    return m_workers.empty() ? 0 : m_workers.front()->dropped.load(std::memory_order_relaxed);
+}
+
+std::vector<FramePipeline::StageStatistics> FramePipeline::sampleStatistics()
+{
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+
+    const int64_t now = steadyNowNs();
+    const double elapsedNs = static_cast<double>(std::max<int64_t>(now - m_lastSampleNs, 1));
+    m_lastSampleNs = now;
+
+    std::vector<StageStatistics> result;
+    result.reserve(m_stages.size());
+
+    for (auto &worker : m_workers) {
+        const size_t depth = worker->queue->size();
+        const size_t peak = std::max(worker->peakDepth.exchange(depth, std::memory_order_relaxed), depth);
+        bool firstInWorker = true;
+
+        for (StageEntry *entry : worker->stages) {
+            StageStatistics stats;
+            stats.name = entry->stage ? entry->stage->stageName() : "Sink";
+            if (firstInWorker) {
+                stats.queueDepth = depth;
+                stats.peakQueueDepth = peak;
+                stats.queueCapacity = worker->queue->capacity();
+                stats.droppedByQueue = worker->dropped.load(std::memory_order_relaxed);
+                firstInWorker = false;
+            }
+
+            const uint64_t busy = entry->busyNs.load(std::memory_order_relaxed);
+            const uint64_t processed = entry->processed.load(std::memory_order_relaxed);
+            const uint64_t busyDelta = busy - entry->sampledBusyNs;
+            const uint64_t processedDelta = processed - entry->sampledProcessed;
+            entry->sampledBusyNs = busy;
+            entry->sampledProcessed = processed;
+
+            stats.occupancy = std::min(1.0, busyDelta / elapsedNs);
+            stats.averageProcessUs = processedDelta ? busyDelta / 1000.0 / processedDelta : 0.0;
+            stats.processed = processed;
+            stats.droppedByStage = entry->dropped.load(std::memory_order_relaxed);
+            result.push_back(std::move(stats));
+        }
+    }
+
+    return result;
+}
+
+void FramePipeline::enqueue(Worker &worker, FramePtr frame)
+{
+    while (true) {
+        const OverflowPolicy policy = worker.overflow.load(std::memory_order_relaxed);
+
+        // Block 策略先取计数再尝试入队，避免消费者在两者之间出队导致错过唤醒
+        const uint32_t key = worker.spaceEvent.load(std::memory_order_acquire);
+        if (worker.queue->tryPush(frame)) {
+            break;
+        }
+
+        if (policy == OverflowPolicy::DropNewest) {
+            worker.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        if (policy == OverflowPolicy::DropOldest) {
+            FramePtr oldest;
+            if (worker.queue->tryPop(oldest)) {
+                worker.dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+            continue;
+        }
+
+        if (!m_running.load(std::memory_order_acquire)) {
+            return;
+        }
+        worker.spaceEvent.wait(key, std::memory_order_acquire);
+    }
+
+    const size_t depth = worker.queue->size();
+    size_t peak = worker.peakDepth.load(std::memory_order_relaxed);
+    while (depth > peak && !worker.peakDepth.compare_exchange_weak(peak, depth, std::memory_order_relaxed)) {
+    }
+
+    worker.itemsEvent.fetch_add(1, std::memory_order_release);
+    worker.itemsEvent.notify_one();
+}
+
+void FramePipeline::workerLoop(Worker *worker)
+{
+    FrameStage *firstStage = worker->stages.front()->stage;
+    qDebug() << "处理管线线程启动, 首阶段:" << (firstStage ? firstStage->stageName() : "Sink")
+             << "阶段数:" << worker->stages.size();
+    TraceRecorder::setThreadName(firstStage ? firstStage->stageName() : "管线输出");
+    TraceRecorder &trace = TraceRecorder::instance();
+
+    while (m_running.load(std::memory_order_acquire)) {
+        FramePtr frame;
+        if (!worker->queue->tryPop(frame)) {
+            const uint32_t key = worker->itemsEvent.load(std::memory_order_acquire);
+            if (!m_running.load(std::memory_order_acquire)) {
+                break;
+            }
+            if (!worker->queue->tryPop(frame)) {
+                worker->itemsEvent.wait(key, std::memory_order_acquire);
+                continue;
+            }
+        }
+
+        worker->spaceEvent.fetch_add(1, std::memory_order_release);
+        if (worker->overflow.load(std::memory_order_relaxed) == OverflowPolicy::Block) {
+            worker->spaceEvent.notify_one();
+        }
+
+        for (StageEntry *entry : worker->stages) {
+            if (!entry->stage) {
+                continue;
+            }
+            const uint64_t frameId = frame->frameId;
+            const int64_t begin = steadyNowNs();
+            frame = entry->stage->process(std::move(frame));
+            const int64_t end = steadyNowNs();
+            entry->busyNs.fetch_add(end - begin, std::memory_order_relaxed);
+            trace.record(entry->stage->stageName(), frameId, begin, end);
+            entry->processed.fetch_add(1, std::memory_order_relaxed);
+            if (!frame) {
+                entry->dropped.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+        }
+
+        if (!frame) {
+            continue;
+        }
+        if (worker->next) {
+            enqueue(*worker->next, std::move(frame));
+        } else if (m_sink) {
+            m_sink(frame);
+        }
+    }
+
+    qDebug() << "处理管线线程停止";
+}
@@ -0,0 +1,196 @@
+#include "FramePool.h"
+#include <algorithm>
+#include <new>
+#include <utility>
+
+// 池状态由池和所有借出的帧（删除器/分配器）共同持有，帧晚于池释放时仍能归还或销毁
+struct FramePool::State
+{
+    static constexpr size_t BLOCK_SIZE = 128;   // 足够容纳带删除器和分配器的控制块
+
+    explicit State(size_t limit)
+        : maxFree(limit)
+    {
+        freeFrames.reserve(maxFree);
+        freeBlocks.reserve(maxFree);
+    }
+
+    ~State()
+    {
+        for (Frame *frame : freeFrames) {
+            delete frame;
+        }
+        for (void *block : freeBlocks) {
+            ::operator delete(block);
+        }
+    }
+
+    void release(Frame *frame)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!closed && freeFrames.size() < maxFree) {
+                freeFrames.push_back(frame);
+                return;
+            }
+        }
+        delete frame;
+    }
+
+    void *allocateBlock(size_t bytes)
+    {
+        if (bytes <= BLOCK_SIZE) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!freeBlocks.empty()) {
+                void *block = freeBlocks.back();
+                freeBlocks.pop_back();
+                return block;
+            }
+        }
+        return ::operator new(bytes <= BLOCK_SIZE ? BLOCK_SIZE : bytes);
+    }
+
+    void releaseBlock(void *block, size_t bytes)
+    {
+        if (bytes <= BLOCK_SIZE) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!closed && freeBlocks.size() < maxFree) {
+                freeBlocks.push_back(block);
+                return;
+            }
+        }
+        ::operator delete(block);
+    }
+
+    const size_t maxFree;
+    mutable std::mutex mutex;
+    std::vector<Frame*> freeFrames;     // 受 mutex 保护
+    std::vector<void*> freeBlocks;      // 受 mutex 保护
+    size_t created = 0;                 // 受 mutex 保护
+    bool closed = false;                // 池已析构：归还的帧直接释放
+};
+
+namespace {
+
+// shared_ptr 控制块的分配器，块大小固定，从池内空闲块分配
+template <typename T>
+struct BlockAllocator
+{
+    using value_type = T;
+
+    explicit BlockAllocator(std::shared_ptr<FramePool::State> s) : state(std::move(s)) {}
+    template <typename U>
+    BlockAllocator(const BlockAllocator<U> &other) : state(other.state) {}
+
+    T *allocate(size_t n) { return static_cast<T*>(state->allocateBlock(n * sizeof(T))); }
+    void deallocate(T *p, size_t n) { state->releaseBlock(p, n * sizeof(T)); }
+
+    template <typename U>
+    bool operator==(const BlockAllocator<U> &other) const { return state == other.state; }
+    template <typename U>
+    bool operator!=(const BlockAllocator<U> &other) const { return state != other.state; }
+
+    std::shared_ptr<FramePool::State> state;
+};
+
+} // namespace
+
+FramePool::FramePool(size_t maxFree)
+    : m_state(std::make_shared<State>(maxFree))
+{
+}
+
+FramePool::~FramePool()
+{
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    m_state->closed = true;
+}
+
+FramePtr FramePool::acquire()
+{
+    Frame *frame = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        if (!m_state->freeFrames.empty()) {
+            frame = m_state->freeFrames.back();
+            m_state->freeFrames.pop_back();
+        } else {
+            m_state->created++;
+        }
+    }
+
+    if (frame) {
+        // 只清元数据，像素缓冲区保留容量
+        std::vector<uint8_t> data;
+        data.swap(frame->data);
+        *frame = Frame();
+        data.clear();
+        frame->data.swap(data);
+    } else {
+        frame = new Frame();
+    }
+
+    std::shared_ptr<State> state = m_state;
+    return FramePtr(frame, [state](Frame *released) { state->release(released); }, BlockAllocator<Frame>(state));
+}
+
+void FramePool::reserve(size_t frames, size_t bytesPerFrame)
+{
+    std::vector<Frame*> newFrames;
+    std::vector<void*> newBlocks;
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        const size_t target = std::min(frames, m_state->maxFree);
+        if (m_state->freeFrames.size() < target) {
+            newFrames.resize(target - m_state->freeFrames.size());
+        }
+        if (m_state->freeBlocks.size() < target) {
+            newBlocks.resize(target - m_state->freeBlocks.size());
+        }
+        m_state->created += newFrames.size();
+    }
+
+    // 在锁外分配
+    for (Frame *&frame : newFrames) {
+        frame = new Frame();
+        frame->data.reserve(bytesPerFrame);
+    }
+    for (void *&block : newBlocks) {
+        block = ::operator new(State::BLOCK_SIZE);
+    }
+
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    m_state->freeFrames.insert(m_state->freeFrames.end(), newFrames.begin(), newFrames.end());
+    m_state->freeBlocks.insert(m_state->freeBlocks.end(), newBlocks.begin(), newBlocks.end());
+}
+
+void FramePool::trim()
+{
+    std::vector<Frame*> frames;
+    std::vector<void*> blocks;
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        frames.swap(m_state->freeFrames);
+        blocks.swap(m_state->freeBlocks);
+        m_state->freeFrames.reserve(m_state->maxFree);
+        m_state->freeBlocks.reserve(m_state->maxFree);
+    }
+    for (Frame *frame : frames) {
+        delete frame;
+    }
+    for (void *block : blocks) {
+        ::operator delete(block);
+    }
+}
+
+size_t FramePool::freeFrames() const
+{
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    return m_state->freeFrames.size();
+}
+
+size_t FramePool::createdFrames() const
+{
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    return m_state->created;
+}
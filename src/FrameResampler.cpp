@@ -0,0 +1,276 @@
+#include "FrameResampler.h"
+#include "Simd.h"
+#include "TileExecutor.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+template <typename T>
+using BinRow = void (*)(const T *, const T *, T *, size_t);
+template <typename T>
+using DecimateRow = void (*)(const T *, T *, size_t);
+
+// 生成一行输出；src 指向该输出行对应的第一行源像素（已按裁剪偏移）
+template <typename T>
+void reduceRow(const T *src, size_t srcStride, T *dst, size_t outWidth, DerivedFrameSpec::Reduce reduce, int scale,
+               BinRow<T> bin, DecimateRow<T> decimate, std::vector<T> &scratch)
+{
+    if (scale == 1) {
+        std::memcpy(dst, src, outWidth * sizeof(T));
+        return;
+    }
+
+    if (scale == 2) {
+        if (reduce == DerivedFrameSpec::Reduce::Bin) {
+            bin(src, src + srcStride, dst, outWidth);
+        } else {
+            decimate(src, dst, outWidth);
+        }
+        return;
+    }
+
+    // 4×: 第一级 2× 写入临时行，第二级再 2×
+    const size_t half = outWidth * 2;
+    if (reduce == DerivedFrameSpec::Reduce::Bin) {
+        scratch.resize(half * 2);
+        bin(src, src + srcStride, scratch.data(), half);
+        bin(src + 2 * srcStride, src + 3 * srcStride, scratch.data() + half, half);
+        bin(scratch.data(), scratch.data() + half, dst, outWidth);
+    } else {
+        scratch.resize(half);
+        decimate(src, scratch.data(), half);
+        decimate(scratch.data(), dst, outWidth);
+    }
+}
+
+} // namespace
+
+QString DerivedFrameSpec::description() const
+{
+    QString text = crop.isEmpty() ? QString("整帧")
+                                  : QString("裁剪 (%1, %2, %3x%4)").arg(crop.x).arg(crop.y).arg(crop.width).arg(crop.height);
+    if (scale() > 1) {
+        text += reduce == Reduce::Bin ? QString(" %1×%1 合并").arg(factor) : QString(" %1× 抽样").arg(factor);
+    }
+    return text;
+}
+
+FramePtr FrameResampler::derive(const Frame &source, const DerivedFrameSpec &spec)
+{
+    int x0 = 0;
+    int y0 = 0;
+    int cropWidth = source.width;
+    int cropHeight = source.height;
+    if (!spec.crop.isEmpty()) {
+        x0 = std::clamp(spec.crop.x, 0, source.width);
+        y0 = std::clamp(spec.crop.y, 0, source.height);
+        cropWidth = std::min(spec.crop.x + spec.crop.width, source.width) - x0;
+        cropHeight = std::min(spec.crop.y + spec.crop.height, source.height) - y0;
+    }
+
+    // 只支持 2× 和 4×，其他值就近归入
+    const int scale = spec.scale() >= 4 ? 4 : (spec.scale() >= 2 ? 2 : 1);
+    const int outWidth = cropWidth / scale;
+    const int outHeight = cropHeight / scale;
+    if (outWidth <= 0 || outHeight <= 0) {
+        return nullptr;
+    }
+
+    auto frame = std::make_shared<Frame>();
+    frame->width = outWidth;
+    frame->height = outHeight;
+    frame->offsetX = source.offsetX + x0;
+    frame->offsetY = source.offsetY + y0;
+    frame->bitDepth = source.bitDepth;
+    frame->pixelFormat = source.pixelFormat;
+    frame->frameId = source.frameId;
+    frame->timestampNs = source.timestampNs;
+    frame->systemTimestampNs = source.systemTimestampNs;
+    frame->chunk = source.chunk;
+    frame->sequence = source.sequence;
+    frame->data.resize(static_cast<size_t>(frame->stride()) * outHeight);
+
+    const size_t sourceWidth = static_cast<size_t>(source.width);
+    const size_t width = static_cast<size_t>(outWidth);
+    const size_t rowsPerOutput = static_cast<size_t>(scale);
+
+    TileExecutor &executor = TileExecutor::instance();
+    executor.parallelFor(outHeight, executor.autoGrain(outHeight, width * source.bytesPerPixel() * scale * scale),
+                         [&](size_t rowBegin, size_t rowEnd) {
+        if (source.bytesPerPixel() == 1) {
+            std::vector<uint8_t> scratch;
+            const uint8_t *origin = source.bits() + y0 * sourceWidth + x0;
+            for (size_t y = rowBegin; y < rowEnd; ++y) {
+                reduceRow<uint8_t>(origin + y * rowsPerOutput * sourceWidth, sourceWidth, frame->bits() + y * width,
+                                   width, spec.reduce, scale, binRow8, decimateRow8, scratch);
+            }
+        } else {
+            std::vector<uint16_t> scratch;
+            const uint16_t *origin = source.bits16() + y0 * sourceWidth + x0;
+            for (size_t y = rowBegin; y < rowEnd; ++y) {
+                reduceRow<uint16_t>(origin + y * rowsPerOutput * sourceWidth, sourceWidth, frame->bits16() + y * width,
+                                    width, spec.reduce, scale, binRow16, decimateRow16, scratch);
+            }
+        }
+    });
+
+    return frame;
+}
+
+void FrameResampler::binRow8(const uint8_t *row0, const uint8_t *row1, uint8_t *out, size_t count)
+{
+    size_t i = 0;
+
+    // 偶数列取低字节、奇数列右移 8 位，两行四个像素在 16 位通道内求和
+#if defined(ARAVIS_HAS_AVX2)
+    const __m256i lowMask = _mm256_set1_epi16(0x00FF);
+    const __m256i round = _mm256_set1_epi16(2);
+    for (; i + 32 <= count; i += 32) {
+        const size_t s = 2 * i;
+        __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0 + s));
+        __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0 + s + 32));
+        __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1 + s));
+        __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1 + s + 32));
+        __m256i sum0 = _mm256_add_epi16(_mm256_add_epi16(_mm256_and_si256(a0, lowMask), _mm256_srli_epi16(a0, 8)),
+                                        _mm256_add_epi16(_mm256_and_si256(b0, lowMask), _mm256_srli_epi16(b0, 8)));
+        __m256i sum1 = _mm256_add_epi16(_mm256_add_epi16(_mm256_and_si256(a1, lowMask), _mm256_srli_epi16(a1, 8)),
+                                        _mm256_add_epi16(_mm256_and_si256(b1, lowMask), _mm256_srli_epi16(b1, 8)));
+        sum0 = _mm256_srli_epi16(_mm256_add_epi16(sum0, round), 2);
+        sum1 = _mm256_srli_epi16(_mm256_add_epi16(sum1, round), 2);
+        // packus 按 128 位通道交错，permute 恢复像素顺序
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(sum0, sum1), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+    }
+#elif defined(ARAVIS_HAS_SSE2)
+    const __m128i lowMask = _mm_set1_epi16(0x00FF);
+    const __m128i round = _mm_set1_epi16(2);
+    for (; i + 16 <= count; i += 16) {
+        const size_t s = 2 * i;
+        __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + s));
+        __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + s + 16));
+        __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + s));
+        __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + s + 16));
+        __m128i sum0 = _mm_add_epi16(_mm_add_epi16(_mm_and_si128(a0, lowMask), _mm_srli_epi16(a0, 8)),
+                                     _mm_add_epi16(_mm_and_si128(b0, lowMask), _mm_srli_epi16(b0, 8)));
+        __m128i sum1 = _mm_add_epi16(_mm_add_epi16(_mm_and_si128(a1, lowMask), _mm_srli_epi16(a1, 8)),
+                                     _mm_add_epi16(_mm_and_si128(b1, lowMask), _mm_srli_epi16(b1, 8)));
+        sum0 = _mm_srli_epi16(_mm_add_epi16(sum0, round), 2);
+        sum1 = _mm_srli_epi16(_mm_add_epi16(sum1, round), 2);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(sum0, sum1));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        const uint32_t sum = row0[2 * i] + row0[2 * i + 1] + row1[2 * i] + row1[2 * i + 1];
+        out[i] = static_cast<uint8_t>((sum + 2) >> 2);
+    }
+}
+
+void FrameResampler::binRow16(const uint16_t *row0, const uint16_t *row1, uint16_t *out, size_t count)
+{
+    size_t i = 0;
+
+    // 16 位数据求和可能超过 16 位，在 32 位通道内进行
+#if defined(ARAVIS_HAS_AVX2)
+    const __m256i lowMask = _mm256_set1_epi32(0xFFFF);
+    const __m256i round = _mm256_set1_epi32(2);
+    for (; i + 16 <= count; i += 16) {
+        const size_t s = 2 * i;
+        __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0 + s));
+        __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0 + s + 16));
+        __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1 + s));
+        __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1 + s + 16));
+        __m256i sum0 = _mm256_add_epi32(_mm256_add_epi32(_mm256_and_si256(a0, lowMask), _mm256_srli_epi32(a0, 16)),
+                                        _mm256_add_epi32(_mm256_and_si256(b0, lowMask), _mm256_srli_epi32(b0, 16)));
+        __m256i sum1 = _mm256_add_epi32(_mm256_add_epi32(_mm256_and_si256(a1, lowMask), _mm256_srli_epi32(a1, 16)),
+                                        _mm256_add_epi32(_mm256_and_si256(b1, lowMask), _mm256_srli_epi32(b1, 16)));
+        sum0 = _mm256_srli_epi32(_mm256_add_epi32(sum0, round), 2);
+        sum1 = _mm256_srli_epi32(_mm256_add_epi32(sum1, round), 2);
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(sum0, sum1), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+    }
+#elif defined(ARAVIS_HAS_SSE2)
+    const __m128i lowMask = _mm_set1_epi32(0xFFFF);
+    const __m128i round = _mm_set1_epi32(2);
+    const __m128i bias32 = _mm_set1_epi32(0x8000);
+    const __m128i bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+    for (; i + 8 <= count; i += 8) {
+        const size_t s = 2 * i;
+        __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + s));
+        __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + s + 8));
+        __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + s));
+        __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + s + 8));
+        __m128i sum0 = _mm_add_epi32(_mm_add_epi32(_mm_and_si128(a0, lowMask), _mm_srli_epi32(a0, 16)),
+                                     _mm_add_epi32(_mm_and_si128(b0, lowMask), _mm_srli_epi32(b0, 16)));
+        __m128i sum1 = _mm_add_epi32(_mm_add_epi32(_mm_and_si128(a1, lowMask), _mm_srli_epi32(a1, 16)),
+                                     _mm_add_epi32(_mm_and_si128(b1, lowMask), _mm_srli_epi32(b1, 16)));
+        sum0 = _mm_srli_epi32(_mm_add_epi32(sum0, round), 2);
+        sum1 = _mm_srli_epi32(_mm_add_epi32(sum1, round), 2);
+        // SSE2 只有有符号 32 -> 16 位打包：先减去 0x8000，打包后再加回
+        __m128i packed = _mm_packs_epi32(_mm_sub_epi32(sum0, bias32), _mm_sub_epi32(sum1, bias32));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_add_epi16(packed, bias16));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        const uint32_t sum = row0[2 * i] + row0[2 * i + 1] + row1[2 * i] + row1[2 * i + 1];
+        out[i] = static_cast<uint16_t>((sum + 2) >> 2);
+    }
+}
+
+void FrameResampler::decimateRow8(const uint8_t *in, uint8_t *out, size_t count)
+{
+    size_t i = 0;
+
+#if defined(ARAVIS_HAS_AVX2)
+    const __m256i lowMask = _mm256_set1_epi16(0x00FF);
+    for (; i + 32 <= count; i += 32) {
+        __m256i a = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i)), lowMask);
+        __m256i b = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i + 32)), lowMask);
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+    }
+#elif defined(ARAVIS_HAS_SSE2)
+    const __m128i lowMask = _mm_set1_epi16(0x00FF);
+    for (; i + 16 <= count; i += 16) {
+        __m128i a = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i)), lowMask);
+        __m128i b = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i + 16)), lowMask);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(a, b));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        out[i] = in[2 * i];
+    }
+}
+
+void FrameResampler::decimateRow16(const uint16_t *in, uint16_t *out, size_t count)
+{
+    size_t i = 0;
+
+#if defined(ARAVIS_HAS_AVX2)
+    const __m256i lowMask = _mm256_set1_epi32(0xFFFF);
+    for (; i + 16 <= count; i += 16) {
+        __m256i a = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i)), lowMask);
+        __m256i b = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i + 16)), lowMask);
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(a, b), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+    }
+#elif defined(ARAVIS_HAS_SSE2)
+    const __m128i bias32 = _mm_set1_epi32(0x8000);
+    const __m128i bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+    const __m128i lowMask = _mm_set1_epi32(0xFFFF);
+    for (; i + 8 <= count; i += 8) {
+        __m128i a = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i)), lowMask);
+        __m128i b = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i + 8)), lowMask);
+        __m128i packed = _mm_packs_epi32(_mm_sub_epi32(a, bias32), _mm_sub_epi32(b, bias32));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_add_epi16(packed, bias16));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        out[i] = in[2 * i];
+    }
+}
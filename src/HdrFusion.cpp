@@ -0,0 +1,280 @@
+#include "HdrFusion.h"
+#include "Simd.h"
+#include "TileExecutor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+constexpr uint32_t PIXEL_FORMAT_MONO_16 = 0x01100007;  // ARV_PIXEL_FORMAT_MONO_16
+
+#if defined(ARAVIS_HAS_AVX2)
+inline __m256 loadFloats(const uint8_t *pixels)
+{
+    return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixels))));
+}
+
+inline __m256 loadFloats(const uint16_t *pixels)
+{
+    return _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels))));
+}
+#elif defined(ARAVIS_HAS_SSE2)
+inline __m128 loadFloats(const uint8_t *pixels)
+{
+    int32_t packed;
+    std::memcpy(&packed, pixels, sizeof(packed));
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i words = _mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero);
+    return _mm_cvtepi32_ps(_mm_unpacklo_epi16(words, zero));
+}
+
+inline __m128 loadFloats(const uint16_t *pixels)
+{
+    const __m128i words = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixels));
+    return _mm_cvtepi32_ps(_mm_unpacklo_epi16(words, _mm_setzero_si128()));
+}
+#endif
+
+template <typename T>
+void accumulateRow(float *sum, float *weight, const T *pixels, size_t count, float scale, float maxValue,
+                   float minWeight)
+{
+    const float saturation = maxValue * HdrFusion::SATURATION_LEVEL;
+    const float norm = 2.0f / maxValue;
+    size_t i = 0;
+
+#if defined(ARAVIS_HAS_AVX2)
+    const __m256 vmax = _mm256_set1_ps(maxValue);
+    const __m256 vsat = _mm256_set1_ps(saturation);
+    const __m256 vnorm = _mm256_set1_ps(norm);
+    const __m256 vscale = _mm256_set1_ps(scale);
+    const __m256 vmin = _mm256_set1_ps(minWeight);
+    for (; i + 8 <= count; i += 8) {
+        const __m256 v = loadFloats(pixels + i);
+        __m256 w = _mm256_mul_ps(_mm256_min_ps(v, _mm256_sub_ps(vmax, v)), vnorm);
+        w = _mm256_max_ps(_mm256_and_ps(w, _mm256_cmp_ps(v, vsat, _CMP_LT_OQ)), vmin);
+        _mm256_storeu_ps(sum + i, _mm256_add_ps(_mm256_loadu_ps(sum + i), _mm256_mul_ps(w, _mm256_mul_ps(v, vscale))));
+        _mm256_storeu_ps(weight + i, _mm256_add_ps(_mm256_loadu_ps(weight + i), w));
+    }
+#elif defined(ARAVIS_HAS_SSE2)
+    const __m128 vmax = _mm_set1_ps(maxValue);
+    const __m128 vsat = _mm_set1_ps(saturation);
+    const __m128 vnorm = _mm_set1_ps(norm);
+    const __m128 vscale = _mm_set1_ps(scale);
+    const __m128 vmin = _mm_set1_ps(minWeight);
+    for (; i + 4 <= count; i += 4) {
+        const __m128 v = loadFloats(pixels + i);
+        __m128 w = _mm_mul_ps(_mm_min_ps(v, _mm_sub_ps(vmax, v)), vnorm);
+        w = _mm_max_ps(_mm_and_ps(w, _mm_cmplt_ps(v, vsat)), vmin);
+        _mm_storeu_ps(sum + i, _mm_add_ps(_mm_loadu_ps(sum + i), _mm_mul_ps(w, _mm_mul_ps(v, vscale))));
+        _mm_storeu_ps(weight + i, _mm_add_ps(_mm_loadu_ps(weight + i), w));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        const float v = static_cast<float>(pixels[i]);
+        float w = v < saturation ? std::min(v, maxValue - v) * norm : 0.0f;
+        w = std::max(w, minWeight);
+        sum[i] += w * v * scale;
+        weight[i] += w;
+    }
+}
+
+} // namespace
+
+HdrFusion::HdrFusion(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void HdrFusion::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+}
+
+bool HdrFusion::isEnabled() const
+{
+    return m_enabled;
+}
+
+uint64_t HdrFusion::fusedFrames() const
+{
+    return m_fused.load(std::memory_order_relaxed);
+}
+
+uint64_t HdrFusion::incompleteBrackets() const
+{
+    return m_incomplete.load(std::memory_order_relaxed);
+}
+
+const char *HdrFusion::stageName() const
+{
+    return "HdrFusion";
+}
+
+FramePtr HdrFusion::process(FramePtr frame)
+{
+    const FrameSequenceTag &tag = frame->sequence;
+    if (!m_enabled || tag.stepCount == 0) {
+        // 未启用或未运行参数序列：原样通过
+        if (!m_bracket.empty()) {
+            clearBracket();
+            m_bracket.clear();
+        }
+        return frame;
+    }
+
+    // 序列运行中无法确定参数组的帧会破坏本轮，连同本轮已收集的帧一起丢弃
+    if (!tag.isValid()) {
+        if (m_collected > 0) {
+            m_incomplete.fetch_add(1, std::memory_order_relaxed);
+            clearBracket();
+        }
+        return nullptr;
+    }
+
+    if (m_bracket.size() != static_cast<size_t>(tag.stepCount)) {
+        clearBracket();
+        m_bracket.assign(tag.stepCount, nullptr);
+    }
+
+    if (m_collected > 0) {
+        const Frame &first = **std::find_if(m_bracket.begin(), m_bracket.end(), [](const FramePtr &f) { return f; });
+        const bool sameGeometry = first.width == frame->width && first.height == frame->height
+                               && first.bitDepth == frame->bitDepth;
+        if (tag.cycle != m_cycle || !sameGeometry || m_bracket[tag.step]) {
+            m_incomplete.fetch_add(1, std::memory_order_relaxed);
+            clearBracket();
+        }
+    }
+
+    m_cycle = tag.cycle;
+    m_bracket[tag.step] = std::move(frame);
+    if (++m_collected < static_cast<int>(m_bracket.size())) {
+        return nullptr;
+    }
+
+    FramePtr fused = fuse();
+    clearBracket();
+    m_fused.fetch_add(1, std::memory_order_relaxed);
+    return fused;
+}
+
+void HdrFusion::clearBracket()
+{
+    std::fill(m_bracket.begin(), m_bracket.end(), nullptr);
+    m_collected = 0;
+}
+
+FramePtr HdrFusion::fuse()
+{
+    const size_t count = m_bracket.size();
+    const Frame &reference = *m_bracket.back();
+
+    // 各帧的相对亮度 = 曝光 × 线性增益，换算到最短的一帧
+    std::vector<float> scales(count);
+    double minLevel = std::numeric_limits<double>::max();
+    size_t shortest = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const FrameSequenceTag &tag = m_bracket[i]->sequence;
+        const double level = std::max(tag.exposureUs, 1e-3) * std::pow(10.0, tag.gainDb / 20.0);
+        scales[i] = static_cast<float>(level);
+        if (level < minLevel) {
+            minLevel = level;
+            shortest = i;
+        }
+    }
+    for (float &scale : scales) {
+        scale = static_cast<float>(minLevel / scale);
+    }
+
+    auto frame = std::make_shared<Frame>();
+    frame->width = reference.width;
+    frame->height = reference.height;
+    frame->offsetX = reference.offsetX;
+    frame->offsetY = reference.offsetY;
+    frame->bitDepth = 16;
+    frame->pixelFormat = PIXEL_FORMAT_MONO_16;
+    frame->frameId = reference.frameId;
+    frame->timestampNs = reference.timestampNs;
+    frame->systemTimestampNs = reference.systemTimestampNs;
+    frame->chunk = reference.chunk;
+    frame->data.resize(static_cast<size_t>(frame->stride()) * frame->height);
+
+    const size_t width = static_cast<size_t>(reference.width);
+    const float maxValue = static_cast<float>(reference.maxValue());
+    const float outScale = 65535.0f / maxValue;
+    const bool eightBit = reference.bytesPerPixel() == 1;
+
+    TileExecutor &executor = TileExecutor::instance();
+    executor.parallelFor(reference.height, executor.autoGrain(reference.height, width * (count + 8)),
+                         [&](size_t rowBegin, size_t rowEnd) {
+        std::vector<float> sum(width);
+        std::vector<float> weight(width);
+        for (size_t y = rowBegin; y < rowEnd; ++y) {
+            std::fill(sum.begin(), sum.end(), 0.0f);
+            std::fill(weight.begin(), weight.end(), 0.0f);
+            for (size_t i = 0; i < count; ++i) {
+                const float minWeight = i == shortest ? MIN_WEIGHT : 0.0f;
+                if (eightBit) {
+                    accumulate8(sum.data(), weight.data(), m_bracket[i]->bits() + y * width, width, scales[i],
+                                maxValue, minWeight);
+                } else {
+                    accumulate16(sum.data(), weight.data(), m_bracket[i]->bits16() + y * width, width, scales[i],
+                                 maxValue, minWeight);
+                }
+            }
+            resolve(frame->bits16() + y * width, sum.data(), weight.data(), width, outScale);
+        }
+    });
+
+    return frame;
+}
+
+void HdrFusion::accumulate8(float *sum, float *weight, const uint8_t *pixels, size_t count, float scale,
+                            float maxValue, float minWeight)
+{
+    accumulateRow(sum, weight, pixels, count, scale, maxValue, minWeight);
+}
+
+void HdrFusion::accumulate16(float *sum, float *weight, const uint16_t *pixels, size_t count, float scale,
+                             float maxValue, float minWeight)
+{
+    accumulateRow(sum, weight, pixels, count, scale, maxValue, minWeight);
+}
+
+void HdrFusion::resolve(uint16_t *out, const float *sum, const float *weight, size_t count, float outScale)
+{
+    size_t i = 0;
+
+#if defined(ARAVIS_HAS_AVX2)
+    const __m256 vscale = _mm256_set1_ps(outScale);
+    const __m256 limit = _mm256_set1_ps(65535.0f);
+    for (; i + 8 <= count; i += 8) {
+        __m256 r = _mm256_div_ps(_mm256_loadu_ps(sum + i), _mm256_loadu_ps(weight + i));
+        r = _mm256_min_ps(_mm256_mul_ps(r, vscale), limit);
+        const __m256i q = _mm256_cvtps_epi32(r);
+        const __m128i packed = _mm_packus_epi32(_mm256_castsi256_si128(q), _mm256_extracti128_si256(q, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+    }
+#elif defined(ARAVIS_HAS_SSE2)
+    const __m128 vscale = _mm_set1_ps(outScale);
+    const __m128 limit = _mm_set1_ps(65535.0f);
+    const __m128i bias32 = _mm_set1_epi32(0x8000);
+    const __m128i bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+    for (; i + 4 <= count; i += 4) {
+        __m128 r = _mm_div_ps(_mm_loadu_ps(sum + i), _mm_loadu_ps(weight + i));
+        r = _mm_min_ps(_mm_mul_ps(r, vscale), limit);
+        // SSE2 只有有符号 32 -> 16 位打包：先减去 0x8000，打包后再加回
+        const __m128i q = _mm_sub_epi32(_mm_cvtps_epi32(r), bias32);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_add_epi16(_mm_packs_epi32(q, q), bias16));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        const float r = weight[i] > 0.0f ? sum[i] / weight[i] * outScale : 0.0f;
+        out[i] = static_cast<uint16_t>(std::lround(std::min(r, 65535.0f)));
+    }
+}
@@ -0,0 +1,187 @@
+#include "HistogramEngine.h"
+#include "Simd.h"
+#include "TileExecutor.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+int FrameStatistics::percentile(double p) const
+{
+    if (sampleCount == 0 || histogram.empty()) {
+        return 0;
+    }
+
+    const uint64_t target = static_cast<uint64_t>(std::clamp(p, 0.0, 1.0) * static_cast<double>(sampleCount));
+    uint64_t accumulated = 0;
+    for (size_t i = 0; i < histogram.size(); ++i) {
+        accumulated += histogram[i];
+        if (accumulated >= target && accumulated > 0) {
+            return static_cast<int>(i);
+        }
+    }
+    return static_cast<int>(histogram.size()) - 1;
+}
+
+int HistogramEngine::autoSampleStep(int width, int height)
+{
+    const uint64_t pixels = static_cast<uint64_t>(width) * static_cast<uint64_t>(height);
+    return static_cast<int>(std::max<uint64_t>(1, (pixels + AUTO_SAMPLE_BUDGET - 1) / AUTO_SAMPLE_BUDGET));
+}
+
+void HistogramEngine::compute(const Frame &frame, int sampleStep, FrameStatistics &stats)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    const int bitDepth = std::clamp(frame.bitDepth, 8, 16);
+    const int bins = 1 << bitDepth;
+    // 4096 个 bin 以内用 4 路子直方图（64KB，仍在 L2 内），16 位只用 1 路
+    const int lanes = bins <= 4096 ? 4 : 1;
+    const int step = sampleStep > 0 ? sampleStep : autoSampleStep(frame.width, frame.height);
+
+    // 按采样后的行数切分行带，每个行带写入自己的一组子直方图
+    TileExecutor &executor = TileExecutor::instance();
+    const size_t sampledRows = (static_cast<size_t>(frame.height) + step - 1) / step;
+    const size_t rowBytes = static_cast<size_t>(frame.width) * frame.bytesPerPixel();
+    size_t grain = executor.autoGrain(sampledRows, rowBytes);
+    if (bins > 4096) {
+        // 16 位子直方图每组 256KB，行带数不超过线程数
+        const size_t threads = static_cast<size_t>(executor.threadCount());
+        grain = std::max(grain, (sampledRows + threads - 1) / threads);
+    }
+    const size_t chunks = std::max<size_t>(TileExecutor::chunkCount(sampledRows, grain), 1);
+    const size_t chunkBins = static_cast<size_t>(bins) * lanes;
+
+    m_lanes.assign(chunkBins * chunks, 0);
+
+    const uint32_t mask = static_cast<uint32_t>(bins - 1);
+    executor.parallelFor(sampledRows, grain, [&](size_t begin, size_t end) {
+        uint32_t *base = m_lanes.data() + (begin / grain) * chunkBins;
+        const int rowBegin = static_cast<int>(begin * step);
+        const int rowEnd = static_cast<int>(std::min<size_t>(end * step, frame.height));
+        if (frame.bytesPerPixel() == 1) {
+            countRows8(frame, rowBegin, rowEnd, step, lanes, base);
+        } else {
+            countRows16(frame, rowBegin, rowEnd, step, lanes, mask, base);
+        }
+    });
+
+    stats.bitDepth = bitDepth;
+    stats.sampleStep = step;
+    stats.frameId = frame.frameId;
+    stats.chunk = frame.chunk;
+    stats.histogram.resize(bins);
+    mergeLanes(static_cast<int>(lanes * chunks), bins, stats.histogram.data());
+
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    int minValue = -1;
+    int maxValue = 0;
+    for (int i = 0; i < bins; ++i) {
+        const uint32_t n = stats.histogram[i];
+        if (n == 0) {
+            continue;
+        }
+        if (minValue < 0) {
+            minValue = i;
+        }
+        maxValue = i;
+        count += n;
+        sum += static_cast<uint64_t>(n) * static_cast<uint64_t>(i);
+    }
+
+    stats.sampleCount = count;
+    stats.minValue = std::max(minValue, 0);
+    stats.maxValue = maxValue;
+    stats.mean = count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0;
+    stats.saturationPercent = count ? 100.0 * stats.histogram[bins - 1] / static_cast<double>(count) : 0.0;
+
+    auto end = std::chrono::steady_clock::now();
+    stats.computeTimeUs = std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+void HistogramEngine::countRows8(const Frame &frame, int rowBegin, int rowEnd, int step, int lanes, uint32_t *base)
+{
+    uint32_t *h0 = base;
+    uint32_t *h1 = h0 + (lanes > 1 ? 256 : 0);
+    uint32_t *h2 = h0 + (lanes > 1 ? 512 : 0);
+    uint32_t *h3 = h0 + (lanes > 1 ? 768 : 0);
+
+    for (int y = rowBegin; y < rowEnd; y += step) {
+        const uint8_t *row = frame.bits() + static_cast<size_t>(y) * frame.stride();
+        int x = 0;
+
+        // 每次读取 8 个像素，分散到 4 个子直方图
+        for (; x + 8 <= frame.width; x += 8) {
+            uint64_t v;
+            std::memcpy(&v, row + x, sizeof(v));
+            ++h0[v & 0xFF];
+            ++h1[(v >> 8) & 0xFF];
+            ++h2[(v >> 16) & 0xFF];
+            ++h3[(v >> 24) & 0xFF];
+            ++h0[(v >> 32) & 0xFF];
+            ++h1[(v >> 40) & 0xFF];
+            ++h2[(v >> 48) & 0xFF];
+            ++h3[v >> 56];
+        }
+
+        for (; x < frame.width; ++x) {
+            ++h0[row[x]];
+        }
+    }
+}
+
+void HistogramEngine::countRows16(const Frame &frame, int rowBegin, int rowEnd, int step, int lanes, uint32_t mask,
+                                  uint32_t *base)
+{
+    const size_t bins = static_cast<size_t>(mask) + 1;
+    uint32_t *h0 = base;
+    uint32_t *h1 = h0 + (lanes > 1 ? bins : 0);
+    uint32_t *h2 = h0 + (lanes > 1 ? 2 * bins : 0);
+    uint32_t *h3 = h0 + (lanes > 1 ? 3 * bins : 0);
+
+    for (int y = rowBegin; y < rowEnd; y += step) {
+        const uint16_t *row = frame.bits16() + static_cast<size_t>(y) * frame.width;
+        int x = 0;
+
+        for (; x + 4 <= frame.width; x += 4) {
+            ++h0[row[x] & mask];
+            ++h1[row[x + 1] & mask];
+            ++h2[row[x + 2] & mask];
+            ++h3[row[x + 3] & mask];
+        }
+
+        for (; x < frame.width; ++x) {
+            ++h0[row[x] & mask];
+        }
+    }
+}
+
+void HistogramEngine::mergeLanes(int lanes, int bins, uint32_t *out) const
+{
+    const uint32_t *h0 = m_lanes.data();
+    std::memcpy(out, h0, static_cast<size_t>(bins) * sizeof(uint32_t));
+
+    for (int lane = 1; lane < lanes; ++lane) {
+        const uint32_t *h = h0 + static_cast<size_t>(lane) * bins;
+        int i = 0;
+
+#if defined(ARAVIS_HAS_AVX2)
+        for (; i + 8 <= bins; i += 8) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(out + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_add_epi32(a, b));
+        }
+#elif defined(ARAVIS_HAS_SSE2)
+        for (; i + 4 <= bins; i += 4) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(out + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_add_epi32(a, b));
+        }
+#endif
+
+        for (; i < bins; ++i) {
+            out[i] += h[i];
+        }
+    }
+}
@@ -0,0 +1,491 @@
+#include "ImageSaveService.h"
+#include "DisplayConverter.h"
+#include "LosslessCodec.h"
+#include "TraceRecorder.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QImage>
+#include <QMetaObject>
+#include <QTimer>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+int64_t steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 小端 TIFF IFD 条目：tag, type, count, value（SHORT 值放在低 16 位）
+void putIfdEntry(uint8_t *p, uint16_t tag, uint16_t type, uint32_t count, uint32_t value)
+{
+    std::memcpy(p, &tag, 2);
+    std::memcpy(p + 2, &type, 2);
+    std::memcpy(p + 4, &count, 4);
+    std::memcpy(p + 8, &value, 4);
+}
+
+} // namespace
+
+ImageSaveService::ImageSaveService(QObject *parent)
+    : QObject(parent)
+    , m_directory(QDir::homePath())
+    , m_statsTimer(new QTimer(this))
+{
+    connect(m_statsTimer, &QTimer::timeout, this, &ImageSaveService::reportThroughput);
+    m_statsTimer->start(1000);
+}
+
+ImageSaveService::~ImageSaveService()
+{
+    m_recording = false;
+    m_singlePending = false;
+    stopWorkers();
+}
+
+void ImageSaveService::setDirectory(const QString &directory)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_directory = directory;
+}
+
+QString ImageSaveService::directory() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_directory;
+}
+
+void ImageSaveService::setFormat(Format format)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_format = format;
+}
+
+ImageSaveService::Format ImageSaveService::format() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_format;
+}
+
+void ImageSaveService::setQueueCapacity(int frames)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queueCapacity = std::max(1, frames);
+}
+
+int ImageSaveService::queueCapacity() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queueCapacity;
+}
+
+bool ImageSaveService::startSequence(int frameLimit)
+{
+    const QString dir = directory();
+    if (!QDir(dir).exists() && !QDir(dir).mkpath(".")) {
+        emit saveFailed(QString("无法创建目录: %1").arg(dir));
+        return false;
+    }
+
+    startWorkers();
+    m_failureReported = false;
+    m_sequenceSaved = 0;
+    m_sequenceRemaining = frameLimit > 0 ? frameLimit : 0;
+    m_sequenceActive = true;
+    m_recording = true;
+    qDebug() << "开始录制图像序列:" << dir << (frameLimit > 0 ? frameLimit : 0) << "帧 (0 = 不限)";
+    return true;
+}
+
+void ImageSaveService::stopSequence()
+{
+    m_recording = false;
+    finishSequenceIfDrained();
+}
+
+bool ImageSaveService::isRecording() const
+{
+    return m_recording;
+}
+
+bool ImageSaveService::saveNextFrame()
+{
+    const QString dir = directory();
+    if (!QDir(dir).exists() && !QDir(dir).mkpath(".")) {
+        emit saveFailed(QString("无法创建目录: %1").arg(dir));
+        return false;
+    }
+
+    startWorkers();
+    m_failureReported = false;
+    m_singlePending = true;
+    return true;
+}
+
+void ImageSaveService::offer(const FramePtr &frame)
+{
+    if (!frame) {
+        return;
+    }
+
+    const bool single = m_singlePending.exchange(false);
+
+    // 有限帧数的序列：先占一个名额，入队失败再归还
+    bool sequence = m_recording;
+    const bool limited = sequence && m_sequenceRemaining.load() > 0;
+    int remaining = 0;
+    if (limited) {
+        remaining = m_sequenceRemaining.fetch_sub(1);
+        if (remaining <= 0) {
+            m_sequenceRemaining.fetch_add(1);
+            sequence = false;
+        }
+    }
+
+    if (!single && !sequence) {
+        return;
+    }
+
+    // 单帧保存和序列录制命中同一帧时只写一个文件，两边的完成处理都由这一个任务完成
+    if (sequence) {
+        m_sequenceInFlight.fetch_add(1);
+    }
+    if (!enqueue(frame, single, sequence)) {
+        if (sequence) {
+            m_sequenceInFlight.fetch_sub(1);
+            if (limited) {
+                m_sequenceRemaining.fetch_add(1);
+            }
+        }
+        return;
+    }
+
+    if (limited && remaining == 1) {
+        m_recording = false;
+        finishSequenceIfDrained();
+    }
+}
+
+bool ImageSaveService::enqueue(const FramePtr &frame, bool single, bool sequence)
+{
+    Format format;
+    QString directory;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        format = m_format;
+        directory = m_directory;
+    }
+
+    // 文件名中的时间格式化放在锁外，不拖慢保存线程取任务
+    Job job{frame, makeFilePath(*frame, format, directory), format, single, sequence};
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (static_cast<int>(m_queue.size()) >= m_queueCapacity) {
+            m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_queue.push_back(std::move(job));
+    }
+    m_cond.notify_one();
+    return true;
+}
+
+int ImageSaveService::queuedFrames() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<int>(m_queue.size());
+}
+
+uint64_t ImageSaveService::savedFrames() const
+{
+    return m_savedFrames;
+}
+
+uint64_t ImageSaveService::droppedFrames() const
+{
+    return m_droppedFrames;
+}
+
+QString ImageSaveService::formatSuffix(Format format)
+{
+    switch (format) {
+    case Format::Png:
+        return "png";
+    case Format::Tiff:
+        return "tif";
+    case Format::Bmp:
+        return "bmp";
+    case Format::Raw:
+        return "raw";
+    case Format::Compressed:
+        return "alc";
+    }
+    return "bin";
+}
+
+void ImageSaveService::startWorkers()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_workersRunning) {
+        return;
+    }
+
+    m_workersRunning = true;
+    const unsigned count = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 0; i < count; ++i) {
+        m_workers.emplace_back(&ImageSaveService::workerLoop, this);
+    }
+    qDebug() << "图像保存线程池启动:" << count << "个线程";
+}
+
+void ImageSaveService::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_workersRunning = false;
+    }
+    m_cond.notify_all();
+
+    for (auto &worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    m_workers.clear();
+}
+
+void ImageSaveService::workerLoop()
+{
+    TraceRecorder::setThreadName("图像保存");
+
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            // 停止时先写完队列中剩余的帧
+            m_cond.wait(lock, [this] { return !m_queue.empty() || !m_workersRunning; });
+            if (m_queue.empty()) {
+                return;
+            }
+            job = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        QString error;
+        const int64_t writeBeginNs = TraceRecorder::instance().isEnabled() ? TraceRecorder::nowNs() : 0;
+        const bool written = writeFrame(job, &error);
+        if (writeBeginNs != 0) {
+            TraceRecorder::instance().record("record", job.frame->frameId, writeBeginNs, TraceRecorder::nowNs());
+        }
+        if (written) {
+            m_savedFrames.fetch_add(1, std::memory_order_relaxed);
+            m_savedBytes.fetch_add(job.frame->data.size(), std::memory_order_relaxed);
+            if (job.sequence) {
+                m_sequenceSaved.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (job.single) {
+                const QString path = job.path;
+                QMetaObject::invokeMethod(this, [this, path]() {
+                    emit frameSaved(path);
+                }, Qt::QueuedConnection);
+            }
+        } else if (!m_failureReported.exchange(true)) {
+            // 磁盘满等错误会连续发生，每次录制只报告一次
+            QMetaObject::invokeMethod(this, [this, error]() {
+                emit saveFailed(error);
+            }, Qt::QueuedConnection);
+        }
+
+        if (job.sequence) {
+            m_sequenceInFlight.fetch_sub(1);
+            if (!m_recording) {
+                finishSequenceIfDrained();
+            }
+        }
+    }
+}
+
+void ImageSaveService::finishSequenceIfDrained()
+{
+    if (m_sequenceInFlight.load() > 0 || !m_sequenceActive.exchange(false)) {
+        return;
+    }
+
+    const qulonglong saved = m_sequenceSaved.load();
+    QMetaObject::invokeMethod(this, [this, saved]() {
+        emit sequenceFinished(saved);
+    }, Qt::QueuedConnection);
+}
+
+QString ImageSaveService::makeFilePath(const Frame &frame, Format format, const QString &directory) const
+{
+    // 以主机接收时间命名，帧号保证同一毫秒内不重名
+    const QDateTime time = frame.systemTimestampNs > 0
+        ? QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(frame.systemTimestampNs / 1000000))
+        : QDateTime::currentDateTime();
+
+    QString name = QString("frame_%1_%2").arg(time.toString("yyyyMMdd_hhmmss_zzz")).arg(frame.frameId);
+    if (format == Format::Raw) {
+        name += QString("_%1x%2_%3bit").arg(frame.width).arg(frame.height).arg(frame.bitDepth);
+    }
+    return QDir(directory).filePath(name + "." + formatSuffix(format));
+}
+
+bool ImageSaveService::writeFrame(const Job &job, QString *error)
+{
+    bool ok = false;
+    switch (job.format) {
+    case Format::Png:
+        ok = writeWithQImage(*job.frame, job.path, "PNG");
+        break;
+    case Format::Tiff:
+        ok = writeTiff(*job.frame, job.path);
+        break;
+    case Format::Bmp:
+        ok = writeWithQImage(*job.frame, job.path, "BMP");
+        break;
+    case Format::Raw:
+        ok = writeRaw(*job.frame, job.path);
+        break;
+    case Format::Compressed:
+        ok = writeCompressed(*job.frame, job.path);
+        break;
+    }
+
+    if (!ok && error) {
+        *error = QString("图像保存失败: %1").arg(job.path);
+    }
+    return ok;
+}
+
+bool ImageSaveService::writeWithQImage(const Frame &frame, const QString &path, const char *format)
+{
+    QImage image;
+    if (frame.bitDepth == 8) {
+        image = QImage(frame.bits(), frame.width, frame.height, frame.stride(), QImage::Format_Grayscale8);
+    } else if (std::strcmp(format, "PNG") == 0) {
+        // PNG 支持 16 位灰度，保留原始数值
+        image = QImage(frame.bits(), frame.width, frame.height, frame.stride(), QImage::Format_Grayscale16);
+    } else {
+        image = QImage(frame.width, frame.height, QImage::Format_Grayscale8);
+        DisplayConverter::toGray8(frame, image.bits(), image.bytesPerLine());
+    }
+    return image.save(path, format);
+}
+
+bool ImageSaveService::writeTiff(const Frame &frame, const QString &path)
+{
+    // 基线 TIFF：小端、单条带、无压缩、BlackIsZero 灰度
+    constexpr uint16_t SHORT = 3;
+    constexpr uint32_t LONG = 4;
+    constexpr uint16_t ENTRY_COUNT = 10;
+    constexpr uint32_t IFD_OFFSET = 8;
+    constexpr uint32_t IFD_SIZE = 2 + ENTRY_COUNT * 12 + 4;
+    constexpr uint32_t DATA_OFFSET = IFD_OFFSET + IFD_SIZE;
+
+    const uint32_t width = static_cast<uint32_t>(frame.width);
+    const uint32_t height = static_cast<uint32_t>(frame.height);
+    const uint32_t bits = frame.bitDepth > 8 ? 16 : 8;
+    const uint32_t dataSize = static_cast<uint32_t>(frame.data.size());
+
+    uint8_t header[DATA_OFFSET] = {};
+    header[0] = 'I';
+    header[1] = 'I';
+    header[2] = 42;
+    std::memcpy(header + 4, &IFD_OFFSET, 4);
+
+    uint8_t *ifd = header + IFD_OFFSET;
+    std::memcpy(ifd, &ENTRY_COUNT, 2);
+    uint8_t *entry = ifd + 2;
+    putIfdEntry(entry, 256, LONG, 1, width);              entry += 12; // ImageWidth
+    putIfdEntry(entry, 257, LONG, 1, height);             entry += 12; // ImageLength
+    putIfdEntry(entry, 258, SHORT, 1, bits);              entry += 12; // BitsPerSample
+    putIfdEntry(entry, 259, SHORT, 1, 1);                 entry += 12; // Compression: 无
+    putIfdEntry(entry, 262, SHORT, 1, 1);                 entry += 12; // Photometric: BlackIsZero
+    putIfdEntry(entry, 273, LONG, 1, DATA_OFFSET);        entry += 12; // StripOffsets
+    putIfdEntry(entry, 277, SHORT, 1, 1);                 entry += 12; // SamplesPerPixel
+    putIfdEntry(entry, 278, LONG, 1, height);             entry += 12; // RowsPerStrip
+    putIfdEntry(entry, 279, LONG, 1, dataSize);           entry += 12; // StripByteCounts
+    putIfdEntry(entry, 284, SHORT, 1, 1);                              // PlanarConfiguration
+    // 下一个 IFD 偏移为 0，已由初始化清零
+
+    const QByteArray nativePath = path.toLocal8Bit();
+    FILE *file = std::fopen(nativePath.constData(), "wb");
+    if (!file) {
+        return false;
+    }
+    const bool ok = std::fwrite(header, 1, sizeof(header), file) == sizeof(header)
+                    && std::fwrite(frame.bits(), 1, frame.data.size(), file) == frame.data.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+bool ImageSaveService::writeRaw(const Frame &frame, const QString &path)
+{
+    const QByteArray nativePath = path.toLocal8Bit();
+    FILE *file = std::fopen(nativePath.constData(), "wb");
+    if (!file) {
+        return false;
+    }
+    const bool ok = std::fwrite(frame.bits(), 1, frame.data.size(), file) == frame.data.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+bool ImageSaveService::writeCompressed(const Frame &frame, const QString &path)
+{
+    // 每个编码线程复用自己的输出缓冲区
+    thread_local std::vector<uint8_t> encoded;
+
+    const int64_t start = steadyNowNs();
+    LosslessCodec::encode(frame, encoded);
+    m_codecNs.fetch_add(static_cast<uint64_t>(steadyNowNs() - start), std::memory_order_relaxed);
+    m_codecInputBytes.fetch_add(frame.data.size(), std::memory_order_relaxed);
+    m_codecOutputBytes.fetch_add(encoded.size(), std::memory_order_relaxed);
+
+    const QByteArray nativePath = path.toLocal8Bit();
+    FILE *file = std::fopen(nativePath.constData(), "wb");
+    if (!file) {
+        return false;
+    }
+    const bool ok = std::fwrite(encoded.data(), 1, encoded.size(), file) == encoded.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+void ImageSaveService::reportThroughput()
+{
+    const int64_t now = steadyNowNs();
+    const uint64_t saved = m_savedFrames.load(std::memory_order_relaxed);
+    const uint64_t bytes = m_savedBytes.load(std::memory_order_relaxed);
+    const uint64_t codecInput = m_codecInputBytes.load(std::memory_order_relaxed);
+    const uint64_t codecOutput = m_codecOutputBytes.load(std::memory_order_relaxed);
+    const uint64_t codecNs = m_codecNs.load(std::memory_order_relaxed);
+
+    if (m_lastReportNs > 0 && (saved != m_lastSavedFrames || m_recording)) {
+        const double seconds = (now - m_lastReportNs) / 1e9;
+        SaveStatistics stats;
+        stats.framesPerSecond = (saved - m_lastSavedFrames) / seconds;
+        stats.megabytesPerSecond = (bytes - m_lastSavedBytes) / seconds / (1024.0 * 1024.0);
+        if (codecOutput > m_lastCodecOutputBytes) {
+            stats.compressionRatio = static_cast<double>(codecInput - m_lastCodecInputBytes)
+                                     / static_cast<double>(codecOutput - m_lastCodecOutputBytes);
+        }
+        if (codecNs > m_lastCodecNs) {
+            stats.codecMegabytesPerSecond = (codecInput - m_lastCodecInputBytes) * 1e9
+                                            / static_cast<double>(codecNs - m_lastCodecNs) / (1024.0 * 1024.0);
+        }
+        stats.queuedFrames = queuedFrames();
+        stats.droppedFrames = m_droppedFrames.load();
+        emit throughputUpdated(stats);
+    }
+
+    m_lastReportNs = now;
+    m_lastSavedFrames = saved;
+    m_lastSavedBytes = bytes;
+    m_lastCodecInputBytes = codecInput;
+    m_lastCodecOutputBytes = codecOutput;
+    m_lastCodecNs = codecNs;
+}
@@ -0,0 +1,146 @@
+#include "IntervalHistogram.h"
+#include <QString>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+IntervalHistogram::IntervalHistogram()
+{
+    reset();
+}
+
+void IntervalHistogram::reset()
+{
+    for (auto &bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sumNs.store(0, std::memory_order_relaxed);
+    m_minNs.store(std::numeric_limits<int64_t>::max(), std::memory_order_relaxed);
+    m_maxNs.store(0, std::memory_order_relaxed);
+}
+
+int IntervalHistogram::bucketIndex(int64_t intervalNs)
+{
+    const uint64_t value = static_cast<uint64_t>(std::max<int64_t>(intervalNs, int64_t(1) << MIN_SHIFT));
+    const int msb = 63 - std::countl_zero(value);
+    const int sub = static_cast<int>((value >> (msb - 2)) & (SUB_BUCKETS - 1));
+    return std::min((msb - MIN_SHIFT) * SUB_BUCKETS + sub, BUCKET_COUNT - 1);
+}
+
+int64_t IntervalHistogram::bucketLowerNs(int index)
+{
+    const int msb = index / SUB_BUCKETS + MIN_SHIFT;
+    const int sub = index % SUB_BUCKETS;
+    return static_cast<int64_t>(SUB_BUCKETS + sub) << (msb - 2);
+}
+
+int64_t IntervalHistogram::bucketUpperNs(int index)
+{
+    const int msb = index / SUB_BUCKETS + MIN_SHIFT;
+    const int sub = index % SUB_BUCKETS;
+    return static_cast<int64_t>(SUB_BUCKETS + sub + 1) << (msb - 2);
+}
+
+void IntervalHistogram::add(int64_t intervalNs)
+{
+    m_buckets[bucketIndex(intervalNs)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sumNs.fetch_add(intervalNs, std::memory_order_relaxed);
+
+    // 单写者：最小/最大值的读-改-写无需 CAS
+    if (intervalNs < m_minNs.load(std::memory_order_relaxed)) {
+        m_minNs.store(intervalNs, std::memory_order_relaxed);
+    }
+    if (intervalNs > m_maxNs.load(std::memory_order_relaxed)) {
+        m_maxNs.store(intervalNs, std::memory_order_relaxed);
+    }
+}
+
+IntervalHistogram::Summary IntervalHistogram::summary(double lateFactor) const
+{
+    Summary result;
+    std::array<uint64_t, BUCKET_COUNT> buckets;
+    uint64_t total = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+        total += buckets[i];
+    }
+    if (total == 0) {
+        return result;
+    }
+
+    const int64_t minNs = m_minNs.load(std::memory_order_relaxed);
+    const int64_t maxNs = m_maxNs.load(std::memory_order_relaxed);
+    result.count = total;
+    result.meanUs = m_sumNs.load(std::memory_order_relaxed) / 1000.0 / std::max<uint64_t>(m_count.load(), 1);
+    result.minUs = minNs / 1000.0;
+    result.maxUs = maxNs / 1000.0;
+
+    auto percentileUs = [&](double p) {
+        const uint64_t rank = static_cast<uint64_t>(p * (total - 1));
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKET_COUNT; ++i) {
+            seen += buckets[i];
+            if (seen > rank) {
+                return std::min(bucketUpperNs(i), maxNs) / 1000.0;
+            }
+        }
+        return maxNs / 1000.0;
+    };
+    result.p50Us = percentileUs(0.50);
+    result.p99Us = percentileUs(0.99);
+    result.p999Us = percentileUs(0.999);
+
+    const double lateNs = result.p50Us * 1000.0 * lateFactor;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        if (bucketLowerNs(i) >= lateNs) {
+            result.lateCount += buckets[i];
+        }
+    }
+    return result;
+}
+
+QStringList IntervalHistogram::report(double lateFactor) const
+{
+    QStringList lines;
+    const Summary s = summary(lateFactor);
+    if (s.count == 0) {
+        lines << "无出队间隔数据";
+        return lines;
+    }
+
+    lines << QString("出队间隔: %1 次 | 平均 %2 μs | 最小 %3 | P50 %4 | P99 %5 | P99.9 %6 | 最大 %7 μs")
+                 .arg(s.count)
+                 .arg(s.meanUs, 0, 'f', 1)
+                 .arg(s.minUs, 0, 'f', 1)
+                 .arg(s.p50Us, 0, 'f', 1)
+                 .arg(s.p99Us, 0, 'f', 1)
+                 .arg(s.p999Us, 0, 'f', 1)
+                 .arg(s.maxUs, 0, 'f', 1);
+    lines << QString("超过 %1 倍中位数的间隔: %2 次 (%3%)")
+                 .arg(lateFactor, 0, 'f', 1)
+                 .arg(s.lateCount)
+                 .arg(100.0 * s.lateCount / s.count, 0, 'f', 3);
+
+    uint64_t peak = 0;
+    for (const auto &bucket : m_buckets) {
+        peak = std::max<uint64_t>(peak, bucket.load(std::memory_order_relaxed));
+    }
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        const uint64_t n = m_buckets[i].load(std::memory_order_relaxed);
+        if (n == 0) {
+            continue;
+        }
+        // 条形长度按对数缩放，少量长尾间隔也可见
+        const int bar = std::max(1, static_cast<int>(40.0 * std::log1p(static_cast<double>(n)) /
+                                                    std::log1p(static_cast<double>(peak))));
+        lines << QString("%1 - %2 μs | %3 %4")
+                     .arg(bucketLowerNs(i) / 1000.0, 9, 'f', 1)
+                     .arg(bucketUpperNs(i) / 1000.0, 9, 'f', 1)
+                     .arg(QString(bar, QChar('#')))
+                     .arg(n);
+    }
+    return lines;
+}
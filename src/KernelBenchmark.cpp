@@ -0,0 +1,140 @@
+#include "KernelBenchmark.h"
+#include "DisplayConverter.h"
+#include "FlatFieldCorrector.h"
+#include "FocusMetric.h"
+#include "FrameResampler.h"
+#include "HistogramEngine.h"
+#include "LosslessCodec.h"
+#include "TemporalFilter.h"
+#include "TileExecutor.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Kernel {
+    const char *name;
+    std::function<void()> run;
+};
+
+double measureMs(const std::function<void()> &fn, int repeats)
+{
+    // 先运行一次预热缓存和线程，再取多次中的最小值
+    fn();
+    double best = 0.0;
+    for (int i = 0; i < repeats; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        best = i == 0 ? ms : std::min(best, ms);
+    }
+    return best;
+}
+
+} // namespace
+
+QStringList KernelBenchmark::run(int width, int height, int repeats, const ProgressCallback &progress)
+{
+    const size_t pixels = static_cast<size_t>(width) * height;
+
+    Frame frame8;
+    frame8.width = width;
+    frame8.height = height;
+    frame8.bitDepth = 8;
+    frame8.data.resize(pixels);
+
+    Frame frame12 = frame8;
+    frame12.bitDepth = 12;
+    frame12.data.resize(pixels * 2);
+
+    std::mt19937 random(42);
+    for (size_t i = 0; i < pixels; ++i) {
+        const uint32_t value = random();
+        frame8.bits()[i] = static_cast<uint8_t>(value);
+        frame12.bits16()[i] = static_cast<uint16_t>(value & 0x0FFF);
+    }
+
+    std::vector<uint8_t> display(pixels);
+    std::vector<uint16_t> dark(pixels, 8);
+    std::vector<uint16_t> gain(pixels, FlatFieldCorrector::GAIN_ONE);
+    std::vector<uint16_t> accumulator(pixels, 0);
+    std::vector<uint8_t> encoded;
+    HistogramEngine histogram;
+    FrameStatistics stats;
+    TileExecutor &executor = TileExecutor::instance();
+    DerivedFrameSpec binSpec;
+    binSpec.reduce = DerivedFrameSpec::Reduce::Bin;
+    binSpec.factor = 2;
+
+    const std::vector<Kernel> kernels = {
+        {"显示转换(12位)", [&]() {
+            DisplayConverter::toGray8(frame12, display.data(), width);
+        }},
+        {"2×2 合并(12位)", [&]() {
+            FrameResampler::derive(frame12, binSpec);
+        }},
+        {"平场校正(8位)", [&]() {
+            executor.parallelFor(height, executor.autoGrain(height, static_cast<size_t>(width) * 6),
+                                 [&](size_t rowBegin, size_t rowEnd) {
+                const size_t offset = rowBegin * width;
+                FlatFieldCorrector::correct8(frame8.bits() + offset, dark.data() + offset, gain.data() + offset,
+                                             (rowEnd - rowBegin) * width);
+            });
+        }},
+        {"时域累加(8位)", [&]() {
+            executor.parallelFor(height, executor.autoGrain(height, static_cast<size_t>(width) * 4),
+                                 [&](size_t rowBegin, size_t rowEnd) {
+                const size_t offset = rowBegin * width;
+                TemporalFilter::accumulate8(accumulator.data() + offset, frame8.bits() + offset, nullptr,
+                                            (rowEnd - rowBegin) * width);
+            });
+        }},
+        {"直方图(12位全帧)", [&]() {
+            histogram.compute(frame12, 1, stats);
+        }},
+        {"对焦评价(拉普拉斯)", [&]() {
+            FocusMetric::compute(frame8, FocusMetric::Method::Laplacian);
+        }},
+        {"无损压缩(12位)", [&]() {
+            LosslessCodec::encode(frame12, encoded);
+        }},
+    };
+
+    const int previousLimit = executor.threadLimit();
+    executor.setThreadLimit(0);
+    const int maxThreads = executor.threadCount();
+
+    QStringList report;
+    report << QString("并行扩展性测试: %1x%2, 最多 %3 线程, 每项取 %4 次最小值")
+                  .arg(width).arg(height).arg(maxThreads).arg(repeats);
+    if (progress) {
+        progress(report.back());
+    }
+
+    for (const Kernel &kernel : kernels) {
+        double single = 0.0;
+        QStringList cells;
+        for (int threads = 1; threads <= maxThreads; ++threads) {
+            executor.setThreadLimit(threads);
+            const double ms = measureMs(kernel.run, repeats);
+            if (threads == 1) {
+                single = ms;
+            }
+            const double efficiency = ms > 0.0 ? single / (threads * ms) : 0.0;
+            cells << QString("%1T %2ms x%3 %4%")
+                         .arg(threads)
+                         .arg(ms, 0, 'f', 2)
+                         .arg(ms > 0.0 ? single / ms : 0.0, 0, 'f', 2)
+                         .arg(efficiency * 100.0, 0, 'f', 0);
+        }
+        report << QString("%1: %2").arg(kernel.name, cells.join(" | "));
+        if (progress) {
+            progress(report.back());
+        }
+    }
+
+    executor.setThreadLimit(previousLimit);
+    return report;
+}
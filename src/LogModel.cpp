@@ -0,0 +1,132 @@
+#include "LogModel.h"
+#include <QColor>
+#include <QDateTime>
+#include <QStringList>
+#include <algorithm>
+#include <cstdio>
+
+LogModel::LogModel(int capacity, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_entries(static_cast<size_t>(std::max(capacity, 8)))
+{
+}
+
+void LogModel::append(const QString &message, bool isError)
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (const QString &line : message.split("\n")) {
+        appendLine(now, line, isError);
+    }
+}
+
+void LogModel::appendLine(qint64 wallTimeMs, const QString &line, bool isError)
+{
+    // 与上一条相同：只累加次数，视图只重绘这一行
+    if (m_count > 0) {
+        Entry &last = entryAt(m_count - 1);
+        if (last.isError == isError && last.text == line) {
+            last.repeats++;
+            last.wallTimeMs = wallTimeMs;
+            const QModelIndex changed = index(m_count - 1);
+            emit dataChanged(changed, changed);
+            return;
+        }
+    }
+
+    const int capacity = this->capacity();
+    if (m_count == capacity) {
+        // 成批淘汰，避免满载后每条消息都触发一次删除行
+        const int evict = capacity / 8;
+        beginRemoveRows(QModelIndex(), 0, evict - 1);
+        for (int row = 0; row < evict; ++row) {
+            entryAt(row) = Entry();
+        }
+        m_head = (m_head + evict) % m_entries.size();
+        m_count -= evict;
+        m_evicted += evict;
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), m_count, m_count);
+    Entry &entry = entryAt(m_count);
+    entry.wallTimeMs = wallTimeMs;
+    entry.text = line;
+    entry.isError = isError;
+    entry.repeats = 1;
+    m_count++;
+    endInsertRows();
+}
+
+void LogModel::clear()
+{
+    beginResetModel();
+    std::fill(m_entries.begin(), m_entries.end(), Entry());
+    m_head = 0;
+    m_count = 0;
+    endResetModel();
+}
+
+bool LogModel::exportText(const QString &path, QString *error) const
+{
+    const QByteArray localPath = path.toLocal8Bit();
+    FILE *file = std::fopen(localPath.constData(), "w");
+    if (!file) {
+        if (error) {
+            *error = QString("无法写入: %1").arg(path);
+        }
+        return false;
+    }
+
+    if (m_evicted > 0) {
+        std::fprintf(file, "# 更早的 %llu 条日志已淘汰\n", static_cast<unsigned long long>(m_evicted));
+    }
+    for (int row = 0; row < m_count; ++row) {
+        const Entry &entry = entryAt(row);
+        const QByteArray line = (QDateTime::fromMSecsSinceEpoch(entry.wallTimeMs).toString("yyyy-MM-dd ")
+                                 + formatEntry(entry)).toUtf8();
+        std::fprintf(file, "%s%s\n", entry.isError ? "[错误] " : "", line.constData());
+    }
+
+    const bool ok = std::fclose(file) == 0;
+    if (!ok && error) {
+        *error = QString("写入失败: %1").arg(path);
+    }
+    return ok;
+}
+
+int LogModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_count;
+}
+
+QVariant LogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_count) {
+        return QVariant();
+    }
+
+    const Entry &entry = entryAt(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::ToolTipRole:
+        return formatEntry(entry);
+    case Qt::ForegroundRole:
+        if (entry.isError) {
+            return QColor(Qt::red);
+        }
+        return QVariant();
+    case IsErrorRole:
+        return entry.isError;
+    default:
+        return QVariant();
+    }
+}
+
+QString LogModel::formatEntry(const Entry &entry)
+{
+    const QString time = QDateTime::fromMSecsSinceEpoch(entry.wallTimeMs).toString("hh:mm:ss");
+    if (entry.repeats > 1) {
+        return QString("[%1] %2 (×%3)").arg(time, entry.text).arg(entry.repeats);
+    }
+    return QString("[%1] %2").arg(time, entry.text);
+}
@@ -0,0 +1,434 @@
+#include "LosslessCodec.h"
+#include "Simd.h"
+#include "TileExecutor.h"
+#include <algorithm>
+#include <limits>
+#include <atomic>
+#include <cstring>
+
+static_assert(sizeof(LosslessCodec::StreamHeader) == 104, "码流头布局必须固定");
+
+namespace {
+
+inline uint8_t zigzag8(uint8_t residual)
+{
+    const int8_t r = static_cast<int8_t>(residual);
+    return static_cast<uint8_t>((static_cast<uint8_t>(r) << 1) ^ static_cast<uint8_t>(r >> 7));
+}
+
+inline uint16_t zigzag16(uint16_t residual)
+{
+    const int16_t r = static_cast<int16_t>(residual);
+    return static_cast<uint16_t>((static_cast<uint16_t>(r) << 1) ^ static_cast<uint16_t>(r >> 15));
+}
+
+template<typename T>
+inline T unzigzag(T value)
+{
+    return static_cast<T>((value >> 1) ^ static_cast<T>(-static_cast<T>(value & 1)));
+}
+
+// 块内所有值按位或，得到最大位宽
+template<typename T>
+inline uint32_t blockBits(const T *values)
+{
+    uint32_t merged = 0;
+
+#if defined(ARAVIS_HAS_SSE2)
+    if constexpr (sizeof(T) == 2) {
+        __m128i v = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values)),
+                                 _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + 8)));
+        v = _mm_or_si128(v, _mm_srli_si128(v, 8));
+        v = _mm_or_si128(v, _mm_srli_si128(v, 4));
+        v = _mm_or_si128(v, _mm_srli_si128(v, 2));
+        merged = static_cast<uint32_t>(_mm_cvtsi128_si32(v)) & 0xFFFF;
+    } else {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+        v = _mm_or_si128(v, _mm_srli_si128(v, 8));
+        v = _mm_or_si128(v, _mm_srli_si128(v, 4));
+        v = _mm_or_si128(v, _mm_srli_si128(v, 2));
+        v = _mm_or_si128(v, _mm_srli_si128(v, 1));
+        merged = static_cast<uint32_t>(_mm_cvtsi128_si32(v)) & 0xFF;
+    }
+#else
+    for (int i = 0; i < LosslessCodec::BLOCK_SIZE; ++i) {
+        merged |= values[i];
+    }
+#endif
+
+    uint32_t bits = 0;
+    while (merged >> bits) {
+        ++bits;
+    }
+    return bits;
+}
+
+} // namespace
+
+void LosslessCodec::residualRow8(const uint8_t *row, const uint8_t *up, uint8_t *out, size_t width)
+{
+    if (width == 0) {
+        return;
+    }
+
+    out[0] = zigzag8(static_cast<uint8_t>(row[0] - (up ? up[0] : 0)));
+    size_t i = 1;
+
+#if defined(ARAVIS_HAS_AVX2)
+    const __m256i zero = _mm256_setzero_si256();
+    for (; i + 32 <= width; i += 32) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+        __m256i predicted = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i - 1));
+        if (up) {
+            predicted = _mm256_sub_epi8(
+                _mm256_add_epi8(predicted, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(up + i))),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(up + i - 1)));
+        }
+        const __m256i r = _mm256_sub_epi8(x, predicted);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                            _mm256_xor_si256(_mm256_add_epi8(r, r), _mm256_cmpgt_epi8(zero, r)));
+    }
+#elif defined(ARAVIS_HAS_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= width; i += 16) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        __m128i predicted = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i - 1));
+        if (up) {
+            predicted = _mm_sub_epi8(
+                _mm_add_epi8(predicted, _mm_loadu_si128(reinterpret_cast<const __m128i*>(up + i))),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(up + i - 1)));
+        }
+        const __m128i r = _mm_sub_epi8(x, predicted);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                         _mm_xor_si128(_mm_add_epi8(r, r), _mm_cmpgt_epi8(zero, r)));
+    }
+#endif
+
+    for (; i < width; ++i) {
+        const uint8_t predicted = up ? static_cast<uint8_t>(row[i - 1] + up[i] - up[i - 1]) : row[i - 1];
+        out[i] = zigzag8(static_cast<uint8_t>(row[i] - predicted));
+    }
+}
+
+void LosslessCodec::residualRow16(const uint16_t *row, const uint16_t *up, uint16_t *out, size_t width)
+{
+    if (width == 0) {
+        return;
+    }
+
+    out[0] = zigzag16(static_cast<uint16_t>(row[0] - (up ? up[0] : 0)));
+    size_t i = 1;
+
+#if defined(ARAVIS_HAS_AVX2)
+    for (; i + 16 <= width; i += 16) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+        __m256i predicted = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i - 1));
+        if (up) {
+            predicted = _mm256_sub_epi16(
+                _mm256_add_epi16(predicted, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(up + i))),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(up + i - 1)));
+        }
+        const __m256i r = _mm256_sub_epi16(x, predicted);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                            _mm256_xor_si256(_mm256_slli_epi16(r, 1), _mm256_srai_epi16(r, 15)));
+    }
+#elif defined(ARAVIS_HAS_SSE2)
+    for (; i + 8 <= width; i += 8) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        __m128i predicted = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i - 1));
+        if (up) {
+            predicted = _mm_sub_epi16(
+                _mm_add_epi16(predicted, _mm_loadu_si128(reinterpret_cast<const __m128i*>(up + i))),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(up + i - 1)));
+        }
+        const __m128i r = _mm_sub_epi16(x, predicted);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                         _mm_xor_si128(_mm_slli_epi16(r, 1), _mm_srai_epi16(r, 15)));
+    }
+#endif
+
+    for (; i < width; ++i) {
+        const uint16_t predicted = up ? static_cast<uint16_t>(row[i - 1] + up[i] - up[i - 1]) : row[i - 1];
+        out[i] = zigzag16(static_cast<uint16_t>(row[i] - predicted));
+    }
+}
+
+template<typename T>
+size_t LosslessCodec::packBlocks(const T *values, size_t count, uint8_t *out)
+{
+    // values 尾部已补零到 BLOCK_SIZE 的整数倍；out 末尾需留 8 字节余量
+    uint8_t *p = out;
+    for (size_t block = 0; block < count; block += BLOCK_SIZE) {
+        const uint32_t bits = blockBits(values + block);
+        *p++ = static_cast<uint8_t>(bits);
+        if (bits == 0) {
+            continue;
+        }
+
+        uint64_t accumulator = 0;
+        uint32_t filled = 0;
+        for (int i = 0; i < BLOCK_SIZE; ++i) {
+            accumulator |= static_cast<uint64_t>(values[block + i]) << filled;
+            filled += bits;
+            if (filled >= 32) {
+                std::memcpy(p, &accumulator, 4);
+                p += 4;
+                accumulator >>= 32;
+                filled -= 32;
+            }
+        }
+        // 16 * bits 必为 8 的整数倍，剩余部分整字节写出
+        std::memcpy(p, &accumulator, 8);
+        p += filled / 8;
+    }
+    return static_cast<size_t>(p - out);
+}
+
+template<typename T>
+bool LosslessCodec::unpackBlocks(const uint8_t *data, size_t size, T *values, size_t count)
+{
+    const uint8_t *p = data;
+    const uint8_t *end = data + size;
+    for (size_t block = 0; block < count; block += BLOCK_SIZE) {
+        if (p >= end) {
+            return false;
+        }
+        const uint32_t bits = *p++;
+        if (bits > sizeof(T) * 8 || static_cast<size_t>(end - p) < bits * 2) {
+            return false;
+        }
+        if (bits == 0) {
+            std::fill(values + block, values + block + BLOCK_SIZE, T(0));
+            continue;
+        }
+
+        const uint64_t mask = (1ull << bits) - 1;
+        uint64_t accumulator = 0;
+        uint32_t available = 0;
+        for (int i = 0; i < BLOCK_SIZE; ++i) {
+            while (available < bits) {
+                accumulator |= static_cast<uint64_t>(*p++) << available;
+                available += 8;
+            }
+            values[block + i] = static_cast<T>(accumulator & mask);
+            accumulator >>= bits;
+            available -= bits;
+        }
+    }
+    return p == end;
+}
+
+template<typename T>
+void LosslessCodec::reconstructBand(const T *residuals, T *pixels, size_t width, size_t rows)
+{
+    for (size_t y = 0; y < rows; ++y) {
+        const T *r = residuals + y * width;
+        T *row = pixels + y * width;
+        const T *up = y > 0 ? row - width : nullptr;
+
+        row[0] = static_cast<T>(unzigzag(r[0]) + (up ? up[0] : 0));
+        for (size_t x = 1; x < width; ++x) {
+            const T predicted = up ? static_cast<T>(row[x - 1] + up[x] - up[x - 1]) : row[x - 1];
+            row[x] = static_cast<T>(unzigzag(r[x]) + predicted);
+        }
+    }
+}
+
+void LosslessCodec::encode(const Frame &frame, std::vector<uint8_t> &out)
+{
+    const size_t width = static_cast<size_t>(frame.width);
+    const size_t height = static_cast<size_t>(frame.height);
+    const size_t bytesPerPixel = static_cast<size_t>(frame.bytesPerPixel());
+    const size_t bandCount = (height + ROWS_PER_BAND - 1) / ROWS_PER_BAND;
+
+    // 每个行带先写在最坏情况的位置上，全部完成后再向前紧缩
+    const size_t bandValues = static_cast<size_t>(ROWS_PER_BAND) * width;
+    const size_t bandBlocks = (bandValues + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    const size_t bandCapacity = bandBlocks * (1 + BLOCK_SIZE * bytesPerPixel) + 8;
+    const size_t tableOffset = sizeof(StreamHeader);
+    const size_t dataOffset = tableOffset + bandCount * sizeof(uint32_t);
+
+    out.resize(dataOffset + bandCount * bandCapacity);
+
+    StreamHeader header = {};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.headerSize = sizeof(StreamHeader);
+    header.width = static_cast<uint32_t>(width);
+    header.height = static_cast<uint32_t>(height);
+    header.pixelFormat = frame.pixelFormat;
+    header.offsetX = frame.offsetX;
+    header.offsetY = frame.offsetY;
+    header.bitDepth = static_cast<uint8_t>(frame.bitDepth);
+    header.bytesPerPixel = static_cast<uint8_t>(bytesPerPixel);
+    header.rowsPerBand = ROWS_PER_BAND;
+    header.bandCount = static_cast<uint32_t>(bandCount);
+    header.frameId = frame.frameId;
+    header.timestampNs = frame.timestampNs;
+    header.systemTimestampNs = frame.systemTimestampNs;
+    header.chunkValid = frame.chunk.valid;
+    header.chunkExposureUs = frame.chunk.exposureUs;
+    header.chunkGainDb = frame.chunk.gainDb;
+    header.chunkFrameId = frame.chunk.frameId;
+    header.chunkTimestamp = frame.chunk.deviceTimestamp;
+    header.chunkLineStatus = frame.chunk.lineStatus;
+    std::memcpy(out.data(), &header, sizeof(header));
+
+    std::vector<uint32_t> bandBytes(bandCount, 0);
+    uint8_t *data = out.data() + dataOffset;
+
+    TileExecutor::instance().parallelFor(bandCount, 1, [&](size_t bandBegin, size_t bandEnd) {
+        thread_local std::vector<uint16_t> residuals;
+        residuals.resize(bandBlocks * BLOCK_SIZE);
+
+        for (size_t band = bandBegin; band < bandEnd; ++band) {
+            const size_t rowBegin = band * ROWS_PER_BAND;
+            const size_t rows = std::min<size_t>(ROWS_PER_BAND, height - rowBegin);
+            const size_t count = rows * width;
+            const size_t padded = (count + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+            uint8_t *bandOut = data + band * bandCapacity;
+
+            if (bytesPerPixel == 1) {
+                uint8_t *values = reinterpret_cast<uint8_t*>(residuals.data());
+                const uint8_t *pixels = frame.bits() + rowBegin * width;
+                for (size_t y = 0; y < rows; ++y) {
+                    residualRow8(pixels + y * width, y > 0 ? pixels + (y - 1) * width : nullptr,
+                                 values + y * width, width);
+                }
+                std::fill(values + count, values + padded, uint8_t(0));
+                bandBytes[band] = static_cast<uint32_t>(packBlocks(values, padded, bandOut));
+            } else {
+                uint16_t *values = residuals.data();
+                const uint16_t *pixels = frame.bits16() + rowBegin * width;
+                for (size_t y = 0; y < rows; ++y) {
+                    residualRow16(pixels + y * width, y > 0 ? pixels + (y - 1) * width : nullptr,
+                                  values + y * width, width);
+                }
+                std::fill(values + count, values + padded, uint16_t(0));
+                bandBytes[band] = static_cast<uint32_t>(packBlocks(values, padded, bandOut));
+            }
+        }
+    });
+
+    size_t written = dataOffset;
+    for (size_t band = 0; band < bandCount; ++band) {
+        std::memmove(out.data() + written, data + band * bandCapacity, bandBytes[band]);
+        written += bandBytes[band];
+    }
+    std::memcpy(out.data() + tableOffset, bandBytes.data(), bandCount * sizeof(uint32_t));
+    out.resize(written);
+}
+
+bool LosslessCodec::decode(const uint8_t *data, size_t size, Frame &frame)
+{
+    // 旧版本码流头较短，缺少的字段保持为 0
+    StreamHeader header = {};
+    if (size < MIN_HEADER_SIZE) {
+        return false;
+    }
+    std::memcpy(&header, data, MIN_HEADER_SIZE);
+    if (header.headerSize < MIN_HEADER_SIZE || size < header.headerSize) {
+        return false;
+    }
+    std::memcpy(&header, data, std::min<size_t>(header.headerSize, sizeof(header)));
+
+    if (header.magic != MAGIC || header.version == 0 || header.version > VERSION
+        || (header.bytesPerPixel != 1 && header.bytesPerPixel != 2) || header.rowsPerBand == 0
+        || header.bandCount != (header.height + header.rowsPerBand - 1) / header.rowsPerBand) {
+        return false;
+    }
+    // 位深与每像素字节数一致（与 Frame::bytesPerPixel() 相同：8 位以内 1 字节，9~16 位 2 字节）
+    if (header.bitDepth == 0 || header.bitDepth > 16 || header.bytesPerPixel != (header.bitDepth > 8 ? 2 : 1)) {
+        return false;
+    }
+    // 尺寸要能放进 Frame 的 int 字段，像素缓冲区大小不能溢出
+    if (header.width == 0 || header.height == 0
+        || header.width > static_cast<uint32_t>(std::numeric_limits<int>::max())
+        || header.height > static_cast<uint32_t>(std::numeric_limits<int>::max())
+        || static_cast<uint64_t>(header.width) * header.height
+               > std::numeric_limits<size_t>::max() / header.bytesPerPixel) {
+        return false;
+    }
+
+    const size_t tableOffset = header.headerSize;
+    const size_t dataOffset = tableOffset + static_cast<size_t>(header.bandCount) * sizeof(uint32_t);
+    if (size < dataOffset) {
+        return false;
+    }
+
+    std::vector<uint32_t> bandBytes(header.bandCount);
+    std::vector<size_t> bandOffsets(header.bandCount);
+    std::memcpy(bandBytes.data(), data + tableOffset, bandBytes.size() * sizeof(uint32_t));
+    size_t offset = dataOffset;
+    for (size_t band = 0; band < bandBytes.size(); ++band) {
+        bandOffsets[band] = offset;
+        offset += bandBytes[band];
+    }
+    if (offset != size) {
+        return false;
+    }
+
+    const size_t width = header.width;
+    const size_t height = header.height;
+    const size_t rowsPerBand = header.rowsPerBand;
+
+    // 每 16 个像素至少占 1 字节（位宽字节），行带数据不足说明尺寸不可信；
+    // 分配像素缓冲区之前检查，损坏或伪造的码流头不会触发超大分配
+    for (size_t band = 0; band < bandBytes.size(); ++band) {
+        const uint64_t rows = std::min<uint64_t>(rowsPerBand, height - band * rowsPerBand);
+        const uint64_t blocks = (static_cast<uint64_t>(width) * rows + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        if (blocks > bandBytes[band]) {
+            return false;
+        }
+    }
+
+    frame.width = static_cast<int>(width);
+    frame.height = static_cast<int>(height);
+    frame.offsetX = header.offsetX;
+    frame.offsetY = header.offsetY;
+    frame.bitDepth = header.bitDepth;
+    frame.pixelFormat = header.pixelFormat;
+    frame.frameId = header.frameId;
+    frame.timestampNs = header.timestampNs;
+    frame.systemTimestampNs = header.systemTimestampNs;
+    frame.chunk = FrameChunkData();
+    frame.chunk.valid = header.chunkValid;
+    frame.chunk.exposureUs = header.chunkExposureUs;
+    frame.chunk.gainDb = header.chunkGainDb;
+    frame.chunk.frameId = header.chunkFrameId;
+    frame.chunk.deviceTimestamp = header.chunkTimestamp;
+    frame.chunk.lineStatus = header.chunkLineStatus;
+    frame.data.resize(width * height * header.bytesPerPixel);
+
+    std::atomic_bool ok{true};
+    TileExecutor::instance().parallelFor(header.bandCount, 1, [&](size_t bandBegin, size_t bandEnd) {
+        thread_local std::vector<uint16_t> residuals;
+
+        for (size_t band = bandBegin; band < bandEnd && ok; ++band) {
+            const size_t rowBegin = band * rowsPerBand;
+            const size_t rows = std::min(rowsPerBand, height - rowBegin);
+            const size_t count = rows * width;
+            const size_t padded = (count + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+            residuals.resize(padded);
+            const uint8_t *bandData = data + bandOffsets[band];
+
+            bool bandOk;
+            if (header.bytesPerPixel == 1) {
+                uint8_t *values = reinterpret_cast<uint8_t*>(residuals.data());
+                bandOk = unpackBlocks(bandData, bandBytes[band], values, padded);
+                if (bandOk) {
+                    reconstructBand(values, frame.bits() + rowBegin * width, width, rows);
+                }
+            } else {
+                bandOk = unpackBlocks(bandData, bandBytes[band], residuals.data(), padded);
+                if (bandOk) {
+                    reconstructBand(residuals.data(), frame.bits16() + rowBegin * width, width, rows);
+                }
+            }
+            if (!bandOk) {
+                ok = false;
+            }
+        }
+    });
+    return ok;
+}
@@ -1,18 +1,58 @@
 #include "MainWindow.h"
+#include "FrameAnalyzer.h"
+#include "AutoExposureController.h"
+#include "FlatFieldCorrector.h"
+#include "TemporalFilter.h"
+#include "HdrFusion.h"
+#include "KernelBenchmark.h"
+#include "BurstRecorder.h"
+#include "ImageSaveService.h"
+#include "PreviewStreamServer.h"
+#include "FrameDropMonitor.h"
+#include "TraceRecorder.h"
+#include "RealtimeTuning.h"
+#include "IntervalHistogram.h"
+#include "StartupTimer.h"
 #include <QMenuBar>
 #include <QMenu>
 #include <QAction>
 #include <QMessageBox>
+#include <QScrollBar>
+#include <QTimer>
 #include <QDateTime>
 #include <QScrollArea>
 #include <QSplitter>
 #include <QStatusBar>
 #include <QDebug>
+#include <QFileDialog>
 #include <QElapsedTimer>
 #include <QCoreApplication>
+#include <QSettings>
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
+namespace {
+
+// 派生输出下拉框的选项，索引与 outputSpecForIndex() 一致
+const char *const DERIVED_OUTPUT_ITEMS[] = {"原始分辨率", "2×2 合并", "4×4 合并", "2× 抽样", "4× 抽样"};
+
+DerivedFrameSpec outputSpecForIndex(int index)
+{
+    DerivedFrameSpec spec;
+    if (index >= 1 && index <= 4) {
+        spec.reduce = index <= 2 ? DerivedFrameSpec::Reduce::Bin : DerivedFrameSpec::Reduce::Decimate;
+        spec.factor = (index % 2 == 1) ? 2 : 4;
+    }
+    return spec;
+}
+
+// 启动配置（QSettings，组织/应用名在 main() 中设置）
+const char *const SETTINGS_LAST_CAMERA = "camera/lastId";
+const char *const SETTINGS_AUTO_CONNECT = "camera/autoConnect";
+
+} // namespace
+
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , m_cameraController(new CameraController(this))
@@ -20,7 +60,16 @@ MainWindow::MainWindow(QWidget *parent)
     , m_gainMin(0), m_gainMax(24)
     , m_roiMaxWidth(1920), m_roiMaxHeight(1080)
 {
+    TraceRecorder::setThreadName("GUI 线程");
+
+    // 设备探测与界面构建并行；启用自动连接时探测线程先打开上次的相机
+    const QSettings settings;
+    const QString lastCameraId = settings.value(SETTINGS_LAST_CAMERA).toString();
+    m_autoConnectPending = settings.value(SETTINGS_AUTO_CONNECT, false).toBool() && !lastCameraId.isEmpty();
+    m_cameraController->startDeviceProbe(m_autoConnectPending ? lastCameraId : QString());
+
     setupUI();
+    StartupTimer::mark("界面构建完成");
 
     // 连接信号槽
     connect(m_cameraController, &CameraController::cameraConnected,
@@ -37,6 +86,31 @@ MainWindow::MainWindow(QWidget *parent)
             this, &MainWindow::onAcquisitionStopped);
     connect(m_cameraController, &CameraController::fpsUpdated,
             this, &MainWindow::onFPSUpdated);
+    connect(m_cameraController->frameAnalyzer(), &FrameAnalyzer::statisticsReady,
+            this, &MainWindow::onStatisticsReady);
+    connect(m_cameraController->autoExposureController(), &AutoExposureController::exposureAdjusted,
+            this, &MainWindow::onAutoExposureAdjusted);
+    connect(m_cameraController->frameAnalyzer(), &FrameAnalyzer::focusMeasured,
+            m_focusPlotWidget, &FocusPlotWidget::addValue);
+    connect(m_cameraController, &CameraController::captureThreadConfigured, this, [this](const QString &report, bool success) {
+        logMessage(report, !success);
+    });
+    connect(m_cameraController, &CameraController::acquisitionReconfigured, this, [this](double applyMs, double gapMs) {
+        logMessage(QString("采集中重配置完成: 暂停 %1 ms, 无帧间隔 %2 ms")
+                   .arg(applyMs, 0, 'f', 1).arg(gapMs, 0, 'f', 1));
+    });
+    connect(m_cameraController, &CameraController::devicesEnumerated,
+            this, &MainWindow::onDevicesEnumerated);
+    connect(m_cameraController, &CameraController::preferredCameraOpened, this, [this](const QString &cameraId) {
+        if (!m_autoConnectPending || m_cameraController->isConnected()) {
+            return;
+        }
+        m_autoConnectPending = false;
+        logMessage(QString("自动连接上次的相机: %1").arg(cameraId));
+        if (connectToCamera(cameraId)) {
+            onStartAcquisitionClicked();
+        }
+    });
 
     updateUIState();
     logMessage("应用程序启动成功");
@@ -44,6 +118,9 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
+    if (m_benchmarkThread.joinable()) {
+        m_benchmarkThread.join();
+    }
     if (m_cameraController->isConnected()) {
         m_cameraController->disconnectCamera();
     }
@@ -101,6 +178,72 @@ void MainWindow::createMenuBar()
     connect(exitAction, &QAction::triggered, this, &QMainWindow::close);
     fileMenu->addAction(exitAction);
 
+    // 工具菜单
+    QMenu *toolsMenu = menuBar->addMenu("工具(&T)");
+
+    QAction *benchmarkAction = new QAction("并行扩展性测试(&B)", this);
+    connect(benchmarkAction, &QAction::triggered, this, [this, benchmarkAction]() {
+        if (m_cameraController->isAcquiring()) {
+            logMessage("请先停止采集再运行扩展性测试", true);
+            return;
+        }
+        if (m_benchmarkThread.joinable()) {
+            m_benchmarkThread.join();
+        }
+
+        benchmarkAction->setEnabled(false);
+        m_benchmarkRunning = true;
+        updateUIState();
+        logMessage("开始并行扩展性测试 (20MP 合成帧)...");
+        m_benchmarkThread = std::thread([this, benchmarkAction]() {
+            KernelBenchmark::run(5472, 3648, 5, [this](const QString &line) {
+                qDebug() << line;
+                QMetaObject::invokeMethod(this, [this, line]() {
+                    logMessage(line);
+                }, Qt::QueuedConnection);
+            });
+            QMetaObject::invokeMethod(this, [this, benchmarkAction]() {
+                benchmarkAction->setEnabled(true);
+                m_benchmarkRunning = false;
+                updateUIState();
+            }, Qt::QueuedConnection);
+        });
+    });
+    toolsMenu->addAction(benchmarkAction);
+    toolsMenu->addSeparator();
+
+    // 逐帧延迟追踪：记录各阶段区间，导出为 Chrome trace JSON 在 Perfetto 中查看
+    QAction *traceAction = new QAction("记录延迟追踪(&R)", this);
+    traceAction->setCheckable(true);
+    connect(traceAction, &QAction::toggled, this, [this](bool checked) {
+        TraceRecorder::instance().setEnabled(checked);
+        logMessage(checked ? "延迟追踪已开启" : "延迟追踪已关闭");
+    });
+    toolsMenu->addAction(traceAction);
+
+    QAction *traceExportAction = new QAction("导出延迟追踪(&E)...", this);
+    connect(traceExportAction, &QAction::triggered, this, [this]() {
+        const QString path = QFileDialog::getSaveFileName(this, "导出延迟追踪", "frame_trace.json",
+                                                          "Chrome Trace (*.json)");
+        if (path.isEmpty()) {
+            return;
+        }
+        QString error;
+        if (TraceRecorder::instance().exportChromeTrace(path, &error)) {
+            logMessage(QString("延迟追踪已导出: %1 (在 ui.perfetto.dev 或 chrome://tracing 中打开)").arg(path));
+        } else {
+            logMessage(error, true);
+        }
+    });
+    toolsMenu->addAction(traceExportAction);
+
+    QAction *traceClearAction = new QAction("清空延迟追踪", this);
+    connect(traceClearAction, &QAction::triggered, this, [this]() {
+        TraceRecorder::instance().clear();
+        logMessage("延迟追踪已清空");
+    });
+    toolsMenu->addAction(traceClearAction);
+
     // 帮助菜单
     QMenu *helpMenu = menuBar->addMenu("帮助(&H)");
 
@@ -143,8 +286,31 @@ void MainWindow::createCameraControlPanel()
 
     // 创建各个控制组
     createParameterPanel();
+    createAnalysisPanel();
+    createDisplayPanel();
+    createCorrectionPanel();
+    createTemporalPanel();
+    createSequencePanel();
+    createBurstPanel();
+    createSavePanel();
     createStatusPanel();
 
+    // 高级设置首次展开时才创建，不计入启动时间
+    m_advancedButton = new QPushButton("高级设置 ▸", m_controlPanel);
+    m_advancedButton->setCheckable(true);
+    m_advancedButton->setToolTip("远程预览、采集实时性、USB3 传输");
+    m_advancedPanel = new QWidget(m_controlPanel);
+    m_advancedLayout = new QVBoxLayout(m_advancedPanel);
+    m_advancedLayout->setContentsMargins(0, 0, 0, 0);
+    m_advancedPanel->setVisible(false);
+    connect(m_advancedButton, &QPushButton::toggled, this, [this](bool checked) {
+        if (checked && !m_streamGroup) {
+            createAdvancedPanels();
+        }
+        m_advancedPanel->setVisible(checked);
+        m_advancedButton->setText(checked ? "高级设置 ▾" : "高级设置 ▸");
+    });
+
     // 相机连接组
     m_connectionGroup = new QGroupBox("相机连接", m_controlPanel);
     QVBoxLayout *connLayout = new QVBoxLayout(m_connectionGroup);
@@ -153,6 +319,30 @@ void MainWindow::createCameraControlPanel()
     m_cameraInfoLabel->setWordWrap(true);
     m_cameraInfoLabel->setStyleSheet("QLabel { padding: 5px; background-color: #f0f0f0; }");
 
+    // 设备列表由启动时的后台探测填充
+    QHBoxLayout *deviceLayout = new QHBoxLayout();
+    m_cameraComboBox = new QComboBox(m_connectionGroup);
+    m_cameraComboBox->addItem("正在枚举设备...");
+    deviceLayout->addWidget(m_cameraComboBox, 1);
+    m_refreshDevicesButton = new QPushButton("刷新", m_connectionGroup);
+    deviceLayout->addWidget(m_refreshDevicesButton);
+
+    m_autoConnectCheckBox = new QCheckBox("启动时自动连接上次的相机并开始采集", m_connectionGroup);
+    m_autoConnectCheckBox->setChecked(QSettings().value(SETTINGS_AUTO_CONNECT, false).toBool());
+
+    connect(m_refreshDevicesButton, &QPushButton::clicked, this, [this]() {
+        m_cameraComboBox->clear();
+        m_cameraComboBox->addItem("正在枚举设备...");
+        m_cameraController->startDeviceProbe();
+        updateUIState();
+    });
+    connect(m_autoConnectCheckBox, &QCheckBox::toggled, this, [this](bool checked) {
+        QSettings().setValue(SETTINGS_AUTO_CONNECT, checked);
+        if (!checked) {
+            m_autoConnectPending = false;
+        }
+    });
+
     m_connectButton = new QPushButton("连接相机", m_connectionGroup);
     m_disconnectButton = new QPushButton("断开连接", m_connectionGroup);
 
@@ -160,6 +350,8 @@ void MainWindow::createCameraControlPanel()
     connect(m_disconnectButton, &QPushButton::clicked, this, &MainWindow::onDisconnectClicked);
 
     connLayout->addWidget(m_cameraInfoLabel);
+    connLayout->addLayout(deviceLayout);
+    connLayout->addWidget(m_autoConnectCheckBox);
     connLayout->addWidget(m_connectButton);
     connLayout->addWidget(m_disconnectButton);
 
@@ -182,10 +374,135 @@ void MainWindow::createCameraControlPanel()
     acqLayout->addWidget(m_stopAcquisitionButton);
     acqLayout->addWidget(m_grabFrameButton);
 
+    m_snapshotModeCheckBox = new QCheckBox("快照模式 (软件触发常驻流)", m_acquisitionGroup);
+    m_snapshotModeCheckBox->setToolTip("保持相机处于触发模式并预分配缓冲区，单帧采集只需曝光和传输时间");
+    acqLayout->addWidget(m_snapshotModeCheckBox);
+    connect(m_snapshotModeCheckBox, &QCheckBox::toggled, this, [this](bool checked) {
+        if (!m_cameraController->setSnapshotModeEnabled(checked)) {
+            m_snapshotModeCheckBox->blockSignals(true);
+            m_snapshotModeCheckBox->setChecked(false);
+            m_snapshotModeCheckBox->blockSignals(false);
+            return;
+        }
+        logMessage(checked ? "快照模式已启用" : "快照模式已关闭");
+    });
+    m_chunkDataCheckBox = new QCheckBox("帧块数据 (曝光/增益/线状态随帧传输)", m_acquisitionGroup);
+    m_chunkDataCheckBox->setToolTip("启用 GenICam ChunkModeActive，每帧携带实际曝光、增益、帧号、I/O 线状态和时间戳");
+    acqLayout->addWidget(m_chunkDataCheckBox);
+    connect(m_chunkDataCheckBox, &QCheckBox::toggled, this, [this](bool checked) {
+        if (!m_cameraController->setChunkDataEnabled(checked)) {
+            m_chunkDataCheckBox->blockSignals(true);
+            m_chunkDataCheckBox->setChecked(m_cameraController->isChunkDataEnabled());
+            m_chunkDataCheckBox->blockSignals(false);
+            return;
+        }
+        logMessage(checked ? "帧块数据已启用" : "帧块数据已关闭");
+    });
+    connect(m_cameraController, &CameraController::grabLatencyMeasured, this, [this](double milliseconds, bool warmStream) {
+        logMessage(QString("单帧采集耗时: %1 ms (%2)").arg(milliseconds, 0, 'f', 1)
+                   .arg(warmStream ? "快照模式" : "临时建流"));
+    });
+
+    // 下拉框顺序与 FramePipeline::OverflowPolicy 一致
+    QHBoxLayout *overflowLayout = new QHBoxLayout();
+    overflowLayout->addWidget(new QLabel("管线满时:", m_acquisitionGroup));
+    m_overflowPolicyComboBox = new QComboBox(m_acquisitionGroup);
+    m_overflowPolicyComboBox->addItem("丢弃最旧帧");
+    m_overflowPolicyComboBox->addItem("丢弃最新帧");
+    m_overflowPolicyComboBox->addItem("阻塞采集");
+    overflowLayout->addWidget(m_overflowPolicyComboBox);
+    acqLayout->addLayout(overflowLayout);
+
+    connect(m_overflowPolicyComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) {
+        m_cameraController->setPipelineOverflowPolicy(static_cast<FramePipeline::OverflowPolicy>(index));
+    });
+
+    m_frameBusCheckBox = new QCheckBox(QString("共享内存发布 (%1)").arg(FrameBus::DEFAULT_NAME), m_acquisitionGroup);
+    acqLayout->addWidget(m_frameBusCheckBox);
+    connect(m_frameBusCheckBox, &QCheckBox::toggled, this, [this](bool checked) {
+        m_cameraController->setFrameBusEnabled(checked);
+        logMessage(checked ? "已启用共享内存帧发布" : "已停止共享内存帧发布");
+    });
+
+    // 派生输出：预览和帧总线可以只取合并/抽样（帧总线还可裁剪）后的图像，
+    // 相同规格共用一次计算
+    QGridLayout *derivedLayout = new QGridLayout();
+    derivedLayout->addWidget(new QLabel("预览输出:", m_acquisitionGroup), 0, 0);
+    m_previewOutputComboBox = new QComboBox(m_acquisitionGroup);
+    for (const char *item : DERIVED_OUTPUT_ITEMS) {
+        m_previewOutputComboBox->addItem(item);
+    }
+    m_previewOutputComboBox->setToolTip("大幅面相机预览时先合并/抽样，减少显示转换和绘制开销");
+    derivedLayout->addWidget(m_previewOutputComboBox, 0, 1);
+    derivedLayout->addWidget(new QLabel("帧总线输出:", m_acquisitionGroup), 1, 0);
+    m_frameBusOutputComboBox = new QComboBox(m_acquisitionGroup);
+    for (const char *item : DERIVED_OUTPUT_ITEMS) {
+        m_frameBusOutputComboBox->addItem(item);
+    }
+    derivedLayout->addWidget(m_frameBusOutputComboBox, 1, 1);
+    m_frameBusCropCheckBox = new QCheckBox("帧总线只发布框选区域", m_acquisitionGroup);
+    derivedLayout->addWidget(m_frameBusCropCheckBox, 2, 0, 1, 2);
+    acqLayout->addLayout(derivedLayout);
+
+    connect(m_previewOutputComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::applyDerivedOutputs);
+    connect(m_frameBusOutputComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::applyDerivedOutputs);
+    connect(m_frameBusCropCheckBox, &QCheckBox::toggled, this, &MainWindow::applyDerivedOutputs);
+
+    // 丢帧监测：帧号间隔 + 不完整缓冲区，超过阈值报警
+    FrameDropMonitor *dropMonitor = m_cameraController->frameDropMonitor();
+    m_dropStatusLabel = new QLabel("丢帧: 0", m_acquisitionGroup);
+    m_dropStatusLabel->setToolTip("按缓冲区帧号间隔和状态统计：间隔为相机已发出但主机未收到的帧，其余为收到但不完整的帧");
+    acqLayout->addWidget(m_dropStatusLabel);
+
+    QHBoxLayout *dropLayout = new QHBoxLayout();
+    dropLayout->addWidget(new QLabel("报警阈值 (帧/秒):", m_acquisitionGroup));
+    m_dropAlarmSpinBox = new QSpinBox(m_acquisitionGroup);
+    m_dropAlarmSpinBox->setRange(0, 10000);
+    m_dropAlarmSpinBox->setValue(static_cast<int>(dropMonitor->alarmSettings().threshold));
+    m_dropAlarmSpinBox->setToolTip("1 秒内丢失帧数达到该值时报警，0 表示关闭报警");
+    dropLayout->addWidget(m_dropAlarmSpinBox);
+    m_dropExportButton = new QPushButton("导出丢帧日志", m_acquisitionGroup);
+    dropLayout->addWidget(m_dropExportButton);
+    acqLayout->addLayout(dropLayout);
+
+    connect(m_dropAlarmSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, [dropMonitor](int value) {
+        FrameDropMonitor::AlarmSettings settings = dropMonitor->alarmSettings();
+        settings.threshold = static_cast<uint64_t>(value);
+        dropMonitor->setAlarmSettings(settings);
+    });
+    connect(dropMonitor, &FrameDropMonitor::dropAlarm, this, [this](qulonglong lostFrames, int windowMs) {
+        const QString message = QString("丢帧报警: %1 ms 内丢失 %2 帧").arg(windowMs).arg(lostFrames);
+        logMessage(message, true);
+        m_statusBarLabel->setText(message);
+    });
+    connect(m_dropExportButton, &QPushButton::clicked, this, [this, dropMonitor]() {
+        const QString path = QFileDialog::getSaveFileName(this, "导出丢帧日志", "frame_drops.csv", "CSV (*.csv)");
+        if (path.isEmpty()) {
+            return;
+        }
+        QString error;
+        if (dropMonitor->exportEvents(path, &error)) {
+            logMessage(QString("丢帧日志已导出: %1").arg(path));
+        } else {
+            logMessage(error, true);
+        }
+    });
+
     // 添加到控制面板
     m_controlLayout->addWidget(m_connectionGroup);
     m_controlLayout->addWidget(m_acquisitionGroup);
     m_controlLayout->addWidget(m_parameterGroup);
+    m_controlLayout->addWidget(m_analysisGroup);
+    m_controlLayout->addWidget(m_displayGroup);
+    m_controlLayout->addWidget(m_correctionGroup);
+    m_controlLayout->addWidget(m_temporalGroup);
+    m_controlLayout->addWidget(m_sequenceGroup);
+    m_controlLayout->addWidget(m_burstGroup);
+    m_controlLayout->addWidget(m_saveGroup);
+    m_controlLayout->addWidget(m_advancedButton);
+    m_controlLayout->addWidget(m_advancedPanel);
     m_controlLayout->addWidget(m_statusGroup);
     m_controlLayout->addStretch();
 }
@@ -297,6 +614,896 @@ void MainWindow::createParameterPanel()
     paramLayout->addWidget(roiGroup);
 }
 
+void MainWindow::createAnalysisPanel()
+{
+    m_analysisGroup = new QGroupBox("图像分析", m_controlPanel);
+    QGridLayout *analysisLayout = new QGridLayout(m_analysisGroup);
+
+    FrameAnalyzer *analyzer = m_cameraController->frameAnalyzer();
+
+    m_histogramCheckBox = new QCheckBox("直方图叠加", m_analysisGroup);
+    m_histogramCheckBox->setChecked(analyzer->isHistogramEnabled());
+    analysisLayout->addWidget(m_histogramCheckBox, 0, 0, 1, 2);
+
+    analysisLayout->addWidget(new QLabel("统计频率 (Hz):"), 1, 0);
+    m_histogramRateSpinBox = new QDoubleSpinBox(m_analysisGroup);
+    m_histogramRateSpinBox->setRange(0, 120);
+    m_histogramRateSpinBox->setDecimals(0);
+    m_histogramRateSpinBox->setSpecialValueText("每帧");
+    m_histogramRateSpinBox->setValue(analyzer->histogramRate());
+    analysisLayout->addWidget(m_histogramRateSpinBox, 1, 1);
+
+    analysisLayout->addWidget(new QLabel("采样行步长:"), 2, 0);
+    m_sampleStepSpinBox = new QSpinBox(m_analysisGroup);
+    m_sampleStepSpinBox->setRange(0, 64);
+    m_sampleStepSpinBox->setSpecialValueText("自动");
+    m_sampleStepSpinBox->setValue(analyzer->sampleStep());
+    analysisLayout->addWidget(m_sampleStepSpinBox, 2, 1);
+
+    // 软件自动曝光
+    AutoExposureController *autoExposure = m_cameraController->autoExposureController();
+    const AutoExposureController::Settings aeSettings = autoExposure->settings();
+
+    m_autoExposureCheckBox = new QCheckBox("自动曝光/增益", m_analysisGroup);
+    analysisLayout->addWidget(m_autoExposureCheckBox, 3, 0, 1, 2);
+
+    analysisLayout->addWidget(new QLabel("目标亮度 (%):"), 4, 0);
+    m_aeTargetSpinBox = new QDoubleSpinBox(m_analysisGroup);
+    m_aeTargetSpinBox->setRange(1, 99);
+    m_aeTargetSpinBox->setDecimals(0);
+    m_aeTargetSpinBox->setValue(aeSettings.target * 100.0);
+    analysisLayout->addWidget(m_aeTargetSpinBox, 4, 1);
+
+    analysisLayout->addWidget(new QLabel("测光方式:"), 5, 0);
+    m_aeMeteringComboBox = new QComboBox(m_analysisGroup);
+    m_aeMeteringComboBox->addItem("均值");
+    m_aeMeteringComboBox->addItem("95% 百分位");
+    analysisLayout->addWidget(m_aeMeteringComboBox, 5, 1);
+
+    auto applyAutoExposureSettings = [this, autoExposure]() {
+        AutoExposureController::Settings settings = autoExposure->settings();
+        settings.target = m_aeTargetSpinBox->value() / 100.0;
+        settings.mode = m_aeMeteringComboBox->currentIndex() == 0
+                            ? AutoExposureController::MeteringMode::Mean
+                            : AutoExposureController::MeteringMode::Percentile;
+        autoExposure->setSettings(settings);
+    };
+
+    connect(m_autoExposureCheckBox, &QCheckBox::toggled, this, &MainWindow::onAutoExposureToggled);
+    connect(m_aeTargetSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+            this, applyAutoExposureSettings);
+    connect(m_aeMeteringComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, applyAutoExposureSettings);
+
+    // 对焦评价
+    m_focusCheckBox = new QCheckBox("对焦评价", m_analysisGroup);
+    analysisLayout->addWidget(m_focusCheckBox, 6, 0);
+
+    m_focusMethodComboBox = new QComboBox(m_analysisGroup);
+    m_focusMethodComboBox->addItem("拉普拉斯方差");
+    m_focusMethodComboBox->addItem("Tenengrad");
+    analysisLayout->addWidget(m_focusMethodComboBox, 6, 1);
+
+    connect(m_focusCheckBox, &QCheckBox::toggled, this, [this, analyzer](bool checked) {
+        analyzer->setFocusEnabled(checked);
+        m_focusPlotWidget->clear();
+        m_focusPlotWidget->setVisible(checked);
+    });
+    connect(m_focusMethodComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, [this, analyzer](int index) {
+        analyzer->setFocusMethod(index == 0 ? FocusMetric::Method::Laplacian
+                                            : FocusMetric::Method::Tenengrad);
+        m_focusPlotWidget->clear();
+    });
+
+    connect(m_histogramCheckBox, &QCheckBox::toggled, this, [this, analyzer](bool checked) {
+        analyzer->setHistogramEnabled(checked);
+        m_videoWidget->setOverlayVisible(checked);
+    });
+    connect(m_histogramRateSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+            analyzer, &FrameAnalyzer::setHistogramRate);
+    connect(m_sampleStepSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            analyzer, &FrameAnalyzer::setSampleStep);
+}
+
+void MainWindow::createDisplayPanel()
+{
+    m_displayGroup = new QGroupBox("显示窗口", m_controlPanel);
+    QGridLayout *displayLayout = new QGridLayout(m_displayGroup);
+
+    // 上下限为满量程的百分比，10/12/16 位数据使用同一设置
+    displayLayout->addWidget(new QLabel("下限 (%):"), 0, 0);
+    m_windowLowSpinBox = new QDoubleSpinBox(m_displayGroup);
+    m_windowLowSpinBox->setRange(0, 99.9);
+    m_windowLowSpinBox->setDecimals(1);
+    m_windowLowSpinBox->setSingleStep(0.5);
+    m_windowLowSpinBox->setValue(0);
+    displayLayout->addWidget(m_windowLowSpinBox, 0, 1);
+
+    displayLayout->addWidget(new QLabel("上限 (%):"), 1, 0);
+    m_windowHighSpinBox = new QDoubleSpinBox(m_displayGroup);
+    m_windowHighSpinBox->setRange(0.1, 100);
+    m_windowHighSpinBox->setDecimals(1);
+    m_windowHighSpinBox->setSingleStep(0.5);
+    m_windowHighSpinBox->setValue(100);
+    displayLayout->addWidget(m_windowHighSpinBox, 1, 1);
+
+    displayLayout->addWidget(new QLabel("伽马:"), 2, 0);
+    m_gammaSpinBox = new QDoubleSpinBox(m_displayGroup);
+    m_gammaSpinBox->setRange(0.2, 5.0);
+    m_gammaSpinBox->setDecimals(2);
+    m_gammaSpinBox->setSingleStep(0.1);
+    m_gammaSpinBox->setValue(1.0);
+    m_gammaSpinBox->setToolTip("大于 1 提亮暗部，小于 1 压暗");
+    displayLayout->addWidget(m_gammaSpinBox, 2, 1);
+
+    displayLayout->addWidget(new QLabel("伪彩色:"), 3, 0);
+    m_paletteComboBox = new QComboBox(m_displayGroup);
+    m_paletteComboBox->addItem("灰度");
+    m_paletteComboBox->addItem("热度");
+    m_paletteComboBox->addItem("彩虹");
+    displayLayout->addWidget(m_paletteComboBox, 3, 1);
+
+    m_autoWindowButton = new QPushButton("自动窗口", m_displayGroup);
+    m_autoWindowButton->setToolTip("按最近一次直方图的 0.5%/99.5% 分位设置上下限");
+    displayLayout->addWidget(m_autoWindowButton, 4, 0);
+    m_resetWindowButton = new QPushButton("复位", m_displayGroup);
+    displayLayout->addWidget(m_resetWindowButton, 4, 1);
+
+    connect(m_windowLowSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+            this, &MainWindow::applyDisplayWindow);
+    connect(m_windowHighSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+            this, &MainWindow::applyDisplayWindow);
+    connect(m_gammaSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+            this, &MainWindow::applyDisplayWindow);
+    connect(m_paletteComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::applyDisplayWindow);
+
+    connect(m_autoWindowButton, &QPushButton::clicked, this, [this]() {
+        if (!m_lastStatistics.isValid()) {
+            logMessage("自动窗口需要直方图统计：请启用直方图叠加并开始采集", true);
+            return;
+        }
+        const double fullScale = m_lastStatistics.fullScale();
+        const double low = m_lastStatistics.percentile(0.005) / fullScale * 100.0;
+        const double high = m_lastStatistics.percentile(0.995) / fullScale * 100.0;
+        m_windowLowSpinBox->blockSignals(true);
+        m_windowHighSpinBox->blockSignals(true);
+        m_windowLowSpinBox->setValue(low);
+        m_windowHighSpinBox->setValue(std::max(high, low + 0.1));
+        m_windowLowSpinBox->blockSignals(false);
+        m_windowHighSpinBox->blockSignals(false);
+        applyDisplayWindow();
+        logMessage(QString("显示窗口: %1% - %2% (%3 位)").arg(low, 0, 'f', 1).arg(high, 0, 'f', 1)
+                       .arg(m_lastStatistics.bitDepth));
+    });
+    connect(m_resetWindowButton, &QPushButton::clicked, this, [this]() {
+        m_windowLowSpinBox->blockSignals(true);
+        m_windowHighSpinBox->blockSignals(true);
+        m_gammaSpinBox->blockSignals(true);
+        m_windowLowSpinBox->setValue(0);
+        m_windowHighSpinBox->setValue(100);
+        m_gammaSpinBox->setValue(1.0);
+        m_windowLowSpinBox->blockSignals(false);
+        m_windowHighSpinBox->blockSignals(false);
+        m_gammaSpinBox->blockSignals(false);
+        applyDisplayWindow();
+    });
+}
+
+void MainWindow::applyDisplayWindow()
+{
+    DisplayWindow window;
+    window.low = m_windowLowSpinBox->value() / 100.0;
+    window.high = m_windowHighSpinBox->value() / 100.0;
+    window.gamma = m_gammaSpinBox->value();
+    window.palette = static_cast<DisplayWindow::Palette>(m_paletteComboBox->currentIndex());
+    m_cameraController->setDisplayWindow(window);
+
+    // 连拍回看时画面不会自动刷新，立即按新窗口重绘当前帧
+    if (m_burstReviewCheckBox->isChecked()) {
+        showBurstFrame(m_burstReviewSlider->value());
+    }
+}
+
+void MainWindow::createCorrectionPanel()
+{
+    m_correctionGroup = new QGroupBox("暗场/平场校正", m_controlPanel);
+    QGridLayout *correctionLayout = new QGridLayout(m_correctionGroup);
+
+    FlatFieldCorrector *corrector = m_cameraController->flatFieldCorrector();
+
+    m_flatFieldCheckBox = new QCheckBox("启用校正", m_correctionGroup);
+    correctionLayout->addWidget(m_flatFieldCheckBox, 0, 0);
+
+    m_calibrationFramesSpinBox = new QSpinBox(m_correctionGroup);
+    m_calibrationFramesSpinBox->setRange(1, 256);
+    m_calibrationFramesSpinBox->setValue(16);
+    m_calibrationFramesSpinBox->setSuffix(" 帧");
+    correctionLayout->addWidget(m_calibrationFramesSpinBox, 0, 1);
+
+    m_darkCaptureButton = new QPushButton("采集暗场", m_correctionGroup);
+    m_flatCaptureButton = new QPushButton("采集平场", m_correctionGroup);
+    m_clearCalibrationButton = new QPushButton("清除标定", m_correctionGroup);
+    correctionLayout->addWidget(m_darkCaptureButton, 1, 0);
+    correctionLayout->addWidget(m_flatCaptureButton, 1, 1);
+    correctionLayout->addWidget(m_clearCalibrationButton, 2, 0, 1, 2);
+
+    m_calibrationStatusLabel = new QLabel("未标定", m_correctionGroup);
+    m_calibrationStatusLabel->setWordWrap(true);
+    correctionLayout->addWidget(m_calibrationStatusLabel, 3, 0, 1, 2);
+
+    auto startCalibration = [this, corrector](FlatFieldCorrector::CalibrationKind kind) {
+        if (!m_cameraController->isAcquiring()) {
+            logMessage("标定需要在连续采集时进行", true);
+            return;
+        }
+        corrector->startCalibration(kind, m_calibrationFramesSpinBox->value());
+        logMessage(kind == FlatFieldCorrector::CalibrationKind::Dark
+                       ? "开始采集暗场，请遮挡镜头..."
+                       : "开始采集平场，请对准均匀光源...");
+    };
+
+    connect(m_flatFieldCheckBox, &QCheckBox::toggled, this, [corrector](bool checked) {
+        corrector->setEnabled(checked);
+    });
+    connect(m_darkCaptureButton, &QPushButton::clicked, this, [startCalibration]() {
+        startCalibration(FlatFieldCorrector::CalibrationKind::Dark);
+    });
+    connect(m_flatCaptureButton, &QPushButton::clicked, this, [startCalibration]() {
+        startCalibration(FlatFieldCorrector::CalibrationKind::Flat);
+    });
+    connect(m_clearCalibrationButton, &QPushButton::clicked, this, [this, corrector]() {
+        corrector->clearCalibration();
+        m_calibrationStatusLabel->setText("未标定");
+        logMessage("已清除暗场/平场标定");
+    });
+
+    connect(corrector, &FlatFieldCorrector::calibrationProgress, this, [this](int captured, int total) {
+        m_calibrationStatusLabel->setText(QString("标定中: %1 / %2").arg(captured).arg(total));
+    });
+    connect(corrector, &FlatFieldCorrector::calibrationFinished, this, [this](const QString &summary) {
+        m_calibrationStatusLabel->setText(summary);
+        logMessage(summary);
+    });
+}
+
+void MainWindow::createTemporalPanel()
+{
+    m_temporalGroup = new QGroupBox("时域滤波", m_controlPanel);
+    QGridLayout *temporalLayout = new QGridLayout(m_temporalGroup);
+
+    TemporalFilter *filter = m_cameraController->temporalFilter();
+
+    temporalLayout->addWidget(new QLabel("模式:", m_temporalGroup), 0, 0);
+    m_temporalModeComboBox = new QComboBox(m_temporalGroup);
+    m_temporalModeComboBox->addItem("关闭");
+    m_temporalModeComboBox->addItem("多帧平均");
+    m_temporalModeComboBox->addItem("运行背景");
+    m_temporalModeComboBox->addItem("背景差分");
+    temporalLayout->addWidget(m_temporalModeComboBox, 0, 1);
+
+    temporalLayout->addWidget(new QLabel("平均帧数:", m_temporalGroup), 1, 0);
+    m_averageFramesSpinBox = new QSpinBox(m_temporalGroup);
+    m_averageFramesSpinBox->setRange(1, TemporalFilter::MAX_AVERAGE_FRAMES);
+    m_averageFramesSpinBox->setValue(8);
+    temporalLayout->addWidget(m_averageFramesSpinBox, 1, 1);
+
+    temporalLayout->addWidget(new QLabel("背景时间常数:", m_temporalGroup), 2, 0);
+    m_backgroundShiftSpinBox = new QSpinBox(m_temporalGroup);
+    m_backgroundShiftSpinBox->setRange(1, 10);
+    m_backgroundShiftSpinBox->setValue(4);
+    m_backgroundShiftSpinBox->setSuffix(" (2^n 帧)");
+    temporalLayout->addWidget(m_backgroundShiftSpinBox, 2, 1);
+
+    temporalLayout->addWidget(new QLabel("变化阈值:", m_temporalGroup), 3, 0);
+    m_changeThresholdSpinBox = new QSpinBox(m_temporalGroup);
+    m_changeThresholdSpinBox->setRange(0, 65535);
+    m_changeThresholdSpinBox->setValue(16);
+    temporalLayout->addWidget(m_changeThresholdSpinBox, 3, 1);
+
+    m_changeLabel = new QLabel("变化像素: --", m_temporalGroup);
+    temporalLayout->addWidget(m_changeLabel, 4, 0, 1, 2);
+
+    // 下拉框顺序与 TemporalFilter::Mode 一致
+    connect(m_temporalModeComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this, filter](int index) {
+        const auto mode = static_cast<TemporalFilter::Mode>(index);
+        filter->setMode(mode);
+        if (mode != TemporalFilter::Mode::Subtract) {
+            m_changeLabel->setText("变化像素: --");
+        }
+    });
+    connect(m_averageFramesSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, [filter](int frames) { filter->setAverageFrames(frames); });
+    connect(m_backgroundShiftSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, [filter](int shift) { filter->setBackgroundShift(shift); });
+    connect(m_changeThresholdSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, [filter](int threshold) { filter->setChangeThreshold(threshold); });
+    connect(filter, &TemporalFilter::changeMeasured, this, [this](double percent) {
+        m_changeLabel->setText(QString("变化像素: %1%").arg(percent, 0, 'f', 2));
+    });
+}
+
+void MainWindow::createSequencePanel()
+{
+    m_sequenceGroup = new QGroupBox("包围曝光序列", m_controlPanel);
+    QGridLayout *sequenceLayout = new QGridLayout(m_sequenceGroup);
+
+    sequenceLayout->addWidget(new QLabel("曝光组数:", m_sequenceGroup), 0, 0);
+    m_sequenceStepsSpinBox = new QSpinBox(m_sequenceGroup);
+    m_sequenceStepsSpinBox->setRange(1, 4);
+    m_sequenceStepsSpinBox->setValue(3);
+    m_sequenceStepsSpinBox->setSpecialValueText("关闭");
+    sequenceLayout->addWidget(m_sequenceStepsSpinBox, 0, 1);
+
+    sequenceLayout->addWidget(new QLabel("相邻组曝光比:", m_sequenceGroup), 1, 0);
+    m_sequenceRatioSpinBox = new QDoubleSpinBox(m_sequenceGroup);
+    m_sequenceRatioSpinBox->setRange(1.5, 16.0);
+    m_sequenceRatioSpinBox->setValue(4.0);
+    m_sequenceRatioSpinBox->setDecimals(1);
+    m_sequenceRatioSpinBox->setPrefix("×");
+    m_sequenceRatioSpinBox->setToolTip("第 i 组曝光 = 当前曝光 × 比值^i，增益保持当前值");
+    sequenceLayout->addWidget(m_sequenceRatioSpinBox, 1, 1);
+
+    m_sequenceHardwareCheckBox = new QCheckBox("使用相机 SequencerMode（支持时）", m_sequenceGroup);
+    m_sequenceHardwareCheckBox->setChecked(true);
+    m_sequenceHardwareCheckBox->setToolTip("关闭时由主机在帧间流水线写入参数，建议同时启用帧块数据以精确标记");
+    sequenceLayout->addWidget(m_sequenceHardwareCheckBox, 2, 0, 1, 2);
+
+    m_hdrFusionCheckBox = new QCheckBox("融合为 HDR 帧 (16 位)", m_sequenceGroup);
+    m_hdrFusionCheckBox->setToolTip("每轮各组曝光合成一帧，输出帧率为采集帧率除以组数");
+    sequenceLayout->addWidget(m_hdrFusionCheckBox, 3, 0, 1, 2);
+
+    m_sequenceApplyButton = new QPushButton("应用序列", m_sequenceGroup);
+    sequenceLayout->addWidget(m_sequenceApplyButton, 4, 0, 1, 2);
+
+    m_sequenceStatusLabel = new QLabel("参数序列: 关闭", m_sequenceGroup);
+    m_sequenceStatusLabel->setWordWrap(true);
+    sequenceLayout->addWidget(m_sequenceStatusLabel, 5, 0, 1, 2);
+
+    HdrFusion *fusion = m_cameraController->hdrFusion();
+    connect(m_hdrFusionCheckBox, &QCheckBox::toggled, this, [fusion](bool checked) {
+        fusion->setEnabled(checked);
+    });
+    connect(m_sequenceApplyButton, &QPushButton::clicked, this, [this]() {
+        ParameterSequencer::Settings settings;
+        settings.allowHardware = m_sequenceHardwareCheckBox->isChecked();
+        const int count = m_sequenceStepsSpinBox->value();
+        if (count >= 2) {
+            double exposure = m_exposureSpinBox->value();
+            for (int i = 0; i < count; ++i) {
+                ParameterSequencer::Step step;
+                step.exposureUs = std::clamp(exposure, m_exposureMin, m_exposureMax);
+                step.gainDb = m_gainSpinBox->value();
+                settings.steps.push_back(step);
+                exposure *= m_sequenceRatioSpinBox->value();
+            }
+        }
+
+        if (m_cameraController->setParameterSequence(settings)) {
+            const ParameterSequencer &sequencer = m_cameraController->parameterSequencer();
+            m_sequenceStatusLabel->setText(sequencer.describe());
+            logMessage(sequencer.describe());
+        }
+        updateUIState();
+    });
+}
+
+void MainWindow::createBurstPanel()
+{
+    m_burstGroup = new QGroupBox("连拍", m_controlPanel);
+    QGridLayout *burstLayout = new QGridLayout(m_burstGroup);
+
+    BurstRecorder *recorder = m_cameraController->burstRecorder();
+
+    burstLayout->addWidget(new QLabel("帧数:", m_burstGroup), 0, 0);
+    m_burstFramesSpinBox = new QSpinBox(m_burstGroup);
+    m_burstFramesSpinBox->setRange(2, 10000);
+    m_burstFramesSpinBox->setValue(200);
+    burstLayout->addWidget(m_burstFramesSpinBox, 0, 1);
+
+    m_burstMaxRateCheckBox = new QCheckBox("使用相机最高帧率", m_burstGroup);
+    m_burstMaxRateCheckBox->setChecked(true);
+    burstLayout->addWidget(m_burstMaxRateCheckBox, 1, 0, 1, 2);
+
+    m_burstStartButton = new QPushButton("开始连拍", m_burstGroup);
+    burstLayout->addWidget(m_burstStartButton, 2, 0, 1, 2);
+
+    m_burstStatusLabel = new QLabel("未连拍", m_burstGroup);
+    m_burstStatusLabel->setWordWrap(true);
+    burstLayout->addWidget(m_burstStatusLabel, 3, 0, 1, 2);
+
+    m_burstReviewCheckBox = new QCheckBox("回看 (暂停实时画面)", m_burstGroup);
+    burstLayout->addWidget(m_burstReviewCheckBox, 4, 0, 1, 2);
+
+    m_burstReviewSlider = new QSlider(Qt::Horizontal, m_burstGroup);
+    m_burstReviewSlider->setRange(0, 0);
+    burstLayout->addWidget(m_burstReviewSlider, 5, 0, 1, 2);
+
+    m_burstSaveButton = new QPushButton("保存...", m_burstGroup);
+    m_burstReleaseButton = new QPushButton("释放内存", m_burstGroup);
+    burstLayout->addWidget(m_burstSaveButton, 6, 0);
+    burstLayout->addWidget(m_burstReleaseButton, 6, 1);
+
+    connect(m_burstStartButton, &QPushButton::clicked, this, [this, recorder]() {
+        if (recorder->isArmed()) {
+            m_cameraController->cancelBurst();
+            return;
+        }
+        m_burstReviewCheckBox->setChecked(false);
+        if (m_cameraController->startBurst(m_burstFramesSpinBox->value(), m_burstMaxRateCheckBox->isChecked())) {
+            m_burstStartButton->setText("停止连拍");
+            m_burstStatusLabel->setText(QString("连拍中: 0/%1").arg(m_burstFramesSpinBox->value()));
+            logMessage(QString("开始连拍 %1 帧").arg(m_burstFramesSpinBox->value()));
+        }
+        updateUIState();
+    });
+    connect(recorder, &BurstRecorder::burstProgress, this, [this](int captured, int total) {
+        m_burstStatusLabel->setText(QString("连拍中: %1/%2").arg(captured).arg(total));
+    });
+    connect(recorder, &BurstRecorder::burstFinished, this, [this](int captured, qulonglong missingFrames, double fps) {
+        m_burstStartButton->setText("开始连拍");
+        const QString summary = QString("连拍完成: %1 帧, %2 fps, 缺失 %3 帧")
+                                    .arg(captured).arg(fps, 0, 'f', 1).arg(missingFrames);
+        m_burstStatusLabel->setText(summary);
+        logMessage(summary, missingFrames > 0);
+        m_burstReviewSlider->setRange(0, qMax(0, captured - 1));
+        m_burstReviewSlider->setValue(0);
+        updateUIState();
+    });
+
+    // 回看时暂停实时画面，拖动滑块逐帧查看
+    connect(m_burstReviewCheckBox, &QCheckBox::toggled, this, [this](bool checked) {
+        if (checked) {
+            showBurstFrame(m_burstReviewSlider->value());
+        }
+    });
+    connect(m_burstReviewSlider, &QSlider::valueChanged, this, [this](int index) {
+        if (m_burstReviewCheckBox->isChecked()) {
+            showBurstFrame(index);
+        }
+    });
+
+    connect(m_burstSaveButton, &QPushButton::clicked, this, [this, recorder]() {
+        const QString directory = QFileDialog::getExistingDirectory(this, "选择保存目录");
+        if (directory.isEmpty()) {
+            return;
+        }
+        if (recorder->saveAsync(directory)) {
+            m_burstStatusLabel->setText("正在保存...");
+            updateUIState();
+        }
+    });
+    connect(recorder, &BurstRecorder::saveFinished, this, [this](bool success, const QString &message) {
+        m_burstStatusLabel->setText(message);
+        logMessage(message, !success);
+        updateUIState();
+    });
+
+    connect(m_burstReleaseButton, &QPushButton::clicked, this, [this, recorder]() {
+        m_burstReviewCheckBox->setChecked(false);
+        recorder->release();
+        m_burstReviewSlider->setRange(0, 0);
+        m_burstStatusLabel->setText("未连拍");
+        updateUIState();
+    });
+}
+
+void MainWindow::createAdvancedPanels()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    createStreamPanel();
+    createRealtimePanel();
+    createTransferPanel();
+    m_advancedLayout->addWidget(m_streamGroup);
+    m_advancedLayout->addWidget(m_realtimeGroup);
+    m_advancedLayout->addWidget(m_transferGroup);
+
+    if (m_cameraController->isConnected()) {
+        updateTransferPanel();
+    }
+    updateUIState();
+    qDebug() << "高级设置面板创建耗时:" << timer.elapsed() << "ms";
+}
+
+void MainWindow::createStreamPanel()
+{
+    m_streamGroup = new QGroupBox("远程预览", m_controlPanel);
+    QGridLayout *streamLayout = new QGridLayout(m_streamGroup);
+
+    PreviewStreamServer *server = m_cameraController->previewStreamServer();
+
+    m_streamCheckBox = new QCheckBox("启用 MJPEG 预览服务", m_streamGroup);
+    m_streamCheckBox->setToolTip("浏览器打开 http://<地址>:<端口>/ 查看；/stream.mjpg 为视频流，/snapshot.jpg 为单帧");
+    streamLayout->addWidget(m_streamCheckBox, 0, 0, 1, 2);
+
+    streamLayout->addWidget(new QLabel("端口:", m_streamGroup), 1, 0);
+    m_streamPortSpinBox = new QSpinBox(m_streamGroup);
+    m_streamPortSpinBox->setRange(1024, 65535);
+    m_streamPortSpinBox->setValue(server->settings().port);
+    streamLayout->addWidget(m_streamPortSpinBox, 1, 1);
+
+    m_streamLoopbackCheckBox = new QCheckBox("仅本机访问 (127.0.0.1)", m_streamGroup);
+    m_streamLoopbackCheckBox->setChecked(server->settings().loopbackOnly);
+    streamLayout->addWidget(m_streamLoopbackCheckBox, 2, 0, 1, 2);
+
+    streamLayout->addWidget(new QLabel("最高帧率:", m_streamGroup), 3, 0);
+    m_streamFpsSpinBox = new QSpinBox(m_streamGroup);
+    m_streamFpsSpinBox->setRange(1, 60);
+    m_streamFpsSpinBox->setValue(static_cast<int>(server->settings().maxFps));
+    m_streamFpsSpinBox->setSuffix(" fps");
+    streamLayout->addWidget(m_streamFpsSpinBox, 3, 1);
+
+    streamLayout->addWidget(new QLabel("分辨率:", m_streamGroup), 4, 0);
+    m_streamOutputComboBox = new QComboBox(m_streamGroup);
+    for (const char *item : DERIVED_OUTPUT_ITEMS) {
+        m_streamOutputComboBox->addItem(item);
+    }
+    m_streamOutputComboBox->setCurrentIndex(2);
+    streamLayout->addWidget(m_streamOutputComboBox, 4, 1);
+    m_cameraController->setStreamOutput(outputSpecForIndex(m_streamOutputComboBox->currentIndex()));
+
+    m_streamStatusLabel = new QLabel("远程预览: 关闭", m_streamGroup);
+    m_streamStatusLabel->setWordWrap(true);
+    streamLayout->addWidget(m_streamStatusLabel, 5, 0, 1, 2);
+
+    connect(m_streamCheckBox, &QCheckBox::toggled, this, [this, server](bool checked) {
+        m_streamPortSpinBox->setEnabled(!checked);
+        m_streamLoopbackCheckBox->setEnabled(!checked);
+        m_streamFpsSpinBox->setEnabled(!checked);
+        if (!checked) {
+            server->stop();
+            m_streamStatusLabel->setText("远程预览: 关闭");
+            logMessage("远程预览服务已停止");
+            return;
+        }
+
+        PreviewStreamServer::Settings settings;
+        settings.port = static_cast<quint16>(m_streamPortSpinBox->value());
+        settings.loopbackOnly = m_streamLoopbackCheckBox->isChecked();
+        settings.maxFps = m_streamFpsSpinBox->value();
+        QString error;
+        if (!server->start(settings, &error)) {
+            logMessage(error, true);
+            m_streamCheckBox->blockSignals(true);
+            m_streamCheckBox->setChecked(false);
+            m_streamCheckBox->blockSignals(false);
+            m_streamPortSpinBox->setEnabled(true);
+            m_streamLoopbackCheckBox->setEnabled(true);
+            m_streamFpsSpinBox->setEnabled(true);
+            return;
+        }
+        const QString url = QString("http://%1:%2/").arg(settings.loopbackOnly ? "127.0.0.1" : "<本机地址>")
+                                .arg(server->serverPort());
+        m_streamStatusLabel->setText(QString("远程预览: %1 (无客户端)").arg(url));
+        logMessage(QString("远程预览服务已启动: %1").arg(url));
+    });
+    connect(m_streamOutputComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) {
+        const DerivedFrameSpec spec = outputSpecForIndex(index);
+        m_cameraController->setStreamOutput(spec);
+        logMessage(QString("远程预览输出: %1").arg(spec.description()));
+    });
+    connect(server, &PreviewStreamServer::clientConnected, this, [this](const QString &peer) {
+        logMessage(QString("远程预览客户端已连接: %1").arg(peer));
+    });
+    connect(server, &PreviewStreamServer::clientDisconnected, this, [this](const QString &peer) {
+        logMessage(QString("远程预览客户端已断开: %1").arg(peer));
+    });
+    connect(server, &PreviewStreamServer::statisticsUpdated, this, [this](const PreviewStreamServer::Statistics &stats) {
+        m_streamStatusLabel->setText(
+            QString("远程预览: 客户端 %1 (质量 %2), 编码 %3 fps, %4 ms/帧, 编码线程 CPU %5%, 发送 %6 Mbit/s, 积压跳帧 %7")
+                .arg(stats.clients).arg(stats.clientLevels.isEmpty() ? QString("-") : stats.clientLevels)
+                .arg(stats.encodedFps, 0, 'f', 1).arg(stats.encodeMsPerFrame, 0, 'f', 1)
+                .arg(stats.encoderCpuPercent, 0, 'f', 0).arg(stats.sendMegabitsPerSecond, 0, 'f', 1)
+                .arg(stats.clientDrops));
+    });
+}
+
+void MainWindow::createRealtimePanel()
+{
+    m_realtimeGroup = new QGroupBox("采集实时性", m_controlPanel);
+    QGridLayout *realtimeLayout = new QGridLayout(m_realtimeGroup);
+
+    const CaptureThreadOptions options = m_cameraController->captureThreadOptions();
+    const int cpuCount = RealtimeTuning::cpuCount();
+
+    m_realtimeCheckBox = new QCheckBox("SCHED_FIFO 实时优先级", m_realtimeGroup);
+    m_realtimeCheckBox->setChecked(options.realtime);
+    m_realtimeCheckBox->setToolTip("采集线程和 Aravis 接收线程（高一级）使用实时调度，需要 rtprio 权限；"
+                                   "启用后采集线程改为阻塞出队");
+    realtimeLayout->addWidget(m_realtimeCheckBox, 0, 0);
+    m_realtimePrioritySpinBox = new QSpinBox(m_realtimeGroup);
+    m_realtimePrioritySpinBox->setRange(1, 98);
+    m_realtimePrioritySpinBox->setValue(options.priority);
+    realtimeLayout->addWidget(m_realtimePrioritySpinBox, 0, 1);
+
+    realtimeLayout->addWidget(new QLabel("采集线程 CPU:", m_realtimeGroup), 1, 0);
+    m_captureCpuSpinBox = new QSpinBox(m_realtimeGroup);
+    m_captureCpuSpinBox->setRange(-1, cpuCount - 1);
+    m_captureCpuSpinBox->setSpecialValueText("不绑定");
+    m_captureCpuSpinBox->setValue(options.captureCpu);
+    realtimeLayout->addWidget(m_captureCpuSpinBox, 1, 1);
+
+    realtimeLayout->addWidget(new QLabel("接收线程 CPU:", m_realtimeGroup), 2, 0);
+    m_streamCpuSpinBox = new QSpinBox(m_realtimeGroup);
+    m_streamCpuSpinBox->setRange(-1, cpuCount - 1);
+    m_streamCpuSpinBox->setSpecialValueText("不绑定");
+    m_streamCpuSpinBox->setValue(options.streamCpu);
+    realtimeLayout->addWidget(m_streamCpuSpinBox, 2, 1);
+
+    m_lockMemoryCheckBox = new QCheckBox("锁定内存 (mlockall)", m_realtimeGroup);
+    m_lockMemoryCheckBox->setChecked(options.lockMemory);
+    m_lockMemoryCheckBox->setToolTip("采集期间锁定进程全部内存，避免换页；需要足够的 memlock 限额");
+    realtimeLayout->addWidget(m_lockMemoryCheckBox, 3, 0);
+    m_prefaultCheckBox = new QCheckBox("预触碰缓冲区", m_realtimeGroup);
+    m_prefaultCheckBox->setChecked(options.prefaultBuffers);
+    m_prefaultCheckBox->setToolTip("开始采集时逐页写入 Aravis 缓冲区，首批帧不再触发缺页");
+    realtimeLayout->addWidget(m_prefaultCheckBox, 3, 1);
+
+    m_jitterReportButton = new QPushButton("出队间隔报告", m_realtimeGroup);
+    m_jitterReportButton->setToolTip("采集线程相邻两次出队的间隔分布，用于检查是否按时取走每一帧");
+    realtimeLayout->addWidget(m_jitterReportButton, 4, 0, 1, 2);
+
+    connect(m_realtimeCheckBox, &QCheckBox::toggled, this, &MainWindow::applyCaptureThreadOptions);
+    connect(m_lockMemoryCheckBox, &QCheckBox::toggled, this, &MainWindow::applyCaptureThreadOptions);
+    connect(m_prefaultCheckBox, &QCheckBox::toggled, this, &MainWindow::applyCaptureThreadOptions);
+    connect(m_realtimePrioritySpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &MainWindow::applyCaptureThreadOptions);
+    connect(m_captureCpuSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &MainWindow::applyCaptureThreadOptions);
+    connect(m_streamCpuSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &MainWindow::applyCaptureThreadOptions);
+
+    connect(m_jitterReportButton, &QPushButton::clicked, this, [this]() {
+        for (const QString &line : m_cameraController->popIntervalHistogram().report()) {
+            logMessage(line);
+        }
+    });
+}
+
+void MainWindow::applyDerivedOutputs()
+{
+    const DerivedFrameSpec previewSpec = outputSpecForIndex(m_previewOutputComboBox->currentIndex());
+    if (previewSpec != m_cameraController->previewOutput()) {
+        // 预览尺寸改变后原有框选位置失效
+        m_videoWidget->clearSelectedRegion();
+        m_cameraController->setPreviewOutput(previewSpec);
+        logMessage(QString("预览输出: %1").arg(previewSpec.description()));
+    }
+
+    DerivedFrameSpec busSpec = outputSpecForIndex(m_frameBusOutputComboBox->currentIndex());
+    if (m_frameBusCropCheckBox->isChecked()) {
+        busSpec.crop = m_selectedImageRegion;
+    }
+    if (busSpec != m_cameraController->frameBusOutput()) {
+        m_cameraController->setFrameBusOutput(busSpec);
+        logMessage(QString("帧总线输出: %1").arg(busSpec.description()));
+    }
+}
+
+void MainWindow::applyCaptureThreadOptions()
+{
+    CaptureThreadOptions options;
+    options.realtime = m_realtimeCheckBox->isChecked();
+    options.priority = m_realtimePrioritySpinBox->value();
+    options.captureCpu = m_captureCpuSpinBox->value();
+    options.streamCpu = m_streamCpuSpinBox->value();
+    options.lockMemory = m_lockMemoryCheckBox->isChecked();
+    options.prefaultBuffers = m_prefaultCheckBox->isChecked();
+    m_cameraController->setCaptureThreadOptions(options);
+}
+
+void MainWindow::createTransferPanel()
+{
+    m_transferGroup = new QGroupBox("USB3 传输", m_controlPanel);
+    QGridLayout *transferLayout = new QGridLayout(m_transferGroup);
+
+    const UsbTransferOptions options = m_cameraController->usbTransferOptions();
+
+    // 下拉框顺序与 UsbTransferOptions::Mode 一致
+    transferLayout->addWidget(new QLabel("USB 模式:", m_transferGroup), 0, 0);
+    m_usbModeComboBox = new QComboBox(m_transferGroup);
+    m_usbModeComboBox->addItem("默认");
+    m_usbModeComboBox->addItem("同步");
+    m_usbModeComboBox->addItem("异步");
+    m_usbModeComboBox->setCurrentIndex(static_cast<int>(options.mode));
+    m_usbModeComboBox->setToolTip("异步模式多个 USB 传输同时排队，主机负载高时不易丢帧；开始采集时生效");
+    transferLayout->addWidget(m_usbModeComboBox, 0, 1);
+
+    transferLayout->addWidget(new QLabel("最大传输大小:", m_transferGroup), 1, 0);
+    m_maxTransferSpinBox = new QSpinBox(m_transferGroup);
+    m_maxTransferSpinBox->setRange(0, 16384);
+    m_maxTransferSpinBox->setSingleStep(64);
+    m_maxTransferSpinBox->setSuffix(" KB");
+    m_maxTransferSpinBox->setSpecialValueText("默认");
+    m_maxTransferSpinBox->setValue(options.maximumTransferKB);
+    m_maxTransferSpinBox->setToolTip("每个 bulk 传输的最大字节数，开始采集时生效");
+    transferLayout->addWidget(m_maxTransferSpinBox, 1, 1);
+
+    m_throughputLimitCheckBox = new QCheckBox("链路带宽限制", m_transferGroup);
+    m_throughputLimitCheckBox->setToolTip("相机 DeviceLinkThroughputLimit，多台相机共用主控制器时按份额限速");
+    transferLayout->addWidget(m_throughputLimitCheckBox, 2, 0);
+    m_throughputLimitSpinBox = new QDoubleSpinBox(m_transferGroup);
+    m_throughputLimitSpinBox->setRange(1, 1000);
+    m_throughputLimitSpinBox->setDecimals(1);
+    m_throughputLimitSpinBox->setSuffix(" MB/s");
+    m_throughputLimitSpinBox->setValue(350);
+    transferLayout->addWidget(m_throughputLimitSpinBox, 2, 1);
+
+    m_throughputApplyButton = new QPushButton("应用带宽限制", m_transferGroup);
+    transferLayout->addWidget(m_throughputApplyButton, 3, 0);
+    m_streamInfoButton = new QPushButton("流统计", m_transferGroup);
+    m_streamInfoButton->setToolTip("输出当前流的全部统计项和单帧传输耗时分布");
+    transferLayout->addWidget(m_streamInfoButton, 3, 1);
+
+    m_transferStatusLabel = new QLabel("传输: -", m_transferGroup);
+    m_transferStatusLabel->setWordWrap(true);
+    transferLayout->addWidget(m_transferStatusLabel, 4, 0, 1, 2);
+
+    connect(m_usbModeComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::applyUsbTransferOptions);
+    connect(m_maxTransferSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &MainWindow::applyUsbTransferOptions);
+
+    connect(m_throughputApplyButton, &QPushButton::clicked, this, [this]() {
+        const bool limited = m_throughputLimitCheckBox->isChecked();
+        const uint64_t bytesPerSecond = limited ? static_cast<uint64_t>(m_throughputLimitSpinBox->value() * 1e6) : 0;
+        if (!m_cameraController->setLinkThroughputLimit(bytesPerSecond)) {
+            return;
+        }
+        const uint64_t actual = m_cameraController->linkThroughputLimit();
+        logMessage(actual > 0 ? QString("链路带宽限制: %1 MB/s").arg(actual / 1e6, 0, 'f', 1)
+                              : QString("链路带宽限制已关闭"));
+    });
+    connect(m_streamInfoButton, &QPushButton::clicked, this, [this]() {
+        const IntervalHistogram::Summary transfer = m_cameraController->transferDurationHistogram().summary();
+        if (transfer.count > 0) {
+            logMessage(QString("单帧传输耗时: %1 帧 | 平均 %2 μs | P50 %3 | P99 %4 | P99.9 %5 | 最大 %6 μs")
+                           .arg(transfer.count).arg(transfer.meanUs, 0, 'f', 0).arg(transfer.p50Us, 0, 'f', 0)
+                           .arg(transfer.p99Us, 0, 'f', 0).arg(transfer.p999Us, 0, 'f', 0)
+                           .arg(transfer.maxUs, 0, 'f', 0));
+        }
+        const QStringList info = m_cameraController->streamInfo();
+        if (info.isEmpty()) {
+            logMessage("流统计需要在连续采集时查看", true);
+            return;
+        }
+        logMessage(QString("流统计:\n%1").arg(info.join("\n")));
+    });
+    connect(m_cameraController, &CameraController::transferStatisticsUpdated, this, [this](const QString &summary) {
+        m_transferStatusLabel->setText(QString("传输: %1").arg(summary));
+    });
+}
+
+void MainWindow::applyUsbTransferOptions()
+{
+    UsbTransferOptions options;
+    options.mode = static_cast<UsbTransferOptions::Mode>(m_usbModeComboBox->currentIndex());
+    options.maximumTransferKB = m_maxTransferSpinBox->value();
+    m_cameraController->setUsbTransferOptions(options);
+}
+
+void MainWindow::updateTransferPanel()
+{
+    // 连接后按相机的 DeviceLinkThroughputLimit 范围和当前值初始化
+    uint64_t minimum = 0, maximum = 0;
+    const bool available = m_cameraController->linkThroughputLimitBounds(minimum, maximum);
+    m_throughputLimitCheckBox->setEnabled(available);
+    m_throughputLimitSpinBox->setEnabled(available);
+    m_throughputApplyButton->setEnabled(available);
+    if (available) {
+        m_throughputLimitSpinBox->setRange(std::max(minimum / 1e6, 0.1), maximum / 1e6);
+        const uint64_t current = m_cameraController->linkThroughputLimit();
+        m_throughputLimitCheckBox->setChecked(current > 0);
+        m_throughputLimitSpinBox->setValue(current > 0 ? current / 1e6 : maximum / 1e6);
+        logMessage(QString("链路带宽范围: %1 - %2 MB/s").arg(minimum / 1e6, 0, 'f', 1).arg(maximum / 1e6, 0, 'f', 1));
+    }
+    m_transferStatusLabel->setText(m_cameraController->isUsb3Device() ? "传输: -" : "传输: 非 USB3 相机，仅显示吞吐和错误计数");
+}
+
+void MainWindow::createSavePanel()
+{
+    m_saveGroup = new QGroupBox("图像保存", m_controlPanel);
+    QGridLayout *saveLayout = new QGridLayout(m_saveGroup);
+
+    ImageSaveService *saver = m_cameraController->imageSaveService();
+
+    // 下拉框顺序与 ImageSaveService::Format 一致
+    saveLayout->addWidget(new QLabel("格式:", m_saveGroup), 0, 0);
+    m_saveFormatComboBox = new QComboBox(m_saveGroup);
+    m_saveFormatComboBox->addItem("PNG (8/16位)");
+    m_saveFormatComboBox->addItem("TIFF (8/16位)");
+    m_saveFormatComboBox->addItem("BMP (8位)");
+    m_saveFormatComboBox->addItem("RAW (原始数据)");
+    m_saveFormatComboBox->addItem("ALC (无损压缩)");
+    saveLayout->addWidget(m_saveFormatComboBox, 0, 1);
+
+    m_saveDirectoryButton = new QPushButton("目录...", m_saveGroup);
+    saveLayout->addWidget(m_saveDirectoryButton, 1, 0);
+    m_saveDirectoryLabel = new QLabel(saver->directory(), m_saveGroup);
+    m_saveDirectoryLabel->setWordWrap(true);
+    saveLayout->addWidget(m_saveDirectoryLabel, 1, 1);
+
+    saveLayout->addWidget(new QLabel("序列帧数:", m_saveGroup), 2, 0);
+    m_sequenceFramesSpinBox = new QSpinBox(m_saveGroup);
+    m_sequenceFramesSpinBox->setRange(0, 1000000);
+    m_sequenceFramesSpinBox->setValue(0);
+    m_sequenceFramesSpinBox->setSuffix(" (0 = 不限)");
+    saveLayout->addWidget(m_sequenceFramesSpinBox, 2, 1);
+
+    m_recordButton = new QPushButton("开始录制", m_saveGroup);
+    m_saveNextButton = new QPushButton("保存下一帧", m_saveGroup);
+    saveLayout->addWidget(m_recordButton, 3, 0);
+    saveLayout->addWidget(m_saveNextButton, 3, 1);
+
+    m_saveStatsLabel = new QLabel("保存: --", m_saveGroup);
+    saveLayout->addWidget(m_saveStatsLabel, 4, 0, 1, 2);
+
+    connect(m_saveFormatComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [saver](int index) {
+        saver->setFormat(static_cast<ImageSaveService::Format>(index));
+    });
+    connect(m_saveDirectoryButton, &QPushButton::clicked, this, [this, saver]() {
+        const QString directory = QFileDialog::getExistingDirectory(this, "选择保存目录", saver->directory());
+        if (!directory.isEmpty()) {
+            saver->setDirectory(directory);
+            m_saveDirectoryLabel->setText(directory);
+        }
+    });
+    connect(m_recordButton, &QPushButton::clicked, this, [this, saver]() {
+        if (saver->isRecording()) {
+            saver->stopSequence();
+            return;
+        }
+        if (saver->startSequence(m_sequenceFramesSpinBox->value())) {
+            m_recordButton->setText("停止录制");
+            logMessage(QString("开始录制图像序列 (%1)").arg(ImageSaveService::formatSuffix(saver->format())));
+        }
+    });
+    connect(m_saveNextButton, &QPushButton::clicked, this, [saver]() {
+        saver->saveNextFrame();
+    });
+
+    connect(saver, &ImageSaveService::sequenceFinished, this, [this](qulonglong savedFrames) {
+        m_recordButton->setText("开始录制");
+        logMessage(QString("图像序列录制结束: 已保存 %1 帧").arg(savedFrames));
+    });
+    connect(saver, &ImageSaveService::frameSaved, this, [this](const QString &filePath) {
+        logMessage(QString("图像已保存: %1").arg(filePath));
+    });
+    connect(saver, &ImageSaveService::saveFailed, this, [this](const QString &message) {
+        logMessage(message, true);
+    });
+    connect(saver, &ImageSaveService::throughputUpdated, this, [this](const ImageSaveService::SaveStatistics &stats) {
+        QString text = QString("保存: %1 帧/s | %2 MB/s | 队列 %3 | 丢弃 %4")
+                           .arg(stats.framesPerSecond, 0, 'f', 1)
+                           .arg(stats.megabytesPerSecond, 0, 'f', 1)
+                           .arg(stats.queuedFrames)
+                           .arg(stats.droppedFrames);
+        if (stats.compressionRatio > 0.0) {
+            text += QString("\n压缩率 %1:1 | 单帧编码 %2 MB/s")
+                        .arg(stats.compressionRatio, 0, 'f', 2)
+                        .arg(stats.codecMegabytesPerSecond, 0, 'f', 0);
+        }
+        m_saveStatsLabel->setText(text);
+    });
+}
+
+void MainWindow::showBurstFrame(int index)
+{
+    FramePtr frame = m_cameraController->burstRecorder()->frameAt(index);
+    if (!frame) {
+        return;
+    }
+
+    m_videoWidget->setFrame(m_cameraController->toDisplayImage(frame));
+    m_burstStatusLabel->setText(QString("回看: %1/%2 帧号 %3")
+                                    .arg(index + 1)
+                                    .arg(m_cameraController->burstRecorder()->capturedFrames())
+                                    .arg(frame->frameId));
+}
+
 void MainWindow::createImageDisplayPanel()
 {
     m_imageGroup = new QGroupBox("图像预览", this);
@@ -305,11 +1512,44 @@ void MainWindow::createImageDisplayPanel()
     m_videoWidget = new VideoWidget(m_imageGroup);
     m_videoWidget->setMinimumSize(800, 600);
 
+    m_focusPlotWidget = new FocusPlotWidget(m_imageGroup);
+    m_focusPlotWidget->setFixedHeight(120);
+    m_focusPlotWidget->setVisible(false);
+
+    // 框选区域作为对焦评价区域，清除框选则回到整帧
+    connect(m_videoWidget, &VideoWidget::regionSelected, this, [this](const QRect &selection) {
+        // 预览可能是合并/抽样后的图像，框选坐标换算回原始帧
+        const int scale = m_cameraController->previewOutput().scale();
+        const QRect region(selection.x() * scale, selection.y() * scale,
+                           selection.width() * scale, selection.height() * scale);
+        m_selectedImageRegion = ImageRegion{region.x(), region.y(), region.width(), region.height()};
+        m_cameraController->frameAnalyzer()->setFocusRegion(m_selectedImageRegion);
+        m_focusPlotWidget->clear();
+        if (region.isEmpty()) {
+            logMessage("对焦区域: 整帧");
+        } else {
+            logMessage(QString("对焦区域: (%1, %2, %3x%4)")
+                       .arg(region.x()).arg(region.y()).arg(region.width()).arg(region.height()));
+        }
+        if (m_frameBusCropCheckBox->isChecked()) {
+            applyDerivedOutputs();
+        }
+    });
+
     m_imageInfoLabel = new QLabel("分辨率: - | 格式: - | FPS: -", m_imageGroup);
     m_imageInfoLabel->setStyleSheet("QLabel { padding: 5px; background-color: #f0f0f0; }");
 
     imgLayout->addWidget(m_videoWidget, 1);
+    imgLayout->addWidget(m_focusPlotWidget);
     imgLayout->addWidget(m_imageInfoLabel);
+
+    m_pipelineStatsLabel = new QLabel("处理管线: -", m_imageGroup);
+    m_pipelineStatsLabel->setStyleSheet("QLabel { padding: 2px 5px; color: #606060; }");
+    imgLayout->addWidget(m_pipelineStatsLabel);
+    connect(m_cameraController, &CameraController::pipelineStatisticsUpdated,
+            m_pipelineStatsLabel, [this](const QString &summary) {
+        m_pipelineStatsLabel->setText(QString("处理管线: %1").arg(summary));
+    });
 }
 
 void MainWindow::createStatusPanel()
@@ -317,22 +1557,105 @@ void MainWindow::createStatusPanel()
     m_statusGroup = new QGroupBox("状态日志", m_controlPanel);
     QVBoxLayout *statusLayout = new QVBoxLayout(m_statusGroup);
 
-    m_statusTextEdit = new QTextEdit(m_statusGroup);
-    m_statusTextEdit->setReadOnly(true);
-    m_statusTextEdit->setMaximumHeight(150);
-    m_statusTextEdit->setStyleSheet("QTextEdit { font-family: 'Consolas', monospace; font-size: 9pt; }");
-
-    statusLayout->addWidget(m_statusTextEdit);
+    // 环形日志模型 + 虚拟化列表：只绘制可见行，长时间运行后追加开销不变
+    m_logModel = new LogModel(LogModel::DEFAULT_CAPACITY, this);
+    m_logView = new QListView(m_statusGroup);
+    m_logView->setModel(m_logModel);
+    m_logView->setUniformItemSizes(true);
+    m_logView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_logView->setMaximumHeight(150);
+    m_logView->setStyleSheet("QListView { font-family: 'Consolas', monospace; font-size: 9pt; }");
+    statusLayout->addWidget(m_logView);
+
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    m_logClearButton = new QPushButton("清空", m_statusGroup);
+    m_logExportButton = new QPushButton("导出日志", m_statusGroup);
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(m_logClearButton);
+    buttonLayout->addWidget(m_logExportButton);
+    statusLayout->addLayout(buttonLayout);
+
+    connect(m_logClearButton, &QPushButton::clicked, this, [this]() {
+        m_logModel->clear();
+    });
+    connect(m_logExportButton, &QPushButton::clicked, this, [this]() {
+        const QString path = QFileDialog::getSaveFileName(this, "导出状态日志", "camera_log.txt", "文本文件 (*.txt)");
+        if (path.isEmpty()) {
+            return;
+        }
+        QString error;
+        if (m_logModel->exportText(path, &error)) {
+            logMessage(QString("状态日志已导出: %1").arg(path));
+        } else {
+            logMessage(error, true);
+        }
+    });
 }
 
 // ========== 槽函数实现 ==========
 
 void MainWindow::onConnectClicked()
+{
+    // 列表尚未枚举完成时 ID 为空，连接第一台相机
+    connectToCamera(m_cameraComboBox->currentData().toString());
+}
+
+bool MainWindow::connectToCamera(const QString &cameraId)
 {
     logMessage("正在连接相机...");
-    if (m_cameraController->connectCamera()) {
-        updateParameterBounds();
-        updateCameraInfo();
+    if (!m_cameraController->connectCamera(cameraId)) {
+        return false;
+    }
+    StartupTimer::mark("相机连接完成");
+    updateParameterBounds();
+    updateCameraInfo();
+    if (!cameraId.isEmpty()) {
+        QSettings().setValue(SETTINGS_LAST_CAMERA, cameraId);
+    }
+    return true;
+}
+
+void MainWindow::onDevicesEnumerated(const QVector<CameraDeviceInfo> &devices, double elapsedMs)
+{
+    m_cameraComboBox->clear();
+    for (const CameraDeviceInfo &device : devices) {
+        m_cameraComboBox->addItem(device.label(), device.id);
+    }
+    if (devices.empty()) {
+        m_cameraComboBox->addItem("未发现相机");
+    }
+
+    const QString selectedId = m_cameraController->isConnected() ? m_cameraController->cameraId()
+                                                                 : QSettings().value(SETTINGS_LAST_CAMERA).toString();
+    const int selected = m_cameraComboBox->findData(selectedId);
+    if (selected >= 0) {
+        m_cameraComboBox->setCurrentIndex(selected);
+    }
+    logMessage(QString("设备枚举完成: %1 台相机, 耗时 %2 ms").arg(devices.size()).arg(elapsedMs, 0, 'f', 0));
+
+    // 探测线程没能打开上次的相机（已拔出或被占用）
+    if (m_autoConnectPending) {
+        m_autoConnectPending = false;
+        logMessage(QString("自动连接失败: 未找到上次的相机 %1").arg(selectedId), true);
+    }
+    updateUIState();
+
+    // 没有自动开始采集时启动到此结束，否则等首帧显示后报告
+    if (!m_cameraController->isAcquiring()) {
+        reportStartup();
+    }
+}
+
+void MainWindow::reportStartup()
+{
+    if (m_startupReported) {
+        return;
+    }
+    m_startupReported = true;
+    const QStringList lines = StartupTimer::report();
+    logMessage(QString("启动耗时:\n%1").arg(lines.join("\n")));
+    for (const QString &line : lines) {
+        qDebug() << line;
     }
 }
 
@@ -350,6 +1673,11 @@ void MainWindow::onStartAcquisitionClicked()
         return;
     }
 
+    if (m_benchmarkRunning) {
+        logMessage("并行扩展性测试运行中，请等待测试结束再开始采集", true);
+        return;
+    }
+
     // 如果正在采集，先停止以便应用新参数
     if (m_cameraController->isAcquiring()) {
         logMessage("先停止当前采集以应用新参数...");
@@ -472,6 +1800,9 @@ void MainWindow::onCameraConnected(const QString &model)
 {
     logMessage(QString("相机已连接: %1").arg(model));
     m_statusBarLabel->setText(QString("已连接: %1").arg(model));
+    if (m_transferGroup) {
+        updateTransferPanel();
+    }
     updateUIState();
 }
 
@@ -490,13 +1821,22 @@ void MainWindow::onNewFrame(const QImage &image)
         return;
     }
 
+    if (m_burstReviewCheckBox->isChecked()) {
+        return;
+    }
+
     qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
     if (currentTime - m_lastFrameTime < UI_FRAME_INTERVAL) {
         return;
     }
     m_lastFrameTime = currentTime;
 
-    m_videoWidget->setFrame(image);
+    m_videoWidget->setFrame(image, m_cameraController->lastFrameId());
+
+    if (!m_startupReported) {
+        StartupTimer::mark("首帧显示");
+        reportStartup();
+    }
 }
 
 void MainWindow::onFPSUpdated(double fps)
@@ -511,21 +1851,166 @@ void MainWindow::onFPSUpdated(double fps)
     }
 
     QString format = "灰度8位";
-    m_imageInfoLabel->setText(QString("分辨率: %1x%2 | 格式: %3 | FPS: %4")
-                              .arg(width)
-                              .arg(height)
-                              .arg(format)
-                              .arg(fps, 0, 'f', 1));
+    QString info = QString("分辨率: %1x%2 | 格式: %3 | FPS: %4")
+                       .arg(width)
+                       .arg(height)
+                       .arg(format)
+                       .arg(fps, 0, 'f', 1);
+
+    const FrameDropMonitor::Counters drops = m_cameraController->frameDropMonitor()->counters();
+    m_dropStatusLabel->setText(QString("丢帧: %1 (间隔 %2 | 超时 %3 | 缺包 %4 | 大小不符 %5 | 中止 %6) / 接收 %7")
+                               .arg(drops.lostFrames())
+                               .arg(drops.count(FrameDropMonitor::EventType::FrameGap))
+                               .arg(drops.count(FrameDropMonitor::EventType::Timeout))
+                               .arg(drops.count(FrameDropMonitor::EventType::MissingPackets))
+                               .arg(drops.count(FrameDropMonitor::EventType::SizeMismatch))
+                               .arg(drops.count(FrameDropMonitor::EventType::Aborted))
+                               .arg(drops.received));
+
+    // 块数据反映的是该帧实际使用的参数，而非最近一次写入的值
+    const FrameChunkData chunk = m_cameraController->lastFrameChunkData();
+    if (chunk.has(FrameChunkData::ExposureTime)) {
+        info += QString(" | 曝光: %1 us").arg(chunk.exposureUs, 0, 'f', 0);
+    }
+    if (chunk.has(FrameChunkData::Gain)) {
+        info += QString(" | 增益: %1 dB").arg(chunk.gainDb, 0, 'f', 1);
+    }
+    if (chunk.has(FrameChunkData::LineStatus)) {
+        info += QString(" | 线状态: 0x%1").arg(chunk.lineStatus, 0, 16);
+    }
+    m_imageInfoLabel->setText(info);
+}
+
+void MainWindow::onStatisticsReady(const FrameStatistics &stats)
+{
+    m_videoWidget->setStatistics(stats);
+    m_lastStatistics = stats;
+}
+
+void MainWindow::onAutoExposureToggled(bool checked)
+{
+    AutoExposureController *autoExposure = m_cameraController->autoExposureController();
+
+    if (checked) {
+        if (m_cameraController->parameterSequencer().isActive()) {
+            logMessage("自动曝光启用失败: 参数序列运行中，请先关闭序列", true);
+            m_autoExposureCheckBox->blockSignals(true);
+            m_autoExposureCheckBox->setChecked(false);
+            m_autoExposureCheckBox->blockSignals(false);
+            return;
+        }
+        if (!autoExposure->enable()) {
+            logMessage("自动曝光启用失败", true);
+            m_autoExposureCheckBox->blockSignals(true);
+            m_autoExposureCheckBox->setChecked(false);
+            m_autoExposureCheckBox->blockSignals(false);
+            return;
+        }
+        logMessage("自动曝光/增益已启用");
+    } else {
+        autoExposure->disable();
+        logMessage("自动曝光/增益已关闭");
+    }
+
+    updateUIState();
+}
+
+void MainWindow::onAutoExposureAdjusted(double exposureUs, double gainDb)
+{
+    m_exposureSpinBox->blockSignals(true);
+    m_exposureSpinBox->setValue(exposureUs);
+    m_exposureSpinBox->blockSignals(false);
+    m_exposureSlider->blockSignals(true);
+    m_exposureSlider->setValue(static_cast<int>(exposureUs));
+    m_exposureSlider->blockSignals(false);
+
+    m_gainSpinBox->blockSignals(true);
+    m_gainSpinBox->setValue(gainDb);
+    m_gainSpinBox->blockSignals(false);
+    m_gainSlider->blockSignals(true);
+    m_gainSlider->setValue(static_cast<int>(gainDb * 10));
+    m_gainSlider->blockSignals(false);
 }
 
 void MainWindow::onError(const QString &errorMsg)
 {
+    // 帧总线创建失败时控制器会自行关闭发布，这里同步复选框状态
+    if (m_frameBusCheckBox->isChecked() && !m_cameraController->isFrameBusEnabled()) {
+        m_frameBusCheckBox->blockSignals(true);
+        m_frameBusCheckBox->setChecked(false);
+        m_frameBusCheckBox->blockSignals(false);
+    }
+    // 快照流重建失败（如停止采集后、修改 ROI 后）时同理
+    if (m_snapshotModeCheckBox->isChecked() && !m_cameraController->isSnapshotModeEnabled()) {
+        m_snapshotModeCheckBox->blockSignals(true);
+        m_snapshotModeCheckBox->setChecked(false);
+        m_snapshotModeCheckBox->blockSignals(false);
+    }
+    if (m_chunkDataCheckBox->isChecked() != m_cameraController->isChunkDataEnabled()) {
+        m_chunkDataCheckBox->blockSignals(true);
+        m_chunkDataCheckBox->setChecked(m_cameraController->isChunkDataEnabled());
+        m_chunkDataCheckBox->blockSignals(false);
+    }
+
     logMessage(errorMsg, true);
-    QMessageBox::warning(this, "错误", errorMsg);
+    notifyError(errorMsg);
+}
+
+void MainWindow::notifyError(const QString &errorMsg)
+{
+    statusBar()->showMessage(QString("错误: %1").arg(errorMsg), 10000);
+
+    // 同一错误在窗口期内只提示一次，重复的只在日志中累加次数
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    m_recentErrors.erase(std::remove_if(m_recentErrors.begin(), m_recentErrors.end(),
+                                        [now](const std::pair<QString, qint64> &recent) {
+                                            return now - recent.second >= ERROR_REPEAT_WINDOW_MS;
+                                        }),
+                         m_recentErrors.end());
+    const bool repeated = std::any_of(m_recentErrors.begin(), m_recentErrors.end(),
+                                      [&errorMsg](const std::pair<QString, qint64> &recent) {
+                                          return recent.first == errorMsg;
+                                      });
+    if (repeated) {
+        return;
+    }
+    m_recentErrors.emplace_back(errorMsg, now);
+
+    if (!m_errorDialog) {
+        // 非模态且只有一个实例：错误连发时不会在实时画面上叠加对话框，也不阻塞事件循环
+        m_errorDialog = new QMessageBox(this);
+        m_errorDialog->setIcon(QMessageBox::Warning);
+        m_errorDialog->setWindowTitle("错误");
+        m_errorDialog->setWindowModality(Qt::NonModal);
+        connect(m_errorDialog, &QMessageBox::finished, this, [this]() {
+            m_unshownErrors = 0;
+            m_errorDialogClosedMs = QDateTime::currentMSecsSinceEpoch();
+        });
+    }
+
+    if (m_errorDialog->isVisible()) {
+        // 已在显示：换成最新的错误，并注明期间的其他错误数
+        m_unshownErrors++;
+        m_errorDialog->setText(errorMsg);
+        m_errorDialog->setInformativeText(QString("另有 %1 条错误，详见状态日志").arg(m_unshownErrors));
+        return;
+    }
+    if (now - m_errorDialogClosedMs < ERROR_DIALOG_INTERVAL_MS) {
+        m_unshownErrors++;
+        return;
+    }
+
+    m_errorDialog->setText(errorMsg);
+    m_errorDialog->setInformativeText(m_unshownErrors > 0
+        ? QString("此前另有 %1 条错误未弹出，详见状态日志").arg(m_unshownErrors)
+        : QString());
+    m_unshownErrors = 0;
+    m_errorDialog->show();
 }
 
 void MainWindow::onAcquisitionStarted()
 {
+    StartupTimer::mark("采集开始");
     logMessage("连续采集已启动");
     updateUIState();
 }
@@ -627,49 +2112,123 @@ void MainWindow::updateUIState()
     bool isConnected = m_cameraController->isConnected();
     bool isAcquiring = m_cameraController->isAcquiring();
 
-    // 连接按钮
+    // 连接按钮：枚举进行中也可连接（未选择设备时连接第一台）
+    const bool probing = m_cameraController->isProbing();
     m_connectButton->setEnabled(!isConnected);
+    m_cameraComboBox->setEnabled(!isConnected && !probing);
+    m_refreshDevicesButton->setEnabled(!isConnected && !probing);
     m_disconnectButton->setEnabled(isConnected);
 
     // 采集按钮
-    m_startAcquisitionButton->setEnabled(isConnected && !isAcquiring);
+    m_startAcquisitionButton->setEnabled(isConnected && !isAcquiring && !m_benchmarkRunning);
     m_stopAcquisitionButton->setEnabled(isConnected && isAcquiring);
     m_grabFrameButton->setEnabled(isConnected && !isAcquiring);
+    m_snapshotModeCheckBox->setEnabled(isConnected);
+    if (!isConnected && m_snapshotModeCheckBox->isChecked()) {
+        m_snapshotModeCheckBox->blockSignals(true);
+        m_snapshotModeCheckBox->setChecked(false);
+        m_snapshotModeCheckBox->blockSignals(false);
+    }
+    m_chunkDataCheckBox->setEnabled(isConnected && !isAcquiring);
+    if (!isConnected && m_chunkDataCheckBox->isChecked()) {
+        m_chunkDataCheckBox->blockSignals(true);
+        m_chunkDataCheckBox->setChecked(false);
+        m_chunkDataCheckBox->blockSignals(false);
+    }
 
-    // 参数控件 - 增益可以在采集时调整,其他参数不行
+    // 参数控件 - 增益和ROI可以在采集时调整,其他参数不行
     if (isAcquiring) {
-        // 采集时:只允许调整增益
+        // 采集时:ROI走不重建流的重配置路径，连拍期间除外
+        const bool roiEditable = !m_cameraController->burstRecorder()->isArmed();
         m_exposureSpinBox->setEnabled(false);
         m_exposureSlider->setEnabled(false);
         m_gainSpinBox->setEnabled(true);
         m_gainSlider->setEnabled(true);
-        m_roiXSpinBox->setEnabled(false);
-        m_roiYSpinBox->setEnabled(false);
-        m_roiWidthSpinBox->setEnabled(false);
-        m_roiHeightSpinBox->setEnabled(false);
-        m_setROIButton->setEnabled(false);
-        m_resetROIButton->setEnabled(false);
+        m_roiXSpinBox->setEnabled(roiEditable);
+        m_roiYSpinBox->setEnabled(roiEditable);
+        m_roiWidthSpinBox->setEnabled(roiEditable);
+        m_roiHeightSpinBox->setEnabled(roiEditable);
+        m_setROIButton->setEnabled(roiEditable);
+        m_resetROIButton->setEnabled(roiEditable);
     } else {
         // 未采集时:所有参数都可以调整(前提是已连接)
         m_parameterGroup->setEnabled(isConnected);
     }
-}
 
-void MainWindow::logMessage(const QString &msg, bool isError)
-{
-    QString timestamp = QDateTime::currentDateTime().toString("hh:mm:ss");
-    QString coloredMsg;
+    // 自动曝光运行时曝光/增益由控制器接管
+    m_autoExposureCheckBox->setEnabled(isConnected);
+    if (!isConnected && m_autoExposureCheckBox->isChecked()) {
+        m_autoExposureCheckBox->blockSignals(true);
+        m_autoExposureCheckBox->setChecked(false);
+        m_autoExposureCheckBox->blockSignals(false);
+    }
+    const bool autoExposure = m_cameraController->autoExposureController()->isEnabled();
+    m_exposureSpinBox->setEnabled(!autoExposure && !isAcquiring);
+    m_exposureSlider->setEnabled(!autoExposure && !isAcquiring);
+    m_gainSpinBox->setEnabled(!autoExposure);
+    m_gainSlider->setEnabled(!autoExposure);
+
+    // 连拍：采集中才能开始，完成后可回看/保存，保存期间内存不可释放
+    BurstRecorder *recorder = m_cameraController->burstRecorder();
+    const bool burstArmed = recorder->isArmed();
+    const bool burstReady = recorder->state() == BurstRecorder::State::Complete && recorder->capturedFrames() > 0;
+    const bool saving = recorder->isSaving();
+    m_burstStartButton->setEnabled(isAcquiring && !saving);
+    m_burstFramesSpinBox->setEnabled(!burstArmed);
+    m_burstMaxRateCheckBox->setEnabled(!burstArmed);
+    m_burstReviewCheckBox->setEnabled(burstReady);
+    m_burstReviewSlider->setEnabled(burstReady);
+    m_burstSaveButton->setEnabled(burstReady && !saving);
+    m_burstReleaseButton->setEnabled(!burstArmed && !saving && recorder->state() != BurstRecorder::State::Idle);
+
+    // 参数序列只能在未采集时切换；序列运行时曝光/增益由序列接管
+    const bool sequenceActive = m_cameraController->parameterSequencer().isActive();
+    m_sequenceStepsSpinBox->setEnabled(isConnected && !isAcquiring);
+    m_sequenceRatioSpinBox->setEnabled(isConnected && !isAcquiring);
+    m_sequenceHardwareCheckBox->setEnabled(isConnected && !isAcquiring);
+    m_sequenceApplyButton->setEnabled(isConnected && !isAcquiring);
+    if (!isConnected) {
+        m_sequenceStatusLabel->setText("参数序列: 关闭");
+    }
+    if (sequenceActive) {
+        m_exposureSpinBox->setEnabled(false);
+        m_exposureSlider->setEnabled(false);
+        m_gainSpinBox->setEnabled(false);
+        m_gainSlider->setEnabled(false);
+    }
 
-    if (isError) {
-        coloredMsg = QString("<font color='red'>[%1] %2</font>").arg(timestamp, msg);
-    } else {
-        coloredMsg = QString("<font color='black'>[%1] %2</font>").arg(timestamp, msg);
+    // 实时性选项在开始采集时生效，采集中不可修改
+    if (m_realtimeGroup) {
+        m_realtimeCheckBox->setEnabled(!isAcquiring);
+        m_realtimePrioritySpinBox->setEnabled(!isAcquiring);
+        m_captureCpuSpinBox->setEnabled(!isAcquiring);
+        m_streamCpuSpinBox->setEnabled(!isAcquiring);
+        m_lockMemoryCheckBox->setEnabled(!isAcquiring);
+        m_prefaultCheckBox->setEnabled(!isAcquiring);
     }
 
-    m_statusTextEdit->append(coloredMsg);
+    // USB 模式和最大传输大小在创建流时生效；带宽限制采集中也可修改
+    if (m_transferGroup) {
+        const bool usb3 = isConnected && m_cameraController->isUsb3Device();
+        m_usbModeComboBox->setEnabled(usb3 && !isAcquiring);
+        m_maxTransferSpinBox->setEnabled(usb3 && !isAcquiring);
+        m_throughputApplyButton->setEnabled(usb3);
+    }
+}
 
-    // 自动滚动到底部
-    QTextCursor cursor = m_statusTextEdit->textCursor();
-    cursor.movePosition(QTextCursor::End);
-    m_statusTextEdit->setTextCursor(cursor);
+void MainWindow::logMessage(const QString &msg, bool isError)
+{
+    // 用户向上翻看时不打断；一批消息只在事件循环回来后滚动一次
+    const QScrollBar *scrollBar = m_logView->verticalScrollBar();
+    const bool atBottom = scrollBar->value() >= scrollBar->maximum();
+
+    m_logModel->append(msg, isError);
+
+    if (atBottom && !m_logScrollPending) {
+        m_logScrollPending = true;
+        QTimer::singleShot(0, this, [this]() {
+            m_logScrollPending = false;
+            m_logView->scrollToBottom();
+        });
+    }
 }
@@ -0,0 +1,290 @@
+#include "ParameterSequencer.h"
+#include <QDebug>
+#include <QStringList>
+#include <algorithm>
+#include <cmath>
+
+// 解决 Qt 和 GLib 的宏冲突
+#ifdef signals
+#undef signals
+#endif
+
+#include <arv.h>
+
+// 恢复 Qt 的 signals 宏
+#define signals Q_SIGNALS
+
+ParameterSequencer::~ParameterSequencer() = default;
+
+bool ParameterSequencer::configure(ArvCamera *camera, const Settings &settings, QString *error)
+{
+    if (m_mode != Mode::Off) {
+        disable(camera);
+    }
+
+    m_settings = settings;
+    if (m_settings.steps.size() > static_cast<size_t>(MAX_STEPS)) {
+        m_settings.steps.resize(MAX_STEPS);
+    }
+    m_settings.latencyFrames = std::clamp(m_settings.latencyFrames, 0, 16);
+    reset();
+
+    if (m_settings.steps.size() < 2) {
+        return true;
+    }
+
+    // 序列接管曝光和增益，关闭相机内置的自动模式（不支持时忽略）
+    arv_camera_set_exposure_time_auto(camera, ARV_AUTO_OFF, nullptr);
+    arv_camera_set_gain_auto(camera, ARV_AUTO_OFF, nullptr);
+
+    if (m_settings.allowHardware && arv_camera_is_feature_available(camera, "SequencerMode", nullptr)) {
+        GError *gerror = nullptr;
+        QString failedAt;
+        auto check = [&](const char *what) {
+            if (gerror && failedAt.isEmpty()) {
+                failedAt = QString("%1: %2").arg(what, QString::fromUtf8(gerror->message));
+            }
+            if (gerror) {
+                g_error_free(gerror);
+                gerror = nullptr;
+            }
+            return failedAt.isEmpty();
+        };
+
+        arv_camera_set_string(camera, "SequencerMode", "Off", &gerror);
+        check("SequencerMode");
+        arv_camera_set_string(camera, "SequencerConfigurationMode", "On", &gerror);
+        check("SequencerConfigurationMode");
+
+        const int count = static_cast<int>(m_settings.steps.size());
+        for (int i = 0; i < count && failedAt.isEmpty(); ++i) {
+            arv_camera_set_integer(camera, "SequencerSetSelector", i, &gerror);
+            check("SequencerSetSelector");
+            arv_camera_set_exposure_time(camera, m_settings.steps[i].exposureUs, &gerror);
+            check("ExposureTime");
+            arv_camera_set_gain(camera, m_settings.steps[i].gainDb, &gerror);
+            check("Gain");
+
+            // 只有一条路径的相机没有 SequencerPathSelector
+            arv_camera_set_integer(camera, "SequencerPathSelector", 0, nullptr);
+            arv_camera_set_integer(camera, "SequencerSetNext", (i + 1) % count, &gerror);
+            check("SequencerSetNext");
+            arv_camera_set_string(camera, "SequencerTriggerSource", "FrameStart", &gerror);
+            check("SequencerTriggerSource");
+            arv_camera_execute_command(camera, "SequencerSetSave", &gerror);
+            check("SequencerSetSave");
+        }
+
+        if (failedAt.isEmpty()) {
+            arv_camera_set_integer(camera, "SequencerSetStart", 0, &gerror);
+            check("SequencerSetStart");
+        }
+        arv_camera_set_string(camera, "SequencerConfigurationMode", "Off", failedAt.isEmpty() ? &gerror : nullptr);
+        check("SequencerConfigurationMode");
+        if (failedAt.isEmpty()) {
+            arv_camera_set_string(camera, "SequencerMode", "On", &gerror);
+            check("SequencerMode");
+        }
+
+        if (failedAt.isEmpty()) {
+            m_mode = Mode::Hardware;
+            return true;
+        }
+
+        arv_camera_set_string(camera, "SequencerMode", "Off", nullptr);
+        qWarning() << "硬件参数序列配置失败，改用软件写入:" << failedAt;
+    }
+
+    // 软件模式：先写入第一组，序列从第 0 帧开始
+    GError *gerror = nullptr;
+    arv_camera_set_exposure_time(camera, m_settings.steps[0].exposureUs, &gerror);
+    if (!gerror) {
+        arv_camera_set_gain(camera, m_settings.steps[0].gainDb, &gerror);
+    }
+    if (gerror) {
+        if (error) {
+            *error = QString("参数序列配置失败: %1").arg(QString::fromUtf8(gerror->message));
+        }
+        g_error_free(gerror);
+        return false;
+    }
+
+    m_mode = Mode::Software;
+    return true;
+}
+
+void ParameterSequencer::disable(ArvCamera *camera)
+{
+    if (m_mode == Mode::Off) {
+        return;
+    }
+
+    if (camera) {
+        if (m_mode == Mode::Hardware) {
+            GError *error = nullptr;
+            arv_camera_set_string(camera, "SequencerMode", "Off", &error);
+            if (error) {
+                qWarning() << "关闭 SequencerMode 失败:" << error->message;
+                g_error_free(error);
+            }
+        }
+        arv_camera_set_exposure_time(camera, m_settings.steps[0].exposureUs, nullptr);
+        arv_camera_set_gain(camera, m_settings.steps[0].gainDb, nullptr);
+    }
+
+    m_mode = Mode::Off;
+}
+
+ParameterSequencer::Mode ParameterSequencer::mode() const
+{
+    return m_mode;
+}
+
+bool ParameterSequencer::isActive() const
+{
+    return m_mode != Mode::Off;
+}
+
+ParameterSequencer::Settings ParameterSequencer::settings() const
+{
+    return m_settings;
+}
+
+QString ParameterSequencer::describe() const
+{
+    if (m_mode == Mode::Off) {
+        return "参数序列: 关闭";
+    }
+
+    QStringList steps;
+    for (const Step &step : m_settings.steps) {
+        steps << QString("%1μs/%2dB").arg(step.exposureUs, 0, 'f', 0).arg(step.gainDb, 0, 'f', 1);
+    }
+    const QString mode = m_mode == Mode::Hardware
+                             ? QString("相机 SequencerMode")
+                             : QString("软件流水线写入, 提前 %1 帧").arg(m_settings.latencyFrames);
+    return QString("参数序列 %1 组 (%2): %3").arg(m_settings.steps.size()).arg(mode, steps.join(", "));
+}
+
+void ParameterSequencer::reset()
+{
+    m_started = false;
+    m_lastFrameId = 0;
+    m_frameIndex = 0;
+    m_scheduled.fill(0);
+    m_tagged = 0;
+    m_untagged = 0;
+    m_corrected = 0;
+    m_overruns = 0;
+}
+
+std::optional<ParameterSequencer::WriteRequest> ParameterSequencer::tag(Frame &frame)
+{
+    frame.sequence = FrameSequenceTag{};
+    if (m_mode == Mode::Off) {
+        return std::nullopt;
+    }
+
+    // 帧号回绕或重置时按连续处理
+    if (!m_started) {
+        m_started = true;
+        m_frameIndex = 0;
+    } else {
+        m_frameIndex += frame.frameId > m_lastFrameId ? frame.frameId - m_lastFrameId : 1;
+    }
+    m_lastFrameId = frame.frameId;
+
+    const uint64_t index = m_frameIndex;
+    const uint64_t count = m_settings.steps.size();
+    const uint64_t latency = static_cast<uint64_t>(m_settings.latencyFrames);
+
+    // 按帧序号推算的参数组：硬件模式下相机每帧切换；软件模式下起始的 latency 帧
+    // 仍是第一组参数，之后只有按时请求过写入的帧可以确定
+    int step = static_cast<int>(index % count);
+    if (m_mode == Mode::Software) {
+        const bool known = index < latency ? step == 0 : m_scheduled[index & 63] == index + 1;
+        if (!known) {
+            step = -1;
+        }
+    }
+
+    const int matched = matchStep(frame.chunk);
+    if (matched >= 0) {
+        if (step >= 0 && matched != step) {
+            m_corrected.fetch_add(1, std::memory_order_relaxed);
+        }
+        step = matched;
+    } else if (frame.chunk.has(FrameChunkData::ExposureTime)) {
+        // 块数据中的曝光不属于任何一组（如写入尚未生效）
+        step = -1;
+    }
+
+    // 序列运行期间 stepCount 始终有效，step 为 -1 表示这一帧的参数组无法确定
+    frame.sequence.stepCount = static_cast<int>(count);
+    if (step >= 0) {
+        const Step &params = m_settings.steps[step];
+        frame.sequence.step = step;
+        // 以本轮第一帧的序号计算轮次，块数据更正过的帧也能与同轮其他帧对齐
+        frame.sequence.cycle = (index >= static_cast<uint64_t>(step) ? index - step : 0) / count;
+        frame.sequence.exposureUs = frame.chunk.has(FrameChunkData::ExposureTime) ? frame.chunk.exposureUs
+                                                                                  : params.exposureUs;
+        frame.sequence.gainDb = frame.chunk.has(FrameChunkData::Gain) ? frame.chunk.gainDb : params.gainDb;
+        m_tagged.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        m_untagged.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (m_mode != Mode::Software) {
+        return std::nullopt;
+    }
+
+    WriteRequest request;
+    request.targetIndex = index + latency;
+    request.step = m_settings.steps[request.targetIndex % count];
+    m_scheduled[request.targetIndex & 63] = request.targetIndex + 1;
+    return request;
+}
+
+void ParameterSequencer::writeSuperseded(uint64_t targetIndex)
+{
+    if (m_scheduled[targetIndex & 63] == targetIndex + 1) {
+        m_scheduled[targetIndex & 63] = 0;
+    }
+    m_overruns.fetch_add(1, std::memory_order_relaxed);
+}
+
+ParameterSequencer::Counters ParameterSequencer::counters() const
+{
+    Counters counters;
+    counters.tagged = m_tagged.load(std::memory_order_relaxed);
+    counters.untagged = m_untagged.load(std::memory_order_relaxed);
+    counters.corrected = m_corrected.load(std::memory_order_relaxed);
+    counters.overruns = m_overruns.load(std::memory_order_relaxed);
+    return counters;
+}
+
+int ParameterSequencer::matchStep(const FrameChunkData &chunk) const
+{
+    if (!chunk.has(FrameChunkData::ExposureTime)) {
+        return -1;
+    }
+
+    // 相机会把曝光量化到行周期，按 1%（至少 2 μs）容差匹配，取最接近的一组
+    int best = -1;
+    double bestError = 0.0;
+    for (size_t i = 0; i < m_settings.steps.size(); ++i) {
+        const Step &step = m_settings.steps[i];
+        const double error = std::abs(chunk.exposureUs - step.exposureUs);
+        if (error > std::max(2.0, step.exposureUs * 0.01)) {
+            continue;
+        }
+        if (chunk.has(FrameChunkData::Gain) && std::abs(chunk.gainDb - step.gainDb) > 0.1) {
+            continue;
+        }
+        if (best < 0 || error < bestError) {
+            best = static_cast<int>(i);
+            bestError = error;
+        }
+    }
+    return best;
+}
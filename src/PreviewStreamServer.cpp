@@ -0,0 +1,519 @@
+#include "PreviewStreamServer.h"
+#include "DisplayConverter.h"
+#include <QBuffer>
+#include <QDebug>
+#include <QHostAddress>
+#include <QImage>
+#include <QMetaObject>
+#include <QStringList>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+#ifdef __linux__
+#include <time.h>
+#endif
+
+namespace {
+
+constexpr int MAX_REQUEST_BYTES = 8192;
+constexpr int UPGRADE_AFTER_FRAMES = 30;    // 连续无积压多少帧后升一档
+constexpr int DOWNGRADE_AFTER_DROPS = 2;    // 连续积压多少帧后降一档
+constexpr char BOUNDARY[] = "frame";
+
+int64_t steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+QByteArray httpResponse(const char *status, const char *contentType, const QByteArray &body)
+{
+    QByteArray response("HTTP/1.0 ");
+    response += status;
+    response += "\r\nContent-Type: ";
+    response += contentType;
+    response += "\r\nContent-Length: ";
+    response += QByteArray::number(body.size());
+    response += "\r\nCache-Control: no-cache\r\nConnection: close\r\n\r\n";
+    response += body;
+    return response;
+}
+
+const char VIEWER_PAGE[] =
+    "<!DOCTYPE html><html><head><meta charset=\"utf-8\"><title>相机预览</title></head>"
+    "<body style=\"margin:0;background:#222\">"
+    "<img src=\"/stream.mjpg\" style=\"max-width:100%;max-height:100vh;display:block;margin:auto\">"
+    "</body></html>";
+
+} // namespace
+
+PreviewStreamServer::PreviewStreamServer(QObject *parent)
+    : QObject(parent)
+    , m_server(new QTcpServer(this))
+    , m_statsTimer(new QTimer(this))
+{
+    connect(m_server, &QTcpServer::newConnection, this, &PreviewStreamServer::onNewConnection);
+    connect(m_statsTimer, &QTimer::timeout, this, &PreviewStreamServer::reportStatistics);
+}
+
+PreviewStreamServer::~PreviewStreamServer()
+{
+    stop();
+}
+
+bool PreviewStreamServer::start(const Settings &settings, QString *error)
+{
+    stop();
+
+    m_settings = settings;
+    m_settings.maxQualityLevel = std::clamp(m_settings.maxQualityLevel, 0, QUALITY_LEVELS - 1);
+    m_settings.clientBufferFrames = std::max(1, m_settings.clientBufferFrames);
+    m_maxFps = m_settings.maxFps;
+
+    const QHostAddress address = m_settings.loopbackOnly ? QHostAddress(QHostAddress::LocalHost)
+                                                         : QHostAddress(QHostAddress::Any);
+    if (!m_server->listen(address, m_settings.port)) {
+        if (error) {
+            *error = QString("远程预览服务启动失败: %1").arg(m_server->errorString());
+        }
+        return false;
+    }
+
+    startEncoder();
+    m_lastReportNs = 0;
+    m_statsTimer->start(1000);
+    qDebug() << "远程预览服务已启动: 端口" << m_server->serverPort() << (m_settings.loopbackOnly ? "(仅本机)" : "");
+    return true;
+}
+
+void PreviewStreamServer::stop()
+{
+    if (!m_server->isListening() && m_clients.empty()) {
+        return;
+    }
+
+    m_server->close();
+    m_statsTimer->stop();
+
+    // abort() 会同步发出 disconnected，先取出客户端列表
+    std::vector<Client> clients;
+    clients.swap(m_clients);
+    for (Client &client : clients) {
+        client.socket->disconnect(this);
+        client.socket->abort();
+        client.socket->deleteLater();
+    }
+    updateRequestedLevels();
+    stopEncoder();
+    qDebug() << "远程预览服务已停止";
+}
+
+bool PreviewStreamServer::isRunning() const
+{
+    return m_server->isListening();
+}
+
+PreviewStreamServer::Settings PreviewStreamServer::settings() const
+{
+    return m_settings;
+}
+
+quint16 PreviewStreamServer::serverPort() const
+{
+    return m_server->serverPort();
+}
+
+bool PreviewStreamServer::wantsFrames() const
+{
+    return m_wantsFrames.load(std::memory_order_relaxed);
+}
+
+void PreviewStreamServer::offer(const FramePtr &frame)
+{
+    if (!frame || !wantsFrames()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_encoderRunning) {
+            return;
+        }
+        m_pending = frame;
+    }
+    m_cond.notify_one();
+}
+
+// ========== 连接与请求（GUI 线程） ==========
+
+void PreviewStreamServer::onNewConnection()
+{
+    while (m_server->hasPendingConnections()) {
+        QTcpSocket *socket = m_server->nextPendingConnection();
+        if (static_cast<int>(m_clients.size()) >= MAX_CLIENTS) {
+            socket->write(httpResponse("503 Service Unavailable", "text/plain", "too many clients\n"));
+            socket->disconnectFromHost();
+            connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            continue;
+        }
+
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        Client client;
+        client.socket = socket;
+        client.peer = QString("%1:%2").arg(socket->peerAddress().toString()).arg(socket->peerPort());
+        client.level = m_settings.maxQualityLevel;
+        m_clients.push_back(client);
+
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() { onDisconnected(socket); });
+    }
+}
+
+void PreviewStreamServer::onReadyRead(QTcpSocket *socket)
+{
+    Client *client = findClient(socket);
+    if (!client) {
+        return;
+    }
+
+    const QByteArray data = socket->readAll();
+    if (client->streaming || client->snapshot) {
+        return;     // 响应已开始，忽略后续输入
+    }
+
+    client->request += data;
+    if (client->request.indexOf("\r\n\r\n") >= 0) {
+        handleRequest(*client);
+    } else if (client->request.size() > MAX_REQUEST_BYTES) {
+        socket->write(httpResponse("400 Bad Request", "text/plain", "request too large\n"));
+        socket->disconnectFromHost();
+    }
+}
+
+void PreviewStreamServer::onDisconnected(QTcpSocket *socket)
+{
+    auto it = std::find_if(m_clients.begin(), m_clients.end(),
+                           [socket](const Client &client) { return client.socket == socket; });
+    if (it == m_clients.end()) {
+        return;
+    }
+
+    const bool streaming = it->streaming;
+    const QString peer = it->peer;
+    m_clients.erase(it);
+    socket->deleteLater();
+    updateRequestedLevels();
+
+    if (streaming) {
+        emit clientDisconnected(peer);
+    }
+}
+
+PreviewStreamServer::Client *PreviewStreamServer::findClient(QTcpSocket *socket)
+{
+    for (Client &client : m_clients) {
+        if (client.socket == socket) {
+            return &client;
+        }
+    }
+    return nullptr;
+}
+
+void PreviewStreamServer::handleRequest(Client &client)
+{
+    // 只看请求行："GET /path?query HTTP/1.1"。disconnectFromHost() 可能同步移除客户端，之后不再访问 client
+    const QByteArray request = client.request;
+    client.request.clear();
+    const QList<QByteArray> parts = request.left(request.indexOf("\r\n")).split(' ');
+    QByteArray path = parts.size() >= 2 ? parts[1] : QByteArray();
+    const int query = path.indexOf('?');
+    if (query >= 0) {
+        path = path.left(query);
+    }
+
+    QTcpSocket *socket = client.socket;
+    if (parts.size() < 2 || parts[0] != "GET") {
+        socket->write(httpResponse("405 Method Not Allowed", "text/plain", "GET only\n"));
+        socket->disconnectFromHost();
+    } else if (path == "/") {
+        socket->write(httpResponse("200 OK", "text/html; charset=utf-8", VIEWER_PAGE));
+        socket->disconnectFromHost();
+    } else if (path == "/stream.mjpg") {
+        QByteArray header("HTTP/1.0 200 OK\r\nContent-Type: multipart/x-mixed-replace; boundary=");
+        header += BOUNDARY;
+        header += "\r\nCache-Control: no-cache\r\nConnection: close\r\n\r\n";
+        socket->write(header);
+        client.streaming = true;
+        updateRequestedLevels();
+        emit clientConnected(client.peer);
+    } else if (path == "/snapshot.jpg") {
+        client.snapshot = true;
+        updateRequestedLevels();
+    } else {
+        socket->write(httpResponse("404 Not Found", "text/plain", "not found\n"));
+        socket->disconnectFromHost();
+    }
+}
+
+void PreviewStreamServer::deliver(const EncodedFrame &frame)
+{
+    // 编码期间客户端可能已换档，取最接近且已编码的质量
+    auto pick = [&frame](int level) -> const QByteArray * {
+        for (int distance = 0; distance < QUALITY_LEVELS; ++distance) {
+            if (level - distance >= 0 && !frame.jpeg[level - distance].isEmpty()) {
+                return &frame.jpeg[level - distance];
+            }
+            if (level + distance < QUALITY_LEVELS && !frame.jpeg[level + distance].isEmpty()) {
+                return &frame.jpeg[level + distance];
+            }
+        }
+        return nullptr;
+    };
+
+    bool levelsChanged = false;
+    std::vector<QTcpSocket*> finished;
+    for (Client &client : m_clients) {
+        if (!client.streaming && !client.snapshot) {
+            continue;
+        }
+        const QByteArray *jpeg = pick(client.level);
+        if (!jpeg) {
+            continue;
+        }
+
+        if (client.snapshot) {
+            const QByteArray response = httpResponse("200 OK", "image/jpeg", *jpeg);
+            client.socket->write(response);
+            m_sentBytes += response.size();
+            client.snapshot = false;
+            finished.push_back(client.socket);
+            levelsChanged = true;
+            continue;
+        }
+
+        // 套接字还积压着超过 clientBufferFrames 帧：跳过这一帧，连续积压时降低质量
+        const qint64 pending = client.socket->bytesToWrite();
+        const qint64 budget = m_settings.clientBufferFrames * std::max<qint64>(client.lastFrameBytes, jpeg->size());
+        if (pending > budget) {
+            m_clientDrops++;
+            client.clean = 0;
+            if (++client.congested >= DOWNGRADE_AFTER_DROPS && client.level > 0) {
+                client.level--;
+                client.congested = 0;
+                levelsChanged = true;
+            }
+            continue;
+        }
+
+        QByteArray part("--");
+        part += BOUNDARY;
+        part += "\r\nContent-Type: image/jpeg\r\nContent-Length: ";
+        part += QByteArray::number(jpeg->size());
+        part += "\r\n\r\n";
+        part += *jpeg;
+        part += "\r\n";
+        client.socket->write(part);
+        m_sentBytes += part.size();
+        client.lastFrameBytes = part.size();
+        client.congested = 0;
+
+        if (pending == 0 && ++client.clean >= UPGRADE_AFTER_FRAMES && client.level < m_settings.maxQualityLevel) {
+            client.level++;
+            client.clean = 0;
+            levelsChanged = true;
+        }
+    }
+
+    if (levelsChanged) {
+        updateRequestedLevels();
+    }
+    for (QTcpSocket *socket : finished) {
+        socket->disconnectFromHost();
+    }
+}
+
+void PreviewStreamServer::updateRequestedLevels()
+{
+    unsigned levels = 0;
+    for (const Client &client : m_clients) {
+        if (client.streaming || client.snapshot) {
+            levels |= 1u << client.level;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_requestedLevels = levels;
+        if (levels == 0) {
+            m_pending.reset();
+        }
+    }
+    m_wantsFrames = levels != 0;
+}
+
+void PreviewStreamServer::reportStatistics()
+{
+    const int64_t now = steadyNowNs();
+    const uint64_t encoded = m_encodedFrames.load(std::memory_order_relaxed);
+    const uint64_t encodeNs = m_encodeNs.load(std::memory_order_relaxed);
+    const uint64_t cpuNs = m_encoderCpuNs.load(std::memory_order_relaxed);
+
+    if (m_lastReportNs > 0) {
+        const double seconds = (now - m_lastReportNs) / 1e9;
+        Statistics stats;
+        QStringList levels;
+        for (const Client &client : m_clients) {
+            if (client.streaming) {
+                stats.clients++;
+                levels << QString::number(QUALITY[client.level]);
+            }
+        }
+        stats.clientLevels = levels.join(",");
+        stats.encodedFps = (encoded - m_lastEncodedFrames) / seconds;
+        if (encoded > m_lastEncodedFrames) {
+            stats.encodeMsPerFrame = (encodeNs - m_lastEncodeNs) / 1e6 / (encoded - m_lastEncodedFrames);
+        }
+        stats.encoderCpuPercent = (cpuNs - m_lastEncoderCpuNs) / 1e9 / seconds * 100.0;
+        stats.sendMegabitsPerSecond = (m_sentBytes - m_lastSentBytes) * 8.0 / 1e6 / seconds;
+        stats.clientDrops = m_clientDrops;
+        emit statisticsUpdated(stats);
+    }
+
+    m_lastReportNs = now;
+    m_lastEncodedFrames = encoded;
+    m_lastEncodeNs = encodeNs;
+    m_lastEncoderCpuNs = cpuNs;
+    m_lastSentBytes = m_sentBytes;
+}
+
+// ========== 编码线程 ==========
+
+void PreviewStreamServer::startEncoder()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_encoderRunning) {
+        return;
+    }
+    m_encoderRunning = true;
+    m_pending.reset();
+    m_encoded.reset();
+    m_encoderThread = std::thread(&PreviewStreamServer::encoderLoop, this);
+}
+
+void PreviewStreamServer::stopEncoder()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_encoderRunning = false;
+        m_pending.reset();
+    }
+    m_cond.notify_one();
+
+    if (m_encoderThread.joinable()) {
+        m_encoderThread.join();
+    }
+}
+
+void PreviewStreamServer::encoderLoop()
+{
+    std::vector<uint8_t> scratch;
+    int64_t lastEncodeNs = 0;
+
+    while (true) {
+        FramePtr frame;
+        unsigned levels = 0;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cond.wait(lock, [this]() { return !m_encoderRunning || m_pending; });
+
+            // 限速：距上次编码不足 1/maxFps 时继续等待，期间到达的新帧替换旧帧
+            const double maxFps = m_maxFps.load(std::memory_order_relaxed);
+            if (m_encoderRunning && maxFps > 0.0 && lastEncodeNs > 0) {
+                const auto due = std::chrono::steady_clock::time_point(
+                    std::chrono::nanoseconds(lastEncodeNs + static_cast<int64_t>(1e9 / maxFps)));
+                m_cond.wait_until(lock, due, [this]() { return !m_encoderRunning; });
+            }
+            if (!m_encoderRunning) {
+                break;
+            }
+            frame = std::move(m_pending);
+            m_pending.reset();
+            levels = m_requestedLevels;
+        }
+        if (!frame || levels == 0) {
+            continue;
+        }
+
+        lastEncodeNs = steadyNowNs();
+        const int64_t cpuStart = threadCpuNs();
+
+        auto encoded = std::make_shared<EncodedFrame>();
+        encoded->frameId = frame->frameId;
+        for (int level = 0; level < QUALITY_LEVELS; ++level) {
+            if (levels & (1u << level)) {
+                encoded->jpeg[level] = encode(*frame, QUALITY[level], scratch);
+            }
+        }
+
+        m_encodeNs.fetch_add(steadyNowNs() - lastEncodeNs, std::memory_order_relaxed);
+        m_encoderCpuNs.fetch_add(threadCpuNs() - cpuStart, std::memory_order_relaxed);
+        m_encodedFrames.fetch_add(1, std::memory_order_relaxed);
+
+        // GUI 线程还没发出上一帧时只替换它，不堆积投递
+        bool post = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            post = !m_encoded;
+            m_encoded = std::move(encoded);
+        }
+        if (post) {
+            QMetaObject::invokeMethod(this, [this]() {
+                std::shared_ptr<EncodedFrame> latest;
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    latest = std::move(m_encoded);
+                    m_encoded.reset();
+                }
+                if (latest) {
+                    deliver(*latest);
+                }
+            }, Qt::QueuedConnection);
+        }
+    }
+}
+
+QByteArray PreviewStreamServer::encode(const Frame &frame, int quality, std::vector<uint8_t> &scratch)
+{
+    const uint8_t *pixels = frame.bits();
+    int stride = frame.stride();
+    if (frame.bitDepth != 8) {
+        scratch.resize(static_cast<size_t>(frame.width) * frame.height);
+        DisplayConverter::toGray8(frame, scratch.data(), frame.width);
+        pixels = scratch.data();
+        stride = frame.width;
+    }
+
+    const QImage image(pixels, frame.width, frame.height, stride, QImage::Format_Grayscale8);
+    QByteArray jpeg;
+    QBuffer buffer(&jpeg);
+    buffer.open(QIODevice::WriteOnly);
+    if (!image.save(&buffer, "JPEG", quality)) {
+        return QByteArray();
+    }
+    return jpeg;
+}
+
+int64_t PreviewStreamServer::threadCpuNs()
+{
+#ifdef __linux__
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+#endif
+    // 没有线程 CPU 时钟时以编码耗时近似
+    return steadyNowNs();
+}
@@ -0,0 +1,128 @@
+#include "RealtimeTuning.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+QString errnoText(int error)
+{
+    return QString::fromLocal8Bit(std::strerror(error));
+}
+
+} // namespace
+
+bool RealtimeTuning::setCurrentThreadRealtime(int priority, QString *error)
+{
+#ifdef __linux__
+    const int minPriority = sched_get_priority_min(SCHED_FIFO);
+    const int maxPriority = sched_get_priority_max(SCHED_FIFO);
+    sched_param param = {};
+    param.sched_priority = priority < minPriority ? minPriority : (priority > maxPriority ? maxPriority : priority);
+
+    const int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (result != 0) {
+        if (error) {
+            *error = QString("SCHED_FIFO 设置失败: %1").arg(errnoText(result));
+        }
+        return false;
+    }
+    return true;
+#else
+    (void)priority;
+    if (error) {
+        *error = "当前平台不支持 SCHED_FIFO";
+    }
+    return false;
+#endif
+}
+
+bool RealtimeTuning::setCurrentThreadAffinity(int cpu, QString *error)
+{
+#ifdef __linux__
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        if (error) {
+            *error = QString("CPU 编号无效: %1").arg(cpu);
+        }
+        return false;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    const int result = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (result != 0) {
+        if (error) {
+            *error = QString("绑定 CPU %1 失败: %2").arg(cpu).arg(errnoText(result));
+        }
+        return false;
+    }
+    return true;
+#else
+    (void)cpu;
+    if (error) {
+        *error = "当前平台不支持设置 CPU 亲和性";
+    }
+    return false;
+#endif
+}
+
+bool RealtimeTuning::lockMemory(QString *error)
+{
+#ifdef __linux__
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        if (error) {
+            *error = QString("mlockall 失败: %1").arg(errnoText(errno));
+        }
+        return false;
+    }
+    return true;
+#else
+    if (error) {
+        *error = "当前平台不支持 mlockall";
+    }
+    return false;
+#endif
+}
+
+void RealtimeTuning::unlockMemory()
+{
+#ifdef __linux__
+    munlockall();
+#endif
+}
+
+void RealtimeTuning::prefault(void *data, size_t size)
+{
+    if (!data || size == 0) {
+        return;
+    }
+
+#ifdef __linux__
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    const size_t step = pageSize > 0 ? static_cast<size_t>(pageSize) : 4096;
+#else
+    const size_t step = 4096;
+#endif
+
+    // volatile 写入避免被优化掉；缓冲区随后会被相机数据覆盖，写 0 即可
+    volatile uint8_t *bytes = static_cast<volatile uint8_t*>(data);
+    for (size_t offset = 0; offset < size; offset += step) {
+        bytes[offset] = 0;
+    }
+    bytes[size - 1] = 0;
+}
+
+int RealtimeTuning::cpuCount()
+{
+    const unsigned count = std::thread::hardware_concurrency();
+    return count > 0 ? static_cast<int>(count) : 1;
+}
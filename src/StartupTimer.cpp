@@ -0,0 +1,54 @@
+#include "StartupTimer.h"
+#include "TraceRecorder.h"
+#include <QString>
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace {
+
+const int64_t g_originNs = TraceRecorder::nowNs();
+
+std::mutex g_mutex;
+std::vector<std::pair<int64_t, const char *>> g_marks;     // 受 g_mutex 保护
+
+} // namespace
+
+bool StartupTimer::mark(const char *phase)
+{
+    const int64_t now = TraceRecorder::nowNs();
+    std::lock_guard<std::mutex> lock(g_mutex);
+    for (const auto &entry : g_marks) {
+        if (std::strcmp(entry.second, phase) == 0) {
+            return false;
+        }
+    }
+    g_marks.emplace_back(now, phase);
+    return true;
+}
+
+double StartupTimer::elapsedMs()
+{
+    return (TraceRecorder::nowNs() - g_originNs) / 1e6;
+}
+
+QStringList StartupTimer::report()
+{
+    std::vector<std::pair<int64_t, const char *>> marks;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        marks = g_marks;
+    }
+    std::sort(marks.begin(), marks.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+
+    QStringList lines;
+    int64_t previous = g_originNs;
+    for (const auto &entry : marks) {
+        lines << QString("+%1 ms  %2 (+%3 ms)").arg((entry.first - g_originNs) / 1e6, 7, 'f', 1)
+                     .arg(QString::fromUtf8(entry.second)).arg((entry.first - previous) / 1e6, 0, 'f', 1);
+        previous = entry.first;
+    }
+    return lines;
+}
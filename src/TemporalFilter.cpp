@@ -0,0 +1,383 @@
+#include "TemporalFilter.h"
+#include "Simd.h"
+#include "TileExecutor.h"
+#include <QDebug>
+#include <QMetaObject>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+namespace {
+
+int64_t steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// (acc + n/2) / n，用乘法代替除法；acc < 2^32 / n 时结果精确
+template <typename Acc, typename Out>
+void divideAccumulator(Out *out, const Acc *acc, size_t count, uint32_t n)
+{
+    const uint64_t reciprocal = ((uint64_t(1) << 32) + n - 1) / n;
+    const uint32_t half = n / 2;
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = static_cast<Out>(((static_cast<uint64_t>(acc[i]) + half) * reciprocal) >> 32);
+    }
+}
+
+} // namespace
+
+TemporalFilter::TemporalFilter(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void TemporalFilter::setMode(Mode mode)
+{
+    m_mode = mode;
+    ++m_settingsGeneration;
+}
+
+TemporalFilter::Mode TemporalFilter::mode() const
+{
+    return m_mode;
+}
+
+void TemporalFilter::setAverageFrames(int frames)
+{
+    m_averageFrames = std::clamp(frames, 1, MAX_AVERAGE_FRAMES);
+    ++m_settingsGeneration;
+}
+
+int TemporalFilter::averageFrames() const
+{
+    return m_averageFrames;
+}
+
+void TemporalFilter::setBackgroundShift(int shift)
+{
+    m_backgroundShift = std::clamp(shift, 1, 10);
+}
+
+void TemporalFilter::setChangeThreshold(int threshold)
+{
+    m_changeThreshold = std::max(threshold, 0);
+}
+
+const char *TemporalFilter::stageName() const
+{
+    return "Temporal";
+}
+
+FramePtr TemporalFilter::process(FramePtr frame)
+{
+    const Mode mode = m_mode;
+    if (mode == Mode::Off) {
+        if (m_width != 0) {
+            // 释放累加状态占用的内存
+            reset(Frame(), Mode::Off);
+        }
+        return frame;
+    }
+
+    if (m_appliedGeneration != m_settingsGeneration || frame->width != m_width ||
+        frame->height != m_height || frame->bitDepth != m_bitDepth) {
+        m_appliedGeneration = m_settingsGeneration;
+        reset(*frame, mode);
+    }
+
+    switch (mode) {
+    case Mode::Average:
+        return averageFrame(std::move(frame));
+    case Mode::Background:
+        return backgroundFrame(std::move(frame), false);
+    case Mode::Subtract:
+        return backgroundFrame(std::move(frame), true);
+    default:
+        return frame;
+    }
+}
+
+void TemporalFilter::reset(const Frame &frame, Mode mode)
+{
+    m_width = frame.width;
+    m_height = frame.height;
+    m_bitDepth = frame.bitDepth;
+
+    const size_t count = static_cast<size_t>(frame.width) * frame.height;
+    m_history.assign(mode == Mode::Average ? m_averageFrames.load() : 0, nullptr);
+    m_historyHead = 0;
+    m_historyCount = 0;
+
+    std::vector<uint16_t>().swap(m_accumulator16);
+    std::vector<uint32_t>().swap(m_accumulator32);
+    if (mode == Mode::Average) {
+        if (frame.bytesPerPixel() == 1) {
+            m_accumulator16.assign(count, 0);
+        } else {
+            m_accumulator32.assign(count, 0);
+        }
+    }
+
+    if (mode == Mode::Background || mode == Mode::Subtract) {
+        m_background.resize(count);
+    } else {
+        std::vector<int32_t>().swap(m_background);
+    }
+    m_backgroundValid = false;
+}
+
+FramePtr TemporalFilter::averageFrame(FramePtr frame)
+{
+    const size_t capacity = m_history.size();
+
+    // 历史已满时，新帧替换最旧帧：累加器加新减旧
+    FramePtr oldest;
+    if (m_historyCount == capacity) {
+        oldest = std::move(m_history[m_historyHead]);
+    } else {
+        ++m_historyCount;
+    }
+
+    FramePtr output = makeFrameLike(*frame);
+    const Frame *input = frame.get();
+    const Frame *removed = oldest.get();
+    Frame *target = output.get();
+    const uint32_t n = static_cast<uint32_t>(m_historyCount);
+    const size_t width = static_cast<size_t>(frame->width);
+
+    // 累加与求平均在同一行带内完成，数据仍在缓存中
+    TileExecutor &executor = TileExecutor::instance();
+    executor.parallelFor(frame->height, executor.autoGrain(frame->height, width * 8),
+                         [this, input, removed, target, n, width](size_t rowBegin, size_t rowEnd) {
+        const size_t offset = rowBegin * width;
+        const size_t count = (rowEnd - rowBegin) * width;
+        if (input->bytesPerPixel() == 1) {
+            uint16_t *acc = m_accumulator16.data() + offset;
+            accumulate8(acc, input->bits() + offset, removed ? removed->bits() + offset : nullptr, count);
+            divideAccumulator(target->bits() + offset, acc, count, n);
+        } else {
+            uint32_t *acc = m_accumulator32.data() + offset;
+            accumulate16(acc, input->bits16() + offset, removed ? removed->bits16() + offset : nullptr, count);
+            divideAccumulator(target->bits16() + offset, acc, count, n);
+        }
+    });
+
+    m_history[m_historyHead] = std::move(frame);
+    m_historyHead = (m_historyHead + 1) % capacity;
+    return output;
+}
+
+FramePtr TemporalFilter::backgroundFrame(FramePtr frame, bool subtract)
+{
+    const size_t width = static_cast<size_t>(frame->width);
+    const size_t count = width * frame->height;
+    const bool wide = frame->bytesPerPixel() == 2;
+
+    if (!m_backgroundValid) {
+        for (size_t i = 0; i < count; ++i) {
+            m_background[i] = static_cast<int32_t>(wide ? frame->bits16()[i] : frame->bits()[i]) << 8;
+        }
+        m_backgroundValid = true;
+    }
+
+    FramePtr output = makeFrameLike(*frame);
+    const Frame *input = frame.get();
+    Frame *target = output.get();
+    const int threshold = m_changeThreshold;
+    const int shift = m_backgroundShift;
+
+    TileExecutor &executor = TileExecutor::instance();
+    const size_t grain = executor.autoGrain(frame->height, width * 8);
+    std::vector<size_t> changedPerChunk(TileExecutor::chunkCount(frame->height, grain), 0);
+
+    executor.parallelFor(frame->height, grain, [&, input, target](size_t rowBegin, size_t rowEnd) {
+        const size_t begin = rowBegin * width;
+        const size_t end = rowEnd * width;
+        int32_t *background = m_background.data();
+        size_t changed = 0;
+
+        // Subtract 模式先与更新前的背景比较，避免当前帧自身被计入背景
+        for (size_t i = begin; i < end; ++i) {
+            const int32_t value = background[i] >> 8;
+            if (subtract) {
+                const int32_t pixel = wide ? input->bits16()[i] : input->bits()[i];
+                const int32_t diff = std::abs(pixel - value);
+                changed += diff > threshold;
+                if (wide) {
+                    target->bits16()[i] = static_cast<uint16_t>(diff);
+                } else {
+                    target->bits()[i] = static_cast<uint8_t>(diff);
+                }
+            } else if (wide) {
+                target->bits16()[i] = static_cast<uint16_t>(value);
+            } else {
+                target->bits()[i] = static_cast<uint8_t>(value);
+            }
+        }
+
+        if (wide) {
+            updateBackground16(background + begin, input->bits16() + begin, end - begin, shift);
+        } else {
+            updateBackground8(background + begin, input->bits() + begin, end - begin, shift);
+        }
+        changedPerChunk[rowBegin / grain] = changed;
+    });
+
+    if (subtract) {
+        const int64_t now = steadyNowNs();
+        if (now - m_lastReportNs >= 100'000'000) {
+            m_lastReportNs = now;
+            size_t changed = 0;
+            for (size_t n : changedPerChunk) {
+                changed += n;
+            }
+            const double percent = count ? 100.0 * changed / count : 0.0;
+            QMetaObject::invokeMethod(this, [this, percent]() {
+                emit changeMeasured(percent);
+            }, Qt::QueuedConnection);
+        }
+    }
+
+    return output;
+}
+
+void TemporalFilter::accumulate8(uint16_t *acc, const uint8_t *add, const uint8_t *sub, size_t count)
+{
+    size_t i = 0;
+
+    // 16 位累加器按模 2^16 运算，最终结果不超过 255 × 64，加减顺序不影响正确性
+#if defined(ARAVIS_HAS_AVX2)
+    for (; i + 16 <= count; i += 16) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
+        a = _mm256_add_epi16(a, _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(add + i))));
+        if (sub) {
+            a = _mm256_sub_epi16(a, _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(sub + i))));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + i), a);
+    }
+#elif defined(ARAVIS_HAS_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16) {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i + 8));
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(add + i));
+        lo = _mm_add_epi16(lo, _mm_unpacklo_epi8(v, zero));
+        hi = _mm_add_epi16(hi, _mm_unpackhi_epi8(v, zero));
+        if (sub) {
+            __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sub + i));
+            lo = _mm_sub_epi16(lo, _mm_unpacklo_epi8(s, zero));
+            hi = _mm_sub_epi16(hi, _mm_unpackhi_epi8(s, zero));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + i), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + i + 8), hi);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        acc[i] = static_cast<uint16_t>(acc[i] + add[i] - (sub ? sub[i] : 0));
+    }
+}
+
+void TemporalFilter::accumulate16(uint32_t *acc, const uint16_t *add, const uint16_t *sub, size_t count)
+{
+    size_t i = 0;
+
+#if defined(ARAVIS_HAS_AVX2)
+    for (; i + 8 <= count; i += 8) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
+        a = _mm256_add_epi32(a, _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(add + i))));
+        if (sub) {
+            a = _mm256_sub_epi32(a, _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(sub + i))));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + i), a);
+    }
+#elif defined(ARAVIS_HAS_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8) {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i + 4));
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(add + i));
+        lo = _mm_add_epi32(lo, _mm_unpacklo_epi16(v, zero));
+        hi = _mm_add_epi32(hi, _mm_unpackhi_epi16(v, zero));
+        if (sub) {
+            __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sub + i));
+            lo = _mm_sub_epi32(lo, _mm_unpacklo_epi16(s, zero));
+            hi = _mm_sub_epi32(hi, _mm_unpackhi_epi16(s, zero));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + i), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + i + 4), hi);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        acc[i] = acc[i] + add[i] - (sub ? sub[i] : 0);
+    }
+}
+
+void TemporalFilter::updateBackground8(int32_t *background, const uint8_t *pixels, size_t count, int shift)
+{
+    size_t i = 0;
+
+#if defined(ARAVIS_HAS_AVX2)
+    const __m128i shiftCount = _mm_cvtsi32_si128(shift);
+    for (; i + 8 <= count; i += 8) {
+        __m256i bg = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(background + i));
+        __m256i v = _mm256_slli_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixels + i))), 8);
+        bg = _mm256_add_epi32(bg, _mm256_sra_epi32(_mm256_sub_epi32(v, bg), shiftCount));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(background + i), bg);
+    }
+#elif defined(ARAVIS_HAS_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i shiftCount = _mm_cvtsi32_si128(shift);
+    for (; i + 8 <= count; i += 8) {
+        __m128i v16 = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixels + i)), zero);
+        __m128i vlo = _mm_slli_epi32(_mm_unpacklo_epi16(v16, zero), 8);
+        __m128i vhi = _mm_slli_epi32(_mm_unpackhi_epi16(v16, zero), 8);
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(background + i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(background + i + 4));
+        lo = _mm_add_epi32(lo, _mm_sra_epi32(_mm_sub_epi32(vlo, lo), shiftCount));
+        hi = _mm_add_epi32(hi, _mm_sra_epi32(_mm_sub_epi32(vhi, hi), shiftCount));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(background + i), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(background + i + 4), hi);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        background[i] += ((static_cast<int32_t>(pixels[i]) << 8) - background[i]) >> shift;
+    }
+}
+
+void TemporalFilter::updateBackground16(int32_t *background, const uint16_t *pixels, size_t count, int shift)
+{
+    size_t i = 0;
+
+#if defined(ARAVIS_HAS_AVX2)
+    const __m128i shiftCount = _mm_cvtsi32_si128(shift);
+    for (; i + 8 <= count; i += 8) {
+        __m256i bg = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(background + i));
+        __m256i v = _mm256_slli_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i))), 8);
+        bg = _mm256_add_epi32(bg, _mm256_sra_epi32(_mm256_sub_epi32(v, bg), shiftCount));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(background + i), bg);
+    }
+#elif defined(ARAVIS_HAS_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i shiftCount = _mm_cvtsi32_si128(shift);
+    for (; i + 8 <= count; i += 8) {
+        __m128i v16 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i));
+        __m128i vlo = _mm_slli_epi32(_mm_unpacklo_epi16(v16, zero), 8);
+        __m128i vhi = _mm_slli_epi32(_mm_unpackhi_epi16(v16, zero), 8);
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(background + i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(background + i + 4));
+        lo = _mm_add_epi32(lo, _mm_sra_epi32(_mm_sub_epi32(vlo, lo), shiftCount));
+        hi = _mm_add_epi32(hi, _mm_sra_epi32(_mm_sub_epi32(vhi, hi), shiftCount));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(background + i), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(background + i + 4), hi);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        background[i] += ((static_cast<int32_t>(pixels[i]) << 8) - background[i]) >> shift;
+    }
+}
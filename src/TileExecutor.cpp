@@ -0,0 +1,183 @@
+#include "TileExecutor.h"
+#include <QDebug>
+#include <algorithm>
+
+TileExecutor &TileExecutor::instance()
+{
+    static TileExecutor executor;
+    return executor;
+}
+
+TileExecutor::TileExecutor()
+{
+    // 调用线程也参与执行，因此工作线程比核心数少一个
+    const int hardwareThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const int workers = std::max(hardwareThreads - 1, 0);
+
+    for (int i = 0; i < workers; ++i) {
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (int i = 0; i < workers; ++i) {
+        m_threads.emplace_back(&TileExecutor::workerLoop, this, i);
+    }
+
+    qDebug() << "分块并行执行器启动, 工作线程数:" << workers;
+}
+
+TileExecutor::~TileExecutor()
+{
+    m_running = false;
+    m_workEvent.fetch_add(1, std::memory_order_release);
+    m_workEvent.notify_all();
+
+    for (auto &thread : m_threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+int TileExecutor::threadCount() const
+{
+    return activeWorkers() + 1;
+}
+
+void TileExecutor::setThreadLimit(int threads)
+{
+    m_threadLimit = std::max(threads, 0);
+}
+
+int TileExecutor::threadLimit() const
+{
+    return m_threadLimit;
+}
+
+int TileExecutor::activeWorkers() const
+{
+    const int workers = static_cast<int>(m_queues.size());
+    const int limit = m_threadLimit.load(std::memory_order_relaxed);
+    return limit > 0 ? std::min(workers, limit - 1) : workers;
+}
+
+size_t TileExecutor::autoGrain(size_t count, size_t bytesPerItem) const
+{
+    // 整体不超过一个目标块时不切分
+    if (count == 0 || count * std::max<size_t>(bytesPerItem, 1) <= CHUNK_TARGET_BYTES) {
+        return std::max<size_t>(count, 1);
+    }
+
+    const size_t byCache = std::max<size_t>(1, CHUNK_TARGET_BYTES / std::max<size_t>(bytesPerItem, 1));
+    const size_t chunksWanted = static_cast<size_t>(threadCount()) * CHUNKS_PER_THREAD;
+    const size_t byBalance = std::max<size_t>(1, (count + chunksWanted - 1) / chunksWanted);
+
+    // 负载均衡优先于缓存大小，但块不能小到让调度开销占主导（至少 1/4 个目标块）
+    const size_t minimum = std::max<size_t>(1, byCache / 4);
+    return std::max(std::min(byCache, byBalance), std::min(minimum, count));
+}
+
+void TileExecutor::parallelFor(size_t count, size_t grain, const RangeFunction &fn)
+{
+    if (count == 0) {
+        return;
+    }
+    grain = std::max<size_t>(grain, 1);
+
+    const size_t chunks = chunkCount(count, grain);
+    const int workers = activeWorkers();
+    if (chunks == 1 || workers == 0) {
+        fn(0, count);
+        return;
+    }
+
+    auto job = std::make_shared<Job>();
+    job->fn = &fn;
+    job->remaining = chunks;
+
+    // 第一块留给调用线程，其余轮流分配到各工作线程的本地队列
+    size_t queueIndex = m_nextQueue.fetch_add(1, std::memory_order_relaxed);
+    for (size_t begin = grain; begin < count; begin += grain) {
+        WorkerQueue &queue = *m_queues[queueIndex++ % static_cast<size_t>(workers)];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(Task{job, begin, std::min(begin + grain, count)});
+    }
+    m_workEvent.fetch_add(1, std::memory_order_release);
+    m_workEvent.notify_all();
+
+    Task first{job, 0, std::min(grain, count)};
+    runTask(first);
+
+    // 帮助执行剩余任务（可能属于其他提交者），直到本任务组全部完成
+    while (job->remaining.load(std::memory_order_acquire) > 0) {
+        Task task;
+        if (steal(-1, task)) {
+            runTask(task);
+            continue;
+        }
+        const size_t remaining = job->remaining.load(std::memory_order_acquire);
+        if (remaining == 0) {
+            break;
+        }
+        job->remaining.wait(remaining, std::memory_order_acquire);
+    }
+}
+
+void TileExecutor::runTask(Task &task)
+{
+    (*task.job->fn)(task.begin, task.end);
+    if (task.job->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        task.job->remaining.notify_all();
+    }
+    task.job.reset();
+}
+
+bool TileExecutor::popLocal(int index, Task &task)
+{
+    WorkerQueue &queue = *m_queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    // 本地从尾部取（最近放入，缓存更热），窃取者从头部取
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool TileExecutor::steal(int thief, Task &task)
+{
+    const int count = static_cast<int>(m_queues.size());
+    const int start = thief >= 0 ? thief + 1 : 0;
+
+    // 遍历全部队列（包括超出线程限制的），保证限制调整时不会遗留任务
+    for (int offset = 0; offset < count; ++offset) {
+        const int victim = (start + offset) % count;
+        if (victim == thief) {
+            continue;
+        }
+        WorkerQueue &queue = *m_queues[victim];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void TileExecutor::workerLoop(int index)
+{
+    while (m_running.load(std::memory_order_acquire)) {
+        const uint32_t key = m_workEvent.load(std::memory_order_acquire);
+
+        if (index < activeWorkers()) {
+            Task task;
+            if (popLocal(index, task) || steal(index, task)) {
+                runTask(task);
+                continue;
+            }
+        }
+
+        m_workEvent.wait(key, std::memory_order_acquire);
+    }
+}
@@ -0,0 +1,194 @@
+#include "TraceRecorder.h"
+#include "AllocationTracker.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+
+namespace {
+
+constexpr uint32_t DEVICE_TID = 1;
+constexpr uint32_t FIRST_THREAD_TID = 2;
+
+} // namespace
+
+// 线程退出时归还缓冲区（数据保留到被复用为止）
+struct TraceRecorder::ThreadLease {
+    ~ThreadLease()
+    {
+        if (t_buffer) {
+            std::lock_guard<std::mutex> lock(instance().m_registryMutex);
+            t_buffer->inUse = false;
+        }
+    }
+};
+
+thread_local TraceRecorder::ThreadBuffer *TraceRecorder::t_buffer = nullptr;
+thread_local const char *TraceRecorder::t_threadName = nullptr;
+
+TraceRecorder &TraceRecorder::instance()
+{
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+void TraceRecorder::setEnabled(bool enabled)
+{
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void TraceRecorder::setThreadName(const char *name)
+{
+    t_threadName = name;
+    AllocationTracker::setThreadName(name);
+
+    // 缓冲区已存在时同步更新（导出在锁内读取名称）
+    if (t_buffer) {
+        std::lock_guard<std::mutex> lock(instance().m_registryMutex);
+        t_buffer->name = name;
+    }
+}
+
+int64_t TraceRecorder::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t TraceRecorder::fromRealtimeNs(int64_t realtimeNs)
+{
+    const int64_t steady = nowNs();
+    const int64_t realtime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    return realtimeNs - realtime + steady;
+}
+
+TraceRecorder::ThreadBuffer *TraceRecorder::threadBuffer()
+{
+    if (t_buffer) {
+        return t_buffer;
+    }
+
+    thread_local ThreadLease lease;
+    (void)lease;
+
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    ThreadBuffer *buffer = nullptr;
+    for (const auto &candidate : m_threads) {
+        if (!candidate->inUse) {
+            buffer = candidate.get();
+            buffer->clearedAt.store(buffer->head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            break;
+        }
+    }
+    if (!buffer) {
+        m_threads.push_back(std::make_shared<ThreadBuffer>());
+        buffer = m_threads.back().get();
+        buffer->tid = FIRST_THREAD_TID + static_cast<uint32_t>(m_threads.size() - 1);
+    }
+    buffer->inUse = true;
+    buffer->name = t_threadName ? t_threadName : "线程 " + std::to_string(buffer->tid);
+    t_buffer = buffer;
+    return t_buffer;
+}
+
+void TraceRecorder::record(const char *name, uint64_t frameId, int64_t beginNs, int64_t endNs, Track track)
+{
+    if (!isEnabled()) {
+        return;
+    }
+
+    ThreadBuffer *buffer = threadBuffer();
+    const uint64_t position = buffer->head.load(std::memory_order_relaxed);
+    Span &span = buffer->spans[position & (THREAD_CAPACITY - 1)];
+    span.name = name;
+    span.frameId = frameId;
+    span.beginNs = beginNs;
+    span.endNs = std::max(endNs, beginNs);
+    span.track = track;
+    buffer->head.store(position + 1, std::memory_order_release);
+}
+
+void TraceRecorder::clear()
+{
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    for (const auto &buffer : m_threads) {
+        buffer->clearedAt.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+bool TraceRecorder::exportChromeTrace(const QString &path, QString *error) const
+{
+    struct Snapshot {
+        std::vector<Span> spans;
+        std::string name;
+        uint32_t tid;
+    };
+
+    // 复制各线程现存的区间：复制后再读一次 head，期间可能被覆盖的槽位丢弃
+    std::vector<Snapshot> snapshots;
+    int64_t originNs = std::numeric_limits<int64_t>::max();
+    {
+        std::lock_guard<std::mutex> lock(m_registryMutex);
+        for (const auto &buffer : m_threads) {
+            Snapshot snapshot;
+            snapshot.name = buffer->name;
+            snapshot.tid = buffer->tid;
+
+            const uint64_t head = buffer->head.load(std::memory_order_acquire);
+            uint64_t begin = head > THREAD_CAPACITY ? head - THREAD_CAPACITY : 0;
+            begin = std::max(begin, buffer->clearedAt.load(std::memory_order_relaxed));
+            for (uint64_t i = begin; i < head; ++i) {
+                snapshot.spans.push_back(buffer->spans[i & (THREAD_CAPACITY - 1)]);
+            }
+
+            const uint64_t headAfter = buffer->head.load(std::memory_order_acquire);
+            if (headAfter > THREAD_CAPACITY && headAfter - THREAD_CAPACITY > begin) {
+                const size_t overwritten = std::min<uint64_t>(headAfter - THREAD_CAPACITY - begin,
+                                                              snapshot.spans.size());
+                snapshot.spans.erase(snapshot.spans.begin(), snapshot.spans.begin() + overwritten);
+            }
+
+            for (const Span &span : snapshot.spans) {
+                originNs = std::min(originNs, span.beginNs);
+            }
+            snapshots.push_back(std::move(snapshot));
+        }
+    }
+
+    const QByteArray localPath = path.toLocal8Bit();
+    FILE *file = std::fopen(localPath.constData(), "w");
+    if (!file) {
+        if (error) {
+            *error = QString("无法写入: %1").arg(path);
+        }
+        return false;
+    }
+
+    // ts/dur 单位为微秒，相对于最早的区间
+    std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    std::fprintf(file, "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"AravisCamera\"}},\n");
+    std::fprintf(file, "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"相机\"}}",
+                 DEVICE_TID);
+    for (const Snapshot &snapshot : snapshots) {
+        std::fprintf(file, ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                     snapshot.tid, snapshot.name.c_str());
+    }
+    for (const Snapshot &snapshot : snapshots) {
+        for (const Span &span : snapshot.spans) {
+            const uint32_t tid = span.track == Track::Device ? DEVICE_TID : snapshot.tid;
+            std::fprintf(file, ",\n{\"ph\":\"X\",\"cat\":\"frame\",\"name\":\"%s\",\"pid\":1,\"tid\":%u,"
+                               "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%llu}}",
+                         span.name, tid, (span.beginNs - originNs) / 1000.0,
+                         (span.endNs - span.beginNs) / 1000.0,
+                         static_cast<unsigned long long>(span.frameId));
+        }
+    }
+    std::fprintf(file, "\n]}\n");
+
+    const bool ok = std::fclose(file) == 0;
+    if (!ok && error) {
+        *error = QString("写入失败: %1").arg(path);
+    }
+    return ok;
+}
@@ -0,0 +1,130 @@
+#include "UsbTransferTuning.h"
+
+// 解决 Qt 和 GLib 的宏冲突
+#ifdef signals
+#undef signals
+#endif
+
+#include <arv.h>
+
+// 恢复 Qt 的 signals 宏
+#define signals Q_SIGNALS
+
+namespace {
+
+QString takeError(GError *&error)
+{
+    const QString message = QString::fromUtf8(error->message);
+    g_clear_error(&error);
+    return message;
+}
+
+} // namespace
+
+void UsbTransferTuning::apply(ArvCamera *camera, const UsbTransferOptions &options, QStringList &applied,
+                              QStringList &failed)
+{
+    if (options.mode != UsbTransferOptions::Mode::Default) {
+        arv_camera_uv_set_usb_mode(camera, options.mode == UsbTransferOptions::Mode::Sync
+                                               ? ARV_UV_USB_MODE_SYNC : ARV_UV_USB_MODE_ASYNC);
+        applied << QString("USB 模式 %1").arg(modeName(options.mode));
+    }
+
+    if (options.maximumTransferKB > 0) {
+        ArvDevice *device = arv_camera_get_device(camera);
+        if (device && g_object_class_find_property(G_OBJECT_GET_CLASS(device), "maximum-transfer-size")) {
+            g_object_set(device, "maximum-transfer-size", static_cast<guint>(options.maximumTransferKB) * 1024u,
+                         nullptr);
+            applied << QString("最大传输 %1 KB").arg(options.maximumTransferKB);
+        } else {
+            failed << "当前 Aravis 版本不支持设置最大传输大小";
+        }
+    }
+}
+
+bool UsbTransferTuning::setLinkThroughputLimit(ArvCamera *camera, uint64_t bytesPerSecond, QString *error)
+{
+    GError *gerror = nullptr;
+    if (!arv_camera_uv_is_bandwidth_control_available(camera, &gerror)) {
+        if (error) {
+            *error = gerror ? takeError(gerror) : QString("相机不支持 DeviceLinkThroughputLimit");
+        } else {
+            g_clear_error(&gerror);
+        }
+        return false;
+    }
+
+    // 0 时 Aravis 关闭 DeviceLinkThroughputLimitMode
+    arv_camera_uv_set_bandwidth(camera, static_cast<guint>(bytesPerSecond), &gerror);
+    if (gerror) {
+        const QString message = takeError(gerror);
+        if (error) {
+            *error = QString("设置链路带宽限制失败: %1").arg(message);
+        }
+        return false;
+    }
+    return true;
+}
+
+uint64_t UsbTransferTuning::linkThroughputLimit(ArvCamera *camera)
+{
+    GError *error = nullptr;
+    const guint bandwidth = arv_camera_uv_get_bandwidth(camera, &error);
+    if (error) {
+        g_clear_error(&error);
+        return 0;
+    }
+    return bandwidth;
+}
+
+bool UsbTransferTuning::linkThroughputLimitBounds(ArvCamera *camera, uint64_t &minimum, uint64_t &maximum)
+{
+    GError *error = nullptr;
+    if (!arv_camera_uv_is_bandwidth_control_available(camera, &error)) {
+        g_clear_error(&error);
+        return false;
+    }
+
+    guint min = 0, max = 0;
+    arv_camera_uv_get_bandwidth_bounds(camera, &min, &max, &error);
+    if (error) {
+        g_clear_error(&error);
+        return false;
+    }
+    minimum = min;
+    maximum = max;
+    return true;
+}
+
+QStringList UsbTransferTuning::streamInfo(ArvStream *stream)
+{
+    QStringList lines;
+    if (!stream) {
+        return lines;
+    }
+
+    const guint count = arv_stream_get_n_infos(stream);
+    for (guint i = 0; i < count; ++i) {
+        const QString name = QString::fromUtf8(arv_stream_get_info_name(stream, i));
+        const GType type = arv_stream_get_info_type(stream, i);
+        if (type == G_TYPE_UINT64) {
+            lines << QString("%1 = %2").arg(name).arg(static_cast<qulonglong>(arv_stream_get_info_uint64(stream, i)));
+        } else if (type == G_TYPE_DOUBLE) {
+            lines << QString("%1 = %2").arg(name).arg(arv_stream_get_info_double(stream, i), 0, 'g', 6);
+        }
+    }
+    return lines;
+}
+
+const char *UsbTransferTuning::modeName(UsbTransferOptions::Mode mode)
+{
+    switch (mode) {
+    case UsbTransferOptions::Mode::Sync:
+        return "同步";
+    case UsbTransferOptions::Mode::Async:
+        return "异步";
+    case UsbTransferOptions::Mode::Default:
+    default:
+        return "默认";
+    }
+}
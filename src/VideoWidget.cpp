@@ -1,5 +1,19 @@
 #include "VideoWidget.h"
+#include "TraceRecorder.h"
 #include <QPaintEvent>
+#include <QMouseEvent>
+#include <algorithm>
+#include <cmath>
+#include <optional>
+
+namespace {
+
+constexpr int OVERLAY_BINS = 256;
+constexpr int OVERLAY_WIDTH = 256;
+constexpr int OVERLAY_HEIGHT = 96;
+constexpr int OVERLAY_MARGIN = 8;
+
+} // namespace
 
 VideoWidget::VideoWidget(QWidget *parent)
     : QWidget(parent)
@@ -10,24 +24,164 @@ VideoWidget::VideoWidget(QWidget *parent)
     setStyleSheet("background-color: black;");
 }
 
-void VideoWidget::setFrame(const QImage &frame)
+void VideoWidget::setFrame(const QImage &frame, uint64_t frameId)
 {
     if (frame.isNull()) {
         return;
     }
 
     m_frame = frame;
+    m_frameId = frameId;
+    m_frameSetNs = TraceRecorder::instance().isEnabled() ? TraceRecorder::nowNs() : 0;
     update();
 }
 
 void VideoWidget::clear()
 {
     m_frame = QImage();
+    m_imageRect = QRect();
+    m_histogramCurve.clear();
+    m_statisticsText.clear();
+    update();
+}
+
+void VideoWidget::setStatistics(const FrameStatistics &stats)
+{
+    if (!stats.isValid()) {
+        return;
+    }
+
+    // 原始 bin 合并为 256 个显示 bin，对数纵轴避免饱和峰压扁其余分布
+    const int binsPerColumn = static_cast<int>(stats.histogram.size()) / OVERLAY_BINS;
+    double columns[OVERLAY_BINS] = {};
+    double peak = 0.0;
+    for (int i = 0; i < OVERLAY_BINS; ++i) {
+        uint64_t n = 0;
+        for (int j = 0; j < binsPerColumn; ++j) {
+            n += stats.histogram[i * binsPerColumn + j];
+        }
+        columns[i] = std::log1p(static_cast<double>(n));
+        peak = std::max(peak, columns[i]);
+    }
+
+    m_histogramCurve.resize(OVERLAY_BINS + 2);
+    m_histogramCurve[0] = QPointF(0.0, 0.0);
+    for (int i = 0; i < OVERLAY_BINS; ++i) {
+        m_histogramCurve[i + 1] = QPointF(static_cast<double>(i) / (OVERLAY_BINS - 1),
+                                          peak > 0.0 ? columns[i] / peak : 0.0);
+    }
+    m_histogramCurve[OVERLAY_BINS + 1] = QPointF(1.0, 0.0);
+
+    m_statisticsText = QString("最小 %1  最大 %2  均值 %3\n饱和 %4%  耗时 %5 μs")
+                           .arg(stats.minValue)
+                           .arg(stats.maxValue)
+                           .arg(stats.mean, 0, 'f', 1)
+                           .arg(stats.saturationPercent, 0, 'f', 2)
+                           .arg(stats.computeTimeUs, 0, 'f', 0);
+
+    if (m_overlayVisible) {
+        update();
+    }
+}
+
+void VideoWidget::setOverlayVisible(bool visible)
+{
+    m_overlayVisible = visible;
+    update();
+}
+
+bool VideoWidget::isOverlayVisible() const
+{
+    return m_overlayVisible;
+}
+
+QRect VideoWidget::selectedRegion() const
+{
+    return m_selectedRegion;
+}
+
+void VideoWidget::clearSelectedRegion()
+{
+    m_selectedRegion = QRect();
+    update();
+}
+
+void VideoWidget::mousePressEvent(QMouseEvent *event)
+{
+    if (m_imageRect.isEmpty()) {
+        return;
+    }
+
+    if (event->button() == Qt::RightButton) {
+        clearSelectedRegion();
+        emit regionSelected(QRect());
+        return;
+    }
+
+    if (event->button() == Qt::LeftButton && m_imageRect.contains(event->pos())) {
+        m_dragging = true;
+        m_dragStart = widgetToImage(event->pos());
+        m_selectedRegion = QRect(m_dragStart, QSize(1, 1));
+        update();
+    }
+}
+
+void VideoWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!m_dragging) {
+        return;
+    }
+
+    m_selectedRegion = QRect(m_dragStart, widgetToImage(event->pos())).normalized();
     update();
 }
 
+void VideoWidget::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (!m_dragging || event->button() != Qt::LeftButton) {
+        return;
+    }
+
+    m_dragging = false;
+    m_selectedRegion = QRect(m_dragStart, widgetToImage(event->pos())).normalized();
+
+    // 过小的框视为误触
+    if (m_selectedRegion.width() < 8 || m_selectedRegion.height() < 8) {
+        m_selectedRegion = QRect();
+    }
+
+    update();
+    emit regionSelected(m_selectedRegion);
+}
+
+QPoint VideoWidget::widgetToImage(const QPoint &pos) const
+{
+    const double sx = static_cast<double>(m_imageSize.width()) / m_imageRect.width();
+    const double sy = static_cast<double>(m_imageSize.height()) / m_imageRect.height();
+    const int x = static_cast<int>((pos.x() - m_imageRect.left()) * sx);
+    const int y = static_cast<int>((pos.y() - m_imageRect.top()) * sy);
+    return QPoint(qBound(0, x, m_imageSize.width() - 1), qBound(0, y, m_imageSize.height() - 1));
+}
+
+QRect VideoWidget::imageToWidget(const QRect &rect) const
+{
+    const double sx = static_cast<double>(m_imageRect.width()) / m_imageSize.width();
+    const double sy = static_cast<double>(m_imageRect.height()) / m_imageSize.height();
+    return QRect(m_imageRect.left() + static_cast<int>(rect.x() * sx),
+                 m_imageRect.top() + static_cast<int>(rect.y() * sy),
+                 static_cast<int>(rect.width() * sx),
+                 static_cast<int>(rect.height() * sy));
+}
+
 void VideoWidget::paintEvent(QPaintEvent *event)
 {
+    std::optional<TraceScope> paintScope;
+    if (m_frameSetNs != 0) {
+        TraceRecorder::instance().record("paint_wait", m_frameId, m_frameSetNs, TraceRecorder::nowNs());
+        paintScope.emplace("paint", m_frameId);
+        m_frameSetNs = 0;
+    }
+
     QPainter painter(this);
     painter.setRenderHint(QPainter::SmoothPixmapTransform, false);
 
@@ -44,12 +198,52 @@ void VideoWidget::paintEvent(QPaintEvent *event)
     if (imageSize.width() <= targetRect.width() && imageSize.height() <= targetRect.height()) {
         int x = (targetRect.width() - imageSize.width()) / 2;
         int y = (targetRect.height() - imageSize.height()) / 2;
+        m_imageRect = QRect(QPoint(x, y), imageSize);
         painter.drawImage(x, y, std::move(m_frame));
     } else {
         QSize scaledSize = imageSize.scaled(targetRect.size(), Qt::KeepAspectRatio);
         int x = (targetRect.width() - scaledSize.width()) / 2;
         int y = (targetRect.height() - scaledSize.height()) / 2;
         QRect drawRect(x, y, scaledSize.width(), scaledSize.height());
+        m_imageRect = drawRect;
         painter.drawImage(drawRect, std::move(m_frame));
     }
+    m_imageSize = imageSize;
+
+    if (!m_selectedRegion.isEmpty()) {
+        painter.setPen(QPen(Qt::yellow, 1, Qt::DashLine));
+        painter.setBrush(Qt::NoBrush);
+        painter.drawRect(imageToWidget(m_selectedRegion));
+    }
+
+    if (m_overlayVisible && !m_histogramCurve.isEmpty()) {
+        drawStatisticsOverlay(painter);
+    }
+}
+
+void VideoWidget::drawStatisticsOverlay(QPainter &painter)
+{
+    const QRect box(OVERLAY_MARGIN,
+                    height() - OVERLAY_HEIGHT - OVERLAY_MARGIN * 2 - 32,
+                    OVERLAY_WIDTH + OVERLAY_MARGIN * 2,
+                    OVERLAY_HEIGHT + OVERLAY_MARGIN * 2 + 32);
+    painter.fillRect(box, QColor(0, 0, 0, 160));
+
+    const QRectF plot(box.left() + OVERLAY_MARGIN, box.top() + OVERLAY_MARGIN,
+                      OVERLAY_WIDTH, OVERLAY_HEIGHT);
+
+    QPolygonF curve(m_histogramCurve.size());
+    for (int i = 0; i < m_histogramCurve.size(); ++i) {
+        const QPointF &p = m_histogramCurve[i];
+        curve[i] = QPointF(plot.left() + p.x() * plot.width(),
+                           plot.bottom() - p.y() * plot.height());
+    }
+
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(255, 255, 255, 180));
+    painter.drawPolygon(curve);
+
+    painter.setPen(Qt::white);
+    painter.drawText(QRectF(plot.left(), plot.bottom() + 4, plot.width(), 32),
+                     Qt::AlignLeft | Qt::AlignTop, m_statisticsText);
 }
@@ -1,10 +1,16 @@
 #include <arv.h>
 #include <iostream>
 #include <QApplication>
+#include <QTimer>
 #include "MainWindow.h"
+#include "StartupTimer.h"
 
 int main(int argc, char *argv[]) {
     QApplication app(argc, argv);
+    // QSettings 的存储位置（上次连接的相机、自动连接）
+    QCoreApplication::setOrganizationName("Aravis");
+    QCoreApplication::setApplicationName("AravisCameraControl");
+    StartupTimer::mark("QApplication 创建");
 
     // 打印Aravis库版本信息
     std::cout << "=== Aravis相机控制系统 ===" << std::endl;
@@ -18,6 +24,10 @@ int main(int argc, char *argv[]) {
     // 创建并显示主窗口
     MainWindow mainWindow;
     mainWindow.show();
+    StartupTimer::mark("主窗口显示");
+    QTimer::singleShot(0, []() {
+        StartupTimer::mark("进入事件循环");
+    });
 
     return app.exec();
 }
\ No newline at end of file
@@ -0,0 +1,90 @@
+// ALC 无损压缩文件解码：校验并转换为 PGM（高位深写成 16 位大端），用于离线查看和归档校验
+//
+// 用法: alc-decode 输入.alc [输出.pgm]    省略输出时只校验并打印帧信息
+
+#include "LosslessCodec.h"
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+bool readFile(const char *path, std::vector<uint8_t> &data)
+{
+    FILE *file = std::fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    std::fseek(file, 0, SEEK_END);
+    const long size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    data.resize(size > 0 ? static_cast<size_t>(size) : 0);
+    const bool ok = std::fread(data.data(), 1, data.size(), file) == data.size();
+    std::fclose(file);
+    return ok;
+}
+
+bool writePgm(const char *path, const Frame &frame)
+{
+    FILE *file = std::fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+
+    std::fprintf(file, "P5\n%d %d\n%d\n", frame.width, frame.height, frame.maxValue());
+    bool ok = true;
+    if (frame.bytesPerPixel() == 1) {
+        ok = std::fwrite(frame.bits(), 1, frame.data.size(), file) == frame.data.size();
+    } else {
+        std::vector<uint8_t> bigEndian(frame.data.size());
+        for (size_t i = 0; i < bigEndian.size(); i += 2) {
+            bigEndian[i] = frame.data[i + 1];
+            bigEndian[i + 1] = frame.data[i];
+        }
+        ok = std::fwrite(bigEndian.data(), 1, bigEndian.size(), file) == bigEndian.size();
+    }
+    return std::fclose(file) == 0 && ok;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        std::fprintf(stderr, "用法: %s 输入.alc [输出.pgm]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<uint8_t> encoded;
+    if (!readFile(argv[1], encoded)) {
+        std::fprintf(stderr, "无法读取: %s\n", argv[1]);
+        return 1;
+    }
+
+    Frame frame;
+    if (!LosslessCodec::decode(encoded.data(), encoded.size(), frame)) {
+        std::fprintf(stderr, "解码失败（格式错误或文件损坏）: %s\n", argv[1]);
+        return 1;
+    }
+
+    std::printf("%dx%d %d位 帧号 %llu 时间戳 %llu 压缩率 %.2f:1\n",
+                frame.width, frame.height, frame.bitDepth,
+                static_cast<unsigned long long>(frame.frameId),
+                static_cast<unsigned long long>(frame.timestampNs),
+                encoded.empty() ? 0.0 : static_cast<double>(frame.data.size()) / encoded.size());
+    if (frame.chunk.has(FrameChunkData::ExposureTime)) {
+        std::printf("块数据: 曝光 %.1f us", frame.chunk.exposureUs);
+        if (frame.chunk.has(FrameChunkData::Gain)) {
+            std::printf(" 增益 %.2f dB", frame.chunk.gainDb);
+        }
+        if (frame.chunk.has(FrameChunkData::LineStatus)) {
+            std::printf(" 线状态 0x%X", frame.chunk.lineStatus);
+        }
+        std::printf("\n");
+    }
+
+    if (argc >= 3 && !writePgm(argv[2], frame)) {
+        std::fprintf(stderr, "无法写入: %s\n", argv[2]);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+// 采集路径稳态零分配检查：用 Aravis 虚拟相机（Fake 接口）运行真实的连续采集，
+// 采集线程走与应用完全相同的路径（出队缓冲区、readFrameHeader/ChunkDecoder、帧池取帧、送入处理管线），
+// 帧池规模也由 startAcquisition() 决定。停止采集时 CameraController 报告预热后采集线程的分配，
+// 有任何分配或结果未知时返回非零退出码。
+//
+// 用法: alloc-check [采集秒数=10] [相机 ID=Fake_1]
+
+#include "AllocationTracker.h"
+#include "CameraController.h"
+#include <QCoreApplication>
+#include <QStringList>
+#include <QTimer>
+#include <algorithm>
+#include <cstdio>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    if (!AllocationTracker::isEnabled()) {
+        std::fprintf(stderr, "需要以 ARAVIS_TRACK_ALLOCATIONS 编译\n");
+        return 2;
+    }
+
+    const QStringList args = app.arguments();
+    // 前 2 秒是预热，之后至少再采集几秒才有稳态结果
+    const int seconds = std::max(args.size() > 1 ? args.at(1).toInt() : 10, 5);
+    const QString cameraId = args.size() > 2 ? args.at(2) : QString("Fake_1");
+
+    // 虚拟相机所在的 Fake 接口默认不枚举
+    arv_enable_interface("Fake");
+
+    CameraController controller;
+    int result = 2;
+    QObject::connect(&controller, &CameraController::errorOccurred, [](const QString &message) {
+        std::fprintf(stderr, "%s\n", message.toUtf8().constData());
+    });
+    QObject::connect(&controller, &CameraController::steadyStateAllocationsMeasured,
+                     [&result](bool measured, quint64 allocations, quint64 bytes, quint64 frames) {
+        if (!measured) {
+            std::printf("未知: 采集线程没有独立计数\n");
+            result = 2;
+            return;
+        }
+        std::printf("采集线程稳态 %llu 帧: %llu 次分配, %llu 字节\n", static_cast<unsigned long long>(frames),
+                    static_cast<unsigned long long>(allocations), static_cast<unsigned long long>(bytes));
+        if (frames == 0) {
+            std::printf("未通过: 稳态期间没有收到帧\n");
+            result = 2;
+        } else if (allocations != 0) {
+            std::printf("未通过: 采集线程稳态下仍有分配\n");
+            result = 1;
+        } else {
+            std::printf("通过\n");
+            result = 0;
+        }
+    });
+
+    if (!controller.connectCamera(cameraId) || !controller.startAcquisition()) {
+        return 2;
+    }
+
+    QTimer::singleShot(seconds * 1000, &app, [&app, &controller]() {
+        controller.stopAcquisition();
+        app.quit();
+    });
+    app.exec();
+
+    controller.disconnectCamera();
+    return result;
+}
@@ -0,0 +1,161 @@
+// 共享内存帧总线吞吐测试：1..N 个读者进程同时读取，统计写端帧率、读者帧率和丢帧率
+//
+// 用法: framebus-bench [最大读者数=4] [秒数=2] [宽=2448] [高=2048] [写端帧率=0(不限)]
+
+#include "FrameBusClient.h"
+#include "FrameBusWriter.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+struct ReaderResult {
+    uint64_t frames = 0;
+    uint64_t missed = 0;
+    uint64_t checksum = 0;
+};
+
+[[noreturn]] void runReader(const std::string &name, int readyFd, int resultFd)
+{
+    FrameBusClient client;
+    for (int attempt = 0; attempt < 100 && !client.open(name); ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    const char ready = client.isOpen() ? 1 : 0;
+    if (write(readyFd, &ready, 1) != 1 || !ready) {
+        _exit(1);
+    }
+
+    ReaderResult result;
+    while (true) {
+        if (!client.waitForFrame(100)) {
+            if (!client.isOpen() || client.readNext([](const FrameBusClient::FrameView &) {})
+                                        == FrameBusClient::ReadResult::Closed) {
+                break;
+            }
+            continue;
+        }
+
+        FrameBusClient::ReadResult status;
+        while ((status = client.readNext([&result](const FrameBusClient::FrameView &view) {
+                    // 零拷贝访问：每个缓存行读一个字节，模拟检测算法扫描整帧
+                    uint64_t sum = 0;
+                    for (size_t i = 0; i < view.size; i += 64) {
+                        sum += view.data[i];
+                    }
+                    result.checksum += sum;
+                })) == FrameBusClient::ReadResult::Ok) {
+            ++result.frames;
+        }
+        if (status == FrameBusClient::ReadResult::Closed) {
+            break;
+        }
+    }
+
+    result.missed = client.missedFrames();
+    const ssize_t written = write(resultFd, &result, sizeof(result));
+    _exit(written == static_cast<ssize_t>(sizeof(result)) ? 0 : 1);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const int maxReaders = argc > 1 ? std::atoi(argv[1]) : 4;
+    const double seconds = argc > 2 ? std::atof(argv[2]) : 2.0;
+    const int width = argc > 3 ? std::atoi(argv[3]) : 2448;
+    const int height = argc > 4 ? std::atoi(argv[4]) : 2048;
+    const double rate = argc > 5 ? std::atof(argv[5]) : 0.0;
+
+    Frame frame;
+    frame.width = width;
+    frame.height = height;
+    frame.bitDepth = 8;
+    frame.data.resize(static_cast<size_t>(width) * height);
+    for (size_t i = 0; i < frame.data.size(); ++i) {
+        frame.data[i] = static_cast<uint8_t>(i * 31);
+    }
+
+    const std::string name = "/framebus-bench-" + std::to_string(getpid());
+    const double frameMB = frame.data.size() / 1e6;
+    std::printf("帧大小 %dx%d (%.2f MB), 每轮 %.1f 秒, 写端帧率 %s\n",
+                width, height, frameMB, seconds, rate > 0 ? std::to_string(static_cast<int>(rate)).c_str() : "不限");
+    std::printf("readers   writer_fps   reader_fps   reader_GB/s   missed_%%\n");
+
+    for (int readers = 1; readers <= maxReaders; ++readers) {
+        FrameBusWriter writer;
+        if (!writer.create(name, 8, frame.data.size())) {
+            std::fprintf(stderr, "创建共享内存失败: %s\n", writer.errorString().c_str());
+            return 1;
+        }
+
+        int readyPipe[2];
+        int resultPipe[2];
+        if (pipe(readyPipe) != 0 || pipe(resultPipe) != 0) {
+            std::perror("pipe");
+            return 1;
+        }
+
+        std::vector<pid_t> children;
+        for (int i = 0; i < readers; ++i) {
+            const pid_t pid = fork();
+            if (pid == 0) {
+                runReader(name, readyPipe[1], resultPipe[1]);
+            }
+            children.push_back(pid);
+        }
+
+        int attached = 0;
+        for (int i = 0; i < readers; ++i) {
+            char ready = 0;
+            if (read(readyPipe[0], &ready, 1) == 1 && ready) {
+                ++attached;
+            }
+        }
+
+        uint64_t published = 0;
+        const auto start = std::chrono::steady_clock::now();
+        const auto end = start + std::chrono::duration<double>(seconds);
+        while (std::chrono::steady_clock::now() < end) {
+            frame.frameId = published;
+            writer.publish(frame);
+            ++published;
+            if (rate > 0) {
+                std::this_thread::sleep_until(start + std::chrono::duration<double>(published / rate));
+            }
+        }
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        writer.close();
+
+        ReaderResult total;
+        for (int i = 0; i < attached; ++i) {
+            ReaderResult result;
+            if (read(resultPipe[0], &result, sizeof(result)) == static_cast<ssize_t>(sizeof(result))) {
+                total.frames += result.frames;
+                total.missed += result.missed;
+            }
+        }
+        for (pid_t pid : children) {
+            waitpid(pid, nullptr, 0);
+        }
+        close(readyPipe[0]);
+        close(readyPipe[1]);
+        close(resultPipe[0]);
+        close(resultPipe[1]);
+
+        const double readerFps = attached ? total.frames / elapsed / attached : 0.0;
+        const double missedPercent = total.frames + total.missed
+                                         ? 100.0 * total.missed / (total.frames + total.missed) : 0.0;
+        std::printf("%7d %12.1f %12.1f %13.2f %10.2f\n", readers, published / elapsed, readerFps,
+                    readerFps * frameMB / 1000.0, missedPercent);
+    }
+
+    return 0;
+}
@@ -0,0 +1,149 @@
+// 远程预览回环测试：连接 MJPEG 流，按秒统计帧率、码率和平均帧大小；
+// 限速参数模拟慢速网络，可观察服务端跳帧和降低 JPEG 质量（平均帧大小下降）
+//
+// 用法: mjpeg-probe [主机=127.0.0.1] [端口=8080] [秒数=10] [限速 KB/s=0(不限)]
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct PartParser {
+    std::string buffer;
+    size_t expected = 0;        // 当前部分的 JPEG 字节数，0 表示正在找部分头
+    bool headerSkipped = false; // HTTP 响应头
+
+    // 返回解析出的完整 JPEG 数，bytes 累加其大小，badFrames 累加不以 FFD8 开头的帧
+    int consume(uint64_t &bytes, uint64_t &badFrames)
+    {
+        int frames = 0;
+        while (true) {
+            if (!headerSkipped || expected == 0) {
+                const size_t end = buffer.find("\r\n\r\n");
+                if (end == std::string::npos) {
+                    return frames;
+                }
+                if (!headerSkipped) {
+                    headerSkipped = true;
+                    buffer.erase(0, end + 4);
+                    continue;
+                }
+                const size_t length = buffer.find("Content-Length: ");
+                if (length == std::string::npos || length > end) {
+                    std::fprintf(stderr, "无法解析部分头\n");
+                    std::exit(1);
+                }
+                expected = std::strtoull(buffer.c_str() + length + 16, nullptr, 10);
+                buffer.erase(0, end + 4);
+            }
+            if (buffer.size() < expected + 2) {
+                return frames;
+            }
+            if (expected < 2 || static_cast<uint8_t>(buffer[0]) != 0xFF || static_cast<uint8_t>(buffer[1]) != 0xD8) {
+                ++badFrames;
+            }
+            bytes += expected;
+            ++frames;
+            buffer.erase(0, expected + 2);
+            expected = 0;
+        }
+    }
+};
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const char *host = argc > 1 ? argv[1] : "127.0.0.1";
+    const int port = argc > 2 ? std::atoi(argv[2]) : 8080;
+    const int seconds = argc > 3 ? std::atoi(argv[3]) : 10;
+    const double limitKBps = argc > 4 ? std::atof(argv[4]) : 0.0;
+
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (limitKBps > 0.0) {
+        // 缩小接收缓冲区，让限速尽快反映为服务端的发送积压
+        const int size = 64 * 1024;
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    }
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, host, &address.sin_addr) != 1
+        || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        std::fprintf(stderr, "连接 %s:%d 失败: %s\n", host, port, std::strerror(errno));
+        return 1;
+    }
+
+    const std::string request = "GET /stream.mjpg HTTP/1.0\r\n\r\n";
+    if (send(fd, request.data(), request.size(), 0) != static_cast<ssize_t>(request.size())) {
+        std::fprintf(stderr, "发送请求失败\n");
+        return 1;
+    }
+
+    std::printf("%6s %8s %10s %12s\n", "秒", "帧/秒", "KB/秒", "平均帧 KB");
+    PartParser parser;
+    char chunk[16384];
+    uint64_t totalFrames = 0;
+    uint64_t totalBytes = 0;
+    uint64_t badFrames = 0;
+    const auto start = Clock::now();
+    auto windowStart = start;
+    uint64_t windowFrames = 0;
+    uint64_t windowBytes = 0;
+    uint64_t receivedBytes = 0;
+
+    while (Clock::now() - start < std::chrono::seconds(seconds)) {
+        const ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+            std::fprintf(stderr, "连接已关闭\n");
+            break;
+        }
+        receivedBytes += static_cast<uint64_t>(n);
+        parser.buffer.append(chunk, static_cast<size_t>(n));
+
+        uint64_t bytes = 0;
+        const int frames = parser.consume(bytes, badFrames);
+        windowFrames += frames;
+        windowBytes += bytes;
+
+        if (limitKBps > 0.0) {
+            // 按累计接收量计算应到时间，超前时休眠
+            const auto due = start + std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(receivedBytes / (limitKBps * 1024.0)));
+            std::this_thread::sleep_until(due);
+        }
+
+        const auto now = Clock::now();
+        const double elapsed = std::chrono::duration<double>(now - windowStart).count();
+        if (elapsed >= 1.0) {
+            const double second = std::chrono::duration<double>(now - start).count();
+            std::printf("%6.0f %8.1f %10.1f %12.1f\n", second, windowFrames / elapsed, windowBytes / 1024.0 / elapsed,
+                        windowFrames > 0 ? windowBytes / 1024.0 / windowFrames : 0.0);
+            std::fflush(stdout);
+            totalFrames += windowFrames;
+            totalBytes += windowBytes;
+            windowFrames = 0;
+            windowBytes = 0;
+            windowStart = now;
+        }
+    }
+    close(fd);
+
+    totalFrames += windowFrames;
+    totalBytes += windowBytes;
+    std::printf("共 %llu 帧, %.1f MB, 无效 JPEG %llu 帧\n", static_cast<unsigned long long>(totalFrames),
+                totalBytes / (1024.0 * 1024.0), static_cast<unsigned long long>(badFrames));
+    return badFrames == 0 ? 0 : 1;
+}